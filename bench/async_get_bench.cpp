@@ -0,0 +1,82 @@
+// Point-read throughput on one thread: synchronous get() vs async_get() with
+// 1..64 lookups outstanding on an AsyncExecutor. Outstanding lookups take
+// turns one skip list step at a time, each step prefetching the next node, so
+// their cache misses overlap. Rows cover the active memtable and a frozen
+// (unflattened) skip list memtable.
+// Usage: async_get_bench [num_keys] [reads]
+#include "src/include/lsm_storage.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double mops(Clock::time_point start, Clock::time_point end, size_t ops) {
+    return static_cast<double>(ops) / std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+// One worker of a batch: reads every outstanding-th key starting at first
+static Task<void> Reader(LsmStorageInner* lsm, AsyncExecutor* executor, const std::vector<std::string>* keys,
+                         size_t first, size_t outstanding, size_t* found) {
+    PinnableValue value;
+    for (size_t i = first; i < keys->size(); i += outstanding) {
+        if (co_await lsm->async_get(*executor, (*keys)[i], &value)) {
+            (*found)++;
+        }
+    }
+}
+
+static void run(const char* name, size_t num_keys, size_t reads, bool freeze) {
+    LsmStorageOptions options;
+    options.target_sst_size = 1 << 30;
+    // A flat memtable answers with one binary search, which has no steps to interleave
+    options.flatten_immutable_memtables = false;
+    LsmStorageInner lsm(options);
+    for (size_t i = 0; i < num_keys; i++) {
+        lsm.put("key" + std::to_string(i * 7919 % num_keys), std::string(32, 'v'));
+    }
+    if (freeze) {
+        lsm.force_freeze_memtable();
+    }
+
+    std::mt19937 rng(46);
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < reads; i++) {
+        keys.push_back("key" + std::to_string(rng() % num_keys));
+    }
+
+    size_t found = 0;
+    PinnableValue value;
+    auto t0 = Clock::now();
+    for (const auto& key : keys) {
+        found += lsm.get(key, &value);
+    }
+    auto t1 = Clock::now();
+    std::printf("%-8s sync        %6.2f Mops/s\n", name, mops(t0, t1, reads));
+
+    for (size_t outstanding : {1, 4, 16, 64}) {
+        AsyncExecutor executor;
+        for (size_t w = 0; w < outstanding; w++) {
+            executor.spawn(Reader(&lsm, &executor, &keys, w, outstanding, &found));
+        }
+        auto start = Clock::now();
+        executor.run();
+        auto end = Clock::now();
+        std::printf("%-8s async x%-4zu %6.2f Mops/s\n", name, outstanding, mops(start, end, reads));
+    }
+    if (found != 5 * reads) {
+        std::printf("unexpected misses\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t num_keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t reads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+    std::printf("async_get_bench: %zu keys, %zu reads\n", num_keys, reads);
+    run("active", num_keys, reads, false);
+    run("frozen", num_keys, reads, true);
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Foreground read latency while a background thread writes a large file, as
+// memtable write-out will: no background work, buffered writes, O_DIRECT
+// writes, and O_DIRECT writes through a flush-priority RateLimiter.
+// Usage: background_io_bench [dir] [background_mb] [limit_mb_per_sec]
+#include "src/include/env.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const size_t kBlockSize = 4096;
+static const size_t kTableSize = 64 << 20;
+
+struct Result {
+    double p50_us;
+    double p99_us;
+    double p999_us;
+    double background_mb_per_sec;
+};
+
+static Result run(const std::string& dir, size_t background_mb, const FileOptions* background) {
+    Env* env = Env::Default();
+    auto table = env->NewRandomAccessFile(dir + "/background_io_bench.table");
+    std::atomic<bool> writing{background != nullptr};
+    double background_seconds = 0;
+
+    std::thread writer;
+    if (background) {
+        writer = std::thread([&] {
+            auto file = env->NewWritableFile(dir + "/background_io_bench.out", *background);
+            std::string chunk(1 << 20, 'w');
+            auto start = Clock::now();
+            for (size_t i = 0; i < background_mb; i++) {
+                file->Append(chunk);
+                if (i % 16 == 15) {
+                    file->Sync();
+                }
+            }
+            file->Close();
+            background_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            writing = false;
+        });
+    }
+
+    // Foreground: random block reads until the background work is done (or 20000 of them)
+    std::mt19937_64 rng(48);
+    std::vector<double> latencies;
+    char scratch[kBlockSize];
+    std::string_view result;
+    while (writing || latencies.size() < 20000) {
+        uint64_t offset = rng() % (kTableSize / kBlockSize) * kBlockSize;
+        auto start = Clock::now();
+        table->Read(offset, kBlockSize, scratch, &result);
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    if (writer.joinable()) {
+        writer.join();
+        env->DeleteFile(dir + "/background_io_bench.out");
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    return Result{pct(0.5), pct(0.99), pct(0.999),
+                  background_seconds > 0 ? static_cast<double>(background_mb) / background_seconds : 0};
+}
+
+static void print(const char* name, const Result& r) {
+    std::printf("%-22s read p50 %7.1f us  p99 %8.1f us  p99.9 %8.1f us   background %7.1f MB/s\n", name, r.p50_us,
+                r.p99_us, r.p999_us, r.background_mb_per_sec);
+}
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : "/tmp";
+    size_t background_mb = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 512;
+    int64_t limit_mb = argc > 3 ? std::strtoll(argv[3], nullptr, 10) : 100;
+    std::printf("background_io_bench: %s, %zu MB background write, limit %lld MB/s\n", dir.c_str(), background_mb,
+                static_cast<long long>(limit_mb));
+
+    auto table = Env::Default()->NewWritableFile(dir + "/background_io_bench.table");
+    std::string chunk(1 << 20, 't');
+    for (size_t i = 0; i < kTableSize; i += chunk.size()) {
+        table->Append(chunk);
+    }
+    table->Sync();
+    table.reset();
+
+    print("idle", run(dir, background_mb, nullptr));
+
+    FileOptions buffered;
+    buffered.io_priority = IOPriority::kFlush;
+    print("buffered writes", run(dir, background_mb, &buffered));
+
+    FileOptions direct = buffered;
+    direct.use_direct_io = true;
+    print("O_DIRECT writes", run(dir, background_mb, &direct));
+
+    FileOptions limited = direct;
+    limited.rate_limiter = std::make_shared<RateLimiter>(limit_mb << 20);
+    print("O_DIRECT + rate limit", run(dir, background_mb, &limited));
+
+    Env::Default()->DeleteFile(dir + "/background_io_bench.table");
+    return 0;
+}
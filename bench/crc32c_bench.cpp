@@ -0,0 +1,52 @@
+// Throughput of the CRC32C kernel: the crc32 instruction path (when the CPU
+// has SSE4.2) against the portable slicing-by-8 tables, per buffer size.
+// Usage: crc32c_bench [total_mb_per_size]
+#include "src/include/crc32c.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+using ExtendFn = uint32_t (*)(uint32_t, const char*, size_t);
+
+// GB/s checksumming total_bytes in buffers of size bytes
+static double run(ExtendFn extend, const std::string& data, size_t size, size_t total_bytes) {
+    size_t rounds = std::max<size_t>(1, total_bytes / size);
+    uint32_t crc = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < rounds; i++) {
+        // Walk through the buffer so every round does not hit the same cache lines
+        size_t offset = (i * size) % (data.size() - size + 1);
+        crc = extend(crc, data.data() + offset, size);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    // Keep the loop from being optimized away
+    if (crc == 0x12345678u) {
+        std::printf("!");
+    }
+    return static_cast<double>(rounds * size) / seconds / 1e9;
+}
+
+int main(int argc, char** argv) {
+    size_t total_mb = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+    std::printf("crc32c_bench: %zu MB per size, hardware acceleration %s\n", total_mb,
+                Crc32cIsHardwareAccelerated() ? "on" : "off");
+
+    std::mt19937_64 rng(49);
+    std::string data(4 << 20, '\0');
+    for (char& c : data) {
+        c = static_cast<char>(rng());
+    }
+
+    std::printf("%10s %14s %14s %8s\n", "size", "crc32c GB/s", "portable GB/s", "speedup");
+    for (size_t size : {16, 64, 256, 1024, 4096, 16384, 65536, 1 << 20}) {
+        double fast = run(Crc32cExtend, data, size, total_mb << 20);
+        double portable = run(Crc32cExtendPortable, data, size, total_mb << 20);
+        std::printf("%10zu %14.2f %14.2f %7.1fx\n", size, fast, portable, fast / portable);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Env backends on a local directory: random block reads issued one pread at a
+// time vs io_uring MultiRead batches, and log appends with and without a
+// sync per record (io_uring links the write and the fdatasync).
+// Usage: env_bench [dir] [file_mb] [batch]
+#include "src/include/env.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const size_t kBlockSize = 4096;
+
+static double us_per_op(Clock::time_point start, Clock::time_point end, size_t ops) {
+    return std::chrono::duration<double, std::micro>(end - start).count() / static_cast<double>(ops);
+}
+
+static void bench_reads(const char* name, Env* env, const std::string& path, size_t file_size, size_t batch) {
+    auto file = env->NewRandomAccessFile(path);
+    std::mt19937_64 rng(47);
+    const size_t reads = 100000;
+    std::vector<ReadRequest> requests(batch);
+    std::vector<char> scratch(batch * kBlockSize);
+    size_t bytes = 0;
+    auto start = Clock::now();
+    for (size_t done = 0; done < reads; done += batch) {
+        for (size_t i = 0; i < batch; i++) {
+            requests[i].offset = rng() % (file_size / kBlockSize) * kBlockSize;
+            requests[i].len = kBlockSize;
+            requests[i].scratch = scratch.data() + i * kBlockSize;
+        }
+        file->MultiRead(requests.data(), batch);
+        for (const ReadRequest& request : requests) {
+            bytes += request.result.size();
+        }
+    }
+    auto end = Clock::now();
+    std::printf("%-10s read 4KB x%-3zu %7.2f us/read   (%zu MB)\n", name, batch, us_per_op(start, end, reads),
+                bytes >> 20);
+}
+
+static void bench_appends(const char* name, Env* env, const std::string& path, bool sync, size_t records) {
+    auto file = env->NewWritableFile(path);
+    std::string record(kBlockSize, 'r');
+    auto start = Clock::now();
+    for (size_t i = 0; i < records; i++) {
+        if (sync) {
+            file->AppendAndSync(record);
+        } else {
+            file->Append(record);
+        }
+    }
+    auto end = Clock::now();
+    std::printf("%-10s append 4KB %-6s %7.2f us/record\n", name, sync ? "+sync" : "", us_per_op(start, end, records));
+    env->DeleteFile(path);
+}
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : "/tmp";
+    size_t file_mb = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+    size_t batch = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 32;
+    std::string path = dir + "/env_bench.data";
+    std::printf("env_bench: %s, %zu MB file, batches of %zu\n", path.c_str(), file_mb, batch);
+
+    Env* posix = Env::Default();
+    std::unique_ptr<Env> uring = NewIoUringEnv();
+    if (!uring) {
+        std::printf("io_uring not available\n");
+    }
+
+    // Reads mostly hit the page cache unless the file is larger than memory
+    auto writer = posix->NewWritableFile(path);
+    std::string chunk(1 << 20, 'x');
+    for (size_t i = 0; i < file_mb; i++) {
+        writer->Append(chunk);
+    }
+    writer->Sync();
+    writer.reset();
+    size_t file_size = file_mb << 20;
+
+    bench_reads("posix", posix, path, file_size, 1);
+    bench_reads("posix", posix, path, file_size, batch);
+    if (uring) {
+        bench_reads("io_uring", uring.get(), path, file_size, 1);
+        bench_reads("io_uring", uring.get(), path, file_size, batch);
+    }
+    posix->DeleteFile(path);
+
+    std::string log = dir + "/env_bench.log";
+    bench_appends("posix", posix, log, false, 20000);
+    bench_appends("posix", posix, log, true, 1000);
+    if (uring) {
+        bench_appends("io_uring", uring.get(), log, false, 20000);
+        bench_appends("io_uring", uring.get(), log, true, 1000);
+    }
+    return 0;
+}
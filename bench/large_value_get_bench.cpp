@@ -0,0 +1,63 @@
+// Point reads of large (64KB) values: std::optional<std::string> get() vs
+// get() into a reused PinnableValue, from the active memtable, a frozen
+// skip list memtable and a frozen flat memtable.
+// Usage: large_value_get_bench [num_keys] [value_size]
+#include "src/include/lsm_storage.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double ns_per_op(Clock::time_point start, Clock::time_point end, size_t ops) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+static void run(const char* name, size_t num_keys, size_t value_size, bool freeze, bool flatten) {
+    LsmStorageOptions options;
+    options.target_sst_size = 1 << 30;
+    options.flatten_immutable_memtables = flatten;
+    LsmStorageInner lsm(options);
+    for (size_t i = 0; i < num_keys; i++) {
+        lsm.put("key" + std::to_string(i), std::string(value_size, static_cast<char>('a' + i % 26)));
+    }
+    if (freeze) {
+        lsm.force_freeze_memtable();
+    }
+
+    std::mt19937 rng(45);
+    std::vector<std::string> lookups;
+    const size_t reads = 20000;
+    for (size_t i = 0; i < reads; i++) {
+        lookups.push_back("key" + std::to_string(rng() % num_keys));
+    }
+
+    size_t bytes = 0;
+    auto t0 = Clock::now();
+    for (const auto& key : lookups) {
+        bytes += lsm.get(key)->size();
+    }
+    auto t1 = Clock::now();
+    PinnableValue value;
+    for (const auto& key : lookups) {
+        lsm.get(key, &value);
+        bytes += value.size();
+    }
+    auto t2 = Clock::now();
+
+    std::printf("%-16s optional %8.1f ns/op   pinnable %8.1f ns/op   (%zu MB read)\n", name,
+                ns_per_op(t0, t1, reads), ns_per_op(t1, t2, reads), bytes >> 20);
+}
+
+int main(int argc, char** argv) {
+    size_t num_keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    size_t value_size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64 * 1024;
+    std::printf("large_value_get_bench: %zu keys, %zu byte values\n", num_keys, value_size);
+    run("active", num_keys, value_size, false, false);
+    run("frozen skiplist", num_keys, value_size, true, false);
+    run("frozen flat", num_keys, value_size, true, true);
+    return 0;
+}
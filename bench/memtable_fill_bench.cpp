@@ -0,0 +1,69 @@
+// fillseq vs fillrandom: MemTable::put throughput on the skip list rep when
+// keys arrive in ascending order (backfills) and in random order, plus an
+// overwrite pass over the same keys. The skiplist rows time the list alone,
+// with and without an insert hint.
+// Usage: memtable_fill_bench [num_keys]
+#include "src/include/mem_table.hpp"
+#include "src/include/data_structures/skiplist.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double ns_per_op(Clock::time_point start, Clock::time_point end, size_t ops) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+static void run(const char* name, const std::vector<std::string>& keys) {
+    MemTable memtable;
+    auto t0 = Clock::now();
+    for (const auto& key : keys) {
+        memtable.put(key, "value");
+    }
+    auto t1 = Clock::now();
+    for (const auto& key : keys) {
+        memtable.put(key, "value2");
+    }
+    auto t2 = Clock::now();
+    std::printf("%-12s fill %8.1f ns/op   overwrite %8.1f ns/op   (size %zu)\n", name,
+                ns_per_op(t0, t1, keys.size()), ns_per_op(t1, t2, keys.size()), memtable.memory_usage());
+}
+
+static void run_list(const char* name, const std::vector<std::string>& keys, bool use_hint) {
+    SkipList list;
+    SkipList::InsertHint hint;
+    SkipList::InsertHint* hint_ptr = use_hint ? &hint : nullptr;
+    auto t0 = Clock::now();
+    for (const auto& key : keys) {
+        list.Upsert(key, "value", hint_ptr);
+    }
+    auto t1 = Clock::now();
+    std::printf("%-12s %-9s %8.1f ns/op\n", name, use_hint ? "hinted" : "unhinted", ns_per_op(t0, t1, keys.size()));
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+    std::vector<std::string> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "key%016zu", i);
+        keys.emplace_back(buf);
+    }
+
+    std::printf("memtable_fill_bench: %zu keys\n", n);
+    run("fillseq", keys);
+    run_list("skiplist seq", keys, false);
+    run_list("skiplist seq", keys, true);
+    std::mt19937_64 rng(44);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    run("fillrandom", keys);
+    run_list("skiplist rnd", keys, false);
+    run_list("skiplist rnd", keys, true);
+    return 0;
+}
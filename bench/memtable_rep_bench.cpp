@@ -0,0 +1,77 @@
+// Compares insert / freeze / point get / full scan throughput of the memtable representations.
+// Gets and scans run after the memtable is frozen, which is when the vector rep sorts
+// and, for the "flat" row, when the skip list is copied into a flat sorted array.
+// Usage: memtable_rep_bench [num_keys]
+#include "src/include/mem_table.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double ns_per_op(Clock::time_point start, Clock::time_point end, size_t ops) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+static void run(const char* name, std::shared_ptr<MemTableRepFactory> factory,
+                const std::vector<std::string>& keys, const std::vector<std::string>& lookups,
+                bool flatten = false) {
+    MemTableOptions options;
+    options.rep_factory = std::move(factory);
+    auto mutable_memtable = std::make_shared<MemTable>(options);
+
+    auto t0 = Clock::now();
+    for (const auto& k : keys) {
+        mutable_memtable->put(k, "value-" + k);
+    }
+    auto t1 = Clock::now();
+    mutable_memtable->mark_immutable();
+    std::shared_ptr<MemTable> frozen = flatten ? mutable_memtable->flatten() : mutable_memtable;
+    MemTable& memtable = *frozen;
+    auto t1f = Clock::now();
+
+    size_t found = 0;
+    for (const auto& k : lookups) {
+        found += memtable.get(k).has_value();
+    }
+    auto t2 = Clock::now();
+
+    size_t scanned = 0;
+    auto iter = memtable.begin();
+    while (iter.is_valid()) {
+        scanned++;
+        iter.next();
+    }
+    auto t3 = Clock::now();
+
+    std::printf("%-10s insert %8.1f ns/op   freeze %8.2f ms   get %8.1f ns/op   scan %8.1f ns/op   (found %zu, scanned %zu)\n",
+                name, ns_per_op(t0, t1, keys.size()),
+                std::chrono::duration<double, std::milli>(t1f - t1).count(),
+                ns_per_op(t1f, t2, lookups.size()), ns_per_op(t2, t3, scanned), found, scanned);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    std::mt19937_64 rng(301);
+    std::vector<std::string> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "user%016llx", static_cast<unsigned long long>(rng()));
+        keys.emplace_back(buf);
+    }
+    std::vector<std::string> lookups = keys;
+    std::shuffle(lookups.begin(), lookups.end(), rng);
+
+    std::printf("memtable_rep_bench: %zu random 20-byte keys\n", n);
+    run("skiplist", std::make_shared<SkipListRepFactory>(), keys, lookups);
+    run("btree", std::make_shared<BTreeRepFactory>(), keys, lookups);
+    run("vector", std::make_shared<VectorRepFactory>(n), keys, lookups);
+    run("flat", std::make_shared<SkipListRepFactory>(), keys, lookups, true);
+    return 0;
+}
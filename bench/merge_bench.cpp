@@ -0,0 +1,59 @@
+// Counter updates: get + put read-modify-write vs a blind merge with AddOperator.
+// Reports the update cost and the cost of reading every counter afterwards,
+// when the merge path folds the operands left in the memtables. "compacted"
+// runs with imm_compaction_trigger, which folds operands eagerly.
+// Usage: merge_bench [num_updates] [num_counters]
+#include "src/include/lsm_storage.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+static double ns_per_op(Clock::time_point start, Clock::time_point end, size_t ops) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+static void run(const char* name, bool use_merge, size_t trigger, size_t updates, size_t counters) {
+    LsmStorageOptions options;
+    options.merge_operator = std::make_shared<AddOperator>();
+    options.target_sst_size = 256 * 1024;
+    options.imm_compaction_trigger = trigger;
+    Lsm lsm(options);
+
+    std::mt19937_64 rng(38);
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < updates; ++i) {
+        std::string key = "counter" + std::to_string(rng() % counters);
+        if (use_merge) {
+            lsm.merge(key, "1");
+        } else {
+            std::optional<std::string> current = lsm.get(key);
+            lsm.put(key, std::to_string((current ? std::stoll(*current) : 0) + 1));
+        }
+    }
+    auto t1 = Clock::now();
+
+    long long total = 0;
+    for (size_t c = 0; c < counters; ++c) {
+        std::optional<std::string> value = lsm.get("counter" + std::to_string(c));
+        if (value) total += std::stoll(*value);
+    }
+    auto t2 = Clock::now();
+
+    std::printf("%-18s update %7.1f ns/op   read %7.1f ns/op   (sum %lld)\n", name,
+                ns_per_op(t0, t1, updates), ns_per_op(t1, t2, counters), total);
+}
+
+int main(int argc, char** argv) {
+    size_t updates = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t counters = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    std::printf("merge_bench: %zu increments over %zu counters\n", updates, counters);
+    run("get+put", false, 0, updates, counters);
+    run("merge", true, 0, updates, counters);
+    run("get+put compacted", false, 4, updates, counters);
+    run("merge compacted", true, 4, updates, counters);
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Time to open a database against the number of tables it holds: Lsm::open
+// reads only the manifest, the first get reads the one table in its key
+// range, and a full scan reads them all (what an eager open would cost).
+// A second run shows manifest snapshots bounding replay after many edits.
+// Usage: open_bench [dir] [max_tables] [churn_freezes]
+#include "src/include/lsm_storage.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int kKeysPerTable = 100;
+
+static double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void remove_dir(const std::string& dir) {
+    std::vector<std::string> names;
+    Env::Default()->GetChildren(dir, &names);
+    for (const auto& name : names) {
+        Env::Default()->DeleteFile(dir + "/" + name);
+    }
+}
+
+static std::string key(int table, int i) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "t%06d_%03d", table, i);
+    return buf;
+}
+
+static uint64_t manifest_bytes(const std::string& dir) {
+    std::vector<std::string> names;
+    Env::Default()->GetChildren(dir, &names);
+    uint64_t total = 0;
+    for (const auto& name : names) {
+        uint64_t size;
+        if (name.rfind("MANIFEST-", 0) == 0 && Env::Default()->GetFileSize(dir + "/" + name, &size)) {
+            total += size;
+        }
+    }
+    return total;
+}
+
+static LsmStorageOptions bench_options() {
+    LsmStorageOptions options;
+    // Every table is written straight from its frozen memtable
+    options.flatten_immutable_memtables = false;
+    return options;
+}
+
+// Build a database of tables tables with disjoint key ranges
+static void build(const std::string& dir, int tables) {
+    remove_dir(dir);
+    auto storage = LsmStorageInner::open(dir, bench_options());
+    for (int t = 0; t < tables; t++) {
+        for (int i = 0; i < kKeysPerTable; i++) {
+            storage->put(key(t, i), std::string(100, 'v'));
+        }
+        storage->force_freeze_memtable();
+    }
+}
+
+static void bench_table_count(const std::string& dir, int tables) {
+    build(dir, tables);
+    LsmStorageOptions options = bench_options();
+
+    // Best of a few, timing the open alone (closing releases every memtable)
+    double open_ms = 1e9;
+    for (int i = 0; i < 5; i++) {
+        auto start = Clock::now();
+        auto storage = LsmStorageInner::open(dir, options);
+        open_ms = std::min(open_ms, ms_since(start));
+    }
+
+    auto storage = LsmStorageInner::open(dir, options);
+    auto start = Clock::now();
+    bool found = storage->get(key(tables / 2, 7)).has_value();
+    double first_get_ms = ms_since(start);
+    storage.reset();
+
+    start = Clock::now();
+    storage = LsmStorageInner::open(dir, options);
+    size_t entries = 0;
+    for (auto iter = storage->scan(); iter->is_valid(); iter->next()) {
+        entries++;
+    }
+    double scan_ms = ms_since(start);
+    storage.reset();
+
+    std::printf("%8d %14llu %10.2f %14.3f %16.1f%s\n", tables, static_cast<unsigned long long>(manifest_bytes(dir)),
+                open_ms, first_get_ms, scan_ms,
+                found && entries == static_cast<size_t>(tables) * kKeysPerTable ? "" : "  (wrong result)");
+}
+
+// Many freezes and compactions; open then replays whatever the manifest holds
+static void bench_churn(const std::string& dir, int freezes, uint64_t max_manifest_file_size) {
+    remove_dir(dir);
+    LsmStorageOptions options = bench_options();
+    options.imm_compaction_trigger = 8;
+    options.max_manifest_file_size = max_manifest_file_size;
+    {
+        auto storage = LsmStorageInner::open(dir, options);
+        for (int f = 0; f < freezes; f++) {
+            storage->put(key(f, 0), "v");
+            storage->force_freeze_memtable();
+        }
+    }
+    // Reopening rewrites the manifest as a snapshot, so time the first open of the log as written
+    uint64_t manifest_before_open = manifest_bytes(dir);
+    auto start = Clock::now();
+    auto storage = LsmStorageInner::open(dir, options);
+    double open_ms = ms_since(start);
+    std::printf("%-22s %8d freezes  manifest before open %9llu bytes  open %8.2f ms\n",
+                max_manifest_file_size == UINT64_MAX ? "no snapshots" : "snapshot at 64 KB", freezes,
+                static_cast<unsigned long long>(manifest_before_open), open_ms);
+}
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : "/tmp/open_bench";
+    int max_tables = argc > 2 ? std::atoi(argv[2]) : 4000;
+    int churn = argc > 3 ? std::atoi(argv[3]) : 4000;
+    Env::Default()->CreateDirIfMissing(dir);
+    std::printf("open_bench: %s, %d keys per table\n", dir.c_str(), kKeysPerTable);
+
+    std::printf("%8s %14s %10s %14s %16s\n", "tables", "manifest bytes", "open ms", "first get ms",
+                "open + scan ms");
+    for (int tables = 10; tables <= max_tables; tables *= 4) {
+        bench_table_count(dir, tables);
+    }
+
+    bench_churn(dir, churn, UINT64_MAX);
+    bench_churn(dir, churn, 64 << 10);
+    remove_dir(dir);
+    return 0;
+}
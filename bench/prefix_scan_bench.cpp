@@ -0,0 +1,83 @@
+// Prefix scan latency on a multi-tenant dataset.
+// Keys are "tenantNNN/tableN/rowNNNNNNN"; tenants ingest in bursts, so each
+// memtable holds only some tenants and a tenant's rows spread over a few of them.
+// "seek" merges every memtable and stops at the end of the prefix by hand,
+// "bounded" is scan_prefix without a prefix extractor (no filters), and
+// "filtered" is scan_prefix with prefix Bloom filters on "tenant/table/".
+// Usage: prefix_scan_bench [num_keys]
+#include "src/include/lsm_storage.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int kTenants = 200;
+static const int kTables = 4;
+static const int kBurst = 200;
+
+static std::string table_prefix(int tenant, int table) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "tenant%03d/table%d/", tenant, table);
+    return buf;
+}
+
+static void load(Lsm& lsm, size_t n) {
+    std::mt19937_64 rng(36);
+    std::vector<int> next_row(kTenants * kTables, 0);
+    for (size_t written = 0; written < n;) {
+        int tenant = static_cast<int>(rng() % kTenants);
+        for (int i = 0; i < kBurst && written < n; ++i, ++written) {
+            int table = static_cast<int>(rng() % kTables);
+            char row[16];
+            std::snprintf(row, sizeof(row), "row%07d", next_row[tenant * kTables + table]++);
+            lsm.put(table_prefix(tenant, table) + row, "payload-payload-payload");
+        }
+    }
+}
+
+template <typename Open>
+static void run(const char* name, Lsm& lsm, Open open, size_t queries) {
+    std::mt19937_64 rng(7);
+    size_t rows = 0;
+    auto t0 = Clock::now();
+    for (size_t q = 0; q < queries; ++q) {
+        std::string prefix = table_prefix(static_cast<int>(rng() % kTenants), static_cast<int>(rng() % kTables));
+        for (auto iter = open(lsm, prefix); iter->is_valid(); iter->next()) {
+            if (iter->key().compare(0, prefix.size(), prefix) != 0) break;
+            rows++;
+        }
+    }
+    auto t1 = Clock::now();
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / static_cast<double>(queries);
+    std::printf("%-10s %8.1f us/scan   (%zu rows, %.1f rows/scan)\n", name, us, rows,
+                static_cast<double>(rows) / static_cast<double>(queries));
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const size_t queries = 2000;
+
+    LsmStorageOptions options;
+    options.target_sst_size = 256 * 1024;
+    Lsm plain(options);
+    load(plain, n);
+
+    options.prefix_extractor = std::make_shared<DelimiterPrefixExtractor>('/', 2);
+    Lsm filtered(options);
+    load(filtered, n);
+
+    std::printf("prefix_scan_bench: %zu keys, %d tenants x %d tables, %zu full table scans\n",
+                n, kTenants, kTables, queries);
+    run("seek", plain, [](Lsm& lsm, const std::string& prefix) {
+        auto iter = lsm.scan();
+        iter->seek(prefix);
+        return iter;
+    }, queries);
+    run("bounded", plain, [](Lsm& lsm, const std::string& prefix) { return lsm.scan_prefix(prefix); }, queries);
+    run("filtered", filtered, [](Lsm& lsm, const std::string& prefix) { return lsm.scan_prefix(prefix); }, queries);
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Scan cost over a deleted region: point tombstones vs one range tombstone.
+// A dropped tenant of num_keys rows sits between two live tenants of 10k rows;
+// "full" scans the whole store, "seek" reads 10 live rows starting at the
+// beginning of the dropped tenant.
+// Usage: range_delete_bench [num_keys]
+#include "src/include/lsm_storage.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+static const int kLiveRows = 10000;
+
+static std::string row_key(int tenant, size_t row) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "tenant%02d/row%08zu", tenant, row);
+    return buf;
+}
+
+static double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void run(const char* name, bool range, size_t n) {
+    Lsm lsm;
+    for (size_t i = 0; i < kLiveRows; ++i) lsm.put(row_key(0, i), "live");
+    for (size_t i = 0; i < n; ++i) lsm.put(row_key(1, i), "dropped");
+    for (size_t i = 0; i < kLiveRows; ++i) lsm.put(row_key(2, i), "live");
+
+    auto t0 = Clock::now();
+    if (range) {
+        lsm.delete_range("tenant01/", "tenant02/");
+    } else {
+        for (auto iter = lsm.scan(); iter->is_valid(); iter->next()) {
+            std::string key = iter->key();
+            if (key.compare(0, 9, "tenant01/") == 0) lsm.delete_key(key);
+        }
+    }
+    double delete_ms = ms_since(t0);
+
+    auto t1 = Clock::now();
+    size_t live = 0;
+    for (auto iter = lsm.scan(); iter->is_valid(); iter->next()) live++;
+    double full_ms = ms_since(t1);
+
+    const int seeks = 20;
+    auto t2 = Clock::now();
+    size_t seen = 0;
+    for (int s = 0; s < seeks; ++s) {
+        auto iter = lsm.scan();
+        iter->seek("tenant01/");
+        for (int i = 0; i < 10 && iter->is_valid(); ++i, iter->next()) seen++;
+    }
+    double seek_ms = ms_since(t2) / seeks;
+
+    std::printf("%-6s delete %9.1f ms   full scan %8.1f ms (%zu live)   seek+10 %9.3f ms (%zu rows)\n",
+                name, delete_ms, full_ms, live, seek_ms, seen);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::printf("range_delete_bench: %zu deleted keys between %d live keys\n", n, 2 * kLiveRows);
+    run("point", false, n);
+    run("range", true, n);
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Forward vs reverse scan throughput through the full Lsm iterator stack.
+// The store holds a few flattened frozen memtables plus an active one.
+// "window" reads the 10 entries before (reverse) or after (forward) a random key.
+// Usage: reverse_scan_bench [num_keys]
+#include "src/include/lsm_storage.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double ns_per_op(Clock::time_point start, Clock::time_point end, size_t ops) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+static void run(const char* name, std::shared_ptr<MemTableRepFactory> factory, size_t n) {
+    LsmStorageOptions options;
+    options.memtable_factory = std::move(factory);
+    Lsm lsm(options);
+
+    std::mt19937_64 rng(35);
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < n; ++i) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "user%016llx", static_cast<unsigned long long>(rng()));
+        keys.emplace_back(buf);
+        lsm.put(buf, "value");
+    }
+
+    auto t0 = Clock::now();
+    size_t forward = 0;
+    for (auto iter = lsm.scan(); iter->is_valid(); iter->next()) forward++;
+    auto t1 = Clock::now();
+    size_t reverse = 0;
+    for (auto iter = lsm.reverse_scan(); iter->is_valid(); iter->prev()) reverse++;
+    auto t2 = Clock::now();
+
+    const size_t windows = 2000;
+    const size_t window = 10;
+    size_t seen = 0;
+    auto t3 = Clock::now();
+    for (size_t w = 0; w < windows; ++w) {
+        auto iter = lsm.scan();
+        iter->seek(keys[w % keys.size()]);
+        for (size_t i = 0; i < window && iter->is_valid(); ++i, iter->next()) seen++;
+    }
+    auto t4 = Clock::now();
+    for (size_t w = 0; w < windows; ++w) {
+        auto iter = lsm.reverse_scan(keys[w % keys.size()]);
+        for (size_t i = 0; i < window && iter->is_valid(); ++i, iter->prev()) seen++;
+    }
+    auto t5 = Clock::now();
+
+    std::printf("%-10s forward %7.1f ns/key   reverse %7.1f ns/key   window fwd %8.0f ns   window rev %8.0f ns   (%zu/%zu keys, %zu)\n",
+                name, ns_per_op(t0, t1, forward), ns_per_op(t1, t2, reverse),
+                ns_per_op(t3, t4, windows), ns_per_op(t4, t5, windows), forward, reverse, seen);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::printf("reverse_scan_bench: %zu random 20-byte keys\n", n);
+    run("skiplist", std::make_shared<SkipListRepFactory>(), n);
+    run("btree", std::make_shared<BTreeRepFactory>(), n);
+    return 0;
+}
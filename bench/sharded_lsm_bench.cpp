@@ -0,0 +1,64 @@
+// Write throughput of Lsm vs ShardedLsm with several writer threads.
+// Each thread writes its own keys; the single instance serializes them on one
+// memtable, the sharded one spreads them over independent shards.
+// Usage: sharded_lsm_bench [num_threads] [keys_per_thread]
+#include "src/include/sharded_lsm.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Put>
+static double run(size_t num_threads, size_t per_thread, Put put) {
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            char buf[32];
+            for (size_t i = 0; i < per_thread; ++i) {
+                std::snprintf(buf, sizeof(buf), "t%02zu_%012zu", t, i);
+                put(std::string(buf));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(num_threads * per_thread) / seconds;
+}
+
+int main(int argc, char** argv) {
+    size_t num_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    size_t per_thread = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    if (num_threads == 0) num_threads = 1;
+
+    std::printf("sharded_lsm_bench: %zu threads x %zu puts\n", num_threads, per_thread);
+
+    {
+        Lsm lsm;
+        double ops = run(num_threads, per_thread, [&](const std::string& k) { lsm.put(k, "value"); });
+        std::printf("%-22s %12.0f puts/s\n", "single", ops);
+    }
+
+    for (ShardingPolicy policy : {ShardingPolicy::kHash, ShardingPolicy::kRange}) {
+        ShardedLsmOptions options;
+        options.policy = policy;
+        options.num_shards = num_threads;
+        // Give each writer thread its own range shard
+        for (size_t t = 1; t < num_threads; ++t) {
+            // Room for any size_t, so the name is never cut short
+            char buf[24];
+            std::snprintf(buf, sizeof(buf), "t%02zu", t);
+            options.split_keys.emplace_back(buf);
+        }
+        ShardedLsm lsm(options);
+        double ops = run(num_threads, per_thread, [&](const std::string& k) { lsm.put(k, "value"); });
+        std::printf("%-22s %12.0f puts/s\n", policy == ShardingPolicy::kHash ? "sharded (hash)" : "sharded (range)", ops);
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+// Key comparisons and time per SkipList lookup at memtable-sized entry
+// counts, to check that tower heights keep up with the list's size.
+// Usage: skiplist_height_bench [num_entries...]   (default 1M 4M 10M)
+#include "src/include/data_structures/skiplist.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t comparisons = 0;
+
+struct CountingLess {
+    bool operator()(uint64_t a, uint64_t b) const {
+        ++comparisons;
+        return a < b;
+    }
+};
+
+static void run(size_t n) {
+    std::mt19937_64 rng(43);
+    BasicSkipList<uint64_t, CountingLess> list;
+    std::vector<uint64_t> keys(n);
+    for (auto& key : keys) {
+        key = rng();
+    }
+
+    auto t0 = Clock::now();
+    for (uint64_t key : keys) {
+        list.Insert(key, "");
+    }
+    auto t1 = Clock::now();
+
+    const size_t lookups = 1000000;
+    size_t found = 0;
+    comparisons = 0;
+    auto t2 = Clock::now();
+    for (size_t i = 0; i < lookups; i++) {
+        found += list.Contains(keys[rng() % n]).has_value();
+    }
+    auto t3 = Clock::now();
+
+    double insert_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(n);
+    double lookup_ns = std::chrono::duration<double, std::nano>(t3 - t2).count() / static_cast<double>(lookups);
+    std::printf("%9zu entries   insert %7.1f ns/op   lookup %7.1f ns/op   %6.1f comparisons/lookup   (found %zu)\n",
+                n, insert_ns, lookup_ns, static_cast<double>(comparisons) / lookups, found);
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(std::strtoul(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {1000000, 4000000, 10000000};
+    }
+    for (size_t n : sizes) {
+        run(n);
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Compares skip list Insert / Contains for byte-string keys against the same
+// keys stored inline as fixed-width integers (8-byte big-endian and 16-byte UUID).
+// Usage: skiplist_key_bench [num_keys]
+#include "src/include/data_structures/skiplist.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double ns_per_op(Clock::time_point start, Clock::time_point end, size_t ops) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+template <typename Key>
+static void run(const char* name, const std::vector<Key>& keys, const std::vector<Key>& lookups) {
+    BasicSkipList<Key> list;
+    std::string value = "value";
+
+    auto t0 = Clock::now();
+    for (const Key& key : keys) {
+        list.Insert(key, value);
+    }
+    auto t1 = Clock::now();
+    size_t found = 0;
+    for (const Key& key : lookups) {
+        found += list.Contains(key).has_value();
+    }
+    auto t2 = Clock::now();
+
+    std::printf("%-16s insert %8.1f ns/op   contains %8.1f ns/op   (found %zu)\n", name,
+                ns_per_op(t0, t1, keys.size()), ns_per_op(t1, t2, lookups.size()), found);
+}
+
+template <typename Key>
+static std::vector<Key> shuffled(std::vector<Key> keys, std::mt19937_64& rng) {
+    std::shuffle(keys.begin(), keys.end(), rng);
+    return keys;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    std::mt19937_64 rng(301);
+    std::vector<uint64_t> ints;
+    std::vector<Uuid> uuids;
+    std::vector<std::string> int_strings;
+    std::vector<std::string> uuid_strings;
+    for (size_t i = 0; i < n; ++i) {
+        ints.push_back(rng());
+        uuids.push_back(Uuid{rng(), rng()});
+        int_strings.push_back(KeyCodec<uint64_t>::Encode(ints.back()));
+        uuid_strings.push_back(KeyCodec<Uuid>::Encode(uuids.back()));
+    }
+
+    std::printf("skiplist_key_bench: %zu random keys\n", n);
+    run("string 8B", int_strings, shuffled(int_strings, rng));
+    run("uint64_t", ints, shuffled(ints, rng));
+    run("string 16B", uuid_strings, shuffled(uuid_strings, rng));
+    run("Uuid", uuids, shuffled(uuids, rng));
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Skip list Insert / Contains cost for the key shapes we store: short random
+// keys, "user" + hex ids, and long keys behind a shared tenant/table path.
+// Usage: skiplist_lookup_bench [num_keys]
+#include "src/include/data_structures/skiplist.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double ns_per_op(Clock::time_point start, Clock::time_point end, size_t ops) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+static void run(const char* name, const std::vector<std::string>& keys, std::mt19937_64& rng) {
+    std::vector<std::string> lookups = keys;
+    std::shuffle(lookups.begin(), lookups.end(), rng);
+    // Same shape, but absent
+    std::vector<std::string> misses;
+    for (size_t i = 0; i < keys.size(); i += 4) {
+        misses.push_back(keys[i] + "~");
+    }
+
+    SkipList list;
+    auto t0 = Clock::now();
+    for (const auto& key : keys) {
+        list.Insert(key, "v");
+    }
+    auto t1 = Clock::now();
+    size_t found = 0;
+    for (const auto& key : lookups) {
+        found += list.Contains(key).has_value();
+    }
+    auto t2 = Clock::now();
+    for (const auto& key : misses) {
+        found += list.Contains(key).has_value();
+    }
+    auto t3 = Clock::now();
+
+    std::printf("%-14s insert %8.1f ns/op   hit %8.1f ns/op   miss %8.1f ns/op   (found %zu)\n", name,
+                ns_per_op(t0, t1, keys.size()), ns_per_op(t1, t2, lookups.size()),
+                ns_per_op(t2, t3, misses.size()), found);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::mt19937_64 rng(301);
+
+    std::vector<std::string> random8;
+    std::vector<std::string> user_ids;
+    std::vector<std::string> long_paths;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t id = rng();
+        random8.push_back(std::string(reinterpret_cast<const char*>(&id), 8));
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "user%016llx", static_cast<unsigned long long>(id));
+        user_ids.emplace_back(buf);
+        std::snprintf(buf, sizeof(buf), "tenant-0042/orders/by-id/%020llu", static_cast<unsigned long long>(id));
+        long_paths.emplace_back(buf);
+    }
+
+    std::printf("skiplist_lookup_bench: %zu keys per shape\n", n);
+    run("random 8B", random8, rng);
+    run("user+hex 20B", user_ids, rng);
+    run("path 45B", long_paths, rng);
+    return 0;
+}
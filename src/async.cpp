@@ -0,0 +1,43 @@
+#include "include/async.hpp"
+
+namespace {
+
+// Owns a spawned Task<void>: runs it to completion, then frees its own frame
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() {
+            return DetachedTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+DetachedTask RunDetached(Task<void> task) {
+    co_await std::move(task);
+}
+
+}  // namespace
+
+void AsyncExecutor::spawn(Task<void> task) {
+    schedule(RunDetached(std::move(task)).handle);
+}
+
+void AsyncExecutor::schedule(std::coroutine_handle<> handle) {
+    ready_.push_back(handle);
+}
+
+size_t AsyncExecutor::run() {
+    size_t resumed = 0;
+    while (!ready_.empty()) {
+        std::coroutine_handle<> handle = ready_.front();
+        ready_.pop_front();
+        handle.resume();
+        resumed++;
+    }
+    return resumed;
+}
@@ -0,0 +1,25 @@
+#include "include/comparator.hpp"
+
+class BytewiseComparatorImpl : public Comparator {
+public:
+    const char* Name() const override { return "BytewiseComparator"; }
+
+    int Compare(const std::string& a, const std::string& b) const override { return a.compare(b); }
+};
+
+class ReverseBytewiseComparatorImpl : public Comparator {
+public:
+    const char* Name() const override { return "ReverseBytewiseComparator"; }
+
+    int Compare(const std::string& a, const std::string& b) const override { return b.compare(a); }
+};
+
+const Comparator* BytewiseComparator() {
+    static const BytewiseComparatorImpl comparator;
+    return &comparator;
+}
+
+const Comparator* ReverseBytewiseComparator() {
+    static const ReverseBytewiseComparatorImpl comparator;
+    return &comparator;
+}
@@ -0,0 +1,215 @@
+#include "include/crc32c.hpp"
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace {
+
+// Reflected Castagnoli polynomial
+const uint32_t kPoly = 0x82f63b78u;
+
+inline uint64_t LoadWord(const char* p) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// Slicing-by-8: table[k][b] is the CRC of byte b followed by k zero bytes
+struct PortableTables {
+    uint32_t table[8][256];
+
+    PortableTables() {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t crc = n;
+            for (int k = 0; k < 8; k++) {
+                crc = crc & 1 ? (crc >> 1) ^ kPoly : crc >> 1;
+            }
+            table[0][n] = crc;
+        }
+        for (uint32_t n = 0; n < 256; n++) {
+            for (int k = 1; k < 8; k++) {
+                table[k][n] = (table[k - 1][n] >> 8) ^ table[0][table[k - 1][n] & 0xff];
+            }
+        }
+    }
+};
+
+const PortableTables& GetPortableTables() {
+    static const PortableTables tables;
+    return tables;
+}
+
+#if defined(__x86_64__)
+
+// Streams are LONG bytes each for large inputs, SHORT bytes for the rest
+const size_t kLong = 8192;
+const size_t kShort = 256;
+
+// Multiply a GF(2) 32x32 matrix by a vector
+uint32_t MatrixTimes(const uint32_t* mat, uint32_t vec) {
+    uint32_t sum = 0;
+    for (; vec; vec >>= 1, mat++) {
+        if (vec & 1) {
+            sum ^= *mat;
+        }
+    }
+    return sum;
+}
+
+void MatrixSquare(uint32_t* square, const uint32_t* mat) {
+    for (int n = 0; n < 32; n++) {
+        square[n] = MatrixTimes(mat, mat[n]);
+    }
+}
+
+/**
+ * Tables that advance a CRC over len zero bytes in four lookups, used to
+ * combine streams computed side by side (from Mark Adler's crc32c.c)
+ */
+struct ShiftTables {
+    uint32_t zeros[4][256];
+
+    explicit ShiftTables(size_t len) {
+        // Operator for one zero bit, then squared up to len zero bytes
+        uint32_t even[32];
+        uint32_t odd[32];
+        odd[0] = kPoly;
+        for (int n = 1; n < 32; n++) {
+            odd[n] = 1u << (n - 1);
+        }
+        MatrixSquare(even, odd);  // 2 bits
+        MatrixSquare(odd, even);  // 4 bits
+        uint32_t* op = odd;
+        // Each squaring doubles the bits: 8 bits (one byte) on the first pass
+        for (;;) {
+            MatrixSquare(even, odd);
+            len >>= 1;
+            if (len == 0) {
+                op = even;
+                break;
+            }
+            MatrixSquare(odd, even);
+            len >>= 1;
+            if (len == 0) {
+                op = odd;
+                break;
+            }
+        }
+        for (uint32_t n = 0; n < 256; n++) {
+            zeros[0][n] = MatrixTimes(op, n);
+            zeros[1][n] = MatrixTimes(op, n << 8);
+            zeros[2][n] = MatrixTimes(op, n << 16);
+            zeros[3][n] = MatrixTimes(op, n << 24);
+        }
+    }
+
+    uint32_t Shift(uint32_t crc) const {
+        return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^ zeros[2][(crc >> 16) & 0xff] ^
+               zeros[3][crc >> 24];
+    }
+};
+
+const ShiftTables& GetLongShift() {
+    static const ShiftTables tables(kLong);
+    return tables;
+}
+
+const ShiftTables& GetShortShift() {
+    static const ShiftTables tables(kShort);
+    return tables;
+}
+
+// Three independent crc32 chains over consecutive blocks hide the instruction's latency
+__attribute__((target("sse4.2"))) uint64_t ThreeStreams(uint64_t crc0, const char** next, size_t* n,
+                                                       size_t block, const ShiftTables& shift) {
+    while (*n >= block * 3) {
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        const char* p = *next;
+        const char* end = p + block;
+        do {
+            crc0 = _mm_crc32_u64(crc0, LoadWord(p));
+            crc1 = _mm_crc32_u64(crc1, LoadWord(p + block));
+            crc2 = _mm_crc32_u64(crc2, LoadWord(p + 2 * block));
+            p += 8;
+        } while (p < end);
+        crc0 = shift.Shift(static_cast<uint32_t>(crc0)) ^ crc1;
+        crc0 = shift.Shift(static_cast<uint32_t>(crc0)) ^ crc2;
+        *next += block * 3;
+        *n -= block * 3;
+    }
+    return crc0;
+}
+
+__attribute__((target("sse4.2"))) uint32_t ExtendHardware(uint32_t crc, const char* data, size_t n) {
+    uint64_t crc0 = crc ^ 0xffffffffu;
+    while (n > 0 && reinterpret_cast<uintptr_t>(data) & 7) {
+        crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), static_cast<uint8_t>(*data++));
+        n--;
+    }
+    crc0 = ThreeStreams(crc0, &data, &n, kLong, GetLongShift());
+    crc0 = ThreeStreams(crc0, &data, &n, kShort, GetShortShift());
+    for (; n >= 8; data += 8, n -= 8) {
+        crc0 = _mm_crc32_u64(crc0, LoadWord(data));
+    }
+    for (; n > 0; n--) {
+        crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), static_cast<uint8_t>(*data++));
+    }
+    return static_cast<uint32_t>(crc0) ^ 0xffffffffu;
+}
+
+#endif
+
+using ExtendFn = uint32_t (*)(uint32_t, const char*, size_t);
+
+ExtendFn ChooseExtend() {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.2")) {
+        // Build the tables now rather than inside the first checksum
+        GetLongShift();
+        GetShortShift();
+        return ExtendHardware;
+    }
+#endif
+    return Crc32cExtendPortable;
+}
+
+// Chosen on first use, so checksums computed during static initialization work too
+ExtendFn GetExtend() {
+    static const ExtendFn extend = ChooseExtend();
+    return extend;
+}
+
+}  // namespace
+
+uint32_t Crc32cExtendPortable(uint32_t crc, const char* data, size_t n) {
+    const uint32_t (*table)[256] = GetPortableTables().table;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    uint32_t c = crc ^ 0xffffffffu;
+    while (n > 0 && reinterpret_cast<uintptr_t>(p) & 7) {
+        c = table[0][(c ^ *p++) & 0xff] ^ (c >> 8);
+        n--;
+    }
+    for (; n >= 8; p += 8, n -= 8) {
+        // Little-endian word: its low four bytes are folded into the running CRC
+        uint64_t word = LoadWord(reinterpret_cast<const char*>(p)) ^ c;
+        c = table[7][word & 0xff] ^ table[6][(word >> 8) & 0xff] ^ table[5][(word >> 16) & 0xff] ^
+            table[4][(word >> 24) & 0xff] ^ table[3][(word >> 32) & 0xff] ^ table[2][(word >> 40) & 0xff] ^
+            table[1][(word >> 48) & 0xff] ^ table[0][word >> 56];
+    }
+    while (n > 0) {
+        c = table[0][(c ^ *p++) & 0xff] ^ (c >> 8);
+        n--;
+    }
+    return c ^ 0xffffffffu;
+}
+
+uint32_t Crc32cExtend(uint32_t crc, const char* data, size_t n) {
+    return GetExtend()(crc, data, n);
+}
+
+bool Crc32cIsHardwareAccelerated() {
+    return GetExtend() != Crc32cExtendPortable;
+}
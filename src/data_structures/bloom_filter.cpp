@@ -1,3 +1,60 @@
 #include "src/include/data_structures/bloom_filter.hpp"
+#include <algorithm>
+#include <functional>
 
-//TODO: Implement Bloom Filter
\ No newline at end of file
+BloomFilter::BloomFilter(size_t num_bits, int num_probes)
+    : num_probes_(std::min(std::max(num_probes, 1), 16)),
+      blocks_(std::max<size_t>((num_bits + kBlockBits - 1) / kBlockBits, 1)) {}
+
+uint64_t BloomFilter::Hash(const std::string& key) {
+    // std::hash is not guaranteed to mix all bits, so finish with the murmur3 finalizer
+    uint64_t h = std::hash<std::string>{}(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+void BloomFilter::Add(const std::string& key) {
+    AddHash(Hash(key));
+}
+
+// High 32 bits choose the block; the low 32 bits drive double hashing inside it
+void BloomFilter::AddHash(uint64_t hash) {
+    Block& block = blocks_[(hash >> 32) % blocks_.size()];
+    uint32_t h = static_cast<uint32_t>(hash);
+    const uint32_t delta = (h >> 17) | (h << 15);
+    for (int i = 0; i < num_probes_; ++i) {
+        uint32_t bit = h % kBlockBits;
+        block.words[bit / 64].fetch_or(uint64_t{1} << (bit % 64), std::memory_order_relaxed);
+        h += delta;
+    }
+}
+
+bool BloomFilter::MayContain(const std::string& key) const {
+    return MayContainHash(Hash(key));
+}
+
+bool BloomFilter::MayContainHash(uint64_t hash) const {
+    const Block& block = blocks_[(hash >> 32) % blocks_.size()];
+    uint32_t h = static_cast<uint32_t>(hash);
+    const uint32_t delta = (h >> 17) | (h << 15);
+    for (int i = 0; i < num_probes_; ++i) {
+        uint32_t bit = h % kBlockBits;
+        if ((block.words[bit / 64].load(std::memory_order_relaxed) & (uint64_t{1} << (bit % 64))) == 0) {
+            return false;
+        }
+        h += delta;
+    }
+    return true;
+}
+
+size_t BloomFilter::NumBits() const {
+    return blocks_.size() * kBlockBits;
+}
+
+int BloomFilter::NumProbes() const {
+    return num_probes_;
+}
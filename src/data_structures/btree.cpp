@@ -1,3 +1,536 @@
 #include "src/include/data_structures/btree.hpp"
+#include "src/include/data_structures/key_prefix.hpp"
+#include <cstring>
+#include <thread>
 
-//TODO: Implement B-Tree
\ No newline at end of file
+// ---- Optimistic lock coupling primitives ----
+
+uint64_t BTree::NodeBase::ReadLockOrRestart(bool& need_restart) const {
+    uint64_t version = version_lock.load();
+    // Wait for a concurrent writer to finish instead of reading a half-written node
+    while ((version & 0b10) == 0b10) {
+        std::this_thread::yield();
+        version = version_lock.load();
+    }
+    if ((version & 0b1) == 0b1) {
+        need_restart = true;
+    }
+    return version;
+}
+
+void BTree::NodeBase::CheckOrRestart(uint64_t start_read, bool& need_restart) const {
+    need_restart = (start_read != version_lock.load());
+}
+
+void BTree::NodeBase::UpgradeToWriteLockOrRestart(uint64_t& version, bool& need_restart) {
+    if (version_lock.compare_exchange_strong(version, version + 0b10)) {
+        version = version + 0b10;
+    } else {
+        need_restart = true;
+    }
+}
+
+void BTree::NodeBase::WriteUnlock() {
+    // Clears the lock bit and bumps the version in one step
+    version_lock.fetch_add(0b10);
+}
+
+// Prefix comparison first; full key comparison only for slots whose prefix ties
+int BTree::NodeBase::LowerBound(const std::string& key, uint64_t prefix, Entry* const* keys) const {
+    int n = count;
+    if (n > kFanout) n = kFanout; // torn read under a concurrent writer, validation will restart
+
+    // Prefixes are sorted, so the number of smaller prefixes is the first tie slot.
+    // Written without branches so the compiler can vectorize it.
+    int lower = 0;
+    for (int i = 0; i < n; ++i) {
+        lower += prefixes[i] < prefix;
+    }
+
+    while (lower < n && prefixes[lower] == prefix) {
+        const Entry* e = keys[lower];
+        if (e == nullptr || !(e->key < key)) break;
+        ++lower;
+    }
+    return lower;
+}
+
+// ---- Node splits ----
+
+BTree::Inner* BTree::Inner::Split(Entry*& separator) {
+    Inner* right = new Inner();
+    int half = count / 2;
+    right->count = count - half - 1;
+    std::memcpy(right->keys, keys + half + 1, sizeof(Entry*) * right->count);
+    std::memcpy(right->prefixes, prefixes + half + 1, sizeof(uint64_t) * right->count);
+    std::memcpy(right->children, children + half + 1, sizeof(NodeBase*) * (right->count + 1));
+    separator = keys[half];
+    count = half;
+    return right;
+}
+
+void BTree::Inner::InsertChild(Entry* separator, NodeBase* child) {
+    uint64_t prefix = KeyPrefix(separator->key);
+    int pos = LowerBound(separator->key, prefix);
+    std::memmove(keys + pos + 1, keys + pos, sizeof(Entry*) * (count - pos));
+    std::memmove(prefixes + pos + 1, prefixes + pos, sizeof(uint64_t) * (count - pos));
+    std::memmove(children + pos + 2, children + pos + 1, sizeof(NodeBase*) * (count - pos));
+    keys[pos] = separator;
+    prefixes[pos] = prefix;
+    children[pos + 1] = child;
+    count++;
+}
+
+BTree::Leaf* BTree::Leaf::Split(Entry*& separator) {
+    Leaf* right = new Leaf();
+    int half = count / 2;
+    right->count = count - half;
+    std::memcpy(right->entries, entries + half, sizeof(Entry*) * right->count);
+    std::memcpy(right->prefixes, prefixes + half, sizeof(uint64_t) * right->count);
+    right->next = next;
+    next = right;
+    count = half;
+    separator = entries[half - 1];
+    return right;
+}
+
+// ---- Tree ----
+
+BTree::BTree() : root_(new Leaf()), size_(0), retired_(nullptr) {}
+
+BTree::~BTree() {
+    FreeNode_(root_.load());
+    Entry* e = retired_.load();
+    while (e) {
+        Entry* next = e->retired_next;
+        delete e;
+        e = next;
+    }
+}
+
+void BTree::FreeNode_(NodeBase* node) {
+    if (node->type == NodeType::kInner) {
+        Inner* inner = static_cast<Inner*>(node);
+        for (int i = 0; i <= inner->count; ++i) {
+            FreeNode_(inner->children[i]);
+        }
+        delete inner;
+    } else {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        for (int i = 0; i < leaf->count; ++i) {
+            delete leaf->entries[i];
+        }
+        delete leaf;
+    }
+}
+
+bool BTree::isEmpty() const {
+    return size_.load() == 0;
+}
+
+int BTree::Size() const {
+    return size_.load();
+}
+
+uint64_t BTree::KeyPrefix(const std::string& key) {
+    return ::KeyPrefix(key);
+}
+
+void BTree::MakeRoot(Entry* separator, NodeBase* left, NodeBase* right) {
+    Inner* inner = new Inner();
+    inner->count = 1;
+    inner->keys[0] = separator;
+    inner->prefixes[0] = KeyPrefix(separator->key);
+    inner->children[0] = left;
+    inner->children[1] = right;
+    root_.store(inner);
+}
+
+void BTree::Retire_(Entry* entry) {
+    Entry* head = retired_.load();
+    do {
+        entry->retired_next = head;
+    } while (!retired_.compare_exchange_weak(head, entry));
+}
+
+// Insert with eager splitting of full nodes on the way down (Leis et al.)
+std::optional<size_t> BTree::Insert(const std::string& key, const std::string& value) {
+    const uint64_t prefix = KeyPrefix(key);
+    int restart_count = 0;
+
+restart:
+    if (restart_count++ > 0) {
+        std::this_thread::yield();
+    }
+    bool need_restart = false;
+
+    NodeBase* node = root_.load();
+    uint64_t version_node = node->ReadLockOrRestart(need_restart);
+    if (need_restart || node != root_.load()) goto restart;
+
+    {
+        Inner* parent = nullptr;
+        uint64_t version_parent = 0;
+
+        while (node->type == NodeType::kInner) {
+            Inner* inner = static_cast<Inner*>(node);
+
+            if (inner->IsFull()) {
+                // Lock parent and node, split, then retry from the root
+                if (parent) {
+                    parent->UpgradeToWriteLockOrRestart(version_parent, need_restart);
+                    if (need_restart) goto restart;
+                }
+                node->UpgradeToWriteLockOrRestart(version_node, need_restart);
+                if (need_restart) {
+                    if (parent) parent->WriteUnlock();
+                    goto restart;
+                }
+                if (!parent && node != root_.load()) {
+                    // Root was split concurrently; there is a new parent now
+                    node->WriteUnlock();
+                    goto restart;
+                }
+                Entry* separator = nullptr;
+                Inner* right = inner->Split(separator);
+                if (parent) {
+                    parent->InsertChild(separator, right);
+                } else {
+                    MakeRoot(separator, inner, right);
+                }
+                node->WriteUnlock();
+                if (parent) parent->WriteUnlock();
+                goto restart;
+            }
+
+            if (parent) {
+                parent->CheckOrRestart(version_parent, need_restart);
+                if (need_restart) goto restart;
+            }
+
+            parent = inner;
+            version_parent = version_node;
+
+            node = inner->children[inner->LowerBound(key, prefix)];
+            inner->CheckOrRestart(version_node, need_restart);
+            if (need_restart) goto restart;
+            version_node = node->ReadLockOrRestart(need_restart);
+            if (need_restart) goto restart;
+        }
+
+        Leaf* leaf = static_cast<Leaf*>(node);
+
+        if (leaf->IsFull()) {
+            if (parent) {
+                parent->UpgradeToWriteLockOrRestart(version_parent, need_restart);
+                if (need_restart) goto restart;
+            }
+            node->UpgradeToWriteLockOrRestart(version_node, need_restart);
+            if (need_restart) {
+                if (parent) parent->WriteUnlock();
+                goto restart;
+            }
+            if (!parent && node != root_.load()) {
+                node->WriteUnlock();
+                goto restart;
+            }
+            Entry* separator = nullptr;
+            Leaf* right = leaf->Split(separator);
+            if (parent) {
+                parent->InsertChild(separator, right);
+            } else {
+                MakeRoot(separator, leaf, right);
+            }
+            node->WriteUnlock();
+            if (parent) parent->WriteUnlock();
+            goto restart;
+        }
+
+        // Only the leaf needs to be locked
+        node->UpgradeToWriteLockOrRestart(version_node, need_restart);
+        if (need_restart) goto restart;
+        if (parent) {
+            parent->CheckOrRestart(version_parent, need_restart);
+            if (need_restart) {
+                node->WriteUnlock();
+                goto restart;
+            }
+        }
+
+        int pos = leaf->LowerBound(key, prefix);
+        if (pos < leaf->count && leaf->entries[pos]->key == key) {
+            // Publish a fresh entry; readers may still be looking at the old one
+            Entry* old = leaf->entries[pos];
+            leaf->entries[pos] = new Entry(key, value);
+            node->WriteUnlock();
+            size_t old_size = old->value.size();
+            Retire_(old);
+            return old_size;
+        }
+
+        std::memmove(leaf->entries + pos + 1, leaf->entries + pos, sizeof(Entry*) * (leaf->count - pos));
+        std::memmove(leaf->prefixes + pos + 1, leaf->prefixes + pos, sizeof(uint64_t) * (leaf->count - pos));
+        leaf->entries[pos] = new Entry(key, value);
+        leaf->prefixes[pos] = prefix;
+        leaf->count++;
+        size_.fetch_add(1);
+        node->WriteUnlock();
+        return std::nullopt;
+    }
+}
+
+std::optional<std::string> BTree::Contains(const std::string& key) const {
+    const uint64_t prefix = KeyPrefix(key);
+
+restart:
+    bool need_restart = false;
+
+    NodeBase* node = root_.load();
+    uint64_t version_node = node->ReadLockOrRestart(need_restart);
+    if (need_restart || node != root_.load()) goto restart;
+
+    {
+        Inner* parent = nullptr;
+        uint64_t version_parent = 0;
+
+        while (node->type == NodeType::kInner) {
+            Inner* inner = static_cast<Inner*>(node);
+
+            if (parent) {
+                parent->CheckOrRestart(version_parent, need_restart);
+                if (need_restart) goto restart;
+            }
+
+            parent = inner;
+            version_parent = version_node;
+
+            node = inner->children[inner->LowerBound(key, prefix)];
+            inner->CheckOrRestart(version_node, need_restart);
+            if (need_restart) goto restart;
+            version_node = node->ReadLockOrRestart(need_restart);
+            if (need_restart) goto restart;
+        }
+
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = leaf->LowerBound(key, prefix);
+        Entry* found = (pos < leaf->count) ? leaf->entries[pos] : nullptr;
+
+        if (parent) {
+            parent->CheckOrRestart(version_parent, need_restart);
+            if (need_restart) goto restart;
+        }
+        node->CheckOrRestart(version_node, need_restart);
+        if (need_restart) goto restart;
+
+        // Entries are immutable and outlive readers, so this is safe after validation
+        if (found && found->key == key) {
+            return found->value;
+        }
+        return std::nullopt;
+    }
+}
+
+BTree::Leaf* BTree::FindLeaf_(const std::string* key) const {
+    const uint64_t prefix = key ? KeyPrefix(*key) : 0;
+
+restart:
+    bool need_restart = false;
+
+    NodeBase* node = root_.load();
+    uint64_t version_node = node->ReadLockOrRestart(need_restart);
+    if (need_restart || node != root_.load()) goto restart;
+
+    while (node->type == NodeType::kInner) {
+        Inner* inner = static_cast<Inner*>(node);
+        int pos = key ? inner->LowerBound(*key, prefix) : 0;
+        NodeBase* child = inner->children[pos];
+        inner->CheckOrRestart(version_node, need_restart);
+        if (need_restart) goto restart;
+
+        node = child;
+        version_node = node->ReadLockOrRestart(need_restart);
+        if (need_restart) goto restart;
+    }
+    return static_cast<Leaf*>(node);
+}
+
+std::optional<std::string> BTree::FindLastLess_(const std::string* key) const {
+    const uint64_t prefix = key ? KeyPrefix(*key) : 0;
+
+restart:
+    bool need_restart = false;
+
+    NodeBase* node = root_.load();
+    uint64_t version_node = node->ReadLockOrRestart(need_restart);
+    if (need_restart || node != root_.load()) goto restart;
+
+    {
+        // Separators are never removed, so any one read under a valid version is still a key
+        const Entry* candidate = nullptr;
+
+        while (node->type == NodeType::kInner) {
+            Inner* inner = static_cast<Inner*>(node);
+            int pos = key ? inner->LowerBound(*key, prefix) : inner->count;
+            if (pos > kFanout) pos = kFanout; // torn count, validation will restart
+            const Entry* separator = pos > 0 ? inner->keys[pos - 1] : nullptr;
+            NodeBase* child = inner->children[pos];
+            inner->CheckOrRestart(version_node, need_restart);
+            if (need_restart) goto restart;
+
+            if (separator) candidate = separator;
+            node = child;
+            version_node = node->ReadLockOrRestart(need_restart);
+            if (need_restart) goto restart;
+        }
+
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = key ? leaf->LowerBound(*key, prefix) : leaf->count;
+        if (pos > kFanout) pos = kFanout;
+        const Entry* found = pos > 0 ? leaf->entries[pos - 1] : nullptr;
+        node->CheckOrRestart(version_node, need_restart);
+        if (need_restart) goto restart;
+
+        if (found) return found->key;
+        if (candidate) return candidate->key;
+        return std::nullopt;
+    }
+}
+
+// ---- Iterator ----
+
+BTree::BTreeIterator::BTreeIterator(const BTree* tree, const std::string* start_key)
+    : tree_(tree), pos_(0), next_leaf_(nullptr) {
+    LoadLeaf_(tree_->FindLeaf_(start_key), start_key, false);
+    if (!is_valid()) {
+        Advance_(start_key, false);
+    }
+}
+
+void BTree::BTreeIterator::seek(const std::string& target) {
+    LoadLeaf_(tree_->FindLeaf_(&target), &target, false);
+    if (!is_valid()) {
+        Advance_(&target, false);
+    }
+}
+
+void BTree::BTreeIterator::seek_for_prev(const std::string& target) {
+    seek(target);
+    if (is_valid() && batch_[pos_]->key == target) {
+        return;
+    }
+    std::optional<std::string> last_less = tree_->FindLastLess_(&target);
+    if (last_less) {
+        seek(*last_less);
+    } else {
+        batch_.clear();
+        pos_ = 0;
+        next_leaf_ = nullptr;
+    }
+}
+
+void BTree::BTreeIterator::seek_to_first() {
+    LoadLeaf_(tree_->FindLeaf_(nullptr), nullptr, false);
+    if (!is_valid()) {
+        Advance_(nullptr, false);
+    }
+}
+
+void BTree::BTreeIterator::seek_to_last() {
+    std::optional<std::string> last = tree_->FindLastLess_(nullptr);
+    if (last) {
+        seek(*last);
+    } else {
+        batch_.clear();
+        pos_ = 0;
+        next_leaf_ = nullptr;
+    }
+}
+
+void BTree::BTreeIterator::LoadLeaf_(Leaf* leaf, const std::string* bound, bool exclusive) {
+    while (true) {
+        bool need_restart = false;
+        uint64_t version = leaf->ReadLockOrRestart(need_restart);
+
+        batch_.clear();
+        int n = leaf->count;
+        if (n > kFanout) n = kFanout;
+        for (int i = 0; i < n; ++i) {
+            batch_.push_back(leaf->entries[i]);
+        }
+        Leaf* next = leaf->next;
+
+        leaf->CheckOrRestart(version, need_restart);
+        if (need_restart) continue;
+
+        // Splits keep the leaf pointer valid and only move keys to the right,
+        // so skipping everything below the bound is all the repair needed
+        size_t skip = 0;
+        while (bound && skip < batch_.size() &&
+               (exclusive ? !(*bound < batch_[skip]->key) : batch_[skip]->key < *bound)) {
+            ++skip;
+        }
+        pos_ = skip;
+        next_leaf_ = next;
+        return;
+    }
+}
+
+void BTree::BTreeIterator::Advance_(const std::string* bound, bool exclusive) {
+    while (!is_valid() && next_leaf_) {
+        LoadLeaf_(next_leaf_, bound, exclusive);
+    }
+}
+
+std::string BTree::BTreeIterator::key() {
+    return batch_[pos_]->key;
+}
+
+std::string BTree::BTreeIterator::value() {
+    return batch_[pos_]->value;
+}
+
+bool BTree::BTreeIterator::is_valid() {
+    return pos_ < batch_.size();
+}
+
+void BTree::BTreeIterator::next() {
+    if (pos_ + 1 < batch_.size()) {
+        ++pos_;
+        return;
+    }
+    if (!is_valid()) {
+        return;
+    }
+    // Copy the last key: the next leaf is filtered against it
+    std::string last_key = batch_.back()->key;
+    batch_.clear();
+    pos_ = 0;
+    Advance_(&last_key, true);
+}
+
+void BTree::BTreeIterator::prev() {
+    if (!is_valid()) {
+        return;
+    }
+    if (pos_ > 0) {
+        --pos_;
+        return;
+    }
+    std::string first_key = batch_[pos_]->key;
+    std::optional<std::string> last_less = tree_->FindLastLess_(&first_key);
+    if (last_less) {
+        seek(*last_less);
+    } else {
+        batch_.clear();
+        pos_ = 0;
+        next_leaf_ = nullptr;
+    }
+}
+
+BTree::BTreeIterator BTree::begin() const {
+    return BTreeIterator(this, nullptr);
+}
+
+BTree::BTreeIterator BTree::scan(const std::string& start_key) const {
+    return BTreeIterator(this, &start_key);
+}
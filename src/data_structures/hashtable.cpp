@@ -1,3 +1,140 @@
 #include "src/include/data_structures/hashtable.hpp"
+#include <functional>
+#include <mutex>
 
-//TODO: Implement Hash Table
\ No newline at end of file
+// Constructor implementation
+HashTable::HashTable(size_t initial_capacity) {
+    size_t capacity = 16;
+    while (capacity < initial_capacity) {
+        capacity <<= 1;
+    }
+    slots_.resize(capacity);
+    mask_ = capacity - 1;
+    size_ = 0;
+    bytes_ = 0;
+}
+
+// Thread-safe empty check with shared lock (allows concurrent reads)
+bool HashTable::isEmpty() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return size_ == 0;
+}
+
+// Thread-safe size getter with shared lock (allows concurrent reads)
+int HashTable::Size() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return size_;
+}
+
+size_t HashTable::Capacity() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return slots_.size();
+}
+
+size_t HashTable::ApproximateMemoryUsage() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return slots_.size() * sizeof(Slot) + bytes_;
+}
+
+void HashTable::Clear() {
+    std::unique_lock<std::shared_mutex> lk(mu_);
+    for (Slot& slot : slots_) {
+        slot = Slot();
+    }
+    size_ = 0;
+    bytes_ = 0;
+}
+
+void HashTable::Insert(const std::string& key, const std::string& value) {
+    std::unique_lock<std::shared_mutex> lk(mu_);
+
+    uint64_t hash = Hash_(key);
+    size_t idx = FindSlot_(key, hash);
+    if (slots_[idx].occupied) {
+        bytes_ += value.size();
+        bytes_ -= slots_[idx].value.size();
+        slots_[idx].value = value;
+        return;
+    }
+
+    // Keep load factor <= 3/4 so linear probe chains stay short
+    if (static_cast<size_t>(size_ + 1) * 4 > slots_.size() * 3) {
+        Grow_();
+        idx = FindSlot_(key, hash);
+    }
+
+    Slot& slot = slots_[idx];
+    slot.occupied = true;
+    slot.hash = hash;
+    slot.key = key;
+    slot.value = value;
+    ++size_;
+    bytes_ += key.size() + value.size();
+}
+
+// Backward-shift deletion: pull later members of the probe chain into the hole
+void HashTable::Erase(const std::string& key) {
+    std::unique_lock<std::shared_mutex> lk(mu_);
+
+    size_t hole = FindSlot_(key, Hash_(key));
+    if (!slots_[hole].occupied) return;
+    bytes_ -= slots_[hole].key.size() + slots_[hole].value.size();
+
+    size_t i = hole;
+    while (true) {
+        i = (i + 1) & mask_;
+        if (!slots_[i].occupied) break;
+
+        // Entry at i may move into the hole only if its home slot is not in (hole, i]
+        size_t home = slots_[i].hash & mask_;
+        if (((i - home) & mask_) >= ((i - hole) & mask_)) {
+            slots_[hole] = std::move(slots_[i]);
+            hole = i;
+        }
+    }
+    slots_[hole] = Slot();
+    --size_;
+}
+
+std::optional<std::string> HashTable::Contains(const std::string& key) const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    size_t idx = FindSlot_(key, Hash_(key));
+    if (slots_[idx].occupied) return slots_[idx].value;
+    return std::nullopt;
+}
+
+uint64_t HashTable::Hash_(const std::string& key) {
+    // Mix std::hash so the low bits used for slot selection are well distributed
+    uint64_t h = std::hash<std::string>{}(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+size_t HashTable::FindSlot_(const std::string& key, uint64_t hash) const {
+    size_t idx = hash & mask_;
+    while (slots_[idx].occupied) {
+        if (slots_[idx].hash == hash && slots_[idx].key == key) {
+            return idx;
+        }
+        idx = (idx + 1) & mask_;
+    }
+    return idx;
+}
+
+void HashTable::Grow_() {
+    std::vector<Slot> old = std::move(slots_);
+    slots_.clear();
+    slots_.resize(old.size() * 2);
+    mask_ = slots_.size() - 1;
+
+    for (Slot& slot : old) {
+        if (!slot.occupied) continue;
+        size_t idx = slot.hash & mask_;
+        while (slots_[idx].occupied) {
+            idx = (idx + 1) & mask_;
+        }
+        slots_[idx] = std::move(slot);
+    }
+}
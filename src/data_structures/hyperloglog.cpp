@@ -1,3 +1,166 @@
 #include "src/include/data_structures/hyperloglog.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
 
-//TODO: Implement HyperLogLog
\ No newline at end of file
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+HyperLogLog::HyperLogLog(int precision) {
+    precision_ = std::min(std::max(precision, 4), 18);
+    registers_.assign(static_cast<size_t>(1) << precision_, 0);
+}
+
+uint64_t HyperLogLog::Hash(const std::string& key) {
+    // std::hash is not guaranteed to mix all bits, so finish with the murmur3 finalizer
+    uint64_t h = std::hash<std::string>{}(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+void HyperLogLog::Add(const std::string& key) {
+    AddHash(Hash(key));
+}
+
+void HyperLogLog::Locate_(uint64_t hash, size_t* index, uint8_t* rank) const {
+    // Top bits pick the register, the rest give the rank (position of the first 1 bit)
+    *index = hash >> (64 - precision_);
+    uint64_t rest = (hash << precision_) | (static_cast<uint64_t>(1) << (precision_ - 1));
+    *rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+}
+
+void HyperLogLog::AddHash(uint64_t hash) {
+    size_t index;
+    uint8_t rank;
+    Locate_(hash, &index, &rank);
+    if (rank > registers_[index]) {
+        registers_[index] = rank;
+    }
+}
+
+void HyperLogLog::AddHashConcurrent(uint64_t hash) {
+    size_t index;
+    uint8_t rank;
+    Locate_(hash, &index, &rank);
+    // Most adds find the register already high enough and only read it
+    std::atomic_ref<uint8_t> reg(registers_[index]);
+    uint8_t current = reg.load(std::memory_order_relaxed);
+    while (rank > current && !reg.compare_exchange_weak(current, rank, std::memory_order_relaxed)) {
+    }
+}
+
+HyperLogLog HyperLogLog::Snapshot() const {
+    HyperLogLog copy(precision_);
+    for (size_t i = 0; i < registers_.size(); i++) {
+        copy.registers_[i] =
+            std::atomic_ref<uint8_t>(const_cast<uint8_t&>(registers_[i])).load(std::memory_order_relaxed);
+    }
+    return copy;
+}
+
+void HyperLogLog::Merge(const HyperLogLog& other) {
+    if (other.precision_ != precision_) {
+        return;
+    }
+    uint8_t* dst = registers_.data();
+    const uint8_t* src = other.registers_.data();
+    size_t n = registers_.size();
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    // 16 registers per instruction; register count is always a multiple of 16
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_max_epu8(a, b));
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = std::max(dst[i], src[i]);
+    }
+}
+
+double HyperLogLog::Estimate() const {
+    const double m = static_cast<double>(registers_.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t r : registers_) {
+        sum += std::ldexp(1.0, -r);
+        zeros += (r == 0);
+    }
+
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+
+    // Small-range correction: linear counting is more accurate while registers are sparse
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    return estimate;
+}
+
+void HyperLogLog::Clear() {
+    std::fill(registers_.begin(), registers_.end(), 0);
+}
+
+int HyperLogLog::Precision() const {
+    return precision_;
+}
+
+// Precision byte, then either every register or 3-byte little-endian index and value pairs
+static const char kSparseRegisters = 's';
+static const char kDenseRegisters = 'd';
+
+std::string HyperLogLog::Encode() const {
+    size_t nonzero = registers_.size() - std::count(registers_.begin(), registers_.end(), 0);
+    std::string out;
+    out.push_back(static_cast<char>(precision_));
+    if (nonzero * 4 >= registers_.size()) {
+        out.push_back(kDenseRegisters);
+        out.append(registers_.begin(), registers_.end());
+        return out;
+    }
+    out.push_back(kSparseRegisters);
+    for (size_t i = 0; i < registers_.size(); i++) {
+        if (registers_[i] != 0) {
+            out.push_back(static_cast<char>(i & 0xff));
+            out.push_back(static_cast<char>((i >> 8) & 0xff));
+            out.push_back(static_cast<char>(i >> 16));
+            out.push_back(static_cast<char>(registers_[i]));
+        }
+    }
+    return out;
+}
+
+bool HyperLogLog::Decode(const std::string& data) {
+    if (data.size() < 2 || data[0] < 4 || data[0] > 18) {
+        return false;
+    }
+    HyperLogLog decoded(data[0]);
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data.data()) + 2;
+    size_t size = data.size() - 2;
+    if (data[1] == kDenseRegisters) {
+        if (size != decoded.registers_.size()) {
+            return false;
+        }
+        decoded.registers_.assign(p, p + size);
+    } else if (data[1] == kSparseRegisters && size % 4 == 0) {
+        for (size_t i = 0; i < size; i += 4) {
+            size_t index = p[i] | (static_cast<size_t>(p[i + 1]) << 8) | (static_cast<size_t>(p[i + 2]) << 16);
+            if (index >= decoded.registers_.size()) {
+                return false;
+            }
+            decoded.registers_[index] = p[i + 3];
+        }
+    } else {
+        return false;
+    }
+    *this = std::move(decoded);
+    return true;
+}
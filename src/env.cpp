@@ -0,0 +1,764 @@
+#include "include/env.hpp"
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+bool RandomAccessFile::MultiRead(ReadRequest* requests, size_t num_requests) const {
+    bool ok = true;
+    for (size_t i = 0; i < num_requests; i++) {
+        ReadRequest& request = requests[i];
+        request.ok = Read(request.offset, request.len, request.scratch, &request.result);
+        ok = ok && request.ok;
+    }
+    return ok;
+}
+
+bool WritableFile::AppendAndSync(std::string_view data) {
+    return Append(data) && Sync();
+}
+
+namespace {
+
+// pread until n bytes or end of file
+bool PreadFully(int fd, uint64_t offset, size_t n, char* scratch, size_t* done) {
+    while (*done < n) {
+        ssize_t r = pread(fd, scratch + *done, n - *done, static_cast<off_t>(offset + *done));
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (r == 0) {
+            break;
+        }
+        *done += static_cast<size_t>(r);
+    }
+    return true;
+}
+
+bool PwriteFully(int fd, uint64_t offset, const char* data, size_t n) {
+    size_t done = 0;
+    while (done < n) {
+        ssize_t r = pwrite(fd, data + done, n - done, static_cast<off_t>(offset + done));
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        done += static_cast<size_t>(r);
+    }
+    return true;
+}
+
+class PosixRandomAccessFile : public RandomAccessFile {
+public:
+    explicit PosixRandomAccessFile(int fd) : fd_(fd) {}
+    ~PosixRandomAccessFile() override { close(fd_); }
+
+    bool Read(uint64_t offset, size_t n, char* scratch, std::string_view* result) const override {
+        size_t done = 0;
+        bool ok = PreadFully(fd_, offset, n, scratch, &done);
+        *result = std::string_view(scratch, done);
+        return ok;
+    }
+
+protected:
+    int fd_;
+};
+
+class PosixWritableFile : public WritableFile {
+public:
+    PosixWritableFile(int fd, uint64_t size) : fd_(fd), size_(size) {}
+    ~PosixWritableFile() override { Close(); }
+
+    bool Append(std::string_view data) override {
+        if (fd_ < 0 || !PwriteFully(fd_, size_, data.data(), data.size())) {
+            return false;
+        }
+        size_ += data.size();
+        return true;
+    }
+
+    bool Sync() override { return fd_ >= 0 && fdatasync(fd_) == 0; }
+
+    bool Close() override {
+        if (fd_ < 0) {
+            return true;
+        }
+        bool ok = close(fd_) == 0;
+        fd_ = -1;
+        return ok;
+    }
+
+    uint64_t Size() const override { return size_; }
+
+protected:
+    int fd_;
+    uint64_t size_;
+};
+
+size_t RoundUpToAlignment(size_t n) {
+    return (n + kDirectIoAlignment - 1) / kDirectIoAlignment * kDirectIoAlignment;
+}
+
+struct FreeDeleter {
+    void operator()(char* p) const { std::free(p); }
+};
+
+// Heap buffer aligned (and sized) for O_DIRECT
+using AlignedBuffer = std::unique_ptr<char, FreeDeleter>;
+
+AlignedBuffer NewAlignedBuffer(size_t size) {
+    return AlignedBuffer(static_cast<char*>(std::aligned_alloc(kDirectIoAlignment, RoundUpToAlignment(size))));
+}
+
+// Aligned pread until n bytes or end of file (the first short read)
+bool DirectPread(int fd, uint64_t offset, size_t n, char* buffer, size_t* done) {
+    *done = 0;
+    while (*done < n) {
+        ssize_t r = pread(fd, buffer + *done, n - *done, static_cast<off_t>(offset + *done));
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        *done += static_cast<size_t>(r);
+        if (static_cast<size_t>(r) % kDirectIoAlignment != 0 || r == 0) {
+            break;
+        }
+    }
+    return true;
+}
+
+// O_DIRECT reads: each read covers the aligned blocks around the range and copies it out
+class DirectRandomAccessFile : public RandomAccessFile {
+public:
+    explicit DirectRandomAccessFile(int fd) : fd_(fd) {}
+    ~DirectRandomAccessFile() override { close(fd_); }
+
+    bool Read(uint64_t offset, size_t n, char* scratch, std::string_view* result) const override {
+        uint64_t start = offset / kDirectIoAlignment * kDirectIoAlignment;
+        size_t skip = static_cast<size_t>(offset - start);
+        size_t len = RoundUpToAlignment(skip + n);
+        AlignedBuffer buffer = NewAlignedBuffer(len);
+        size_t done = 0;
+        if (!buffer || !DirectPread(fd_, start, len, buffer.get(), &done)) {
+            *result = std::string_view();
+            return false;
+        }
+        size_t available = done > skip ? std::min(n, done - skip) : 0;
+        std::memcpy(scratch, buffer.get() + skip, available);
+        *result = std::string_view(scratch, available);
+        return true;
+    }
+
+private:
+    int fd_;
+};
+
+/**
+ * O_DIRECT appends, staged in an aligned buffer that is written out whole
+ * blocks at a time. Sync and Close write the partial last block padded with
+ * zeros and truncate the file back to its real size; the block stays
+ * buffered and is rewritten by later appends.
+ */
+class DirectWritableFile : public WritableFile {
+public:
+    static constexpr size_t kBufferSize = 1 << 20;
+
+    DirectWritableFile(int fd, uint64_t size) : fd_(fd), size_(size), buffer_(NewAlignedBuffer(kBufferSize)) {
+        file_offset_ = size / kDirectIoAlignment * kDirectIoAlignment;
+        buffered_ = static_cast<size_t>(size - file_offset_);
+    }
+    ~DirectWritableFile() override { Close(); }
+
+    // Read back a partial last block so appends can continue it
+    bool LoadTail() {
+        size_t done = 0;
+        return buffer_ && (buffered_ == 0 || (DirectPread(fd_, file_offset_, kDirectIoAlignment, buffer_.get(), &done) &&
+                                              done >= buffered_));
+    }
+
+    bool Append(std::string_view data) override {
+        if (fd_ < 0) {
+            return false;
+        }
+        while (!data.empty()) {
+            size_t n = std::min(kBufferSize - buffered_, data.size());
+            std::memcpy(buffer_.get() + buffered_, data.data(), n);
+            buffered_ += n;
+            size_ += n;
+            data.remove_prefix(n);
+            if (buffered_ == kBufferSize) {
+                if (!PwriteFully(fd_, file_offset_, buffer_.get(), kBufferSize)) {
+                    return false;
+                }
+                file_offset_ += kBufferSize;
+                buffered_ = 0;
+            }
+        }
+        return true;
+    }
+
+    bool Sync() override { return fd_ >= 0 && FlushTail_() && fdatasync(fd_) == 0; }
+
+    bool Close() override {
+        if (fd_ < 0) {
+            return true;
+        }
+        bool ok = FlushTail_();
+        ok = close(fd_) == 0 && ok;
+        fd_ = -1;
+        return ok;
+    }
+
+    uint64_t Size() const override { return size_; }
+
+private:
+    bool FlushTail_() {
+        if (buffered_ == 0) {
+            return true;
+        }
+        size_t len = RoundUpToAlignment(buffered_);
+        std::memset(buffer_.get() + buffered_, 0, len - buffered_);
+        return PwriteFully(fd_, file_offset_, buffer_.get(), len) && ftruncate(fd_, static_cast<off_t>(size_)) == 0;
+    }
+
+    int fd_;
+    uint64_t size_;
+    AlignedBuffer buffer_;
+    // File offset of buffer_[0], always aligned
+    uint64_t file_offset_;
+    size_t buffered_;
+};
+
+// Takes every transfer's bytes from a RateLimiter first, one burst at a time
+class RateLimitedRandomAccessFile : public RandomAccessFile {
+public:
+    RateLimitedRandomAccessFile(std::unique_ptr<RandomAccessFile> target, const FileOptions& options)
+        : target_(std::move(target)), rate_limiter_(options.rate_limiter), priority_(options.io_priority) {}
+
+    bool Read(uint64_t offset, size_t n, char* scratch, std::string_view* result) const override {
+        size_t burst = rate_limiter_->GetSingleBurstBytes();
+        size_t done = 0;
+        do {
+            size_t len = std::min(burst, n - done);
+            rate_limiter_->Request(len, priority_);
+            std::string_view part;
+            if (!target_->Read(offset + done, len, scratch + done, &part)) {
+                *result = std::string_view(scratch, done);
+                return false;
+            }
+            done += part.size();
+            if (part.size() < len) {
+                break;
+            }
+        } while (done < n);
+        *result = std::string_view(scratch, done);
+        return true;
+    }
+
+    bool MultiRead(ReadRequest* requests, size_t num_requests) const override {
+        size_t bytes = 0;
+        for (size_t i = 0; i < num_requests; i++) {
+            bytes += requests[i].len;
+        }
+        rate_limiter_->Request(bytes, priority_);
+        return target_->MultiRead(requests, num_requests);
+    }
+
+private:
+    std::unique_ptr<RandomAccessFile> target_;
+    std::shared_ptr<RateLimiter> rate_limiter_;
+    IOPriority priority_;
+};
+
+class RateLimitedWritableFile : public WritableFile {
+public:
+    RateLimitedWritableFile(std::unique_ptr<WritableFile> target, const FileOptions& options)
+        : target_(std::move(target)), rate_limiter_(options.rate_limiter), priority_(options.io_priority) {}
+
+    bool Append(std::string_view data) override { return Write_(data, false); }
+    bool Sync() override { return target_->Sync(); }
+    bool AppendAndSync(std::string_view data) override { return Write_(data, true); }
+    bool Close() override { return target_->Close(); }
+    uint64_t Size() const override { return target_->Size(); }
+
+private:
+    bool Write_(std::string_view data, bool sync) {
+        size_t burst = rate_limiter_->GetSingleBurstBytes();
+        do {
+            std::string_view part = data.substr(0, burst);
+            data.remove_prefix(part.size());
+            rate_limiter_->Request(part.size(), priority_);
+            bool ok = sync && data.empty() ? target_->AppendAndSync(part) : target_->Append(part);
+            if (!ok) {
+                return false;
+            }
+        } while (!data.empty());
+        return true;
+    }
+
+    std::unique_ptr<WritableFile> target_;
+    std::shared_ptr<RateLimiter> rate_limiter_;
+    IOPriority priority_;
+};
+
+class PosixEnv : public Env {
+public:
+    std::unique_ptr<RandomAccessFile> NewRandomAccessFile(const std::string& path,
+                                                          const FileOptions& options) override {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | (options.use_direct_io ? O_DIRECT : 0));
+        if (fd < 0) {
+            return nullptr;
+        }
+        std::unique_ptr<RandomAccessFile> file;
+        if (options.use_direct_io) {
+            file = std::make_unique<DirectRandomAccessFile>(fd);
+        } else {
+            file = NewReadFile_(fd);
+        }
+        if (options.rate_limiter) {
+            file = std::make_unique<RateLimitedRandomAccessFile>(std::move(file), options);
+        }
+        return file;
+    }
+
+    std::unique_ptr<WritableFile> NewWritableFile(const std::string& path, const FileOptions& options) override {
+        return OpenWritable_(path, O_TRUNC, options);
+    }
+
+    std::unique_ptr<WritableFile> NewAppendableFile(const std::string& path, const FileOptions& options) override {
+        return OpenWritable_(path, 0, options);
+    }
+
+    bool FileExists(const std::string& path) override { return access(path.c_str(), F_OK) == 0; }
+
+    bool GetFileSize(const std::string& path, uint64_t* size) override {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
+            return false;
+        }
+        *size = static_cast<uint64_t>(st.st_size);
+        return true;
+    }
+
+    bool GetChildren(const std::string& dir, std::vector<std::string>* names) override {
+        names->clear();
+        DIR* d = opendir(dir.c_str());
+        if (!d) {
+            return false;
+        }
+        while (struct dirent* entry = readdir(d)) {
+            if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0) {
+                names->push_back(entry->d_name);
+            }
+        }
+        closedir(d);
+        return true;
+    }
+
+    bool DeleteFile(const std::string& path) override { return unlink(path.c_str()) == 0; }
+
+    bool RenameFile(const std::string& from, const std::string& to) override {
+        return std::rename(from.c_str(), to.c_str()) == 0;
+    }
+
+    bool CreateDirIfMissing(const std::string& dir) override {
+        return mkdir(dir.c_str(), 0755) == 0 || errno == EEXIST;
+    }
+
+    bool SyncDir(const std::string& dir) override {
+        int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = fsync(fd) == 0;
+        close(fd);
+        return ok;
+    }
+
+protected:
+    // Buffered files over an open descriptor; backends override these
+    virtual std::unique_ptr<RandomAccessFile> NewReadFile_(int fd) {
+        return std::make_unique<PosixRandomAccessFile>(fd);
+    }
+    virtual std::unique_ptr<WritableFile> NewWriteFile_(int fd, uint64_t size) {
+        return std::make_unique<PosixWritableFile>(fd, size);
+    }
+
+private:
+    std::unique_ptr<WritableFile> OpenWritable_(const std::string& path, int extra_flags, const FileOptions& options) {
+        // Direct appends may read back the partial last block
+        int flags = options.use_direct_io ? O_RDWR | O_DIRECT : O_WRONLY;
+        int fd = open(path.c_str(), flags | O_CREAT | O_CLOEXEC | extra_flags, 0644);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return nullptr;
+        }
+        uint64_t size = static_cast<uint64_t>(st.st_size);
+
+        std::unique_ptr<WritableFile> file;
+        if (options.use_direct_io) {
+            auto direct = std::make_unique<DirectWritableFile>(fd, size);
+            if (!direct->LoadTail()) {
+                return nullptr;
+            }
+            file = std::move(direct);
+        } else {
+            file = NewWriteFile_(fd, size);
+        }
+        if (options.rate_limiter) {
+            file = std::make_unique<RateLimitedWritableFile>(std::move(file), options);
+        }
+        return file;
+    }
+};
+
+/**
+ * Minimal io_uring driven through the raw system calls (no liburing).
+ * Callers hold mu, queue at most Capacity() entries, then Submit() waits
+ * for all of them; completions are matched to entries by user_data, which
+ * carries the submission's generation next to the caller's slot.
+ */
+class IoUring {
+public:
+    std::mutex mu;
+
+    ~IoUring() {
+        if (sqes_) {
+            munmap(sqes_, sqes_size_);
+        }
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_) {
+            munmap(cq_ptr_, cq_size_);
+        }
+        if (sq_ptr_) {
+            munmap(sq_ptr_, sq_size_);
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool Init(unsigned entries, size_t buffer_size) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            return false;
+        }
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+        }
+        sq_ptr_ = Map_(sq_size_, IORING_OFF_SQ_RING);
+        if (!sq_ptr_) {
+            return false;
+        }
+        cq_ptr_ = single_mmap ? sq_ptr_ : Map_(cq_size_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(Map_(sqes_size_, IORING_OFF_SQES));
+        if (!cq_ptr_ || !sqes_) {
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        // The completion queue is at least as large, so a full batch always fits
+        capacity_ = params.sq_entries;
+
+        if (buffer_size > 0) {
+            buffer_.resize(buffer_size);
+            iovec iov{buffer_.data(), buffer_.size()};
+            if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, &iov, 1) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t Capacity() const { return capacity_; }
+
+    // Registered buffer (index 0), empty when none was asked for
+    char* Buffer() { return buffer_.data(); }
+    size_t BufferSize() const { return buffer_.size(); }
+
+    // Zeroed entry to fill in, reporting into results[slot] of Submit(); valid until Submit()
+    io_uring_sqe* Queue(uint32_t slot) {
+        unsigned tail = *sq_tail_ + queued_;
+        unsigned index = tail & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->user_data = (static_cast<uint64_t>(generation_) << 32) | slot;
+        sq_array_[index] = index;
+        queued_++;
+        return sqe;
+    }
+
+    /**
+     * Submit the queued entries and wait for all of them to complete. On
+     * failure the entries the kernel did not take are withdrawn and the ones
+     * it did are still waited for, since they may be using the callers' buffers.
+     * @param results results[slot] receives each entry's cqe res (slots past num_results are dropped)
+     * @return false if the kernel rejected the submission
+     */
+    bool Submit(int* results, size_t num_results) {
+        unsigned pending = queued_;
+        __atomic_store_n(sq_tail_, *sq_tail_ + queued_, __ATOMIC_RELEASE);
+        queued_ = 0;
+
+        bool ok = true;
+        unsigned to_submit = pending;
+        while (pending > 0) {
+            int r = static_cast<int>(
+                syscall(__NR_io_uring_enter, fd_, to_submit, pending, IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (r < 0 && errno == EINTR) {
+                continue;
+            }
+            if (r < 0 && ok) {
+                // Without SQPOLL the kernel only reads the tail in io_uring_enter, so
+                // entries it has not taken can be unpublished under mu
+                unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+                pending -= *sq_tail_ - head;
+                __atomic_store_n(sq_tail_, head, __ATOMIC_RELEASE);
+                to_submit = 0;
+                ok = false;
+                continue;
+            }
+            if (r < 0) {
+                std::fprintf(stderr, "io_uring: cannot wait for %u submitted operations (errno %d)\n", pending, errno);
+                std::abort();
+            }
+            to_submit -= std::min<unsigned>(to_submit, static_cast<unsigned>(r));
+            pending -= Reap_(results, num_results);
+        }
+        generation_++;
+        return ok;
+    }
+
+private:
+    // Take every available completion; returns how many were this generation's
+    unsigned Reap_(int* results, size_t num_results) {
+        unsigned reaped = 0;
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            if (static_cast<uint32_t>(cqe.user_data >> 32) != generation_) {
+                continue;
+            }
+            uint32_t slot = static_cast<uint32_t>(cqe.user_data);
+            if (slot < num_results) {
+                results[slot] = cqe.res;
+            }
+            reaped++;
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return reaped;
+    }
+
+    void* Map_(size_t size, off_t offset) {
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    int fd_ = -1;
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    size_t capacity_ = 0;
+    unsigned queued_ = 0;
+    // Tags this submission's entries, so a completion left over from another is never taken for one of its own
+    uint32_t generation_ = 0;
+    std::vector<char> buffer_;
+};
+
+class IoUringRandomAccessFile : public PosixRandomAccessFile {
+public:
+    IoUringRandomAccessFile(int fd, std::shared_ptr<IoUring> ring)
+        : PosixRandomAccessFile(fd), ring_(std::move(ring)) {}
+
+    // A single Read stays a plain pread: one system call either way
+    bool MultiRead(ReadRequest* requests, size_t num_requests) const override {
+        std::lock_guard<std::mutex> lock(ring_->mu);
+        std::vector<int> results(ring_->Capacity());
+        bool ok = true;
+        for (size_t first = 0; first < num_requests; first += ring_->Capacity()) {
+            size_t count = std::min(num_requests - first, ring_->Capacity());
+            for (size_t i = 0; i < count; i++) {
+                const ReadRequest& request = requests[first + i];
+                io_uring_sqe* sqe = ring_->Queue(static_cast<uint32_t>(i));
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = fd_;
+                sqe->off = request.offset;
+                sqe->addr = reinterpret_cast<uint64_t>(request.scratch);
+                sqe->len = static_cast<uint32_t>(request.len);
+            }
+            if (!ring_->Submit(results.data(), results.size())) {
+                return false;
+            }
+            for (size_t i = 0; i < count; i++) {
+                ReadRequest& request = requests[first + i];
+                size_t done = results[i] < 0 ? 0 : static_cast<size_t>(results[i]);
+                // A short read is only final at end of file
+                request.ok = results[i] >= 0 &&
+                             (done == request.len || PreadFully(fd_, request.offset, request.len, request.scratch, &done));
+                request.result = std::string_view(request.scratch, done);
+                ok = ok && request.ok;
+            }
+        }
+        return ok;
+    }
+
+private:
+    std::shared_ptr<IoUring> ring_;
+};
+
+class IoUringWritableFile : public PosixWritableFile {
+public:
+    IoUringWritableFile(int fd, uint64_t size, std::shared_ptr<IoUring> ring)
+        : PosixWritableFile(fd, size), ring_(std::move(ring)) {}
+
+    bool Append(std::string_view data) override { return Write_(data, false); }
+
+    bool Sync() override { return Write_(std::string_view(), true); }
+
+    bool AppendAndSync(std::string_view data) override { return Write_(data, true); }
+
+private:
+    /**
+     * Write data at the end of the file, through the registered buffer when
+     * there is one. With sync, an fdatasync is linked behind the last write
+     * and submitted with it.
+     */
+    bool Write_(std::string_view data, bool sync) {
+        if (fd_ < 0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(ring_->mu);
+        size_t chunk_size = ring_->BufferSize() > 0 ? ring_->BufferSize() : std::max<size_t>(data.size(), 1);
+        size_t done = 0;
+        do {
+            size_t n = std::min(chunk_size, data.size() - done);
+            bool last = done + n == data.size();
+            int results[2] = {0, 0};
+            if (n > 0) {
+                io_uring_sqe* sqe = ring_->Queue(0);
+                sqe->fd = fd_;
+                sqe->off = size_;
+                sqe->len = static_cast<uint32_t>(n);
+                if (ring_->BufferSize() > 0) {
+                    std::memcpy(ring_->Buffer(), data.data() + done, n);
+                    sqe->opcode = IORING_OP_WRITE_FIXED;
+                    sqe->addr = reinterpret_cast<uint64_t>(ring_->Buffer());
+                    sqe->buf_index = 0;
+                } else {
+                    sqe->opcode = IORING_OP_WRITE;
+                    sqe->addr = reinterpret_cast<uint64_t>(data.data() + done);
+                }
+                if (last && sync) {
+                    sqe->flags |= IOSQE_IO_LINK;
+                }
+            }
+            if (last && sync) {
+                io_uring_sqe* sqe = ring_->Queue(1);
+                sqe->opcode = IORING_OP_FSYNC;
+                sqe->fd = fd_;
+                sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+            }
+            if (!ring_->Submit(results, 2) || results[0] < 0) {
+                return false;
+            }
+            size_t written = static_cast<size_t>(results[0]);
+            if (written < n) {
+                // Short write: finish it directly; the linked sync was cancelled
+                if (!PwriteFully(fd_, size_ + written, data.data() + done + written, n - written)) {
+                    return false;
+                }
+                if (last && sync && fdatasync(fd_) != 0) {
+                    return false;
+                }
+            } else if (last && sync && results[1] < 0) {
+                return false;
+            }
+            size_ += n;
+            done += n;
+        } while (done < data.size());
+        return true;
+    }
+
+    std::shared_ptr<IoUring> ring_;
+};
+
+class IoUringEnv : public PosixEnv {
+public:
+    explicit IoUringEnv(std::shared_ptr<IoUring> ring) : ring_(std::move(ring)) {}
+
+protected:
+    std::unique_ptr<RandomAccessFile> NewReadFile_(int fd) override {
+        return std::make_unique<IoUringRandomAccessFile>(fd, ring_);
+    }
+    std::unique_ptr<WritableFile> NewWriteFile_(int fd, uint64_t size) override {
+        return std::make_unique<IoUringWritableFile>(fd, size, ring_);
+    }
+
+private:
+    // Shared with the files, which may outlive the Env
+    std::shared_ptr<IoUring> ring_;
+};
+
+}  // namespace
+
+Env* Env::Default() {
+    static PosixEnv env;
+    return &env;
+}
+
+std::unique_ptr<Env> NewIoUringEnv(const IoUringEnvOptions& options) {
+    auto ring = std::make_shared<IoUring>();
+    if (!ring->Init(std::max(options.queue_depth, 2u), options.registered_buffer_size)) {
+        return nullptr;
+    }
+    return std::make_unique<IoUringEnv>(std::move(ring));
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <utility>
+
+class AsyncExecutor;
+
+/**
+ * Lazily started coroutine producing a T. A Task only runs once it is
+ * awaited (or handed to AsyncExecutor::spawn), and resumes its awaiter
+ * directly when it finishes. Exceptions are not propagated: an escaping
+ * exception terminates, as everywhere else in the engine.
+ */
+template <typename T>
+class Task;
+
+namespace async_detail {
+
+template <typename Promise>
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    // Symmetric transfer back to whoever awaited the task
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        return handle.promise().continuation;
+    }
+    void await_resume() const noexcept {}
+};
+
+template <typename Derived>
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter<Derived> final_suspend() const noexcept { return {}; }
+    void unhandled_exception() const noexcept { std::terminate(); }
+};
+
+}  // namespace async_detail
+
+template <typename T>
+class Task {
+public:
+    struct promise_type : async_detail::PromiseBase<promise_type> {
+        std::optional<T> result;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_value(T value) { result.emplace(std::move(value)); }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task(const Task&) = delete;
+    void operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        handle_.promise().continuation = awaiter;
+        return handle_;
+    }
+    T await_resume() { return std::move(*handle_.promise().result); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <>
+class Task<void> {
+public:
+    struct promise_type : async_detail::PromiseBase<promise_type> {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_void() const noexcept {}
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task(const Task&) = delete;
+    void operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        handle_.promise().continuation = awaiter;
+        return handle_;
+    }
+    void await_resume() const noexcept {}
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * Single-threaded run queue that drives the engine's coroutines. Where the
+ * synchronous API would block (waiting for the state lock) or stall on a
+ * cache miss (walking a skip list), the async API yields back here so other
+ * ready coroutines run in the meantime.
+ *
+ * Not thread-safe: spawn, schedule and run are called from the thread that
+ * owns the executor. Spawned tasks must be run to completion before the
+ * executor (or anything they read from) is destroyed.
+ */
+class AsyncExecutor {
+public:
+    AsyncExecutor() {}
+    AsyncExecutor(const AsyncExecutor&) = delete;
+    void operator=(const AsyncExecutor&) = delete;
+
+    // Start task on the next run(); its frame is freed when it finishes
+    void spawn(Task<void> task);
+
+    // Queue a suspended coroutine to be resumed by run()
+    void schedule(std::coroutine_handle<> handle);
+
+    /**
+     * Resume ready coroutines in FIFO order until none are left
+     * @return number of resumptions
+     */
+    size_t run();
+
+    struct YieldAwaiter {
+        AsyncExecutor* executor;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { executor->schedule(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await executor.yield() requeues the caller behind the coroutines already ready
+    YieldAwaiter yield() { return YieldAwaiter{this}; }
+
+    // Coroutines waiting to be resumed
+    size_t num_ready() const { return ready_.size(); }
+
+private:
+    std::deque<std::coroutine_handle<>> ready_;
+};
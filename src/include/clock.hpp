@@ -0,0 +1,31 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Time source for entry expiry, replaceable in tests
+class TtlClock {
+public:
+    virtual ~TtlClock() {}
+
+    // Microseconds since the Unix epoch
+    virtual uint64_t NowMicros() const = 0;
+};
+
+// An entry with expiry time expire_at_micros (0 = never) is gone at now_micros
+inline bool IsExpired(uint64_t expire_at_micros, uint64_t now_micros) {
+    return expire_at_micros != 0 && expire_at_micros <= now_micros;
+}
+
+// Expiry time ttl_micros after now_micros; saturates rather than wrapping past the epoch
+inline uint64_t ExpireAtMicros(uint64_t now_micros, uint64_t ttl_micros) {
+    return ttl_micros > UINT64_MAX - now_micros ? UINT64_MAX : now_micros + ttl_micros;
+}
+
+class SystemClock : public TtlClock {
+public:
+    uint64_t NowMicros() const override {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/**
+ * Fixed-width little-endian integers and length-prefixed strings, the
+ * building blocks of the records the engine persists. The Get functions
+ * consume from the front of *input and return false if it is too short.
+ */
+
+inline void PutFixed32(std::string* dst, uint32_t value) {
+    char buf[sizeof(value)];
+    std::memcpy(buf, &value, sizeof(value));
+    dst->append(buf, sizeof(buf));
+}
+
+inline void PutFixed64(std::string* dst, uint64_t value) {
+    char buf[sizeof(value)];
+    std::memcpy(buf, &value, sizeof(value));
+    dst->append(buf, sizeof(buf));
+}
+
+inline void PutLengthPrefixed(std::string* dst, std::string_view value) {
+    PutFixed32(dst, static_cast<uint32_t>(value.size()));
+    dst->append(value.data(), value.size());
+}
+
+inline uint32_t DecodeFixed32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline bool GetFixed32(std::string_view* input, uint32_t* value) {
+    if (input->size() < sizeof(*value)) {
+        return false;
+    }
+    *value = DecodeFixed32(input->data());
+    input->remove_prefix(sizeof(*value));
+    return true;
+}
+
+inline bool GetFixed64(std::string_view* input, uint64_t* value) {
+    if (input->size() < sizeof(*value)) {
+        return false;
+    }
+    std::memcpy(value, input->data(), sizeof(*value));
+    input->remove_prefix(sizeof(*value));
+    return true;
+}
+
+inline bool GetLengthPrefixed(std::string_view* input, std::string_view* value) {
+    uint32_t size;
+    if (!GetFixed32(input, &size) || input->size() < size) {
+        return false;
+    }
+    *value = input->substr(0, size);
+    input->remove_prefix(size);
+    return true;
+}
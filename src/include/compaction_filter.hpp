@@ -0,0 +1,34 @@
+// Based on RocksDB's CompactionFilter
+#pragma once
+#include <string>
+
+/**
+ * Called for every live value whenever memtable entries are rewritten: when a
+ * frozen memtable is flattened and when immutable memtables are compacted.
+ * It may keep, drop or replace the value. Point tombstones and merge operands
+ * are not passed in, and neither are expired entries, which are dropped first.
+ *
+ * A dropped value turns into a tombstone while older memtables may still hold
+ * the key, so older versions never resurface; compaction drops it outright.
+ * Filters may run concurrently with reads and writes and must be thread-safe.
+ */
+class CompactionFilter {
+public:
+    enum class Decision {
+        kKeep,
+        kRemove,
+        // Replace the value with *new_value
+        kChangeValue,
+    };
+
+    virtual ~CompactionFilter() {}
+
+    virtual const char* Name() const = 0;
+
+    /**
+     * @param key The entry's key
+     * @param value Its current value
+     * @param new_value Set to the replacement when returning kChangeValue
+     */
+    virtual Decision Filter(const std::string& key, const std::string& value, std::string* new_value) const = 0;
+};
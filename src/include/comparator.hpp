@@ -0,0 +1,35 @@
+// Based on RocksDB's Comparator
+#pragma once
+#include <string>
+
+/**
+ * Total order over keys, chosen per column family at open time.
+ *
+ * Compare must return 0 only for byte-identical keys: equal keys are still
+ * matched by their bytes (hash index, merge iterator ties). Prefix scans seek
+ * straight to the run of keys sharing a prefix under the bytewise order and
+ * its reverse; under any other order they visit every key.
+ */
+class Comparator {
+public:
+    virtual ~Comparator() {}
+
+    virtual const char* Name() const = 0;
+
+    // Negative if a sorts before b, zero if they are the same key, positive otherwise
+    virtual int Compare(const std::string& a, const std::string& b) const = 0;
+
+    bool Less(const std::string& a, const std::string& b) const { return Compare(a, b) < 0; }
+};
+
+// Lexicographic order of the unsigned bytes (std::string's operator<)
+const Comparator* BytewiseComparator();
+// The bytewise order reversed
+const Comparator* ReverseBytewiseComparator();
+
+// Adapts a Comparator to the std::less-style functor the ordered containers take
+struct ComparatorLess {
+    const Comparator* comparator = BytewiseComparator();
+
+    bool operator()(const std::string& a, const std::string& b) const { return comparator->Less(a, b); }
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * CRC32C (Castagnoli polynomial), the checksum on every record and block the
+ * engine persists and, optionally, on memtable entries. On x86-64 CPUs with
+ * SSE4.2 it is computed with the crc32 instruction, three streams at a time;
+ * elsewhere with a portable slicing-by-8 table. The choice is made once, at
+ * startup.
+ */
+
+// CRC32C of data appended to something whose CRC32C is crc
+uint32_t Crc32cExtend(uint32_t crc, const char* data, size_t n);
+
+inline uint32_t Crc32cValue(const char* data, size_t n) {
+    return Crc32cExtend(0, data, n);
+}
+
+// The table-driven implementation, whatever the CPU supports (for tests and benchmarks)
+uint32_t Crc32cExtendPortable(uint32_t crc, const char* data, size_t n);
+
+// Whether Crc32cExtend uses the crc32 instruction
+bool Crc32cIsHardwareAccelerated();
+
+static const uint32_t kCrc32cMaskDelta = 0xa282ead8u;
+
+/**
+ * Form of a CRC to store next to the data it covers. Computing the CRC of a
+ * string that contains embedded CRCs is problematic, so stored CRCs are
+ * rotated and offset first (as in LevelDB).
+ */
+inline uint32_t Crc32cMask(uint32_t crc) {
+    return ((crc >> 15) | (crc << 17)) + kCrc32cMaskDelta;
+}
+
+inline uint32_t Crc32cUnmask(uint32_t masked) {
+    uint32_t rot = masked - kCrc32cMaskDelta;
+    return (rot >> 17) | (rot << 15);
+}
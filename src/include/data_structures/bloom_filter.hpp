@@ -0,0 +1,82 @@
+/*
+
+Blocked Bloom filter
+
+My Implementation is based on:
+Felix Putze, Peter Sanders, Johannes Singler. 2007.
+Cache-, Hash- and Space-Efficient Bloom Filters. WEA '07.
+
+Every key sets all of its bits inside a single 64-byte block, so a lookup
+touches one cache line instead of one line per probe, for a small increase
+in false positive rate over a standard filter of the same size.
+
+*/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Thread-safe blocked Bloom filter
+ * Add and MayContain may run concurrently: bits are set with atomic OR and are
+ * never cleared, so a reader that synchronizes with the writer after Add (e.g.
+ * through the lock of the structure the key went into) always sees the key.
+ */
+class BloomFilter {
+public:
+    static constexpr int kDefaultNumProbes = 6;
+
+    /**
+     * Constructor: Initialize an empty filter
+     * @param num_bits Filter size, rounded up to a whole number of 512-bit blocks
+     * @param num_probes Bits set per key (6 is near optimal at 10 bits per key)
+     */
+    explicit BloomFilter(size_t num_bits, int num_probes = kDefaultNumProbes);
+
+    BloomFilter(const BloomFilter&) = delete;
+    void operator=(const BloomFilter&) = delete;
+
+    /**
+     * Record a key
+     * @param key The key to add (hashed internally)
+     */
+    void Add(const std::string& key);
+
+    /**
+     * Record an already hashed value
+     * @param hash 64-bit hash with well-mixed bits
+     */
+    void AddHash(uint64_t hash);
+
+    /**
+     * Check whether a key may have been added
+     * @param key The key to look for
+     * @return false only if the key was definitely never added
+     */
+    bool MayContain(const std::string& key) const;
+
+    bool MayContainHash(uint64_t hash) const;
+
+    // Filter size in bits (a multiple of 512)
+    size_t NumBits() const;
+    int NumProbes() const;
+
+    static uint64_t Hash(const std::string& key);
+
+private:
+    static constexpr size_t kBlockBits = 512;
+
+    // One cache line of bits
+    struct alignas(64) Block {
+        std::atomic<uint64_t> words[kBlockBits / 64];
+        Block() {
+            for (auto& word : words) word.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    int num_probes_;
+    std::vector<Block> blocks_;
+};
@@ -0,0 +1,213 @@
+/*
+
+An in-memory B+tree with optimistic lock coupling
+
+Concurrency control follows:
+Viktor Leis, Michael Haubenschild, Thomas Neumann. 2019. Optimistic Lock Coupling:
+A Scalable and Efficient General-Purpose Synchronization Method. IEEE Data Eng. Bull. 42(1).
+
+Readers never write to shared memory: they remember each node's version,
+read, then validate that the version did not change. Writers lock only the
+nodes they modify (plus the parent while splitting).
+
+*/
+
+#pragma once
+#include "src/include/iterators/StorageIterator.hpp"
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Thread-safe B+tree mapping string keys to string values
+ * Insert-only (a memtable never removes keys), so nodes and entries are
+ * never freed before the tree itself is destroyed and optimistic readers can
+ * always safely dereference what they read.
+ *
+ * Nodes are cache-line aligned and keep an array of 8-byte big-endian key
+ * prefixes next to the entry pointers. In-node search compares the prefix
+ * array first (a branch-free, vectorizable loop) and only touches the full
+ * key strings for slots whose prefix ties with the search key.
+ */
+class BTree {
+public:
+    // Max keys per node; two cache lines of prefixes and two of pointers
+    static constexpr int kFanout = 16;
+
+    /**
+     * Immutable key-value record referenced from leaves
+     * Overwriting a key publishes a new Entry so readers never see a torn value
+     */
+    struct Entry {
+        std::string key;
+        std::string value;
+        Entry* retired_next = nullptr;
+        Entry(std::string k, std::string v) : key(std::move(k)), value(std::move(v)) {}
+    };
+
+    BTree();
+    ~BTree();
+
+    BTree(const BTree&) = delete;
+    void operator=(const BTree&) = delete;
+
+    /**
+     * Check if the tree is empty
+     * @return true if the tree contains no elements
+     */
+    bool isEmpty() const;
+
+    /**
+     * Get the number of distinct keys in the tree
+     * @return current number of key-value pairs stored
+     */
+    int Size() const;
+
+    /**
+     * Insert or update a key-value pair in a single descent
+     *
+     * @param key The string key to insert/update
+     * @param value The string value to associate with the key
+     * @return size of the value that was replaced, or std::nullopt if the key was new
+     */
+    std::optional<size_t> Insert(const std::string& key, const std::string& value);
+
+    /**
+     * Search for a key and return its value
+     *
+     * @param key The key to search for
+     * @return std::optional containing the value if found, std::nullopt if not found
+     */
+    std::optional<std::string> Contains(const std::string& key) const;
+
+    /**
+     * Compute the 8-byte big-endian prefix used for in-node comparisons
+     * Keys shorter than 8 bytes are zero padded, which preserves byte-wise order
+     */
+    static uint64_t KeyPrefix(const std::string& key);
+
+private:
+    enum class NodeType : uint8_t { kInner, kLeaf };
+
+    struct alignas(64) NodeBase {
+        // Bit 0: obsolete, bit 1: locked, bits 2..63: version counter
+        std::atomic<uint64_t> version_lock{0b100};
+        NodeType type;
+        uint16_t count = 0;
+        uint64_t prefixes[kFanout];
+
+        explicit NodeBase(NodeType t) : type(t) {}
+
+        uint64_t ReadLockOrRestart(bool& need_restart) const;
+        void CheckOrRestart(uint64_t start_read, bool& need_restart) const;
+        void UpgradeToWriteLockOrRestart(uint64_t& version, bool& need_restart);
+        void WriteUnlock();
+
+        // Index of the first slot whose key is >= key (count if none)
+        int LowerBound(const std::string& key, uint64_t prefix, Entry* const* keys) const;
+    };
+
+    struct Inner : NodeBase {
+        // keys[i] is the largest key reachable through children[i]
+        Entry* keys[kFanout];
+        NodeBase* children[kFanout + 1];
+
+        Inner() : NodeBase(NodeType::kInner) {}
+        bool IsFull() const { return count == kFanout; }
+        int LowerBound(const std::string& key, uint64_t prefix) const {
+            return NodeBase::LowerBound(key, prefix, keys);
+        }
+        Inner* Split(Entry*& separator);
+        void InsertChild(Entry* separator, NodeBase* child);
+    };
+
+    struct Leaf : NodeBase {
+        Entry* entries[kFanout];
+        Leaf* next = nullptr;
+
+        Leaf() : NodeBase(NodeType::kLeaf) {}
+        bool IsFull() const { return count == kFanout; }
+        int LowerBound(const std::string& key, uint64_t prefix) const {
+            return NodeBase::LowerBound(key, prefix, entries);
+        }
+        Leaf* Split(Entry*& separator);
+    };
+
+    std::atomic<NodeBase*> root_;
+    std::atomic<int> size_;
+    // Overwritten entries, freed with the tree (optimistic readers may still hold them)
+    std::atomic<Entry*> retired_;
+
+    void MakeRoot(Entry* separator, NodeBase* left, NodeBase* right);
+    void Retire_(Entry* entry);
+    static void FreeNode_(NodeBase* node);
+
+    /**
+     * Find the leaf that would hold key (or the leftmost leaf when key is nullptr)
+     */
+    Leaf* FindLeaf_(const std::string* key) const;
+
+    /**
+     * Find the largest key < *key (the largest key of the tree when key is nullptr)
+     * Leaves only link forward, so when the leaf holding key has nothing smaller
+     * the answer is the separator left of the deepest child taken, which is the
+     * largest key of the neighbouring subtree
+     */
+    std::optional<std::string> FindLastLess_(const std::string* key) const;
+
+public:
+    /**
+     * Iterator class for traversing the tree in sorted order
+     * Holds a validated copy of one leaf's entry pointers at a time, so
+     * concurrent splits never invalidate it. prev() steps within that copy and
+     * only descends from the root again when it runs off the front.
+     */
+    class BTreeIterator : public StorageIterator {
+    public:
+        BTreeIterator() : tree_(nullptr), pos_(0), next_leaf_(nullptr) {}
+        // Position at the first key >= *start_key, or at the first key when start_key is nullptr
+        BTreeIterator(const BTree* tree, const std::string* start_key);
+
+        std::string key() override;
+        std::string value() override;
+        bool is_valid() override;
+        void next() override;
+        void prev() override;
+
+        // Reposition at the first key >= target
+        void seek(const std::string& target) override;
+        // Reposition at the last key <= target
+        void seek_for_prev(const std::string& target) override;
+        // Reposition at the first key of the tree
+        void seek_to_first() override;
+        // Reposition at the last key of the tree
+        void seek_to_last() override;
+
+    private:
+        const BTree* tree_;
+        std::vector<Entry*> batch_;
+        // Index into batch_; invalid once it reaches batch_.size()
+        size_t pos_;
+        Leaf* next_leaf_;
+
+        // Copy the entries of leaf and position at the first one >= bound (> bound if exclusive)
+        void LoadLeaf_(Leaf* leaf, const std::string* bound, bool exclusive);
+        // Load leaves until one yields a position or the chain ends
+        void Advance_(const std::string* bound, bool exclusive);
+    };
+
+    /**
+     * Get iterator pointing to first element in the tree
+     * @return iterator at the beginning of sorted sequence
+     */
+    BTreeIterator begin() const;
+
+    /**
+     * Get iterator pointing to first element >= start_key
+     * @param start_key The key to start scanning from
+     * @return iterator positioned at first key >= start_key
+     */
+    BTreeIterator scan(const std::string& start_key) const;
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * 16-byte key such as a UUID, held as two big-endian words so that comparing
+ * the words orders keys exactly like their bytes.
+ */
+struct Uuid {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    bool operator<(const Uuid& other) const {
+        return hi != other.hi ? hi < other.hi : lo < other.lo;
+    }
+    bool operator==(const Uuid& other) const {
+        return hi == other.hi && lo == other.lo;
+    }
+};
+
+/**
+ * Converts a skip list key type to and from the byte strings that
+ * StorageIterator speaks. kWidth is the encoded size of fixed-width keys (0
+ * for variable-width ones).
+ */
+template <typename Key>
+struct KeyCodec;
+
+template <>
+struct KeyCodec<std::string> {
+    static constexpr size_t kWidth = 0;
+
+    static std::string Encode(const std::string& key) { return key; }
+
+    static std::string Decode(const std::string& bytes, bool* truncated) {
+        *truncated = false;
+        return bytes;
+    }
+};
+
+// 8 bytes read as a big-endian integer, so integer order is byte order
+template <>
+struct KeyCodec<uint64_t> {
+    static constexpr size_t kWidth = 8;
+
+    static std::string Encode(uint64_t key) {
+        std::string bytes(kWidth, '\0');
+        for (size_t i = 0; i < kWidth; ++i) {
+            bytes[i] = static_cast<char>(key >> (56 - 8 * i));
+        }
+        return bytes;
+    }
+
+    /**
+     * Shorter inputs are zero padded, longer ones cut to the first 8 bytes
+     * @param truncated Set when bytes continued past the key
+     */
+    static uint64_t Decode(const std::string& bytes, bool* truncated) {
+        *truncated = bytes.size() > kWidth;
+        return Read(bytes.data(), bytes.size());
+    }
+
+    static uint64_t Read(const char* data, size_t size) {
+        uint64_t key = 0;
+        size_t n = size < kWidth ? size : kWidth;
+        for (size_t i = 0; i < n; ++i) {
+            key |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (56 - 8 * i);
+        }
+        return key;
+    }
+};
+
+template <>
+struct KeyCodec<Uuid> {
+    static constexpr size_t kWidth = 16;
+
+    static std::string Encode(const Uuid& key) {
+        return KeyCodec<uint64_t>::Encode(key.hi) + KeyCodec<uint64_t>::Encode(key.lo);
+    }
+
+    // Same padding and truncation rules as KeyCodec<uint64_t>
+    static Uuid Decode(const std::string& bytes, bool* truncated) {
+        *truncated = bytes.size() > kWidth;
+        Uuid key;
+        key.hi = KeyCodec<uint64_t>::Read(bytes.data(), bytes.size());
+        if (bytes.size() > 8) {
+            key.lo = KeyCodec<uint64_t>::Read(bytes.data() + 8, bytes.size() - 8);
+        }
+        return key;
+    }
+};
@@ -0,0 +1,117 @@
+/*
+
+An open-addressing hash table with linear probing
+
+Deletion uses backward-shift instead of tombstones so probe sequences never
+degrade, see:
+Knuth. The Art of Computer Programming, Vol. 3, Section 6.4, Algorithm R.
+
+*/
+
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Thread-safe open-addressing hash table mapping string keys to string values
+ * Provides O(1) expected time for search, insert, and delete operations
+ * Uses reader-writer locks for concurrent access (same model as SkipList)
+ */
+class HashTable {
+public:
+    /**
+     * Constructor: Initialize an empty table
+     * @param initial_capacity Number of slots to start with (rounded up to a power of two)
+     */
+    explicit HashTable(size_t initial_capacity = 16);
+
+    /**
+     * Check if the table is empty
+     * @return true if the table contains no elements
+     */
+    bool isEmpty() const;
+
+    /**
+     * Get the number of elements in the table
+     * @return current number of key-value pairs stored
+     */
+    int Size() const;
+
+    /**
+     * Get the number of slots currently allocated
+     * @return capacity of the slot array (always a power of two)
+     */
+    size_t Capacity() const;
+
+    /**
+     * Get the approximate bytes held by the table
+     * @return slot array size plus the bytes of every stored key and value
+     */
+    size_t ApproximateMemoryUsage() const;
+
+    /**
+     * Remove all elements from the table, keeping the allocated slots
+     */
+    void Clear();
+
+    /**
+     * Insert or update a key-value pair
+     * Grows the slot array when the load factor would exceed 3/4
+     *
+     * @param key The string key to insert/update
+     * @param value The string value to associate with the key
+     */
+    void Insert(const std::string& key, const std::string& value);
+
+    /**
+     * Remove a key-value pair
+     * If key doesn't exist, operation has no effect
+     *
+     * @param key The key to remove from the table
+     */
+    void Erase(const std::string& key);
+
+    /**
+     * Search for a key and return its value
+     *
+     * @param key The key to search for
+     * @return std::optional containing the value if found, std::nullopt if not found
+     */
+    std::optional<std::string> Contains(const std::string& key) const;
+
+private:
+    /**
+     * Slot in the open-addressing array
+     * The full hash is cached so probes only compare strings on a hash match
+     */
+    struct Slot {
+        bool occupied = false;
+        uint64_t hash = 0;
+        std::string key;
+        std::string value;
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    int size_;
+    // Sum of the sizes of the stored keys and values
+    size_t bytes_;
+
+    mutable std::shared_mutex mu_;
+
+    static uint64_t Hash_(const std::string& key);
+
+    /**
+     * Find the slot holding key, or the empty slot where it would be inserted
+     * @return index into slots_
+     */
+    size_t FindSlot_(const std::string& key, uint64_t hash) const;
+
+    /**
+     * Double the slot array and reinsert every element
+     */
+    void Grow_();
+};
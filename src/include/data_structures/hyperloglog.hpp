@@ -0,0 +1,103 @@
+/*
+
+HyperLogLog distinct-count sketch
+
+My Implementation is based on:
+Philippe Flajolet, Éric Fusy, Olivier Gandouet, Frédéric Meunier. 2007.
+HyperLogLog: the analysis of a near-optimal cardinality estimation algorithm. AofA '07.
+
+with the small-range (linear counting) correction from the same paper.
+
+*/
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Dense HyperLogLog sketch
+ * Uses 2^precision one-byte registers; standard error is about 1.04 / sqrt(2^precision)
+ * (0.8% with the default precision of 14, i.e. 16KB per sketch).
+ *
+ * Not thread-safe, except that AddHashConcurrent and Snapshot may run
+ * alongside each other; callers must serialize everything else.
+ */
+class HyperLogLog {
+public:
+    static constexpr int kDefaultPrecision = 14;
+
+    /**
+     * Constructor: Initialize an empty sketch
+     * @param precision Number of index bits, clamped to [4, 18]
+     */
+    explicit HyperLogLog(int precision = kDefaultPrecision);
+
+    /**
+     * Record a key
+     * @param key The key to add (hashed internally)
+     */
+    void Add(const std::string& key);
+
+    /**
+     * Record an already hashed value
+     * @param hash 64-bit hash with well-mixed bits
+     */
+    void AddHash(uint64_t hash);
+
+    /**
+     * AddHash for a sketch shared between writers: the register is raised
+     * with an atomic max, so concurrent adds neither block nor lose updates
+     * @param hash 64-bit hash with well-mixed bits
+     */
+    void AddHashConcurrent(uint64_t hash);
+
+    /**
+     * Copy of the sketch that may be taken while AddHashConcurrent runs
+     * @return a sketch holding every add that finished before the call
+     */
+    HyperLogLog Snapshot() const;
+
+    /**
+     * Fold another sketch into this one (register-wise max)
+     * Sketches with a different precision are ignored
+     * @param other Sketch built with the same precision
+     */
+    void Merge(const HyperLogLog& other);
+
+    /**
+     * Estimate the number of distinct keys added so far
+     * @return approximate distinct count
+     */
+    double Estimate() const;
+
+    /**
+     * Reset to the empty state
+     */
+    void Clear();
+
+    int Precision() const;
+
+    /**
+     * Serialize the registers: the non-zero ones as (index, value) pairs
+     * while that is smaller than all of them
+     * @return bytes Decode accepts
+     */
+    std::string Encode() const;
+
+    /**
+     * Replace this sketch with one produced by Encode
+     * @return false (leaving the sketch unchanged) if data is malformed
+     */
+    bool Decode(const std::string& data);
+
+    static uint64_t Hash(const std::string& key);
+
+private:
+    int precision_;
+
+    // Register a hash lands in, and the rank it offers that register
+    void Locate_(uint64_t hash, size_t* index, uint8_t* rank) const;
+
+    std::vector<uint8_t> registers_;
+};
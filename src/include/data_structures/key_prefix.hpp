@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/**
+ * First 8 bytes of a key packed big-endian into an integer.
+ * Keys shorter than 8 bytes are zero padded, so comparing prefixes as
+ * integers agrees with byte-wise key order except when prefixes tie, in
+ * which case the full keys must be compared.
+ */
+inline uint64_t KeyPrefix(const char* data, size_t size) {
+    uint64_t prefix = 0;
+    size_t n = size < 8 ? size : 8;
+    for (size_t i = 0; i < n; ++i) {
+        prefix |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+inline uint64_t KeyPrefix(const std::string& key) {
+    return KeyPrefix(key.data(), key.size());
+}
@@ -1,9 +1,9 @@
 /*
 
-A skip list is a probabilistic data structure with effective searching 
+A skip list is a probabilistic data structure with effective searching
 
-My Implementation is based on: 
-William Pugh. 1990. Skip lists: a probabilistic alternative to balanced trees. 
+My Implementation is based on:
+William Pugh. 1990. Skip lists: a probabilistic alternative to balanced trees.
 Commun. ACM 33, 6 (June 1990), 668–676. https://doi.org/10.1145/78973.78977
 
 Author: Nicholas Terek
@@ -11,58 +11,205 @@ Author: Nicholas Terek
 
 #pragma once
 #include "src/include/iterators/StorageIterator.hpp"
+#include "src/include/data_structures/fixed_key.hpp"
+#include "src/include/data_structures/key_prefix.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <optional>
 #include <shared_mutex>
+#include <type_traits>
+
+/**
+ * 64 random bits from a per-thread xorshift64* generator, used to pick tower
+ * heights without sharing engine state between writers
+ * @return uniformly distributed random word
+ */
+uint64_t SkipListRandomWord();
+
+/**
+ * Process-wide unique stamp; a skip list takes a new one whenever nodes may
+ * have been freed, which invalidates insert hints pointing into it
+ */
+uint64_t SkipListNewEpoch();
+
+/**
+ * Whether BasicSkipList caches an 8-byte big-endian prefix of every key next
+ * to the links that reach it. Only byte-ordered string keys benefit:
+ * fixed-width keys already compare as integers, and a custom order need not
+ * agree with the byte order the prefixes encode.
+ */
+template <typename Key, typename Compare>
+struct SkipListCachesPrefix : std::false_type {};
+
+template <>
+struct SkipListCachesPrefix<std::string, std::less<std::string>> : std::true_type {};
 
 /**
  * Thread-safe probabilistic skip list implementation
  * Provides O(log n) expected time for search, insert, and delete operations
  * Uses reader-writer locks for concurrent access
+ *
+ * Inserting a new key only takes the shared lock, so writers run alongside
+ * each other and the readers: each level of the tower is spliced in with a
+ * compare-and-swap on the predecessor's link, bottom level first, as in
+ * LevelDB/RocksDB's InlineSkipList. Nodes are never freed under the shared
+ * lock, so a search can always carry on from a node it holds. Overwrites,
+ * Erase and Clear take the exclusive lock, as does an insert that would
+ * shrink the cached common prefix (below).
+ *
+ * Templated on the key type and its ordering. Keys live inline in the nodes,
+ * so fixed-width keys (uint64_t, Uuid) avoid the string's heap allocation and
+ * compare as integers. The iterator speaks the byte strings StorageIterator
+ * uses, converting through KeyCodec<Key>; the ordering must then agree with
+ * the byte order of the encoded keys, which holds for the fixed-width codecs
+ * with std::less. String keys may use any order (e.g. ComparatorLess).
+ *
+ * Byte-ordered string lists (SkipList) also cache each key's prefix in its
+ * node and in every tower link pointing at it, so a search step is usually a
+ * single integer compare that never touches the next node's key. The prefix
+ * is taken after the bytes all keys in the list share (capped at
+ * kMaxCommonPrefix), which keeps it discriminating for keys like
+ * "tenant-0042/orders/...". Only prefix ties fall back to the full keys.
  */
-class SkipList {
-    friend class MemTable;
+template <typename Key, typename Compare = std::less<Key>>
+class BasicSkipList {
 public:
+    static constexpr bool kCachesPrefix = SkipListCachesPrefix<Key, Compare>::value;
+    // Longest shared leading run skipped before taking the cached prefix
+    static constexpr size_t kMaxCommonPrefix = 32;
+    // Height cap of an empty list; raised by one each time the size doubles past 2^max_level_
+    static constexpr int kInitialMaxLevel = 16;
+    // Levels the head node is built with (room for 2^32 entries)
+    static constexpr int kMaxHeight = 32;
+
+    struct Node;
+
+    // Forward pointer, plus the cached prefix of its target when kCachesPrefix.
+    // The cached prefix is always its target's Node::prefix.
+    struct PlainLink {
+        Node* Get() const { return node_.load(std::memory_order_acquire); }
+        Node* Get(uint64_t* prefix) const {
+            *prefix = 0;
+            return Get();
+        }
+        // Only while no other thread can reach the link, or under the exclusive lock
+        void Set(Node* n) { node_.store(n, std::memory_order_release); }
+        // Swing the link from expected to n, racing other inserters
+        bool Publish(Node* expected, Node* n) {
+            return node_.compare_exchange_strong(expected, n, std::memory_order_acq_rel);
+        }
+
+    private:
+        std::atomic<Node*> node_{nullptr};
+    };
+    struct PrefixedLink {
+        Node* Get() const { return Untag_(word_.load(std::memory_order_acquire)); }
+        // Target and its cached prefix as one consistent pair
+        Node* Get(uint64_t* prefix) const {
+            for (;;) {
+                uintptr_t word = word_.load(std::memory_order_acquire);
+                Node* n = Untag_(word);
+                if (word & kPending) {
+                    // Publish has not stored the prefix yet; the node has it
+                    *prefix = n->prefix;
+                    return n;
+                }
+                *prefix = prefix_.load(std::memory_order_acquire);
+                // Links only ever move to new nodes, so an unchanged word means no Publish came between
+                if (word_.load(std::memory_order_relaxed) == word) {
+                    return n;
+                }
+            }
+        }
+        void Set(Node* n) {
+            prefix_.store(n ? n->prefix : 0, std::memory_order_relaxed);
+            word_.store(reinterpret_cast<uintptr_t>(n), std::memory_order_release);
+        }
+        // The pending bit tells readers the prefix still belongs to the old
+        // target; other inserters fail their swap until it is cleared
+        bool Publish(Node* expected, Node* n) {
+            uintptr_t word = reinterpret_cast<uintptr_t>(expected);
+            if (!word_.compare_exchange_strong(word, reinterpret_cast<uintptr_t>(n) | kPending,
+                                               std::memory_order_acq_rel)) {
+                return false;
+            }
+            prefix_.store(n->prefix, std::memory_order_release);
+            word_.store(reinterpret_cast<uintptr_t>(n), std::memory_order_release);
+            return true;
+        }
+
+    private:
+        static constexpr uintptr_t kPending = 1;
+        static Node* Untag_(uintptr_t word) { return reinterpret_cast<Node*>(word & ~kPending); }
+
+        std::atomic<uintptr_t> word_{0};
+        std::atomic<uint64_t> prefix_{0};
+    };
+    using Link = std::conditional_t<kCachesPrefix, PrefixedLink, PlainLink>;
+
     /**
      * Node structure for the skip list
-     * Each node contains a key-value pair and multiple forward pointers (next array)
+     * Each node contains a key-value pair and multiple forward links (next array)
      * The height of a node determines how many levels it participates in
      */
     struct Node {
-        std::string key;
+        Key key;
         std::string value;
-        std::vector<Node*> next;
-        Node(std::string k, std::string v, int h)
-          : key(std::move(k)), value(std::move(v)), next(static_cast<size_t>(h), nullptr) {}
-        
+        // Cached prefix of key past the list's common prefix (0 unless kCachesPrefix)
+        uint64_t prefix = 0;
+        std::vector<Link> next;
+        Node(Key k, std::string v, int h)
+          : key(std::move(k)), value(std::move(v)), next(static_cast<size_t>(h)) {}
+
         // Constructor for header node (no key/value, just height)
-        Node(int h) : key(), value(), next(static_cast<size_t>(h), nullptr) {}
+        Node(int h) : key(), value(), next(static_cast<size_t>(h)) {}
+    };
+
+    /**
+     * Where an insert landed: the node at each level just before the next
+     * larger key. Passed back to the following Upsert, a larger key resumes
+     * each level from there instead of head_, so ascending inserts splice in
+     * after a few pointer checks. Smaller keys, another list's hint, or a hint
+     * from before an Erase/Clear are ignored and searched normally.
+     */
+    struct InsertHint {
+        uint64_t epoch = 0;
+        int levels = 0;
+        Node* prev[kMaxHeight] = {};
     };
 
     /**
      * Constructor: Initialize an empty skip list
      * Sets up the header node and default parameters
+     * @param compare Strict weak ordering of the keys
      */
-    SkipList();
-    
+    explicit BasicSkipList(Compare compare = Compare());
+
     /**
      * Destructor: Clean up all nodes and free memory
      */
-    ~SkipList();
-    
+    ~BasicSkipList();
+
+    BasicSkipList(const BasicSkipList&) = delete;
+    void operator=(const BasicSkipList&) = delete;
+
     /**
      * Check if the skip list is empty
      * @return true if the list contains no elements
      */
     bool isEmpty() const;
-    
+
     /**
      * Get the number of elements in the skip list
      * @return current number of key-value pairs stored
      */
     int Size() const;
-    
+
     /**
      * Remove all elements from the skip list
      * Resets the list to initial empty state
@@ -72,28 +219,52 @@ public:
     /**
      * Insert or update a key-value pair in the skip list
      * If key exists, updates the value; otherwise creates new node
-     * 
-     * @param key The string key to insert/update
+     *
+     * @param key The key to insert/update
      * @param value The string value to associate with the key
      */
-    void Insert(const std::string& key, const std::string& value);
-    
+    void Insert(const Key& key, const std::string& value);
+
+    /**
+     * Insert or update in a single traversal
+     * New keys are linked under the shared lock, concurrently with other
+     * inserts; replacing a value waits for the exclusive lock
+     *
+     * @param key The key to insert/update
+     * @param value The string value to associate with the key
+     * @param hint Optional; used as a starting point and updated to this insert
+     * @return size of the value replaced, or std::nullopt if the key was new
+     */
+    std::optional<size_t> Upsert(const Key& key, const std::string& value, InsertHint* hint = nullptr);
+
     /**
      * Remove a key-value pair from the skip list
      * If key doesn't exist, operation has no effect
-     * 
+     *
      * @param key The key to remove from the list
      */
-    void Erase(const std::string& key);
-    
+    void Erase(const Key& key);
+
     /**
      * Search for a key in the skip list and return its value
      * Uses skip list's O(log n) expected search time
-     * 
+     *
      * @param key The key to search for
      * @return std::optional containing the value if found, std::nullopt if not found
      */
-    std::optional<std::string> Contains(const std::string& key) const;
+    std::optional<std::string> Contains(const Key& key) const;
+
+    /**
+     * Search for a key and hand its value to fn under the read lock
+     * Lets callers copy into a buffer they reuse, or keep a reference when
+     * they know no writer will replace the value
+     *
+     * @param key The key to search for
+     * @param fn Called as fn(const std::string& value) if the key is found
+     * @return true if the key was found
+     */
+    template <typename Fn>
+    bool Find(const Key& key, Fn&& fn) const;
 
     // placeholder for later:
     // bool GetResult(const std::string& key);
@@ -104,39 +275,73 @@ public:
      * Inherits from StorageIterator for compatibility with other storage components
      */
     class SkipListIterator : public StorageIterator {
-        friend class MemTable;
     public:
         SkipListIterator() : skiplist_(nullptr), current_(nullptr) {}
-        SkipListIterator(SkipList* skiplist, Node* current) 
+        SkipListIterator(BasicSkipList* skiplist, Node* current)
             : skiplist_(skiplist), current_(current) {}
 
         /**
          * Get the current key
-         * @return key string of current node
+         * @return key of current node, encoded with KeyCodec<Key>
          */
         std::string key() override;
-        
+
+        /**
+         * Get the current key without encoding it
+         * @return key of current node
+         */
+        Key typed_key();
+
         /**
          * Get the current value
          * @return value string of current node
          */
         std::string value() override;
-        
+
         /**
          * Check if iterator points to a valid node
          * @return true if iterator is valid, false if at end
          */
         bool is_valid() override;
-        
+
         /**
          * Move iterator to next node in sorted order
          * Advances along level 0 (bottom level with all nodes)
          */
         void next() override;
-    
+
+        /**
+         * Move iterator to the previous node in sorted order
+         * Nodes only link forward, so this searches the towers for the
+         * predecessor of the current key: O(log n) rather than a rescan
+         */
+        void prev() override;
+
+        /**
+         * Reposition at the first node >= target
+         * @param target The encoded key to seek to (any length for fixed-width keys)
+         */
+        void seek(const std::string& target) override;
+
+        /**
+         * Reposition at the last node <= target
+         * @param target The encoded key to seek to (any length for fixed-width keys)
+         */
+        void seek_for_prev(const std::string& target) override;
+
+        /**
+         * Reposition at the first node of the list
+         */
+        void seek_to_first() override;
+
+        /**
+         * Reposition at the last node of the list
+         */
+        void seek_to_last() override;
+
     private:
-        SkipList* skiplist_;
-        SkipList::Node* current_;
+        BasicSkipList* skiplist_;
+        Node* current_;
     };
 
     /**
@@ -144,44 +349,683 @@ public:
      * @return iterator at the beginning of sorted sequence
      */
     SkipListIterator begin() const;
-    
+
     /**
      * Get iterator pointing to first element >= start_key
      * Useful for range queries and scans
      * @param start_key The key to start scanning from
      * @return iterator positioned at first key >= start_key
      */
-    SkipListIterator scan(const std::string& start_key) const;
+    SkipListIterator scan(const Key& start_key) const;
+
+    /**
+     * Point lookup run one step at a time, for interleaving many lookups on
+     * one thread: each Step() moves one node along the search path and
+     * prefetches the node the next step compares against, so the caller can
+     * switch to other lookups while it arrives.
+     *
+     * The read lock is only held inside Step() and Finish(). Between steps
+     * the cursor keeps a node pointer, which stays valid because only Erase
+     * and Clear free nodes; they renew the list's epoch and the cursor then
+     * restarts from the head. The list must outlive the cursor.
+     */
+    class LookupCursor {
+    public:
+        LookupCursor(const BasicSkipList* list, Key key);
+
+        /**
+         * Advance the search to the next node not yet in cache, prefetching it
+         * @return false once the search is complete
+         */
+        bool Step();
+
+        /**
+         * Complete the search and hand the value to fn under the read lock
+         * @param fn Called as fn(const std::string& value) if the key is found
+         * @return true if the key was found
+         */
+        template <typename Fn>
+        bool Finish(Fn&& fn);
+
+    private:
+        // Start over from the head; requires the read lock
+        void Restart_();
+
+        const BasicSkipList* list_;
+        Key key_;
+        uint64_t epoch_;
+        Node* x_;
+        int level_;
+        // x_ was just reached; its links have not been fetched yet
+        bool links_pending_;
+    };
 
 private:
-    int max_level_;
-    int level_;
-    int size_ ;
-    double prob_;
+    // Height cap for new towers, about log2(size_) once the list outgrows kInitialMaxLevel
+    std::atomic<int> max_level_;
+    std::atomic<int> level_;
+    std::atomic<int> size_;
+    // Renewed whenever nodes are freed
+    uint64_t epoch_;
     Node* head_;
+    Compare compare_;
+
+    // Leading bytes every key in the list shares; only grows back once the list empties
+    std::string common_prefix_;
 
     mutable std::shared_mutex mu_;
 
+    // A search target with its prefix worked out once for the whole descent
+    struct Probe_ {
+        const Key* key;
+        uint64_t prefix;
+        // False when the target does not share common_prefix_ (cached prefixes say nothing then)
+        bool use_prefix;
+    };
+
+    bool Equal_(const Key& a, const Key& b) const {
+        return !compare_(a, b) && !compare_(b, a);
+    }
+
+    Probe_ MakeProbe_(const Key& key) const;
+
+    /**
+     * The node behind link if it sorts before the probe's key
+     * Decided by the cached prefixes unless they tie
+     * @param stop If given, receives the node when it does not sort before.
+     *        Inserters may relink in the meantime, so a search must end on
+     *        this node rather than read the link again.
+     * @return the node, or nullptr if there is none or it does not sort before
+     */
+    Node* Before_(const Link& link, const Probe_& probe, Node** stop = nullptr) const {
+        uint64_t prefix;
+        Node* n = link.Get(&prefix);
+        bool before = false;
+        if (n) {
+            if constexpr (kCachesPrefix) {
+                if (probe.use_prefix && prefix != probe.prefix) {
+                    before = prefix < probe.prefix;
+                } else {
+                    before = compare_(n->key, *probe.key);
+                }
+            } else {
+                before = compare_(n->key, *probe.key);
+            }
+        }
+        if (before) return n;
+        if (stop) *stop = n;
+        return nullptr;
+    }
+
+    uint64_t PrefixOf_(const Key& key) const;
+
+    /**
+     * Splice a new node for key in after the predecessors in update
+     * @return the new node
+     */
+    Node* Link_(const Key& key, const std::string& value, Node** update);
+
+    /**
+     * Splice a new node for key in under the shared lock, racing other
+     * inserters: a level whose link changed since the search walks forward
+     * from update[i] and retries
+     * @param update Predecessors from FindGE_ for levels below searched; becomes the final ones
+     * @param searched Number of levels FindGE_ filled in
+     * @return the new node, or nullptr if another writer linked key first
+     */
+    Node* LinkShared_(const Key& key, const std::string& value, Node** update, int searched);
+
+    // Count a linked node, raising the height cap each time the size doubles past it
+    void Grow_();
+
+    /**
+     * Shrink common_prefix_ to what it shares with key, re-deriving every
+     * cached prefix if it changed. O(n log n), but the common prefix can only
+     * shrink kMaxCommonPrefix times between clears.
+     */
+    void UpdateCommonPrefix_(const Key& key);
+
     /**
      * Find the first node with key >= target
      * Core search algorithm that fills update array with predecessors at each level
      * @param target The key to search for
-     * @param update Array to store predecessor nodes at each level
+     * @param update Array of kMaxHeight entries; levels below level_ receive predecessors
+     * @param hint Predecessors of a smaller key to resume levels from, or nullptr
      * @return pointer to first node >= target, or nullptr if not found
      */
-    Node* FindGE_(const std::string& target, std::vector<Node*>& update) const;
-    
+    Node* FindGE_(const Key& target, Node** update, const InsertHint* hint = nullptr) const;
+
+    /**
+     * Find the last node with key < target, descending the towers from the top level
+     * @param target The key to search for, or nullptr to find the last node of the list
+     * @return pointer to the last node < target, or nullptr if there is none
+     */
+    Node* FindLT_(const Key* target) const;
+
     /**
      * Helper function to delete all data nodes (called by Clear and destructor)
      * Traverses level 0 and deletes each node
      */
     void ClearAll_();
-    
+
     /**
      * Generate random height for new nodes using geometric distribution
-     * Each level has prob_ chance of promotion (default 0.5)
-     * Expected height is 1/(1-prob_) = 2 for prob_=0.5
+     * Each trailing zero bit of one random word is a promotion (p = 0.5),
+     * so the expected height is 2 and a single draw decides the whole tower
      * @return random height between 1 and max_level_
      */
     int RandomHeight_() const;
-};
\ No newline at end of file
+};
+
+// Byte-string keys in their natural order
+using SkipList = BasicSkipList<std::string>;
+
+// Constructor implementation
+template <typename Key, typename Compare>
+BasicSkipList<Key, Compare>::BasicSkipList(Compare compare) : compare_(std::move(compare)) {
+    max_level_ = kInitialMaxLevel;
+    level_ = 1;
+    size_ = 0;
+    epoch_ = SkipListNewEpoch();
+    head_ = new Node(kMaxHeight);
+}
+
+// Destructor implementation
+template <typename Key, typename Compare>
+BasicSkipList<Key, Compare>::~BasicSkipList() {
+    Clear();
+    delete head_;
+    head_ = nullptr;
+}
+
+// Thread-safe empty check with shared lock (allows concurrent reads)
+template <typename Key, typename Compare>
+bool BasicSkipList<Key, Compare>::isEmpty() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return size_ == 0;
+}
+
+// Thread-safe size getter with shared lock (allows concurrent reads)
+template <typename Key, typename Compare>
+int BasicSkipList<Key, Compare>::Size() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return size_;
+}
+
+// Insert/update implementation with skip list algorithm
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::Insert(const Key& key, const std::string& value) {
+    Upsert(key, value);
+}
+
+template <typename Key, typename Compare>
+std::optional<size_t> BasicSkipList<Key, Compare>::Upsert(const Key& key, const std::string& value,
+                                                          InsertHint* hint) {
+    // Every hinted node sorts at or before hint->prev[0], so one compare vets them all
+    auto usable_hint = [&]() -> const InsertHint* {
+        if (hint && hint->epoch == epoch_ && hint->prev[0] != head_ && compare_(hint->prev[0]->key, key)) {
+            return hint;
+        }
+        return nullptr;
+    };
+    Node* update[kMaxHeight];
+
+    {
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        // Only an exclusive insert may start the common prefix or shrink it
+        bool keeps_prefix = true;
+        if constexpr (kCachesPrefix) {
+            keeps_prefix = size_ > 0 && key.compare(0, common_prefix_.size(), common_prefix_) == 0;
+        }
+        if (keeps_prefix) {
+            int searched = level_;
+            Node* x = FindGE_(key, update, usable_hint());
+            if (!x || !Equal_(x->key, key)) {
+                x = LinkShared_(key, value, update, searched);
+            } else {
+                x = nullptr;
+            }
+            if (x) {
+                if (hint) {
+                    int levels = std::max(searched, static_cast<int>(x->next.size()));
+                    hint->epoch = epoch_;
+                    hint->levels = levels;
+                    for (int i = 0; i < levels; ++i) {
+                        hint->prev[i] = static_cast<size_t>(i) < x->next.size() ? x : update[i];
+                    }
+                }
+                return std::nullopt;
+            }
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lk(mu_);
+    Node* x = FindGE_(key, update, usable_hint());
+
+    std::optional<size_t> old_size;
+    if (x && Equal_(x->key, key)) {
+        old_size = x->value.size();
+        x->value = value;
+    } else {
+        UpdateCommonPrefix_(key);
+        x = Link_(key, value, update);
+    }
+
+    if (hint) {
+        hint->epoch = epoch_;
+        hint->levels = level_;
+        for (int i = 0; i < level_; ++i) {
+            hint->prev[i] = static_cast<size_t>(i) < x->next.size() ? x : update[i];
+        }
+    }
+    return old_size;
+}
+
+template <typename Key, typename Compare>
+typename BasicSkipList<Key, Compare>::Node* BasicSkipList<Key, Compare>::Link_(const Key& key,
+                                                                               const std::string& value,
+                                                                               Node** update) {
+    // Create new node with probabilistically determined height
+    int node_level = RandomHeight_();
+    if (node_level > level_) {
+        for (int i = level_; i < node_level; ++i)
+            update[static_cast<size_t>(i)] = head_;
+        level_ = node_level;
+    }
+
+    Node* n = new Node(key, value, node_level);
+    n->prefix = PrefixOf_(n->key);
+    for (int i = 0; i < node_level; ++i) {
+        Link& link = update[static_cast<size_t>(i)]->next[static_cast<size_t>(i)];
+        n->next[static_cast<size_t>(i)].Set(link.Get());
+        link.Set(n);
+    }
+    Grow_();
+    return n;
+}
+
+template <typename Key, typename Compare>
+typename BasicSkipList<Key, Compare>::Node* BasicSkipList<Key, Compare>::LinkShared_(const Key& key,
+                                                                                     const std::string& value,
+                                                                                     Node** update,
+                                                                                     int searched) {
+    int node_level = RandomHeight_();
+    for (int i = searched; i < node_level; ++i) {
+        update[i] = head_;
+    }
+    int level = level_;
+    while (level < node_level && !level_.compare_exchange_weak(level, node_level)) {
+    }
+
+    Node* n = new Node(key, value, node_level);
+    n->prefix = PrefixOf_(n->key);
+    // Bottom up: a node reachable at some level is already linked at every level below it
+    for (int i = 0; i < node_level; ++i) {
+        Node* prev = update[i];
+        for (;;) {
+            Node* next = prev->next[i].Get();
+            if (next && compare_(next->key, key)) {
+                // Another writer linked a smaller key since the search
+                prev = next;
+                continue;
+            }
+            if (next && !compare_(key, next->key)) {
+                // Another writer linked key first, which only shows at the bottom level
+                delete n;
+                return nullptr;
+            }
+            // n is not reachable at level i yet, so its own link can be set plainly
+            n->next[i].Set(next);
+            if (prev->next[i].Publish(next, n)) {
+                break;
+            }
+        }
+        update[i] = prev;
+    }
+    Grow_();
+    return n;
+}
+
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::Grow_() {
+    int size = ++size_;
+    // A fixed cap leaves ever longer walks along the top level as the list grows
+    int max_level = max_level_;
+    if (max_level < kMaxHeight && (static_cast<uint64_t>(size) >> max_level) != 0) {
+        max_level_.compare_exchange_strong(max_level, max_level + 1);
+    }
+}
+
+// Delete implementation with proper level cleanup
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::Erase(const Key& searchKey) {
+    std::unique_lock<std::shared_mutex> lk(mu_);
+    Node* update[kMaxHeight];
+    Node* x = FindGE_(searchKey, update);
+    if (!x || !Equal_(x->key, searchKey)) return;
+
+    for (int i = 0; i < level_; ++i) {
+        if (update[i]->next[i].Get() == x) {
+            update[i]->next[i].Set(x->next[i].Get());
+        }
+    }
+    delete x;
+    --size_;
+    epoch_ = SkipListNewEpoch();
+
+    while (level_ > 1 && head_->next[level_ - 1].Get() == nullptr) {
+        --level_;
+    }
+}
+
+// Search implementation using skip list's logarithmic search algorithm
+template <typename Key, typename Compare>
+std::optional<std::string> BasicSkipList<Key, Compare>::Contains(const Key& searchKey) const {
+    std::optional<std::string> value;
+    Find(searchKey, [&](const std::string& found) { value = found; });
+    return value;
+}
+
+template <typename Key, typename Compare>
+template <typename Fn>
+bool BasicSkipList<Key, Compare>::Find(const Key& searchKey, Fn&& fn) const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    Probe_ probe = MakeProbe_(searchKey);
+    Node* x = head_;
+    Node* y = nullptr;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (Node* next = Before_(x->next[i], probe, &y)) {
+            x = next;
+        }
+    }
+    if (!y || !Equal_(y->key, searchKey)) return false;
+    fn(y->value);
+    return true;
+}
+
+template <typename Key, typename Compare>
+typename BasicSkipList<Key, Compare>::Probe_ BasicSkipList<Key, Compare>::MakeProbe_(const Key& key) const {
+    Probe_ probe{&key, 0, false};
+    if constexpr (kCachesPrefix) {
+        probe.use_prefix = key.compare(0, common_prefix_.size(), common_prefix_) == 0;
+        if (probe.use_prefix) {
+            probe.prefix = PrefixOf_(key);
+        }
+    }
+    return probe;
+}
+
+template <typename Key, typename Compare>
+uint64_t BasicSkipList<Key, Compare>::PrefixOf_(const Key& key) const {
+    if constexpr (kCachesPrefix) {
+        return KeyPrefix(key.data() + common_prefix_.size(), key.size() - common_prefix_.size());
+    } else {
+        return 0;
+    }
+}
+
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::UpdateCommonPrefix_(const Key& key) {
+    if constexpr (kCachesPrefix) {
+        if (size_ == 0) {
+            // Nothing cached yet: start from the whole key and let later keys whittle it down
+            common_prefix_ = key.substr(0, kMaxCommonPrefix);
+            return;
+        }
+        size_t limit = std::min(common_prefix_.size(), key.size());
+        size_t shared = static_cast<size_t>(
+            std::mismatch(common_prefix_.begin(), common_prefix_.begin() + static_cast<std::ptrdiff_t>(limit),
+                          key.begin())
+                .first -
+            common_prefix_.begin());
+        if (shared == common_prefix_.size()) {
+            return;
+        }
+        common_prefix_.resize(shared);
+        for (Node* x = head_->next[0].Get(); x; x = x->next[0].Get()) {
+            x->prefix = PrefixOf_(x->key);
+        }
+        for (Node* x = head_; x; x = x->next[0].Get()) {
+            for (Link& link : x->next) {
+                // Re-caches the target's new prefix
+                link.Set(link.Get());
+            }
+        }
+    }
+}
+
+template <typename Key, typename Compare>
+typename BasicSkipList<Key, Compare>::Node* BasicSkipList<Key, Compare>::FindGE_(
+    const Key& target, Node** update, const InsertHint* hint) const {
+    Probe_ probe = MakeProbe_(target);
+    Node* x = head_;
+    // While no level has walked, x is at or before the hinted node of the level
+    // above, and hinted nodes only move forward going down, so each level can
+    // start from its hinted node without comparing it to x
+    bool following_hint = hint != nullptr;
+    Node* stop = nullptr;
+    for (int i = level_ -1; i >= 0; --i) {
+        if (following_hint && i < hint->levels) {
+            x = hint->prev[i];
+        }
+        while (Node* next = Before_(x->next[i], probe, &stop)) {
+            x = next;
+            following_hint = false;
+        }
+        update[i] = x;
+    }
+    return stop;
+}
+
+template <typename Key, typename Compare>
+typename BasicSkipList<Key, Compare>::Node* BasicSkipList<Key, Compare>::FindLT_(const Key* target) const {
+    Probe_ probe{nullptr, 0, false};
+    if (target) {
+        probe = MakeProbe_(*target);
+    }
+    Node* x = head_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (Node* next = target ? Before_(x->next[i], probe) : x->next[i].Get()) {
+            x = next;
+        }
+    }
+    return x == head_ ? nullptr : x;
+}
+
+// Clear implementation with thread safety
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::Clear() {
+    std::unique_lock<std::shared_mutex> lk(mu_);
+    ClearAll_();
+    for (Link& link : head_->next) {
+        link.Set(nullptr);
+    }
+
+    // Reset to initial state
+    size_ = 0;
+    level_ = 1;
+    max_level_ = kInitialMaxLevel;
+    epoch_ = SkipListNewEpoch();
+    common_prefix_.clear();
+}
+
+// Helper: delete all data nodes by traversing bottom level
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::ClearAll_() {
+    Node* x = head_->next[0].Get();
+    while (x) {
+        Node* next = x->next[0].Get();
+        delete x;
+        x = next;
+    }
+}
+
+// Generate random height using geometric distribution
+// The forced bit at max_level_ - 1 caps the count of trailing zeros
+template <typename Key, typename Compare>
+int BasicSkipList<Key, Compare>::RandomHeight_() const {
+    uint64_t word = SkipListRandomWord() | (uint64_t{1} << (max_level_ - 1));
+    return 1 + __builtin_ctzll(word);
+}
+
+// SkipList Iterator implementations
+// Values are replaced and nodes freed under the exclusive lock, so every step reads under the shared lock
+template <typename Key, typename Compare>
+std::string BasicSkipList<Key, Compare>::SkipListIterator::key(){
+    std::shared_lock<std::shared_mutex> lk(skiplist_->mu_);
+    return KeyCodec<Key>::Encode(current_->key);
+}
+
+template <typename Key, typename Compare>
+Key BasicSkipList<Key, Compare>::SkipListIterator::typed_key(){
+    std::shared_lock<std::shared_mutex> lk(skiplist_->mu_);
+    return current_->key;
+}
+
+template <typename Key, typename Compare>
+std::string BasicSkipList<Key, Compare>::SkipListIterator::value(){
+    std::shared_lock<std::shared_mutex> lk(skiplist_->mu_);
+    return current_->value;
+}
+
+template <typename Key, typename Compare>
+bool BasicSkipList<Key, Compare>::SkipListIterator::is_valid(){
+    return current_ != nullptr;
+}
+
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::SkipListIterator::next(){
+    std::shared_lock<std::shared_mutex> lk(skiplist_->mu_);
+    current_= current_->next[0].Get();
+}
+
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::SkipListIterator::seek(const std::string& target){
+    std::shared_lock<std::shared_mutex> lk(skiplist_->mu_);
+    Node* update[kMaxHeight];
+    bool truncated = false;
+    Key key = KeyCodec<Key>::Decode(target, &truncated);
+    current_ = skiplist_->FindGE_(key, update);
+    // The target continues past a matching key, so it sorts after it
+    if (truncated && current_ && skiplist_->Equal_(current_->key, key)) {
+        current_ = current_->next[0].Get();
+    }
+}
+
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::SkipListIterator::prev(){
+    std::shared_lock<std::shared_mutex> lk(skiplist_->mu_);
+    current_ = skiplist_->FindLT_(&current_->key);
+}
+
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::SkipListIterator::seek_for_prev(const std::string& target){
+    std::shared_lock<std::shared_mutex> lk(skiplist_->mu_);
+    Node* update[kMaxHeight];
+    bool truncated = false;
+    Key key = KeyCodec<Key>::Decode(target, &truncated);
+    Node* x = skiplist_->FindGE_(key, update);
+    // update[0] is already the last node < target. A zero-padded short target
+    // sorts before the matching key, so the key only counts if nothing was padded.
+    if (x && skiplist_->Equal_(x->key, key) && target.size() >= KeyCodec<Key>::kWidth) {
+        current_ = x;
+    } else {
+        current_ = update[0] == skiplist_->head_ ? nullptr : update[0];
+    }
+}
+
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::SkipListIterator::seek_to_last(){
+    std::shared_lock<std::shared_mutex> lk(skiplist_->mu_);
+    current_ = skiplist_->FindLT_(nullptr);
+}
+
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::SkipListIterator::seek_to_first(){
+    std::shared_lock<std::shared_mutex> lk(skiplist_->mu_);
+    current_ = skiplist_->head_->next[0].Get();
+}
+
+// Create iterator starting from first data node
+template <typename Key, typename Compare>
+typename BasicSkipList<Key, Compare>::SkipListIterator BasicSkipList<Key, Compare>::begin() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return SkipListIterator(const_cast<BasicSkipList*>(this), head_->next[0].Get());
+}
+
+template <typename Key, typename Compare>
+BasicSkipList<Key, Compare>::LookupCursor::LookupCursor(const BasicSkipList* list, Key key)
+    : list_(list), key_(std::move(key)), epoch_(0), x_(nullptr), level_(-1), links_pending_(false) {
+    std::shared_lock<std::shared_mutex> lk(list_->mu_);
+    Restart_();
+}
+
+template <typename Key, typename Compare>
+void BasicSkipList<Key, Compare>::LookupCursor::Restart_() {
+    epoch_ = list_->epoch_;
+    x_ = list_->head_;
+    level_ = list_->level_ - 1;
+    links_pending_ = false;
+}
+
+template <typename Key, typename Compare>
+bool BasicSkipList<Key, Compare>::LookupCursor::Step() {
+    std::shared_lock<std::shared_mutex> lk(list_->mu_);
+    if (epoch_ != list_->epoch_) {
+        Restart_();
+    }
+    if (links_pending_) {
+        // x_ was prefetched by the last step; now fetch its links
+        links_pending_ = false;
+        __builtin_prefetch(&x_->next[level_]);
+        return true;
+    }
+    // The probe is cheap to rebuild, and the common prefix may have shrunk since the last step
+    Probe_ probe = list_->MakeProbe_(key_);
+    while (level_ >= 0) {
+        if (Node* next = list_->Before_(x_->next[level_], probe)) {
+            // Moving on touches a node that is likely not cached: prefetch it and let others run
+            x_ = next;
+            __builtin_prefetch(x_);
+            links_pending_ = true;
+            return true;
+        }
+        // The lower links of x_ are already at hand
+        level_--;
+    }
+    return false;
+}
+
+template <typename Key, typename Compare>
+template <typename Fn>
+bool BasicSkipList<Key, Compare>::LookupCursor::Finish(Fn&& fn) {
+    while (Step()) {
+    }
+    std::shared_lock<std::shared_mutex> lk(list_->mu_);
+    if (epoch_ != list_->epoch_) {
+        // Nodes were freed after the last step; search again in one go
+        lk.unlock();
+        return list_->Find(key_, std::forward<Fn>(fn));
+    }
+    // Keys inserted after the last step may sit between x_ and the target
+    Probe_ probe = list_->MakeProbe_(key_);
+    Node* y = nullptr;
+    while (Node* next = list_->Before_(x_->next[0], probe, &y)) {
+        x_ = next;
+    }
+    if (!y || !list_->Equal_(y->key, key_)) return false;
+    fn(y->value);
+    return true;
+}
+
+// Create iterator starting from first node >= start_key (range scan)
+template <typename Key, typename Compare>
+typename BasicSkipList<Key, Compare>::SkipListIterator BasicSkipList<Key, Compare>::scan(
+    const Key& start_key) const {
+    // Find first node >= start_key
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    Node* update[kMaxHeight];
+    Node* start_node = FindGE_(start_key, update);
+
+    return SkipListIterator(const_cast<BasicSkipList*>(this), start_node);
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include "rate_limiter.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Alignment of offsets, lengths and buffers for O_DIRECT transfers
+constexpr size_t kDirectIoAlignment = 4096;
+
+// How a file opened through an Env transfers its data
+struct FileOptions {
+    // Bypass the page cache with O_DIRECT, for bulk background transfers that
+    // would otherwise evict what foreground reads need. The file stages
+    // transfers through aligned buffers, so callers need not align anything.
+    // Direct files use pread/pwrite in every Env.
+    bool use_direct_io = false;
+
+    // Every transfer first takes its bytes from this limiter at io_priority
+    std::shared_ptr<RateLimiter> rate_limiter;
+    IOPriority io_priority = IOPriority::kForeground;
+};
+
+// One read of a RandomAccessFile::MultiRead batch
+struct ReadRequest {
+    uint64_t offset = 0;
+    size_t len = 0;
+    // At least len bytes the result may be read into
+    char* scratch = nullptr;
+
+    // Filled in by MultiRead; shorter than len at end of file
+    std::string_view result;
+    bool ok = false;
+};
+
+// File read at arbitrary offsets, e.g. a table
+class RandomAccessFile {
+public:
+    virtual ~RandomAccessFile() {}
+
+    /**
+     * Read up to n bytes at offset into scratch
+     * @param result Set to the bytes read; shorter than n only at end of file
+     * @return false on an I/O error
+     */
+    virtual bool Read(uint64_t offset, size_t n, char* scratch, std::string_view* result) const = 0;
+
+    /**
+     * Read a batch of independent ranges. The default reads them one at a
+     * time; backends that can keep several reads in flight override it.
+     * @return false if any read failed (see each request's ok)
+     */
+    virtual bool MultiRead(ReadRequest* requests, size_t num_requests) const;
+};
+
+// File written sequentially, e.g. a log
+class WritableFile {
+public:
+    virtual ~WritableFile() {}
+
+    virtual bool Append(std::string_view data) = 0;
+    // Make everything appended so far durable
+    virtual bool Sync() = 0;
+    // Append then Sync; backends may submit both together
+    virtual bool AppendAndSync(std::string_view data);
+    virtual bool Close() = 0;
+
+    // Bytes appended so far, including what the file held when opened
+    virtual uint64_t Size() const = 0;
+};
+
+/**
+ * Filesystem access for the engine: every log append and table read goes
+ * through an Env, so the I/O backend can be swapped without touching the
+ * engine. Failures are reported as false / nullptr, as elsewhere in the
+ * engine. Implementations are thread-safe; the files they return are not.
+ */
+class Env {
+public:
+    virtual ~Env() {}
+
+    // Shared POSIX (pread/write/fdatasync) environment
+    static Env* Default();
+
+    // nullptr if path cannot be opened (or, with use_direct_io, the filesystem lacks O_DIRECT)
+    virtual std::unique_ptr<RandomAccessFile> NewRandomAccessFile(const std::string& path,
+                                                                  const FileOptions& options = FileOptions()) = 0;
+    // Creates or truncates path; nullptr on failure
+    virtual std::unique_ptr<WritableFile> NewWritableFile(const std::string& path,
+                                                          const FileOptions& options = FileOptions()) = 0;
+    // Creates path or continues at its end; nullptr on failure
+    virtual std::unique_ptr<WritableFile> NewAppendableFile(const std::string& path,
+                                                            const FileOptions& options = FileOptions()) = 0;
+
+    virtual bool FileExists(const std::string& path) = 0;
+    virtual bool GetFileSize(const std::string& path, uint64_t* size) = 0;
+    virtual bool GetChildren(const std::string& dir, std::vector<std::string>* names) = 0;
+    virtual bool DeleteFile(const std::string& path) = 0;
+    // Atomically replaces to if it exists
+    virtual bool RenameFile(const std::string& from, const std::string& to) = 0;
+    virtual bool CreateDirIfMissing(const std::string& dir) = 0;
+    // Make the directory entries (creates, renames) in dir durable
+    virtual bool SyncDir(const std::string& dir) = 0;
+};
+
+// Options for NewIoUringEnv
+struct IoUringEnvOptions {
+    // Submission queue entries, and the most reads one MultiRead keeps in flight
+    unsigned queue_depth = 64;
+
+    // Size of the buffer registered with the ring. Appends are staged through
+    // it and written with IORING_OP_WRITE_FIXED, so the kernel does not map
+    // the user pages on every write.
+    size_t registered_buffer_size = 1 << 20;
+};
+
+/**
+ * Env backed by one io_uring: MultiRead submits a whole batch with a single
+ * system call, and AppendAndSync links the write and the fdatasync so both
+ * go down in one submission. Directory operations are the POSIX ones. The
+ * ring is shared by all files of the Env and serialized by a mutex.
+ * @return nullptr if the kernel does not support io_uring
+ */
+std::unique_ptr<Env> NewIoUringEnv(const IoUringEnvOptions& options = IoUringEnvOptions());
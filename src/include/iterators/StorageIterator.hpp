@@ -1,7 +1,17 @@
 // Based on RocksDB cursor style iterator
 #pragma  once
+#include <cstdint>
 #include <string>
 
+// Kind of entry an iterator is positioned on
+enum class EntryType {
+    kValue,
+    // Tombstone; value() is empty
+    kDeletion,
+    // Operand for the merge operator, folded onto older entries on read
+    kMerge,
+};
+
 class StorageIterator { 
 public:
     StorageIterator() {}
@@ -15,4 +25,20 @@ public:
     virtual std::string value()= 0;
     virtual bool is_valid() = 0;
     virtual void next() = 0;
+
+    // Positioning and backward movement; every iterator supports them, so a
+    // merge or a reverse scan never silently stays put
+    // Move to the previous key (invalid when already at the first)
+    virtual void prev() = 0;
+    // Position at the first key >= target
+    virtual void seek(const std::string& target) = 0;
+    // Position at the last key <= target
+    virtual void seek_for_prev(const std::string& target) = 0;
+    virtual void seek_to_first() = 0;
+    virtual void seek_to_last() = 0;
+
+    // Iterators that cannot hold merge operands keep the empty-value tombstone convention
+    virtual EntryType entry_type() { return value().empty() ? EntryType::kDeletion : EntryType::kValue; }
+    // When the current value expires, in TtlClock::NowMicros() time (0 = never)
+    virtual uint64_t expire_at_micros() { return 0; }
 };
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#include "src/include/async.hpp"
+#include "src/include/iterators/lsm_iterator.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * Forward scan for coroutines running on an AsyncExecutor. next() is awaited
+ * and yields to the executor every kYieldInterval entries, so one long scan
+ * shares its thread with the other coroutines instead of holding it until
+ * the scan ends.
+ */
+class AsyncIterator {
+public:
+    static constexpr size_t kYieldInterval = 64;
+
+    AsyncIterator(AsyncExecutor* executor, std::unique_ptr<FusedIterator> inner);
+
+    bool is_valid();
+    std::string key();
+    std::string value();
+    Task<void> next();
+
+private:
+    AsyncExecutor* executor_;
+    std::unique_ptr<FusedIterator> inner_;
+    size_t steps_since_yield_;
+};
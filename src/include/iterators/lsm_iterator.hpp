@@ -1,28 +1,91 @@
 #pragma once
 #include "StorageIterator.hpp"
 #include "merge_iterator.hpp"
+#include "src/include/range_tombstone.hpp"
+#include "src/include/merge_operator.hpp"
+#include "src/include/clock.hpp"
+#include "src/include/comparator.hpp"
 #include <memory>
+#include <optional>
 #include <string>
 
+// What an LsmIterator applies on top of the merged memtables
+struct LsmIteratorOptions {
+    // Only yield keys starting with this (all keys when empty)
+    std::string prefix;
+    // Order of the merged memtables. Under any order but bytewise and its reverse,
+    // keys sharing a prefix need not be adjacent, so every key is visited.
+    const Comparator* comparator = BytewiseComparator();
+    // Fragmented against the merge children; null when there are none
+    std::shared_ptr<const FragmentedRangeTombstones> range_tombstones;
+    // Folds merge operands; without one they read as plain values
+    std::shared_ptr<const MergeOperator> merge_operator;
+    // Values that expire at or before this time are hidden (TtlClock::NowMicros() time)
+    uint64_t now_micros = 0;
+};
+
 /**
  * LSMIterator wraps a MergeIterator over memtables and filters out deleted keys.
+ * With a non-empty prefix it only yields keys starting with it: moving past the
+ * last (or before the first) such key leaves the iterator invalid. Under an
+ * order that scatters the prefix, other keys are stepped over instead.
+ * Range tombstones are fragmented against the merge children; a child whose
+ * current key falls in a fragment that hides it is moved past the whole
+ * fragment in one seek instead of key by key.
+ * A merge operand on top is folded with the older versions of its key down to
+ * the first value or deletion; keys that fold to an empty value are skipped.
+ * Expired values read as deletions.
  */
 class LsmIterator : public StorageIterator {
 public:
-    explicit LsmIterator(std::unique_ptr<MergeIterator> inner);
+    explicit LsmIterator(std::unique_ptr<MergeIterator> inner, LsmIteratorOptions options = LsmIteratorOptions());
     static std::unique_ptr<LsmIterator> create(std::unique_ptr<MergeIterator> merge_iter);
+    static std::unique_ptr<LsmIterator> create(std::unique_ptr<MergeIterator> merge_iter, LsmIteratorOptions options);
 
     std::string key() override;
     std::string value() override;
     bool is_valid() override;
     void next() override;
+    void prev() override;
+    void seek(const std::string& target) override;
+    void seek_for_prev(const std::string& target) override;
+    void seek_to_first() override;
+    void seek_to_last() override;
+    uint64_t expire_at_micros() override;
 
 private:
     std::unique_ptr<MergeIterator> LsmIteratorInner_;
+    std::string prefix_;
+    // Keys sharing prefix_ run from its largest to itself rather than the other way round
+    bool reversed_;
+    // Keys sharing prefix_ may be anywhere in the order, so none ends the scan
+    bool prefix_scattered_;
+    // Null when no merged memtable has range tombstones
+    std::shared_ptr<const FragmentedRangeTombstones> range_tombstones_;
+    std::shared_ptr<const MergeOperator> merge_operator_;
+    uint64_t now_micros_;
+    // Folded value of the current key when its newest entry is a merge operand
+    std::optional<std::string> merged_value_;
+    // Expiry of the value the operands were folded onto
+    uint64_t merged_expire_at_;
+    // Current entry is a tombstone or an expired value
+    bool is_deleted(EntryType type);
+    // Inner iterator is valid and on a key inside the prefix
+    bool in_bounds();
+    // Inner iterator's key starts with prefix_
+    bool in_prefix();
+    // Inner iterator on the bytewise-largest key starting with prefix_ (or past it)
+    void seek_to_prefix_end();
+    // Fragment deleting the current entry, or nullptr
+    const FragmentedRangeTombstones::Fragment* covering_fragment();
+    // Fold the current key's operands into merged_value_; false if it reads as deleted
+    bool fold_merge_operands();
     void skip_deleted_keys();
+    // Same, moving backwards
+    void skip_deleted_keys_backward();
 };
 
-class FusedIterator : StorageIterator {
+class FusedIterator : public StorageIterator {
 public:
     explicit FusedIterator(std::unique_ptr<StorageIterator> inner);
     static std::unique_ptr<FusedIterator> create(std::unique_ptr<StorageIterator> inner);
@@ -30,6 +93,11 @@ public:
     std::string value() override;
     bool is_valid() override;
     void next() override;
+    void prev() override;
+    void seek(const std::string& target) override;
+    void seek_for_prev(const std::string& target) override;
+    void seek_to_first() override;
+    void seek_to_last() override;
 
 private:
     bool has_errored_;
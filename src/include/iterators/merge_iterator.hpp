@@ -1,9 +1,11 @@
 #pragma once
 
 #include "StorageIterator.hpp"
+#include "src/include/comparator.hpp"
 #include <vector>
 #include <memory>
-#include <queue>
+#include <string>
+#include <utility>
 
 /**
  * HeapWrapper wraps an iterator with its index.
@@ -12,20 +14,20 @@
 struct HeapWrapper {
     size_t index;
     StorageIterator* iterator;
-    
-    HeapWrapper(size_t idx, StorageIterator* iter) 
+
+    HeapWrapper(size_t idx, StorageIterator* iter)
         : index(idx), iterator(iter) {}
-    
-    // For priority_queue: we want min-heap by key, with lower index winning ties
-    // operator< is reversed because priority_queue is a max-heap by default
+
+    // For a max-heap (std::push_heap) we want min-heap by key, with lower index winning ties
+    // operator< is reversed because the standard heap algorithms keep the largest on top
     bool operator<(const HeapWrapper& other) const {
         std::string my_key = iterator->key();
         std::string other_key = other.iterator->key();
-        
+
         if (my_key != other_key) {
             return my_key > other_key;
         }
-        
+
         // If keys equal, prefer lower index
         return index > other.index;
     }
@@ -33,28 +35,68 @@ struct HeapWrapper {
 
 /**
  * MergeIterator merges multiple iterators using a binary heap.
+ * Moving forward the heap yields the smallest key; after prev() or
+ * seek_for_prev() it flips to yielding the largest. Either way each key is
+ * produced once, taken from the lowest-index (newest) child that has it.
+ * Backward movement and seeks require children that implement them.
  */
 class MergeIterator : public StorageIterator {
 private:
-    std::priority_queue<HeapWrapper> heap_;
-    HeapWrapper* current_;
+    // Valid children arranged as a heap; the top is the current entry
+    std::vector<HeapWrapper> heap_;
+    bool forward_;
     std::vector<std::unique_ptr<StorageIterator>> owned_iters_;
+    const Comparator* comparator_;
 
 public:
     /**
      * Create a merge iterator from a vector of iterators.
      * Index 0 has the newest data.
+     * @param comparator The order every child yields its keys in
      */
-    static std::unique_ptr<MergeIterator> create(std::vector<std::unique_ptr<StorageIterator>> iterators);
-    
+    static std::unique_ptr<MergeIterator> create(std::vector<std::unique_ptr<StorageIterator>> iterators,
+                                                 const Comparator* comparator = BytewiseComparator());
+
     // StorageIterator interface
     std::string key() override;
-    std::string value() override; 
+    std::string value() override;
     bool is_valid() override;
     void next() override;
-    
-    ~MergeIterator() { delete current_; }
+    void prev() override;
+    void seek(const std::string& target) override;
+    void seek_for_prev(const std::string& target) override;
+    void seek_to_first() override;
+    void seek_to_last() override;
+    EntryType entry_type() override;
+    uint64_t expire_at_micros() override;
+
+    // Index of the child the current entry comes from
+    size_t current_index() const;
+
+    /**
+     * Every child positioned on the current key with its index, newest first;
+     * the first one is the current entry. Used to fold merge operands onto the
+     * older versions the merge would otherwise hide.
+     */
+    std::vector<std::pair<size_t, StorageIterator*>> current_versions();
+
+    /**
+     * Skip part of the key space in the older children only, e.g. a range
+     * deleted by a newer child. Moving forward, children from min_index on that
+     * sit before target jump to their first key >= target.
+     */
+    void seek_children(size_t min_index, const std::string& target);
+    // Moving backward, children from min_index on that sit at or after target
+    // jump to their last key < target
+    void seek_children_before(size_t min_index, const std::string& target);
 
 private:
-    MergeIterator() : current_(nullptr) {}
+    explicit MergeIterator(const Comparator* comparator) : forward_(true), comparator_(comparator) {}
+
+    // True when a should sit below b in the heap for the current direction
+    bool HeapLess_(const HeapWrapper& a, const HeapWrapper& b) const;
+    // Re-collect the valid children into a heap for the given direction
+    void RebuildHeap_(bool forward);
+    // Step every child on the current key one entry in the current direction
+    void AdvanceCurrent_();
 };
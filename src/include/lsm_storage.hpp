@@ -1,41 +1,312 @@
 #pragma once
+#include "env.hpp"
+#include "manifest.hpp"
 #include "mem_table.hpp"
+#include "pinnable_value.hpp"
 #include "src/include/iterators/lsm_iterator.hpp"
+#include "src/include/iterators/async_iterator.hpp"
+#include "write_batch.hpp"
+#include "write_buffer_manager.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 #include <mutex>
+#include <shared_mutex>
+
+// Options that each column family sets for itself
+struct ColumnFamilyOptions {
+    // Memtable size (in bytes) at which the active memtable is frozen
+    int target_sst_size = 2 * 1024 * 1024; // 2MB default (like Rust)
+
+    // Creates the ordered structure backing each memtable
+    std::shared_ptr<MemTableRepFactory> memtable_factory = std::make_shared<SkipListRepFactory>();
+
+    // Key order of the family: scans, range deletes and the memtables all follow it.
+    // Must outlive the storage; see Comparator for what scan_prefix needs of it.
+    const Comparator* comparator = BytewiseComparator();
+
+    // Build a hash index in each memtable for O(1) point lookups
+    bool enable_memtable_hash_index = false;
+
+    // Rewrite each frozen memtable into a flat sorted array (see MemTable::flatten)
+    bool flatten_immutable_memtables = true;
+
+    // Merge all immutable memtables into one once a freeze leaves this many
+    // (see LsmStorageInner::compact_imm_memtables); 0 disables
+    size_t imm_compaction_trigger = 0;
+
+    // Groups keys for the memtable prefix Bloom filters used by scan_prefix (none by default)
+    std::shared_ptr<const PrefixExtractor> prefix_extractor;
+
+    // Prefix Bloom filter size per memtable, as a fraction of target_sst_size
+    // in bytes; 0 disables the filters. Only used with a prefix_extractor.
+    double memtable_prefix_bloom_size_ratio = 0.1;
+
+    // Folds the operands written with merge(); merge() fails without one
+    std::shared_ptr<const MergeOperator> merge_operator;
+
+    // Sees every live value when a frozen memtable is flattened and when
+    // immutable memtables are compacted, and may drop or rewrite it
+    std::shared_ptr<const CompactionFilter> compaction_filter;
+
+    // Keep a CRC32C of key and value in every memtable entry to catch in-memory corruption
+    bool memtable_checksums = false;
+
+    // Check checksums on every read (memtable entries, and the records and blocks
+    // read back from files); a mismatch in a memtable entry aborts the process
+    bool verify_checksums = true;
+};
+
+// Options used to open the storage engine; the inherited fields configure the default column family
+struct LsmStorageOptions : ColumnFamilyOptions {
+    // Optional manager shared between Lsm instances to bound total memtable memory.
+    // Every column family of the instance charges its memtables to it.
+    std::shared_ptr<WriteBufferManager> write_buffer_manager;
+
+    // Time source for TTLs (SystemClock when null)
+    std::shared_ptr<const TtlClock> clock;
+
+    // Filesystem used for every log append and table read; must outlive the storage
+    Env* env = Env::Default();
+
+    // Open the files of background work (memtable write-out, compaction) with
+    // O_DIRECT so it does not evict what foreground reads rely on
+    bool use_direct_io_for_background_work = false;
+
+    // Token bucket for every file the instance opens (may be shared between
+    // instances); queued foreground transfers go before flushes, flushes before compactions
+    std::shared_ptr<RateLimiter> rate_limiter;
+
+    // With open(): once the manifest grows past this many bytes it is rewritten
+    // as a snapshot of the live tables, bounding what the next open replays
+    uint64_t max_manifest_file_size = 1 << 20;
+};
+
+// Options of a column family recorded in a database's manifest, for open()
+struct ColumnFamilyDescriptor {
+    std::string name;
+    ColumnFamilyOptions options;
+};
 
 // Represents the state of the storage engine
 class LsmStorageState {
 public:
     LsmStorageState();
+    explicit LsmStorageState(const MemTableOptions& memtable_options);
     ~LsmStorageState();
     
-    MemTable* memtable;
+    std::shared_ptr<MemTable> memtable;
     
-    std::vector<MemTable*> imm_memtables;
+    std::vector<std::shared_ptr<MemTable>> imm_memtables;
     
     static LsmStorageState create();
 };
 
+/**
+ * A named keyspace inside one LsmStorageInner, with its own active and
+ * immutable memtables and its own ColumnFamilyOptions. Families share the
+ * instance's state lock, write buffer manager and clock. Handles are owned by
+ * the LsmStorageInner and stay valid for its lifetime.
+ */
+class ColumnFamilyHandle {
+public:
+    const std::string& name() const;
+    uint32_t id() const;
+
+private:
+    friend class LsmStorageInner;
+
+    ColumnFamilyHandle(uint32_t id, const std::string& name, const ColumnFamilyOptions& options,
+                       const MemTableOptions& memtable_options);
+
+    uint32_t id_;
+    std::string name_;
+    MemTableOptions memtable_options_;
+
+    // Guarded by the owning LsmStorageInner's state_lock_
+    LsmStorageState state_;
+    // Union of the distinct-key sketches of every frozen memtable, merged on freeze
+    HyperLogLog imm_sketch_;
+
+    // Serializes compact_imm_memtables and table writes; the merge itself runs without state_lock_
+    std::mutex compaction_lock_;
+    // Set while imm_sketch_ lacks recovered tables that had no sketch in the manifest;
+    // the first approximate_distinct_keys reads their keys to fill it in
+    bool imm_sketch_stale_ = false;
+
+    int target_sst_size_;
+    bool flatten_immutable_memtables_;
+    size_t imm_compaction_trigger_;
+};
+
 // The storage interface of the LSM tree
 class LsmStorageInner {
 public:
+    static constexpr const char* kDefaultColumnFamilyName = "default";
+
     LsmStorageInner();
+    explicit LsmStorageInner(const LsmStorageOptions& options);
     ~LsmStorageInner();
-    
+
+    /**
+     * Open the database in directory path, creating it if missing. Every
+     * frozen memtable is written there as a table named by next_sst_id()
+     * and logged in the manifest, as are column families and the tables a
+     * compaction replaces; closing freezes and writes the active memtables.
+     * Nothing is logged before a freeze, so a crash loses the writes still
+     * in active memtables. On open the tables come back as frozen memtables
+     * that read their file on first access (see MemTable::create_lazy), so
+     * opening costs one manifest read whatever the number of tables.
+     * Failing to write a table or the manifest afterwards aborts the process.
+     * @param column_families Options of families in the manifest; the others use options
+     * @return nullptr if the directory or manifest cannot be read or written,
+     *         or a family's comparator differs from the one it was created with
+     */
+    static std::unique_ptr<LsmStorageInner> open(const std::string& path, const LsmStorageOptions& options,
+                                                 const std::vector<ColumnFamilyDescriptor>& column_families = {});
+
+    /**
+     * Add a column family. Its memtables are sized and built from options;
+     * memory and TTL settings come from the options the instance was opened with.
+     * @return nullptr if a family with this name already exists
+     */
+    ColumnFamilyHandle* create_column_family(const std::string& name, const ColumnFamilyOptions& options);
+    // nullptr if there is no family with this name
+    ColumnFamilyHandle* get_column_family(const std::string& name);
+    ColumnFamilyHandle* default_column_family();
+
+    // Operations without a ColumnFamilyHandle apply to the default column family
     std::optional<std::string> get(const std::string& key);
-    void put(const std::string& key, const std::string& value);
-    void delete_key(const std::string& key);
+    std::optional<std::string> get(ColumnFamilyHandle* cf, const std::string& key);
+    /**
+     * Point lookup without copying the value more than once. A value found
+     * in a frozen memtable is referenced in place, pinning that memtable
+     * until *value is reset or reused, so it stays valid across later writes
+     * and compactions. Others (the active memtable, merge results) are
+     * copied into value's buffer, whose capacity carries over between calls.
+     * @return false if the key is absent, or if a recovered table that may
+     *         hold it cannot be read (*value is reset)
+     */
+    bool get(const std::string& key, PinnableValue* value);
+    bool get(ColumnFamilyHandle* cf, const std::string& key, PinnableValue* value);
+
+    /**
+     * Coroutine versions of get and scan for callers on an AsyncExecutor.
+     * Where the synchronous calls would block on the state lock they yield to
+     * the executor until it is free, and memtable lookups yield between skip
+     * list steps after prefetching the next node, so many gets outstanding on
+     * one thread overlap their cache misses. A get searches the memtables as
+     * they were when it started; results otherwise match get() and scan().
+     * Reading in a recovered table runs on its own thread while the get yields.
+     * The storage must outlive the tasks.
+     */
+    Task<std::optional<std::string>> async_get(AsyncExecutor& executor, std::string key);
+    Task<bool> async_get(AsyncExecutor& executor, std::string key, PinnableValue* value);
+    Task<bool> async_get(AsyncExecutor& executor, ColumnFamilyHandle* cf, std::string key, PinnableValue* value);
+    Task<std::unique_ptr<AsyncIterator>> async_scan(AsyncExecutor& executor);
+    Task<std::unique_ptr<AsyncIterator>> async_scan(AsyncExecutor& executor, ColumnFamilyHandle* cf);
+
+    /**
+     * Point writes (and merge()) return false, writing nothing, if the
+     * family's memtable representation does not accept the key (see
+     * MemTableRep::AcceptsKey); with the default representations they always succeed.
+     */
+    bool put(const std::string& key, const std::string& value);
+    bool put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value);
+    /**
+     * Put a value that expires ttl from now. Expired values read as deleted and
+     * are dropped when their memtable is flattened or compacted, without a tombstone.
+     * @return false, writing nothing, if ttl is not positive (or the key is not accepted)
+     */
+    bool put(const std::string& key, const std::string& value, std::chrono::microseconds ttl);
+    bool put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value,
+             std::chrono::microseconds ttl);
+    bool delete_key(const std::string& key);
+    bool delete_key(ColumnFamilyHandle* cf, const std::string& key);
+
+    /**
+     * Apply operand to key's value with the merge operator as a blind write.
+     * Operands are folded when the key is read or the memtables are compacted.
+     * @return false if no merge operator is configured (or the key is not accepted)
+     */
+    bool merge(const std::string& key, const std::string& operand);
+    bool merge(ColumnFamilyHandle* cf, const std::string& key, const std::string& operand);
+
+    /**
+     * Delete every key in [begin, end) with a single range tombstone in the
+     * active memtable. The tombstone only hides older memtables, so keys the
+     * active memtable already holds in the range are overwritten with point
+     * tombstones; past 64 such keys it is frozen (and flushed) first instead.
+     */
+    void delete_range(const std::string& begin, const std::string& end);
+    void delete_range(ColumnFamilyHandle* cf, const std::string& begin, const std::string& end);
+
+    /**
+     * Apply every operation in batch, across any number of column families,
+     * as one unit: no get() and no iterator created afterwards observes only
+     * part of it. Iterators that are already open may. Batches are applied one
+     * at a time into pinned memtables, alongside other writers and freezes;
+     * only reads starting meanwhile wait for the batch. A batch with a range
+     * deletion takes state_lock_ exclusively instead, since it may freeze.
+     * @return false, applying nothing, if the batch merges into a family
+     *         without a merge operator, has a put whose ttl is not positive,
+     *         or writes a key its family does not accept
+     */
+    bool write(const WriteBatch& batch);
     
     std::unique_ptr<FusedIterator> scan();
+    std::unique_ptr<FusedIterator> scan(ColumnFamilyHandle* cf);
+    // Positioned at the last key, for walking backwards with prev()
+    std::unique_ptr<FusedIterator> reverse_scan();
+    // Positioned at the last key <= upper_bound, e.g. the newest N entries before a key
+    std::unique_ptr<FusedIterator> reverse_scan(const std::string& upper_bound);
+
+    /**
+     * Iterate only the keys starting with prefix, beginning at the first one.
+     * seek_to_last() / prev() walk the prefix backwards. Under a comparator
+     * other than the bytewise order or its reverse, the keys sharing a prefix
+     * need not be adjacent, so the scan visits every key. When prefix is exactly
+     * what the prefix extractor produces, memtables whose prefix Bloom filter
+     * rules it out are left out of the merge entirely.
+     */
+    std::unique_ptr<FusedIterator> scan_prefix(const std::string& prefix);
+    std::unique_ptr<FusedIterator> scan_prefix(ColumnFamilyHandle* cf, const std::string& prefix);
 
     // Force freeze the current memtable to an immutable memtable
     void force_freeze_memtable();
+    void force_freeze_memtable(ColumnFamilyHandle* cf);
+
+    /**
+     * Merge every immutable memtable into a single flat one, keeping only the
+     * newest version of each key. Nothing is stored below the immutable
+     * memtables, so point and range tombstones are applied and dropped.
+     * @return false if there was nothing to merge or a concurrent freeze
+     *         reshaped the list (the caller may simply try again later)
+     */
+    bool compact_imm_memtables();
+    bool compact_imm_memtables(ColumnFamilyHandle* cf);
+
+    // Approximate number of distinct keys across all memtables (tombstones included)
+    size_t approximate_distinct_keys();
+    // Entries physically stored across all memtables; each memtable keeps one per key
+    size_t num_entries();
+    size_t num_entries(ColumnFamilyHandle* cf);
+
+    // Size of the largest active memtable across all column families
+    int largest_memtable_size();
+    // Freeze that memtable (used by the write buffer manager)
+    void freeze_largest_memtable();
+
+    // How the engine opens a file for work at priority: through the instance's
+    // rate limiter, and with O_DIRECT for flushes and compactions if configured
+    FileOptions file_options_for(IOPriority priority) const;
     
-    // Test accessors
+    // Test accessors (default column family)
     int get_imm_memtables_count() const;
     int get_imm_memtable_size(int index) const;
     void set_target_sst_size(int size);
@@ -44,35 +315,162 @@ public:
     
 
 private:
-    LsmStorageState state_;
-    
-    // State lock for synchronizing state modifications
-    std::mutex state_lock_;
+    // Declared before column_families_ so it outlives the memtables charged to it
+    std::shared_ptr<WriteBufferManager> write_buffer_manager_;
+    std::shared_ptr<const TtlClock> clock_;
+    Env* env_;
+    bool use_direct_io_for_background_work_;
+    std::shared_ptr<RateLimiter> rate_limiter_;
+    // Database directory and its manifest; null for an in-memory instance
+    std::string path_;
+    std::unique_ptr<Manifest> manifest_;
+
+    // Index 0 is the default family; families are never removed, so handles stay valid
+    std::vector<std::unique_ptr<ColumnFamilyHandle>> column_families_;
+    ColumnFamilyHandle* default_cf_;
     
-    // Configuration
-    int target_sst_size_;
+    // Guards column_families_ and every family's state_: shared for reads and
+    // for pinning an active memtable, exclusive for swapping memtables in or out
+    std::shared_mutex state_lock_;
+
+    // Serializes write(batch)
+    std::mutex batch_write_lock_;
+    // Batches begun and finished; reads wait until every batch begun before them is done
+    std::atomic<uint64_t> batches_started_;
+    std::atomic<uint64_t> batches_done_;
+    std::mutex batch_done_lock_;
+    std::condition_variable batch_done_cv_;
+
     int next_sst_id_;
     
     // Helper to get next SST ID
     int next_sst_id();
+
+    MemTableOptions memtable_options_for(const ColumnFamilyOptions& options) const;
     
     // Helper to check if memtable should be frozen
-    bool try_freeze(int estimated_size);
+    bool try_freeze(ColumnFamilyHandle* cf, int estimated_size);
+
+    // What a point lookup has collected so far, newest memtable first
+    struct GetState {
+        std::vector<std::string> operands;
+        // Set once an entry other than a merge operand is found; the value then holds it
+        std::optional<EntryType> found;
+        uint64_t expire_at = 0;
+        // A recovered table the lookup needed could not be read
+        bool failed = false;
+    };
+
+    /**
+     * Record one memtable's answer to a point lookup
+     * @param hit Whether the memtable had an entry; *value holds it
+     * @return true once nothing older can affect the result
+     */
+    static bool add_get_result(const MemTable& memtable, const std::string& key, bool hit, EntryType type,
+                               const PinnableValue& value, GetState* state);
+
+    // Resolve the collected entries (expiry, merges, tombstones) into *value
+    bool finish_get(ColumnFamilyHandle* cf, GetState* state, PinnableValue* value);
+
+    // Merge iterator over every memtable of cf; caller holds state_lock_
+    std::unique_ptr<FusedIterator> scan_locked(ColumnFamilyHandle* cf);
+
+    // Move the active memtable to imm_memtables; caller holds state_lock_
+    std::shared_ptr<MemTable> freeze_memtable_locked(ColumnFamilyHandle* cf);
+
+    // Block until no write(batch) that began before this call is still being applied
+    void wait_for_batches();
+    // wait_for_batches that yields to executor instead of blocking
+    Task<void> async_wait_for_batches(AsyncExecutor& executor);
+
+    /**
+     * Range tombstone into the active memtable, shadowing its live keys in the
+     * range with point tombstones or, past kMaxInPlaceRangeDeleteKeys of them,
+     * freezing it first. Caller holds state_lock_ exclusively.
+     * @return the memtable frozen, for after_freeze once the lock is released
+     */
+    std::shared_ptr<MemTable> delete_range_locked(ColumnFamilyHandle* cf, const std::string& begin,
+                                                  const std::string& end);
+
+    // Pin the active memtable, insert without state_lock_, then maybe freeze; false if the key was refused
+    bool write_to_memtable(ColumnFamilyHandle* cf, const std::string& key, const std::string& value,
+                           EntryType type, uint64_t expire_at_micros = 0);
+
+    // Drain writers from a frozen memtable, then flatten or compact; called without state_lock_
+    void after_freeze(ColumnFamilyHandle* cf, const std::shared_ptr<MemTable>& frozen);
+
+    // Replace a frozen memtable with its flattened copy; called without state_lock_
+    void flatten_imm_memtable(ColumnFamilyHandle* cf, const std::shared_ptr<MemTable>& frozen);
+
+    // Freeze the largest memtable across instances if the shared budget is exceeded
+    void enforce_write_buffer_limit();
+
+    // Write a frozen memtable to its table file at priority; fills everything in meta
+    void write_table(ColumnFamilyHandle* cf, MemTable* memtable, IOPriority priority, TableMeta* meta);
+    // Write the frozen memtable with this id as a table and log it, unless a compaction took it
+    void persist_imm_memtable(ColumnFamilyHandle* cf, int id);
+    // Log edit or abort; a storage that cannot record its tables must not go on writing them
+    void log_manifest_edit(const ManifestEdit& edit);
 };
 
 // Thin wrapper for LsmStorageInner and the user interface
 class Lsm {
 public:
     Lsm();
+    explicit Lsm(const LsmStorageOptions& options);
     ~Lsm();
+
+    // Persistent instance in directory path (see LsmStorageInner::open); nullptr on failure
+    static std::unique_ptr<Lsm> open(const std::string& path, const LsmStorageOptions& options = LsmStorageOptions(),
+                                     const std::vector<ColumnFamilyDescriptor>& column_families = {});
     
 
     std::unique_ptr<FusedIterator> scan();
+    // Positioned at the last key, for walking backwards with prev()
+    std::unique_ptr<FusedIterator> reverse_scan();
+    // Positioned at the last key <= upper_bound, e.g. the newest N entries before a key
+    std::unique_ptr<FusedIterator> reverse_scan(const std::string& upper_bound);
+    std::unique_ptr<FusedIterator> scan_prefix(const std::string& prefix);
     
     std::optional<std::string> get(const std::string& key);
-    void put(const std::string& key, const std::string& value);
-    void delete_key(const std::string& key);
+    // Reads into a reusable PinnableValue (see LsmStorageInner::get)
+    bool get(const std::string& key, PinnableValue* value);
+    // Coroutine API (see LsmStorageInner::async_get)
+    Task<std::optional<std::string>> async_get(AsyncExecutor& executor, std::string key);
+    Task<bool> async_get(AsyncExecutor& executor, std::string key, PinnableValue* value);
+    Task<std::unique_ptr<AsyncIterator>> async_scan(AsyncExecutor& executor);
+    bool put(const std::string& key, const std::string& value);
+    bool put(const std::string& key, const std::string& value, std::chrono::microseconds ttl);
+    bool delete_key(const std::string& key);
+    bool merge(const std::string& key, const std::string& operand);
+    void delete_range(const std::string& begin, const std::string& end);
+
+    // Column families (see LsmStorageInner::create_column_family)
+    ColumnFamilyHandle* create_column_family(const std::string& name, const ColumnFamilyOptions& options);
+    ColumnFamilyHandle* get_column_family(const std::string& name);
+    std::optional<std::string> get(ColumnFamilyHandle* cf, const std::string& key);
+    bool get(ColumnFamilyHandle* cf, const std::string& key, PinnableValue* value);
+    bool put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value);
+    bool put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value,
+             std::chrono::microseconds ttl);
+    bool delete_key(ColumnFamilyHandle* cf, const std::string& key);
+    bool merge(ColumnFamilyHandle* cf, const std::string& key, const std::string& operand);
+    void delete_range(ColumnFamilyHandle* cf, const std::string& begin, const std::string& end);
+    std::unique_ptr<FusedIterator> scan(ColumnFamilyHandle* cf);
+    std::unique_ptr<FusedIterator> scan_prefix(ColumnFamilyHandle* cf, const std::string& prefix);
+    // Atomic across column families (see LsmStorageInner::write)
+    bool write(const WriteBatch& batch);
+
+    // Estimated distinct keys without a full scan(); compare with num_entries()
+    // to see how much merging the memtables would shrink them
+    size_t approximate_distinct_keys();
+    size_t num_entries();
+
+    // Merge the immutable memtables into one (see LsmStorageInner::compact_imm_memtables)
+    bool compact_imm_memtables();
 
 private:
+    explicit Lsm(LsmStorageInner* inner);
+
     LsmStorageInner* inner_;
 };
\ No newline at end of file
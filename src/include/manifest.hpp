@@ -0,0 +1,81 @@
+#pragma once
+#include "env.hpp"
+#include "table.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One change to the set of column families and tables, logged atomically
+struct ManifestEdit {
+    struct ColumnFamily {
+        uint32_t id;
+        std::string name;
+        // Comparator::Name() of the family; reopening with another comparator fails
+        std::string comparator;
+    };
+
+    std::vector<ColumnFamily> column_families;
+    std::vector<TableMeta> new_tables;
+    std::vector<uint64_t> deleted_tables;
+    // Lowest table id not handed out yet (0 leaves it unchanged)
+    uint64_t next_table_id = 0;
+};
+
+/**
+ * Append-only log of the edits to a database directory's column families
+ * and tables. CURRENT names the live MANIFEST-<n> file, each of whose
+ * records is an edit. Opening replays the log, then starts a new manifest
+ * holding a single snapshot of the result; the same happens whenever the
+ * manifest grows past max_file_size, so the work of opening stays bounded
+ * however long the database has been running. Thread-safe.
+ */
+class Manifest {
+public:
+    /**
+     * Recover the state of the database in dir (empty if dir has no CURRENT
+     * file) and start a fresh manifest with a snapshot of it. Table files the
+     * state does not list, left by a crash between writing a table and
+     * logging it, are deleted, as are old manifests.
+     * @param options How the manifest files are opened
+     * @return nullptr if the manifest is corrupt or cannot be written
+     */
+    static std::unique_ptr<Manifest> Open(Env* env, const std::string& dir, uint64_t max_file_size,
+                                          const FileOptions& options = FileOptions());
+
+    std::vector<ManifestEdit::ColumnFamily> column_families() const;
+    // Live tables in id order
+    std::vector<TableMeta> tables() const;
+    uint64_t next_table_id() const;
+    // Size of the manifest file being appended to
+    uint64_t file_size() const;
+
+    /**
+     * Append edit, make it durable and apply it. Deleting a table the
+     * manifest does not list is allowed and does nothing.
+     * @return false on an I/O error; the edit is then not applied
+     */
+    bool LogAndApply(const ManifestEdit& edit);
+
+private:
+    Manifest(Env* env, const std::string& dir, uint64_t max_file_size, const FileOptions& options);
+
+    void Apply_(const ManifestEdit& edit);
+    // Write the state to a new manifest and point CURRENT at it; caller holds mu_
+    bool WriteSnapshot_();
+    std::string ManifestFileName_(uint64_t number) const;
+
+    Env* env_;
+    std::string dir_;
+    uint64_t max_file_size_;
+    FileOptions options_;
+
+    mutable std::mutex mu_;
+    std::map<uint32_t, ManifestEdit::ColumnFamily> column_families_;
+    std::map<uint64_t, TableMeta> tables_;
+    uint64_t next_table_id_;
+    uint64_t number_;
+    std::unique_ptr<WritableFile> file_;
+};
@@ -1,35 +1,237 @@
+#pragma once
 #include "src/include/iterators/StorageIterator.hpp"
-#include "src/include/data_structures/skiplist.hpp"
+#include "src/include/memtable_rep.hpp"
+#include "src/include/data_structures/hashtable.hpp"
+#include "src/include/data_structures/hyperloglog.hpp"
+#include "src/include/data_structures/bloom_filter.hpp"
+#include "src/include/prefix_extractor.hpp"
+#include "src/include/range_tombstone.hpp"
+#include "src/include/merge_operator.hpp"
+#include "src/include/compaction_filter.hpp"
+#include "src/include/clock.hpp"
+#include "src/include/async.hpp"
+#include "src/include/pinnable_value.hpp"
 #include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <memory>
 
-class MemTable {
+class WriteBufferManager;
+struct TableMeta;
+
+// Per-memtable configuration, derived from LsmStorageOptions
+struct MemTableOptions {
+    // Creates the ordered structure backing the memtable (skip list when null)
+    std::shared_ptr<MemTableRepFactory> rep_factory;
+
+    // Order of the keys in the rep and of range tombstone bounds
+    const Comparator* comparator = BytewiseComparator();
+
+    // Memtable memory is charged to this manager when set
+    WriteBufferManager* write_buffer_manager = nullptr;
+
+    // Keep a hash index next to the ordered rep so point lookups are O(1). It holds
+    // a second copy of every entry, counted by memory_usage() and the write
+    // buffer charge but not by Size().
+    bool enable_hash_index = false;
+
+    // Groups keys for the prefix Bloom filter
+    std::shared_ptr<const PrefixExtractor> prefix_extractor;
+
+    // Bits in the prefix Bloom filter; 0 (or no prefix_extractor) disables it
+    size_t prefix_bloom_bits = 0;
+
+    // Combines operands written with MemTable::merge; merge() fails without one
+    std::shared_ptr<const MergeOperator> merge_operator;
+
+    // Applied to the values of a frozen memtable when it is flattened, and by create_flat
+    std::shared_ptr<const CompactionFilter> compaction_filter;
+
+    // Decides which entries have expired; without one nothing expires
+    std::shared_ptr<const TtlClock> clock;
+
+    // Store a CRC32C of key and value with each entry (4 bytes per entry)
+    bool protect_entries = false;
+
+    // With protect_entries, check the CRC on every read; a mismatch, or an
+    // entry that lost its protection, aborts the process
+    bool verify_checksums = true;
+};
+
+class MemTable : public std::enable_shared_from_this<MemTable> {
 public:
     MemTable();
+    explicit MemTable(const MemTableOptions& options);
     ~MemTable();
 
+    // Table id the storage gave the memtable when it was frozen (0 before)
     int Id();
+    void set_id(int id);
+    // Position among the column family's tables, newer is larger: the id for a
+    // frozen memtable, the newest input's for a compacted one. Kept across reopens.
+    int sequence();
+    void set_sequence(int sequence);
     int Size();
+    // Number of distinct keys stored (tombstones included). A rep that only
+    // finds overwrites when frozen (the vector rep) counts every write until then.
+    int num_entries();
+    // Bytes held by the underlying representation and the hash index, if any
+    size_t memory_usage();
     bool isEmpty();
     void Clear();
 
+    // A key's entry in this memtable
+    struct Entry {
+        EntryType type;
+        // Empty for a deletion
+        std::string value;
+        // Expiry time of a value in TtlClock::NowMicros() time (0 = never)
+        uint64_t expire_at = 0;
+    };
+
+    // Value stored for key; empty for a tombstone. Merge operands come back as
+    // they are, so callers that allow merges use get_entry instead.
     std::optional<std::string> get(std::string key);
-    bool put(std::string key, std::string value);
+    std::optional<Entry> get_entry(const std::string& key);
+    /**
+     * get_entry without copying the value out of a frozen memtable: *value
+     * pins this memtable and refers to the stored bytes when the rep lends
+     * them out, otherwise it receives one copy in its reusable buffer.
+     * @param type Receives the entry type; *value holds the value or merge operand
+     * @param expire_at Optional, receives the expiry of a value (0 = never)
+     * @return false if key has no entry in this memtable (*value is reset)
+     */
+    bool get_entry(const std::string& key, PinnableValue* value, EntryType* type, uint64_t* expire_at = nullptr);
+    /**
+     * Read in the entries a lookup of key needs, for a memtable recovered
+     * from a table (see create_lazy); blocks on the read
+     * @return false if the table cannot be read, in which case get_entry finds nothing
+     */
+    bool load_for(const std::string& key);
+    // load_for that reads on another thread, yielding to executor until it is done
+    Task<bool> async_load_for(AsyncExecutor& executor, std::string key);
+    // get_entry that yields to executor between the steps of the rep's search
+    // (and while a recovered table is read, see async_load_for)
+    Task<bool> async_get_entry(AsyncExecutor& executor, std::string key, PinnableValue* value, EntryType* type,
+                               uint64_t* expire_at = nullptr);
+    /**
+     * An empty value writes a tombstone; a non-zero expire_at_micros makes the value expire.
+     * @return false, writing nothing, if the representation does not accept key
+     */
+    bool put(std::string key, std::string value, uint64_t expire_at_micros = 0);
+    // Whether the representation can store key (see MemTableRep::AcceptsKey)
+    bool accepts_key(const std::string& key) const;
+
+    /**
+     * Record a merge operand for key. It is combined right away with an entry
+     * for key already in this memtable (folded onto a value, or merged with an
+     * earlier operand), so each memtable still holds one entry per key.
+     * @return false if no merge operator is configured or key is not accepted
+     */
+    bool merge(std::string key, std::string operand);
+
+    /**
+     * Record a range tombstone for [begin, end). It hides keys in older
+     * memtables only: entries of this memtable win over its own tombstones,
+     * whether they were put before or after. Overlapping and adjacent ranges
+     * are merged as they arrive, so a call costs O(log n) in the ranges held.
+     */
+    void delete_range(const std::string& begin, const std::string& end);
+    // True if one of this memtable's range tombstones covers key
+    bool is_range_deleted(const std::string& key) const;
+    // Snapshot of the (merged, sorted) range tombstones; null when there are none
+    std::shared_ptr<const std::vector<RangeTombstone>> range_tombstones() const;
+
+    // Called once the memtable is frozen; it no longer counts as active memory.
+    // Size() and num_entries() drop any overwrites the rep only now removed.
+    void mark_immutable();
+    bool is_immutable() const;
+
+    // Writers pin the memtable around put() so a freeze can wait for them to finish
+    void ref_writer();
+    void unref_writer();
+    // Block until every pinned writer has called unref_writer()
+    void wait_for_writers() const;
+
+    // Copy of the distinct-key sketch maintained on put (built from the entries of a lazy memtable)
+    HyperLogLog distinct_keys_sketch() const;
+
+    /**
+     * Check the prefix Bloom filter
+     * @param prefix A prefix produced by the memtable's prefix extractor
+     * @return false only if no key with this prefix was ever put (always true without a filter)
+     */
+    bool may_contain_prefix(const std::string& prefix) const;
+
+    /**
+     * Build an immutable copy of this (frozen) memtable backed by a flat sorted
+     * array instead of the original rep. The copy takes over the size, sketch,
+     * range tombstones and write-buffer accounting; this memtable can be
+     * dropped afterwards. Expired values and values the compaction filter
+     * removes become tombstones in the copy.
+     */
+    std::shared_ptr<MemTable> flatten();
+
+    /**
+     * Build an immutable, flat memtable from a sorted stream holding one entry
+     * per key, such as a merge of several frozen memtables. Its size and sketch
+     * are computed from the entries and charged to options.write_buffer_manager
+     * as frozen memory. Deletions, expired values and values removed by
+     * options.compaction_filter are left out.
+     */
+    static std::shared_ptr<MemTable> create_flat(StorageIterator* iter, const MemTableOptions& options);
+
+    /**
+     * Build an immutable, flat memtable for a table described by meta whose
+     * entries are only read, through load, the first time a lookup or an
+     * iterator needs them. Point lookups outside [meta.smallest, meta.largest]
+     * are answered without loading; size, entry count, range tombstones and
+     * (when recorded) the distinct-key sketch come from meta. load returns
+     * the entries in key order, one per key, tombstones included, or null if
+     * the table cannot be read (see load_for; an iterator that needs the
+     * entries then aborts).
+     * Recovered memtables have no prefix Bloom filter or hash index.
+     */
+    static std::shared_ptr<MemTable> create_lazy(const TableMeta& meta,
+                                                 std::function<std::unique_ptr<StorageIterator>()> load,
+                                                 const MemTableOptions& options);
 
     class MemTableIterator : public StorageIterator {
     public:
         MemTableIterator();
-        MemTableIterator(SkipList::Node* current);
+        // owner keeps the memtable alive while the iterator exists (may be null)
+        MemTableIterator(std::unique_ptr<MemTableRep::Iterator> rep_iter,
+                         std::shared_ptr<const MemTable> owner, bool verify_checksums = false);
 
         std::string key() override;
         std::string value() override;
         bool is_valid() override;
         void next() override;
+        void prev() override;
+        void seek(const std::string& target) override;
+        void seek_for_prev(const std::string& target) override;
+        void seek_to_first() override;
+        void seek_to_last() override;
+        EntryType entry_type() override;
+        uint64_t expire_at_micros() override;
 
     private:
-        SkipList::Node* current_node_;
+        std::shared_ptr<const MemTable> owner_;
+        std::unique_ptr<MemTableRep::Iterator> rep_iter_;
+        bool verify_checksums_ = false;
+
+        // The current entry, decoded (and verified) at most once per position
+        bool decoded_ = false;
+        std::string value_;
+        EntryType type_ = EntryType::kDeletion;
+        uint64_t expire_at_ = 0;
+
+        // Decode the current entry into the fields above unless already done
+        void decode();
     };
 
     MemTableIterator begin() const;
@@ -38,9 +240,64 @@ public:
     std::unique_ptr<MemTableIterator> begin_ptr() const;
     std::unique_ptr<MemTableIterator> scan_ptr(const std::string& lower_bound, const std::string& upper_bound) const;
 private:
-    SkipList map_;
+    // With sketch_pending the sketch is left minimal until distinct_keys_sketch() builds it
+    MemTable(const MemTableOptions& options, std::unique_ptr<MemTableRep> rep, bool sketch_pending = false);
+
+    // Point value at stored (pinning this memtable if stored is not its buffer) and strip the tag
+    void settle_entry(const std::string& key, std::string_view stored, PinnableValue* value, EntryType* type,
+                      uint64_t* expire_at);
+    // Insert an already encoded entry (adding its checksum) and update size, charge, sketch and filter
+    void insert_stored(const std::string& key, std::string stored);
+    std::mutex& merge_lock_for(const std::string& key);
+    // Merge [begin, end) into range_tombstones_; caller holds range_tombstone_lock_
+    void add_range_tombstone_locked(std::string begin, std::string end);
+    uint64_t now_micros() const;
+
+    std::unique_ptr<MemTableRep> rep_;
+    // Optional point-lookup index; ordered iteration always comes from rep_
+    std::unique_ptr<HashTable> hash_index_;
     int id_;
+    int sequence_;
     std::atomic<int> approximatesize_;
+
+    WriteBufferManager* write_buffer_manager_;
+    // Bytes reserved with write_buffer_manager_, released on destruction
+    std::atomic<size_t> charged_bytes_;
+    std::atomic<bool> immutable_;
+    std::atomic<int> active_writers_;
+    // Only used with hash_index_, so the rep and the index agree on the latest value
+    std::mutex index_write_lock_;
+
+    // Puts raise sketch_'s registers with atomic max; the lock only covers building a pending sketch
+    mutable std::mutex sketch_lock_;
+    mutable HyperLogLog sketch_;
+    // Set for lazily loaded memtables until the sketch is first built from the entries
+    mutable bool sketch_pending_;
+
+    std::shared_ptr<const PrefixExtractor> prefix_extractor_;
+    // Shared with flattened copies, which never add to it
+    std::shared_ptr<BloomFilter> prefix_bloom_;
+
+    // Every tombstone of a memtable hides the same older data, so they are kept
+    // merged: disjoint [begin, end) ranges keyed by begin, in comparator order
+    mutable std::mutex range_tombstone_lock_;
+    std::map<std::string, std::string, ComparatorLess> range_tombstones_;
+    // Lets lookups in memtables without range tombstones skip the lock
+    std::atomic<bool> has_range_tombstones_;
+    // Built by range_tombstones() and kept until the next delete_range
+    mutable std::shared_ptr<const std::vector<RangeTombstone>> range_tombstone_snapshot_;
+
+    const Comparator* comparator_;
+    std::shared_ptr<const MergeOperator> merge_operator_;
+    std::shared_ptr<const CompactionFilter> compaction_filter_;
+    std::shared_ptr<const TtlClock> clock_;
+    bool protect_entries_;
+    // Only set together with protect_entries_
+    bool verify_checksums_;
+    // With a merge operator, put and merge lock the key's stripe: merge reads
+    // the entry it replaces, and a put landing in between would be lost
+    static constexpr size_t kMergeLockStripes = 16;
+    std::mutex merge_locks_[kMergeLockStripes];
 //  WriteAheadLog log;
 
 };
@@ -0,0 +1,187 @@
+// Based on RocksDB's MemTableRep / MemTableRepFactory
+#pragma once
+#include "src/include/iterators/StorageIterator.hpp"
+#include "src/include/comparator.hpp"
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * MemTableRep is the ordered key-value structure a MemTable stores its data in.
+ * Implementations must allow concurrent readers alongside a writer; once
+ * MarkReadOnly() has been called no more inserts arrive.
+ */
+class MemTableRep {
+public:
+    /**
+     * Ordered cursor over a representation
+     */
+    class Iterator : public StorageIterator {};
+
+    MemTableRep() {}
+    MemTableRep(const MemTableRep&) = delete;
+    void operator=(const MemTableRep&) = delete;
+    virtual ~MemTableRep() {}
+
+    /**
+     * Whether Insert can store key. The memtable refuses writes of keys a
+     * representation cannot hold (e.g. the wrong width for a fixed-key skip list).
+     */
+    virtual bool AcceptsKey(const std::string& key) const {
+        (void)key;
+        return true;
+    }
+
+    /**
+     * Insert or overwrite a key that AcceptsKey. Never called once the memtable is frozen;
+     * representations built read-only (BuildFlatMemTableRep) abort.
+     * @return size of the value that was replaced, or std::nullopt if the key was new
+     *         (or the representation does not look for duplicates on insert)
+     */
+    virtual std::optional<size_t> Insert(const std::string& key, const std::string& value) = 0;
+
+    /**
+     * Latest value for key, std::nullopt if absent
+     */
+    virtual std::optional<std::string> Get(const std::string& key) const = 0;
+
+    /**
+     * Latest value for key without an intermediate copy. *value points either
+     * into the representation, valid for as long as it lives (offered only
+     * where nothing can replace the value, e.g. after MarkReadOnly()), or at
+     * *buffer, which receives a copy and keeps its capacity across calls.
+     * @return false if key is absent
+     */
+    virtual bool GetInto(const std::string& key, std::string* buffer, std::string_view* value) const;
+
+    /**
+     * A point lookup driven one step at a time (see NewLookup)
+     */
+    class Lookup {
+    public:
+        virtual ~Lookup() {}
+        // Do one step of the search; false once it is complete
+        virtual bool Advance() = 0;
+        // Finish the search; same contract as MemTableRep::GetInto
+        virtual bool GetInto(std::string* buffer, std::string_view* value) = 0;
+    };
+
+    /**
+     * Lookup of key that the caller advances step by step, running other
+     * work between steps while the memory the next one reads is prefetched.
+     * The default has no steps and searches in GetInto. The representation
+     * must outlive the lookup.
+     */
+    virtual std::unique_ptr<Lookup> NewLookup(const std::string& key) const;
+
+    /**
+     * Whether a lookup of key would first have to read the entries in (see
+     * Load). Only representations recovered from a file start out unloaded.
+     */
+    virtual bool NeedsLoad(const std::string& key) const {
+        (void)key;
+        return false;
+    }
+
+    /**
+     * Read the entries in, blocking on I/O; safe to call from several threads
+     * @return false if they cannot be read: lookups then find nothing (and a
+     *         later one tries again), and iterators abort
+     */
+    virtual bool Load() const { return true; }
+
+    // Number of entries currently stored
+    virtual int NumEntries() const = 0;
+
+    // Approximate bytes held by the representation, including structural overhead
+    virtual size_t ApproximateMemoryUsage() const = 0;
+
+    // Called when the owning memtable is frozen
+    virtual void MarkReadOnly() {}
+
+    // Iterator positioned at the first key
+    virtual std::unique_ptr<Iterator> NewIterator() const = 0;
+};
+
+/**
+ * Creates one representation per memtable; shared through LsmStorageOptions
+ */
+class MemTableRepFactory {
+public:
+    virtual ~MemTableRepFactory() {}
+    // The representation keeps its keys in comparator order
+    virtual std::unique_ptr<MemTableRep> CreateMemTableRep(
+        const Comparator* comparator = BytewiseComparator()) const = 0;
+    virtual const char* Name() const = 0;
+};
+
+// Default: probabilistic skip list with a reader-writer lock
+class SkipListRepFactory : public MemTableRepFactory {
+public:
+    std::unique_ptr<MemTableRep> CreateMemTableRep(
+        const Comparator* comparator = BytewiseComparator()) const override;
+    const char* Name() const override { return "SkipListRepFactory"; }
+};
+
+/**
+ * Skip list whose nodes hold fixed-width keys inline as integers: 8-byte keys
+ * as a big-endian uint64_t, 16-byte keys (UUIDs) as a Uuid. Keys of any other
+ * length are not accepted, so writing one fails. Other key_size values, or a
+ * non-bytewise comparator, fall back to the plain skip list.
+ */
+class FixedKeySkipListRepFactory : public MemTableRepFactory {
+public:
+    explicit FixedKeySkipListRepFactory(size_t key_size) : key_size_(key_size) {}
+    std::unique_ptr<MemTableRep> CreateMemTableRep(
+        const Comparator* comparator = BytewiseComparator()) const override;
+    const char* Name() const override { return "FixedKeySkipListRepFactory"; }
+
+private:
+    size_t key_size_;
+};
+
+/**
+ * Cache-conscious B+tree with optimistic lock coupling. Its nodes search on
+ * bytewise key prefixes, so other comparators get the skip list instead.
+ */
+class BTreeRepFactory : public MemTableRepFactory {
+public:
+    std::unique_ptr<MemTableRep> CreateMemTableRep(
+        const Comparator* comparator = BytewiseComparator()) const override;
+    const char* Name() const override { return "BTreeRepFactory"; }
+};
+
+/**
+ * Unsorted append-only vector, sorted once when the memtable is frozen.
+ * Inserts are O(1) but gets on a mutable memtable scan linearly and
+ * iterating one sorts a copy, so this is meant for bulk loads that do not
+ * read back their own writes. Overwrites are not detected until the sort,
+ * so until the memtable is frozen its size estimate and entry count (and
+ * its write-buffer charge, which the duplicates do occupy) include every
+ * write; freezing corrects the size and count.
+ */
+class VectorRepFactory : public MemTableRepFactory {
+public:
+    explicit VectorRepFactory(size_t reserve_entries = 0) : reserve_entries_(reserve_entries) {}
+    std::unique_ptr<MemTableRep> CreateMemTableRep(
+        const Comparator* comparator = BytewiseComparator()) const override;
+    const char* Name() const override { return "VectorRepFactory"; }
+
+private:
+    size_t reserve_entries_;
+};
+
+/**
+ * Build a read-only representation that lays the entries produced by iter
+ * (already sorted, one per key) out contiguously: one buffer holding every
+ * key and value, a sorted offset array, and an Eytzinger-ordered array of
+ * 8-byte key prefixes for cache-friendly binary search.
+ *
+ * Used to flatten frozen memtables; Insert on the result aborts. The
+ * prefix array only orders keys bytewise, so under any other comparator
+ * searches binary search the full keys instead.
+ */
+std::unique_ptr<MemTableRep> BuildFlatMemTableRep(StorageIterator* iter,
+                                                  const Comparator* comparator = BytewiseComparator());
@@ -0,0 +1,55 @@
+// Based on RocksDB's AssociativeMergeOperator
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * Combines the operands written with Lsm::merge into a value.
+ *
+ * Merge must be associative: folding two operands together first and applying
+ * the result to a value gives the same value as applying them one by one.
+ * This lets memtables combine operands for a key as they arrive, and lets reads
+ * and compaction fold them onto the newest older value lazily.
+ *
+ * An empty result reads as a deleted key, like an empty value.
+ */
+class MergeOperator {
+public:
+    virtual ~MergeOperator() {}
+
+    virtual const char* Name() const = 0;
+
+    /**
+     * Apply an operand
+     * @param existing The older value or operand, or nullptr if the key does not exist
+     * @param operand The newer operand
+     * @return The merged value (or combined operand)
+     */
+    virtual std::string Merge(const std::string* existing, const std::string& operand) const = 0;
+
+    /**
+     * Fold a key's operands onto its value
+     * @param existing The value below the operands, or nullptr if there is none
+     * @param operands Operands ordered newest first (the order reads find them in)
+     */
+    std::string FullMerge(const std::string* existing, const std::vector<std::string>& operands) const;
+};
+
+// Treats values and operands as signed decimal integers and adds them; non-numbers count as 0
+class AddOperator : public MergeOperator {
+public:
+    const char* Name() const override { return "AddOperator"; }
+    std::string Merge(const std::string* existing, const std::string& operand) const override;
+};
+
+// Appends each operand to the value, separated by delimiter
+class StringAppendOperator : public MergeOperator {
+public:
+    explicit StringAppendOperator(char delimiter = ',') : delimiter_(delimiter) {}
+
+    const char* Name() const override { return "StringAppendOperator"; }
+    std::string Merge(const std::string* existing, const std::string& operand) const override;
+
+private:
+    char delimiter_;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * Value returned by a point lookup without the copies of an
+ * std::optional<std::string>. It either refers to the bytes in place, pinning
+ * whatever owns them (a frozen memtable) until Reset() or destruction, or
+ * holds its own copy in a buffer whose capacity is reused when the same
+ * PinnableValue serves the next lookup.
+ *
+ * Based on RocksDB's PinnableSlice.
+ */
+class PinnableValue {
+public:
+    PinnableValue() {}
+    PinnableValue(const PinnableValue&) = delete;
+    void operator=(const PinnableValue&) = delete;
+
+    const char* data() const { return value_.data(); }
+    size_t size() const { return value_.size(); }
+    bool empty() const { return value_.empty(); }
+    std::string_view view() const { return value_; }
+    std::string ToString() const { return std::string(value_); }
+
+    // True while the value refers to storage it keeps alive rather than its own buffer
+    bool IsPinned() const { return pin_ != nullptr; }
+
+    // Drop the value and release the pin; the buffer keeps its capacity
+    void Reset() {
+        pin_.reset();
+        value_ = std::string_view();
+    }
+
+    /**
+     * Refer to value in place
+     * @param owner Kept alive until the value is reset or replaced
+     */
+    void PinSlice(std::string_view value, std::shared_ptr<const void> owner) {
+        pin_ = std::move(owner);
+        value_ = value;
+    }
+
+    // Buffer to copy a value into, followed by PinSelf()
+    std::string* GetSelf() {
+        pin_.reset();
+        return &buffer_;
+    }
+
+    // The value is the buffer filled through GetSelf()
+    void PinSelf() {
+        pin_.reset();
+        value_ = buffer_;
+    }
+
+    // Copy value into the buffer
+    void PinSelf(std::string_view value) {
+        buffer_.assign(value.data(), value.size());
+        PinSelf();
+    }
+
+    // Keep only the first n bytes of the value
+    void RemoveSuffix(size_t n) { value_.remove_suffix(n); }
+
+private:
+    std::string buffer_;
+    std::string_view value_;
+    std::shared_ptr<const void> pin_;
+};
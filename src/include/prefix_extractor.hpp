@@ -0,0 +1,56 @@
+// Based on RocksDB's SliceTransform
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * Maps a key to the prefix used for prefix Bloom filters and prefix scans.
+ * Keys for which InDomain() is false have no prefix and are never filtered.
+ * Transform must be stable: every key that starts with Transform(k) and is in
+ * the domain must produce the same prefix.
+ */
+class PrefixExtractor {
+public:
+    virtual ~PrefixExtractor() {}
+
+    virtual const char* Name() const = 0;
+
+    // Prefix of key; only called when InDomain(key)
+    virtual std::string Transform(const std::string& key) const = 0;
+
+    virtual bool InDomain(const std::string& key) const = 0;
+};
+
+// First prefix_len bytes; shorter keys are out of domain
+class FixedPrefixExtractor : public PrefixExtractor {
+public:
+    explicit FixedPrefixExtractor(size_t prefix_len) : prefix_len_(prefix_len) {}
+
+    const char* Name() const override { return "FixedPrefixExtractor"; }
+    std::string Transform(const std::string& key) const override;
+    bool InDomain(const std::string& key) const override;
+
+private:
+    size_t prefix_len_;
+};
+
+/**
+ * Everything up to and including the count-th delimiter, e.g. "tenant/table/"
+ * for "tenant/table/row" with delimiter '/' and count 2. Keys with fewer
+ * delimiters are out of domain.
+ */
+class DelimiterPrefixExtractor : public PrefixExtractor {
+public:
+    DelimiterPrefixExtractor(char delimiter, int count) : delimiter_(delimiter), count_(count) {}
+
+    const char* Name() const override { return "DelimiterPrefixExtractor"; }
+    std::string Transform(const std::string& key) const override;
+    bool InDomain(const std::string& key) const override;
+
+private:
+    char delimiter_;
+    int count_;
+
+    // Length of the prefix, or std::string::npos when key has too few delimiters
+    size_t PrefixLength_(const std::string& key) const;
+};
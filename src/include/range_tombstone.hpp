@@ -0,0 +1,55 @@
+// Based on RocksDB's FragmentedRangeTombstoneList
+#pragma once
+#include "src/include/comparator.hpp"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Deletes every key in [begin, end)
+struct RangeTombstone {
+    std::string begin;
+    std::string end;
+};
+
+/**
+ * A set of possibly overlapping range tombstones cut at every boundary into
+ * sorted, non-overlapping fragments.
+ *
+ * Sources are numbered like MergeIterator children (0 = newest). Each tombstone
+ * is added with the first source it hides, and a fragment keeps the smallest
+ * such value among the tombstones overlapping it, so a single binary search
+ * tells whether an entry read from source i is deleted.
+ */
+class FragmentedRangeTombstones {
+public:
+    struct Fragment {
+        std::string begin;
+        std::string end;
+        // Entries in [begin, end) from sources >= first_covered are deleted
+        size_t first_covered;
+    };
+
+    FragmentedRangeTombstones() {}
+    /**
+     * Fragment a set of tombstones
+     * @param tombstones Each tombstone paired with the first source it hides;
+     *                   empty ranges are ignored
+     * @param comparator Order of the keys the bounds are compared with
+     */
+    explicit FragmentedRangeTombstones(const std::vector<std::pair<RangeTombstone, size_t>>& tombstones,
+                                       const Comparator* comparator = BytewiseComparator());
+
+    bool empty() const;
+    const std::vector<Fragment>& fragments() const;
+
+    // Fragment whose range contains key, or nullptr
+    const Fragment* find(const std::string& key) const;
+
+    // True if an entry for key read from source is deleted
+    bool covers(const std::string& key, size_t source) const;
+
+private:
+    const Comparator* comparator_ = BytewiseComparator();
+    std::vector<Fragment> fragments_;
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// Who a file transfer is for; pending requests are granted from the most urgent down
+enum class IOPriority {
+    kCompaction = 0,
+    kFlush = 1,
+    kForeground = 2,
+};
+
+/**
+ * Token bucket shared by the files that do bulk I/O, so background write-out
+ * cannot take the device away from foreground reads. Every refill_period the
+ * bucket is refilled with one period's worth of bytes; requests that do not
+ * fit wait in a queue per priority and are granted foreground first, then
+ * flush, then compaction.
+ *
+ * With auto_tuned, the rate moves between max_bytes_per_second / 20 and
+ * max_bytes_per_second: up 5% when most refills of the last tuning window
+ * (100 refill periods) were used up by queued requests, so work is piling
+ * up, and down 5% when fewer than half were.
+ *
+ * Based on RocksDB's GenericRateLimiter. Thread-safe.
+ */
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RateLimiter(int64_t max_bytes_per_second, bool auto_tuned = false,
+                         std::chrono::microseconds refill_period = std::chrono::milliseconds(10));
+    RateLimiter(const RateLimiter&) = delete;
+    void operator=(const RateLimiter&) = delete;
+
+    // Block until bytes may be transferred; large requests are granted over several refills
+    void Request(size_t bytes, IOPriority priority);
+
+    // Current rate (below the maximum when auto-tuned down)
+    int64_t GetBytesPerSecond() const;
+    void SetBytesPerSecond(int64_t bytes_per_second);
+
+    // Bytes granted per refill. Larger requests wait for several refills, so
+    // transfers split into chunks of this size reach the device at an even pace.
+    size_t GetSingleBurstBytes() const;
+
+    int64_t GetTotalBytesThrough(IOPriority priority) const;
+    int64_t GetTotalRequests(IOPriority priority) const;
+
+private:
+    static constexpr int kNumPriorities = 3;
+    // Refill periods per auto-tuning window
+    static constexpr int kRefillsPerTune = 100;
+
+    struct Req {
+        size_t bytes;
+        bool granted;
+    };
+
+    // Grant up to bytes (at most one burst) at priority; requires mu_
+    void RequestLocked_(std::unique_lock<std::mutex>& lock, size_t bytes, int priority);
+    void SetBytesPerSecondLocked_(int64_t bytes_per_second);
+    // Refill the bucket and grant queued requests, most urgent first
+    void RefillAndGrant_(Clock::time_point now);
+    void Tune_(Clock::time_point now);
+
+    const int64_t max_bytes_per_second_;
+    const bool auto_tuned_;
+    const std::chrono::microseconds refill_period_;
+
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    int64_t bytes_per_second_;
+    size_t refill_bytes_;
+    size_t available_bytes_;
+    Clock::time_point next_refill_;
+    // One waiter sleeps until the next refill and grants on behalf of the rest
+    bool leader_waiting_;
+    std::deque<Req*> queues_[kNumPriorities];
+
+    Clock::time_point tuned_time_;
+    // Refills since tuned_time_, and how many of them left the bucket empty
+    int64_t num_refills_;
+    int64_t num_drains_;
+
+    int64_t total_bytes_[kNumPriorities];
+    int64_t total_requests_[kNumPriorities];
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include "env.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Framing of every file the engine persists (the manifest and tables): a
+ * sequence of records, each a masked CRC32C of the payload (4 bytes), the
+ * payload length (4 bytes) and the payload.
+ */
+
+// Bytes in front of each record's payload
+static const size_t kRecordHeaderSize = 8;
+
+// Frame payload as a record at the end of *dst
+void EncodeRecord(std::string* dst, std::string_view payload);
+
+/**
+ * Split a file's contents into the payloads of its records
+ * @param verify_checksums Check each payload against its CRC
+ * @param truncated Optional; set if the last record is cut short, as by a
+ *        crash in the middle of an append. That record is dropped and not
+ *        reported as an error; callers that never append pass null.
+ * @return false if a record fails its checksum, or is cut short without truncated;
+ *         *records holds the payloads before it
+ */
+bool DecodeRecords(std::string_view contents, bool verify_checksums, std::vector<std::string_view>* records,
+                   bool* truncated = nullptr);
+
+// Read all of path into *contents; false if it cannot be opened or read
+bool ReadFileToString(Env* env, const std::string& path, std::string* contents,
+                      const FileOptions& options = FileOptions());
@@ -0,0 +1,88 @@
+#pragma once
+#include "lsm_storage.hpp"
+#include "src/include/iterators/lsm_iterator.hpp"
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// How ShardedLsm assigns keys to shards
+enum class ShardingPolicy {
+    // Spread keys evenly by hash; scans merge every shard
+    kHash,
+    // Contiguous key ranges split at ShardedLsmOptions::split_keys; scans visit shards in order
+    kRange,
+};
+
+// Options used to open a ShardedLsm
+struct ShardedLsmOptions {
+    ShardingPolicy policy = ShardingPolicy::kHash;
+
+    // Number of shards for kHash (at least 1)
+    size_t num_shards = 8;
+
+    // kRange only: shard i holds keys in [split_keys[i-1], split_keys[i]), so there
+    // are split_keys.size() + 1 shards. Sorted (by shard_options.comparator) and
+    // deduplicated on open.
+    std::vector<std::string> split_keys;
+
+    // Applied to every shard; a write_buffer_manager set here is shared by all of them
+    LsmStorageOptions shard_options;
+};
+
+/**
+ * Front-end that partitions the keyspace across independent LsmStorageInner
+ * instances, each with its own active memtable and state lock, so writers to
+ * different shards never contend.
+ *
+ * Point operations touch exactly one shard. scan() merges one iterator per
+ * shard; each is a consistent view of its shard, but shards are not captured
+ * atomically with respect to each other.
+ */
+class ShardedLsm {
+public:
+    ShardedLsm();
+    explicit ShardedLsm(const ShardedLsmOptions& options);
+    ~ShardedLsm();
+
+    ShardedLsm(const ShardedLsm&) = delete;
+    void operator=(const ShardedLsm&) = delete;
+
+    std::optional<std::string> get(const std::string& key);
+    bool get(const std::string& key, PinnableValue* value);
+    // Point writes return false if the key is not accepted (see LsmStorageInner::put)
+    bool put(const std::string& key, const std::string& value);
+    // Also false if ttl is not positive
+    bool put(const std::string& key, const std::string& value, std::chrono::microseconds ttl);
+    bool delete_key(const std::string& key);
+    // Needs shard_options.merge_operator
+    bool merge(const std::string& key, const std::string& operand);
+    // Applied to every shard that may hold keys in [begin, end)
+    void delete_range(const std::string& begin, const std::string& end);
+
+    std::unique_ptr<FusedIterator> scan();
+    // Positioned at the last key (<= upper_bound); shards are merged in reverse
+    std::unique_ptr<FusedIterator> reverse_scan();
+    std::unique_ptr<FusedIterator> reverse_scan(const std::string& upper_bound);
+    // Keys starting with prefix; range shards that cannot hold any are not visited
+    // (under the bytewise order or its reverse; any other visits every shard)
+    std::unique_ptr<FusedIterator> scan_prefix(const std::string& prefix);
+
+    // Freeze the active memtable of every shard
+    void force_freeze_memtable();
+
+    // Sums over all shards (a key lives in exactly one shard)
+    size_t approximate_distinct_keys();
+    size_t num_entries();
+
+    size_t num_shards() const;
+    // Index of the shard that owns key
+    size_t shard_for(const std::string& key) const;
+
+private:
+    ShardingPolicy policy_;
+    const Comparator* comparator_;
+    std::vector<std::string> split_keys_;
+    std::vector<std::unique_ptr<LsmStorageInner>> shards_;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include "comparator.hpp"
+#include "env.hpp"
+#include "range_tombstone.hpp"
+#include "src/include/iterators/StorageIterator.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class MemTable;
+
+/**
+ * What the manifest keeps about a table: enough to serve it as a frozen
+ * memtable whose entries are read on first access (see MemTable::create_lazy).
+ */
+struct TableMeta {
+    uint64_t id = 0;
+    uint32_t column_family = 0;
+    // Recency among the column family's tables (see MemTable::sequence). Ids
+    // are not: a compaction's output gets a fresh id yet is older than the
+    // tables frozen while it ran.
+    uint64_t sequence = 0;
+    // MemTable::Size of the table's memtable
+    int64_t size = 0;
+    // Entries in the file, tombstones included
+    uint64_t num_entries = 0;
+    // First and last key of the entries (both empty without entries)
+    std::string smallest;
+    std::string largest;
+    // Kept in the manifest rather than the file, so lookups see them without opening it
+    std::vector<RangeTombstone> range_tombstones;
+    // HyperLogLog::Encode of the keys' sketch, so recovery estimates distinct
+    // keys without reading the table; empty if the manifest predates it
+    std::string distinct_keys_sketch;
+};
+
+// Payload size at which WriteTable closes a block record
+static const size_t kTableBlockSize = 32 * 1024;
+
+// Path of table id inside the database directory dir
+std::string TableFileName(const std::string& dir, uint64_t id);
+
+// Whether name (without directory) is a table file, and its id
+bool ParseTableFileName(const std::string& name, uint64_t* id);
+
+/**
+ * Write the entries of a frozen memtable to path as a table: records of
+ * about kTableBlockSize holding entries in key order, then a footer record
+ * with the entry count. The file is synced before returning.
+ * @param meta Receives everything but id and column_family
+ * @return false on an I/O error
+ */
+bool WriteTable(Env* env, const std::string& path, const FileOptions& options, MemTable* memtable, TableMeta* meta);
+
+/**
+ * Read a whole table back as a sorted stream of entries, tombstones included
+ * @param comparator The order the table was written in, for seeks
+ * @return nullptr if the file cannot be read, fails a checksum (with
+ *         verify_checksums) or is incomplete
+ */
+std::unique_ptr<StorageIterator> ReadTable(Env* env, const std::string& path, const FileOptions& options,
+                                           bool verify_checksums,
+                                           const Comparator* comparator = BytewiseComparator());
@@ -0,0 +1,51 @@
+#pragma once
+#include "src/include/iterators/StorageIterator.hpp"
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+class ColumnFamilyHandle;
+
+/**
+ * An ordered list of writes, possibly spanning several column families, that
+ * LsmStorageInner::write applies as one unit. Operations without a
+ * ColumnFamilyHandle go to the default column family.
+ */
+class WriteBatch {
+public:
+    struct Operation {
+        // nullptr for the default column family
+        ColumnFamilyHandle* column_family;
+        EntryType type;
+        std::string key;
+        // The value for kValue, the operand for kMerge, empty for kDeletion
+        std::string value;
+        // For kValue: expire this long after the batch is written
+        std::optional<std::chrono::microseconds> ttl;
+        // For kDeletion: delete every key in [key, *range_end) instead of key alone
+        std::optional<std::string> range_end;
+    };
+
+    void put(const std::string& key, const std::string& value);
+    void put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value);
+    // write() rejects the batch if ttl is not positive
+    void put(const std::string& key, const std::string& value, std::chrono::microseconds ttl);
+    void put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value,
+             std::chrono::microseconds ttl);
+    void delete_key(const std::string& key);
+    void delete_key(ColumnFamilyHandle* cf, const std::string& key);
+    void merge(const std::string& key, const std::string& operand);
+    void merge(ColumnFamilyHandle* cf, const std::string& key, const std::string& operand);
+    void delete_range(const std::string& begin, const std::string& end);
+    void delete_range(ColumnFamilyHandle* cf, const std::string& begin, const std::string& end);
+
+    void clear();
+    size_t count() const;
+    // Later operations on the same key win, as if written one after another
+    const std::vector<Operation>& operations() const;
+
+private:
+    std::vector<Operation> operations_;
+};
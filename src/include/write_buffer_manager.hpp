@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class LsmStorageInner;
+
+/**
+ * MemoryBudget is a process-wide byte counter. Components that hold memory
+ * (memtables today, caches later) charge their usage here so one total can
+ * be reasoned about across all of them. It enforces no limit of its own:
+ * memtable memory is bounded by WriteBufferManager's buffer_size.
+ */
+class MemoryBudget {
+public:
+    MemoryBudget();
+
+    void charge(size_t bytes);
+    void release(size_t bytes);
+
+    size_t usage() const;
+
+private:
+    std::atomic<size_t> usage_;
+};
+
+/**
+ * WriteBufferManager tracks memtable memory across any number of Lsm
+ * instances that share it. Based on RocksDB's WriteBufferManager.
+ *
+ * - memory_usage() counts every memtable that is still alive (active + frozen)
+ * - mutable_memory_usage() counts only the active memtables
+ *
+ * When the active memtables together exceed buffer_size, the instance holding
+ * the largest active memtable is asked to freeze it.
+ */
+class WriteBufferManager {
+public:
+    /**
+     * @param buffer_size  Budget for active memtables across all instances (0 disables)
+     * @param cache_budget Optional shared budget that memtable memory is charged to
+     */
+    explicit WriteBufferManager(size_t buffer_size,
+                                std::shared_ptr<MemoryBudget> cache_budget = nullptr);
+    ~WriteBufferManager();
+
+    WriteBufferManager(const WriteBufferManager&) = delete;
+    void operator=(const WriteBufferManager&) = delete;
+
+    bool enabled() const;
+    size_t buffer_size() const;
+    size_t memory_usage() const;
+    size_t mutable_memory_usage() const;
+
+    // True when the active memtables are over budget
+    bool should_freeze() const;
+
+    // Memtable accounting hooks
+    void reserve_mem(size_t bytes);       // bytes added to an active memtable
+    void schedule_free_mem(size_t bytes); // an active memtable of this size was frozen
+    void free_mem(size_t bytes);          // a memtable of this size was destroyed
+
+    // Lsm instances sharing this manager
+    void register_instance(LsmStorageInner* inner);
+    // Waits for a freeze_largest() that is already looking at inner
+    void unregister_instance(LsmStorageInner* inner);
+
+    /**
+     * Freeze the largest active memtable among registered instances. The
+     * instances are called without the manager's lock held; only one call
+     * freezes at a time, and others return false while it runs.
+     * @return true if a memtable was frozen
+     */
+    bool freeze_largest();
+
+private:
+    size_t buffer_size_;
+    std::shared_ptr<MemoryBudget> cache_budget_;
+
+    std::atomic<size_t> memory_used_;
+    std::atomic<size_t> memory_active_;
+
+    // Held for the whole of freeze_largest, so concurrent callers do not freeze twice
+    std::mutex freeze_lock_;
+
+    // Guards instances_ and candidates_
+    std::mutex instances_lock_;
+    std::condition_variable candidates_cv_;
+    std::vector<LsmStorageInner*> instances_;
+    // Instances the running freeze_largest may call into; they cannot unregister until it is done
+    std::vector<LsmStorageInner*> candidates_;
+};
@@ -0,0 +1,24 @@
+#include "../include/iterators/async_iterator.hpp"
+
+AsyncIterator::AsyncIterator(AsyncExecutor* executor, std::unique_ptr<FusedIterator> inner)
+    : executor_(executor), inner_(std::move(inner)), steps_since_yield_(0) {}
+
+bool AsyncIterator::is_valid() {
+    return inner_->is_valid();
+}
+
+std::string AsyncIterator::key() {
+    return inner_->key();
+}
+
+std::string AsyncIterator::value() {
+    return inner_->value();
+}
+
+Task<void> AsyncIterator::next() {
+    inner_->next();
+    if (++steps_since_yield_ >= kYieldInterval) {
+        steps_since_yield_ = 0;
+        co_await executor_->yield();
+    }
+}
@@ -2,7 +2,15 @@
 #include "src/include/iterators/merge_iterator.hpp"
 #include <memory>
 
-LsmIterator::LsmIterator(std::unique_ptr<MergeIterator> inner) : LsmIteratorInner_(std::move(inner)){
+LsmIterator::LsmIterator(std::unique_ptr<MergeIterator> inner, LsmIteratorOptions options)
+    : LsmIteratorInner_(std::move(inner)), prefix_(std::move(options.prefix)),
+      reversed_(options.comparator == ReverseBytewiseComparator()),
+      prefix_scattered_(!prefix_.empty() && options.comparator != BytewiseComparator() && !reversed_),
+      merge_operator_(std::move(options.merge_operator)), now_micros_(options.now_micros),
+      merged_expire_at_(0) {
+    if (options.range_tombstones && !options.range_tombstones->empty()) {
+        range_tombstones_ = std::move(options.range_tombstones);
+    }
     skip_deleted_keys();
 }
 
@@ -10,31 +18,159 @@ std::unique_ptr<LsmIterator> LsmIterator::create(std::unique_ptr<MergeIterator>
     return std::unique_ptr<LsmIterator>(new LsmIterator(std::move(merge_iter)));
 }
 
+std::unique_ptr<LsmIterator> LsmIterator::create(std::unique_ptr<MergeIterator> merge_iter, LsmIteratorOptions options) {
+    return std::unique_ptr<LsmIterator>(new LsmIterator(std::move(merge_iter), std::move(options)));
+}
+
+bool LsmIterator::in_bounds() {
+    if (!LsmIteratorInner_->is_valid()) {
+        return false;
+    }
+    return in_prefix();
+}
+
+bool LsmIterator::in_prefix() {
+    return prefix_.empty() || LsmIteratorInner_->key().compare(0, prefix_.size(), prefix_) == 0;
+}
+
+const FragmentedRangeTombstones::Fragment* LsmIterator::covering_fragment() {
+    if (!range_tombstones_) {
+        return nullptr;
+    }
+    const FragmentedRangeTombstones::Fragment* fragment = range_tombstones_->find(LsmIteratorInner_->key());
+    if (fragment && LsmIteratorInner_->current_index() >= fragment->first_covered) {
+        return fragment;
+    }
+    return nullptr;
+}
+
+bool LsmIterator::is_deleted(EntryType type) {
+    if (type == EntryType::kDeletion) {
+        return true;
+    }
+    return type == EntryType::kValue && IsExpired(LsmIteratorInner_->expire_at_micros(), now_micros_);
+}
+
+bool LsmIterator::fold_merge_operands() {
+    if (!merge_operator_) {
+        return true;
+    }
+    std::string key = LsmIteratorInner_->key();
+    std::vector<std::string> operands;
+    std::optional<std::string> base;
+    merged_expire_at_ = 0;
+    for (const auto& version : LsmIteratorInner_->current_versions()) {
+        if (range_tombstones_ && range_tombstones_->covers(key, version.first)) {
+            break;
+        }
+        StorageIterator* iter = version.second;
+        EntryType type = iter->entry_type();
+        if (type == EntryType::kMerge) {
+            operands.push_back(iter->value());
+            continue;
+        }
+        if (type == EntryType::kValue && !IsExpired(iter->expire_at_micros(), now_micros_)) {
+            base = iter->value();
+            merged_expire_at_ = iter->expire_at_micros();
+        }
+        break;
+    }
+    merged_value_ = merge_operator_->FullMerge(base ? &*base : nullptr, operands);
+    return !merged_value_->empty();
+}
+
+// Tombstones outside the prefix are not skipped: the iterator is already done,
+// unless the prefix is scattered
 void LsmIterator::skip_deleted_keys(){
-    while(LsmIteratorInner_->is_valid() && LsmIteratorInner_->value().empty()){
-        LsmIteratorInner_->next();
+    merged_value_.reset();
+    while (LsmIteratorInner_->is_valid()) {
+        if (!in_prefix()) {
+            if (!prefix_scattered_) {
+                return;
+            }
+            LsmIteratorInner_->next();
+            continue;
+        }
+        EntryType type = LsmIteratorInner_->entry_type();
+        if (is_deleted(type)) {
+            LsmIteratorInner_->next();
+            continue;
+        }
+        const FragmentedRangeTombstones::Fragment* fragment = covering_fragment();
+        if (fragment) {
+            LsmIteratorInner_->seek_children(fragment->first_covered, fragment->end);
+            continue;
+        }
+        if (type == EntryType::kMerge && !fold_merge_operands()) {
+            merged_value_.reset();
+            LsmIteratorInner_->next();
+            continue;
+        }
+        return;
+    }
+}
+
+void LsmIterator::skip_deleted_keys_backward(){
+    merged_value_.reset();
+    while (LsmIteratorInner_->is_valid()) {
+        if (!in_prefix()) {
+            if (!prefix_scattered_) {
+                return;
+            }
+            LsmIteratorInner_->prev();
+            continue;
+        }
+        EntryType type = LsmIteratorInner_->entry_type();
+        if (is_deleted(type)) {
+            LsmIteratorInner_->prev();
+            continue;
+        }
+        const FragmentedRangeTombstones::Fragment* fragment = covering_fragment();
+        if (fragment) {
+            LsmIteratorInner_->seek_children_before(fragment->first_covered, fragment->begin);
+            continue;
+        }
+        if (type == EntryType::kMerge && !fold_merge_operands()) {
+            merged_value_.reset();
+            LsmIteratorInner_->prev();
+            continue;
+        }
+        return;
     }
 }
 std::string LsmIterator::key() {
-    if (!LsmIteratorInner_->is_valid()) {
+    if (!in_bounds()) {
         return "";
     }
     return LsmIteratorInner_->key();
 }
 
 std::string LsmIterator::value() {
-    if (!LsmIteratorInner_->is_valid()) {
+    if (!in_bounds()) {
         return "";
     }
+    if (merged_value_.has_value()) {
+        return *merged_value_;
+    }
     return LsmIteratorInner_->value();
 }
 
+uint64_t LsmIterator::expire_at_micros() {
+    if (!in_bounds()) {
+        return 0;
+    }
+    if (merged_value_.has_value()) {
+        return merged_expire_at_;
+    }
+    return LsmIteratorInner_->expire_at_micros();
+}
+
 bool LsmIterator::is_valid() {
-    return LsmIteratorInner_->is_valid();
+    return in_bounds();
 }
 
 void LsmIterator::next() {
-    if (!LsmIteratorInner_->is_valid()) {
+    if (!in_bounds()) {
         return;
     }
     LsmIteratorInner_->next();
@@ -42,6 +178,78 @@ void LsmIterator::next() {
     skip_deleted_keys();
 }
 
+void LsmIterator::prev() {
+    if (!in_bounds()) {
+        return;
+    }
+    LsmIteratorInner_->prev();
+
+    skip_deleted_keys_backward();
+}
+
+void LsmIterator::seek(const std::string& target) {
+    LsmIteratorInner_->seek(target);
+    skip_deleted_keys();
+}
+
+void LsmIterator::seek_for_prev(const std::string& target) {
+    LsmIteratorInner_->seek_for_prev(target);
+    skip_deleted_keys_backward();
+}
+
+// With a prefix, first and last mean the first and last key inside it
+void LsmIterator::seek_to_first() {
+    if (prefix_.empty() || prefix_scattered_) {
+        LsmIteratorInner_->seek_to_first();
+    } else if (reversed_) {
+        seek_to_prefix_end();
+    } else {
+        LsmIteratorInner_->seek(prefix_);
+    }
+    skip_deleted_keys();
+}
+
+void LsmIterator::seek_to_last() {
+    if (prefix_.empty() || prefix_scattered_) {
+        LsmIteratorInner_->seek_to_last();
+    } else if (reversed_) {
+        LsmIteratorInner_->seek_for_prev(prefix_);
+    } else {
+        seek_to_prefix_end();
+    }
+    skip_deleted_keys_backward();
+}
+
+void LsmIterator::seek_to_prefix_end() {
+    // Smallest key greater than every key starting with prefix_
+    std::string limit = prefix_;
+    while (!limit.empty() && static_cast<unsigned char>(limit.back()) == 0xff) {
+        limit.pop_back();
+    }
+    if (limit.empty()) {
+        // Every key from prefix_ on starts with it
+        if (reversed_) {
+            LsmIteratorInner_->seek_to_first();
+        } else {
+            LsmIteratorInner_->seek_to_last();
+        }
+        return;
+    }
+    limit.back()++;
+    // Step from limit towards prefix_, whichever way the order runs
+    if (reversed_) {
+        LsmIteratorInner_->seek(limit);
+        if (LsmIteratorInner_->is_valid() && LsmIteratorInner_->key() == limit) {
+            LsmIteratorInner_->next();
+        }
+    } else {
+        LsmIteratorInner_->seek_for_prev(limit);
+        if (LsmIteratorInner_->is_valid() && LsmIteratorInner_->key() == limit) {
+            LsmIteratorInner_->prev();
+        }
+    }
+}
+
 
 
 
@@ -82,3 +290,35 @@ void FusedIterator::next() {
 
     inner_->next();
 }
+
+void FusedIterator::prev() {
+    if (has_errored_ || !inner_->is_valid()) {
+        return;
+    }
+    inner_->prev();
+}
+
+// Seeks are allowed even after the iterator ran off either end
+void FusedIterator::seek(const std::string& target) {
+    if (!has_errored_) {
+        inner_->seek(target);
+    }
+}
+
+void FusedIterator::seek_for_prev(const std::string& target) {
+    if (!has_errored_) {
+        inner_->seek_for_prev(target);
+    }
+}
+
+void FusedIterator::seek_to_first() {
+    if (!has_errored_) {
+        inner_->seek_to_first();
+    }
+}
+
+void FusedIterator::seek_to_last() {
+    if (!has_errored_) {
+        inner_->seek_to_last();
+    }
+}
@@ -1,97 +1,202 @@
 #include "../include/iterators/merge_iterator.hpp"
+#include <algorithm>
 #include <string>
 
-std::unique_ptr<MergeIterator> MergeIterator::create(std::vector<std::unique_ptr<StorageIterator>> iterators) {
-    MergeIterator* merge_iter = new MergeIterator();
-    
-    if (iterators.empty()) {
-        return std::unique_ptr<MergeIterator>(merge_iter);
-    }
-    
+std::unique_ptr<MergeIterator> MergeIterator::create(std::vector<std::unique_ptr<StorageIterator>> iterators,
+                                                     const Comparator* comparator) {
+    MergeIterator* merge_iter = new MergeIterator(comparator);
     merge_iter->owned_iters_ = std::move(iterators);
-    
-    for (size_t i = 0; i < merge_iter->owned_iters_.size(); i++) {
-        StorageIterator* iter = merge_iter->owned_iters_[i].get();
+    merge_iter->RebuildHeap_(true);
+    return std::unique_ptr<MergeIterator>(merge_iter);
+}
+
+bool MergeIterator::HeapLess_(const HeapWrapper& a, const HeapWrapper& b) const {
+    std::string a_key = a.iterator->key();
+    std::string b_key = b.iterator->key();
+    if (a_key != b_key) {
+        // The heap keeps its largest element on top, so forward order is reversed
+        return forward_ ? comparator_->Less(b_key, a_key) : comparator_->Less(a_key, b_key);
+    }
+    // Newer data wins ties in either direction
+    return a.index > b.index;
+}
+
+void MergeIterator::RebuildHeap_(bool forward) {
+    forward_ = forward;
+    heap_.clear();
+    for (size_t i = 0; i < owned_iters_.size(); i++) {
+        StorageIterator* iter = owned_iters_[i].get();
         if (iter->is_valid()) {
-            merge_iter->heap_.push(HeapWrapper(i, iter));
+            heap_.push_back(HeapWrapper(i, iter));
         }
     }
-    
-    if (!merge_iter->heap_.empty()) {
-        HeapWrapper top = merge_iter->heap_.top();
-        merge_iter->heap_.pop();
-        merge_iter->current_ = new HeapWrapper(top.index, top.iterator);
+    auto less = [this](const HeapWrapper& a, const HeapWrapper& b) { return HeapLess_(a, b); };
+    std::make_heap(heap_.begin(), heap_.end(), less);
+}
+
+void MergeIterator::AdvanceCurrent_() {
+    auto less = [this](const HeapWrapper& a, const HeapWrapper& b) { return HeapLess_(a, b); };
+    std::string current_key = heap_.front().iterator->key();
+
+    // The top and any older children holding the same key all move past it
+    std::vector<HeapWrapper> to_reinsert;
+    while (!heap_.empty() && heap_.front().iterator->key() == current_key) {
+        std::pop_heap(heap_.begin(), heap_.end(), less);
+        to_reinsert.push_back(heap_.back());
+        heap_.pop_back();
+    }
+
+    for (size_t i = 0; i < to_reinsert.size(); i++) {
+        StorageIterator* iter = to_reinsert[i].iterator;
+        if (forward_) {
+            iter->next();
+        } else {
+            iter->prev();
+        }
+        if (iter->is_valid()) {
+            heap_.push_back(to_reinsert[i]);
+            std::push_heap(heap_.begin(), heap_.end(), less);
+        }
     }
-    
-    return std::unique_ptr<MergeIterator>(merge_iter);
 }
 
 std::string MergeIterator::key() {
-    if (!current_ || !current_->iterator) {
+    if (heap_.empty()) {
         return "";
     }
-    return current_->iterator->key();
+    return heap_.front().iterator->key();
 }
 
 std::string MergeIterator::value() {
-    if (!current_ || !current_->iterator) {
+    if (heap_.empty()) {
         return "";
     }
-    return current_->iterator->value();
+    return heap_.front().iterator->value();
 }
 
 bool MergeIterator::is_valid() {
-    if (!current_ || !current_->iterator) {
-        return false;
+    return !heap_.empty();
+}
+
+EntryType MergeIterator::entry_type() {
+    if (heap_.empty()) {
+        return EntryType::kDeletion;
+    }
+    return heap_.front().iterator->entry_type();
+}
+
+uint64_t MergeIterator::expire_at_micros() {
+    if (heap_.empty()) {
+        return 0;
+    }
+    return heap_.front().iterator->expire_at_micros();
+}
+
+std::vector<std::pair<size_t, StorageIterator*>> MergeIterator::current_versions() {
+    std::vector<std::pair<size_t, StorageIterator*>> versions;
+    if (heap_.empty()) {
+        return versions;
+    }
+    // Children on the current key all sit on it, whichever the direction
+    std::string current_key = key();
+    for (size_t i = 0; i < owned_iters_.size(); i++) {
+        StorageIterator* iter = owned_iters_[i].get();
+        if (iter->is_valid() && iter->key() == current_key) {
+            versions.emplace_back(i, iter);
+        }
+    }
+    return versions;
+}
+
+size_t MergeIterator::current_index() const {
+    return heap_.empty() ? owned_iters_.size() : heap_.front().index;
+}
+
+void MergeIterator::seek_children(size_t min_index, const std::string& target) {
+    for (size_t i = min_index; i < owned_iters_.size(); i++) {
+        StorageIterator* iter = owned_iters_[i].get();
+        if (iter->is_valid() && comparator_->Less(iter->key(), target)) {
+            iter->seek(target);
+        }
+    }
+    RebuildHeap_(forward_);
+}
+
+void MergeIterator::seek_children_before(size_t min_index, const std::string& target) {
+    for (size_t i = min_index; i < owned_iters_.size(); i++) {
+        StorageIterator* iter = owned_iters_[i].get();
+        if (iter->is_valid() && !comparator_->Less(iter->key(), target)) {
+            iter->seek_for_prev(target);
+            if (iter->is_valid() && iter->key() == target) {
+                iter->prev();
+            }
+        }
     }
-    return current_->iterator->is_valid();
+    RebuildHeap_(forward_);
 }
 
 void MergeIterator::next() {
-    if (!current_ || !current_->iterator) {
+    if (heap_.empty()) {
         return;
     }
-    
-    std::string current_key = current_->iterator->key();
-    
-    std::vector<HeapWrapper> to_reinsert;
-    while (!heap_.empty()) {
-        HeapWrapper top = heap_.top();
-        if (top.iterator->key() == current_key) {
-            heap_.pop();
-            top.iterator->next();
-            if (top.iterator->is_valid()) {
-                to_reinsert.push_back(top);
+    if (!forward_) {
+        // Children sit at or before the current key; move all of them past it
+        std::string current_key = key();
+        for (auto& iter : owned_iters_) {
+            iter->seek(current_key);
+            if (iter->is_valid() && iter->key() == current_key) {
+                iter->next();
             }
-        } else {
-            break;
         }
+        RebuildHeap_(true);
+        return;
     }
-    
-    current_->iterator->next();
-    
-    for (size_t i = 0; i < to_reinsert.size(); i++) {
-        heap_.push(to_reinsert[i]);
-    }
+    AdvanceCurrent_();
+}
 
-    if (current_->iterator->is_valid()) {
-        if (!heap_.empty()) {
-            HeapWrapper top = heap_.top();
-            if (*current_ < top) {
-                heap_.pop();
-                heap_.push(*current_);
-                delete current_;
-                current_ = new HeapWrapper(top.index, top.iterator);
+void MergeIterator::prev() {
+    if (heap_.empty()) {
+        return;
+    }
+    if (forward_) {
+        // Children sit at or after the current key; move all of them before it
+        std::string current_key = key();
+        for (auto& iter : owned_iters_) {
+            iter->seek_for_prev(current_key);
+            if (iter->is_valid() && iter->key() == current_key) {
+                iter->prev();
             }
         }
-    } else {
-        delete current_;
-        current_ = nullptr;
-        
-        if (!heap_.empty()) {
-            HeapWrapper top = heap_.top();
-            heap_.pop();
-            current_ = new HeapWrapper(top.index, top.iterator);
-        }
+        RebuildHeap_(false);
+        return;
+    }
+    AdvanceCurrent_();
+}
+
+void MergeIterator::seek(const std::string& target) {
+    for (auto& iter : owned_iters_) {
+        iter->seek(target);
+    }
+    RebuildHeap_(true);
+}
+
+void MergeIterator::seek_for_prev(const std::string& target) {
+    for (auto& iter : owned_iters_) {
+        iter->seek_for_prev(target);
+    }
+    RebuildHeap_(false);
+}
+
+void MergeIterator::seek_to_first() {
+    for (auto& iter : owned_iters_) {
+        iter->seek_to_first();
+    }
+    RebuildHeap_(true);
+}
+
+void MergeIterator::seek_to_last() {
+    for (auto& iter : owned_iters_) {
+        iter->seek_to_last();
     }
+    RebuildHeap_(false);
 }
@@ -1,19 +1,23 @@
 #include "include/lsm_storage.hpp"
 #include "include/iterators/lsm_iterator.hpp"
 #include "include/iterators/merge_iterator.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
 #include <memory>
 #include <vector>
 
-LsmStorageState::LsmStorageState() {
+LsmStorageState::LsmStorageState() : LsmStorageState(MemTableOptions()) {}
+
+LsmStorageState::LsmStorageState(const MemTableOptions& memtable_options) {
     // Initialize with memtable of id 0
-    memtable = new MemTable();
+    memtable = std::make_shared<MemTable>(memtable_options);
 }
 
 LsmStorageState::~LsmStorageState() {
-    delete memtable;
-    for (MemTable* mt : imm_memtables) {
-        delete mt;
-    }
+    // Memtables are shared with live iterators and released with the last reference
 }
 
 LsmStorageState LsmStorageState::create() {
@@ -21,76 +25,859 @@ LsmStorageState LsmStorageState::create() {
 }
 
 
-LsmStorageInner::LsmStorageInner() {
-    // state_ is initialized automatically by its constructor
-    target_sst_size_ = 2 * 1024 * 1024; // 2MB default (like Rust)
+LsmStorageInner::LsmStorageInner() : LsmStorageInner(LsmStorageOptions()) {}
+
+// Collect memtable's range tombstones; they hide merge children first_covered and up
+static void add_range_tombstones(const MemTable& memtable, size_t first_covered,
+                                 std::vector<std::pair<RangeTombstone, size_t>>& out) {
+    std::shared_ptr<const std::vector<RangeTombstone>> tombstones = memtable.range_tombstones();
+    if (!tombstones) {
+        return;
+    }
+    for (const RangeTombstone& tombstone : *tombstones) {
+        out.emplace_back(tombstone, first_covered);
+    }
+}
+
+// Null when there is nothing to fragment, so iterators without range deletes skip the lookups
+static std::shared_ptr<const FragmentedRangeTombstones> fragment_range_tombstones(
+    const std::vector<std::pair<RangeTombstone, size_t>>& tombstones, const Comparator* comparator) {
+    if (tombstones.empty()) {
+        return nullptr;
+    }
+    return std::make_shared<FragmentedRangeTombstones>(tombstones, comparator);
+}
+
+ColumnFamilyHandle::ColumnFamilyHandle(uint32_t id, const std::string& name, const ColumnFamilyOptions& options,
+                                       const MemTableOptions& memtable_options)
+    : id_(id), name_(name), memtable_options_(memtable_options), state_(memtable_options_) {
+    target_sst_size_ = options.target_sst_size;
+    flatten_immutable_memtables_ = options.flatten_immutable_memtables;
+    imm_compaction_trigger_ = options.imm_compaction_trigger;
+}
+
+const std::string& ColumnFamilyHandle::name() const {
+    return name_;
+}
+
+uint32_t ColumnFamilyHandle::id() const {
+    return id_;
+}
+
+MemTableOptions LsmStorageInner::memtable_options_for(const ColumnFamilyOptions& options) const {
+    MemTableOptions memtable_options;
+    memtable_options.write_buffer_manager = write_buffer_manager_.get();
+    memtable_options.rep_factory = options.memtable_factory;
+    memtable_options.comparator = options.comparator ? options.comparator : BytewiseComparator();
+    memtable_options.enable_hash_index = options.enable_memtable_hash_index;
+    memtable_options.merge_operator = options.merge_operator;
+    memtable_options.compaction_filter = options.compaction_filter;
+    memtable_options.clock = clock_;
+    memtable_options.protect_entries = options.memtable_checksums;
+    memtable_options.verify_checksums = options.verify_checksums;
+    if (options.prefix_extractor) {
+        memtable_options.prefix_extractor = options.prefix_extractor;
+        memtable_options.prefix_bloom_bits =
+            static_cast<size_t>(options.target_sst_size * options.memtable_prefix_bloom_size_ratio * 8);
+    }
+    return memtable_options;
+}
+
+LsmStorageInner::LsmStorageInner(const LsmStorageOptions& options)
+    : write_buffer_manager_(options.write_buffer_manager),
+      clock_(options.clock ? options.clock : std::make_shared<SystemClock>()),
+      env_(options.env ? options.env : Env::Default()),
+      use_direct_io_for_background_work_(options.use_direct_io_for_background_work),
+      rate_limiter_(options.rate_limiter), batches_started_(0), batches_done_(0) {
     next_sst_id_ = 1;
+    column_families_.push_back(std::unique_ptr<ColumnFamilyHandle>(
+        new ColumnFamilyHandle(0, kDefaultColumnFamilyName, options, memtable_options_for(options))));
+    default_cf_ = column_families_.front().get();
+
+    if (write_buffer_manager_) {
+        write_buffer_manager_->register_instance(this);
+    }
 }
 
 LsmStorageInner::~LsmStorageInner() {
-    // Destructor handles cleanup automatically
+    // Memtables are released by column_families_; only stop the manager from picking us,
+    // first, so no other instance's writer freezes one while we tear down
+    if (write_buffer_manager_) {
+        write_buffer_manager_->unregister_instance(this);
+    }
+    // A persistent instance writes out what the active memtables hold
+    if (manifest_) {
+        for (const auto& cf : column_families_) {
+            const std::shared_ptr<MemTable>& memtable = cf->state_.memtable;
+            if (memtable->num_entries() > 0 || memtable->range_tombstones()) {
+                force_freeze_memtable(cf.get());
+            }
+        }
+    }
+}
+
+std::unique_ptr<LsmStorageInner> LsmStorageInner::open(const std::string& path, const LsmStorageOptions& options,
+                                                       const std::vector<ColumnFamilyDescriptor>& column_families) {
+    std::unique_ptr<LsmStorageInner> storage(new LsmStorageInner(options));
+    if (!storage->env_->CreateDirIfMissing(path)) {
+        return nullptr;
+    }
+    std::unique_ptr<Manifest> manifest = Manifest::Open(storage->env_, path, options.max_manifest_file_size,
+                                                        storage->file_options_for(IOPriority::kForeground));
+    if (!manifest) {
+        return nullptr;
+    }
+
+    // Families come back with the ids they were logged with, since ids are handed out in order
+    std::vector<ManifestEdit::ColumnFamily> recorded = manifest->column_families();
+    for (const ManifestEdit::ColumnFamily& family : recorded) {
+        ColumnFamilyHandle* cf = storage->default_cf_;
+        if (family.id != 0) {
+            const ColumnFamilyOptions* cf_options = &options;
+            for (const ColumnFamilyDescriptor& descriptor : column_families) {
+                if (descriptor.name == family.name) {
+                    cf_options = &descriptor.options;
+                }
+            }
+            cf = storage->create_column_family(family.name, *cf_options);
+        }
+        if (!cf || cf->id() != family.id || family.comparator != cf->memtable_options_.comparator->Name()) {
+            return nullptr;
+        }
+    }
+    if (recorded.empty()) {
+        ManifestEdit edit;
+        const Comparator* comparator = storage->default_cf_->memtable_options_.comparator;
+        edit.column_families.push_back({0, kDefaultColumnFamilyName, comparator->Name()});
+        if (!manifest->LogAndApply(edit)) {
+            return nullptr;
+        }
+    }
+
+    // Newest first, like the frozen memtables they were
+    std::vector<TableMeta> tables = manifest->tables();
+    std::sort(tables.begin(), tables.end(), [](const TableMeta& a, const TableMeta& b) {
+        return a.sequence < b.sequence;
+    });
+    for (auto table = tables.rbegin(); table != tables.rend(); ++table) {
+        if (table->column_family >= storage->column_families_.size()) {
+            return nullptr;
+        }
+        ColumnFamilyHandle* cf = storage->column_families_[table->column_family].get();
+        auto load = [env = storage->env_, file = TableFileName(path, table->id),
+                     file_options = storage->file_options_for(IOPriority::kForeground),
+                     verify = cf->memtable_options_.verify_checksums,
+                     comparator = cf->memtable_options_.comparator]() {
+            return ReadTable(env, file, file_options, verify, comparator);
+        };
+        cf->state_.imm_memtables.push_back(MemTable::create_lazy(*table, load, cf->memtable_options_));
+        if (table->distinct_keys_sketch.empty()) {
+            cf->imm_sketch_stale_ = true;
+        } else {
+            cf->imm_sketch_.Merge(cf->state_.imm_memtables.back()->distinct_keys_sketch());
+        }
+    }
+
+    storage->next_sst_id_ = static_cast<int>(manifest->next_table_id());
+    storage->path_ = path;
+    storage->manifest_ = std::move(manifest);
+    return storage;
+}
+
+ColumnFamilyHandle* LsmStorageInner::create_column_family(const std::string& name,
+                                                          const ColumnFamilyOptions& options) {
+    MemTableOptions memtable_options = memtable_options_for(options);
+    std::unique_lock<std::shared_mutex> lock(state_lock_);
+    for (const auto& cf : column_families_) {
+        if (cf->name() == name) {
+            return nullptr;
+        }
+    }
+    uint32_t id = static_cast<uint32_t>(column_families_.size());
+    column_families_.push_back(
+        std::unique_ptr<ColumnFamilyHandle>(new ColumnFamilyHandle(id, name, options, memtable_options)));
+    ColumnFamilyHandle* cf = column_families_.back().get();
+    lock.unlock();
+
+    if (manifest_) {
+        ManifestEdit edit;
+        edit.column_families.push_back({id, name, memtable_options.comparator->Name()});
+        log_manifest_edit(edit);
+    }
+    return cf;
+}
+
+ColumnFamilyHandle* LsmStorageInner::get_column_family(const std::string& name) {
+    std::shared_lock<std::shared_mutex> lock(state_lock_);
+    for (const auto& cf : column_families_) {
+        if (cf->name() == name) {
+            return cf.get();
+        }
+    }
+    return nullptr;
+}
+
+ColumnFamilyHandle* LsmStorageInner::default_column_family() {
+    return default_cf_;
 }
 
 std::optional<std::string> LsmStorageInner::get(const std::string& key) {
+    return get(default_cf_, key);
+}
+
+std::optional<std::string> LsmStorageInner::get(ColumnFamilyHandle* cf, const std::string& key) {
+    PinnableValue value;
+    if (!get(cf, key, &value)) {
+        return std::nullopt;
+    }
+    return value.ToString();
+}
+
+bool LsmStorageInner::get(const std::string& key, PinnableValue* value) {
+    return get(default_cf_, key, value);
+}
+
+bool LsmStorageInner::get(ColumnFamilyHandle* cf, const std::string& key, PinnableValue* value) {
+    wait_for_batches();
     // Use lock to ensure consistent state while reading
-    std::lock_guard<std::mutex> lock(state_lock_);
-    
-    // Search on the current memtable first (newest data)
-    std::optional<std::string> result = state_.memtable->get(key);
-    
-    if (result.has_value()) {
-        // Check for tombstone (empty value means deleted)
-        if (result.value().empty()) {
-            return std::nullopt; // Found tombstone
+    std::shared_lock<std::shared_mutex> lock(state_lock_);
+
+    GetState state;
+    auto search = [&](const std::shared_ptr<MemTable>& memtable) {
+        if (!memtable->load_for(key)) {
+            state.failed = true;
+            return true;
         }
-        return result.value();
-    }
-    
-    // Search on immutable memtables from newest to oldest
-    // (index 0 is newest since we insert at the beginning)
-    for (MemTable* memtable : state_.imm_memtables) {
-        std::optional<std::string> result = memtable->get(key);
-        if (result.has_value()) {
-            if (result.value().empty()) {
-                return std::nullopt; // Found tombstone
+        EntryType type;
+        bool hit = memtable->get_entry(key, value, &type, &state.expire_at);
+        return add_get_result(*memtable, key, hit, type, *value, &state);
+    };
+
+    // Search the current memtable first (newest data), then the immutable
+    // memtables from newest to oldest (index 0 is newest)
+    if (!search(cf->state_.memtable)) {
+        for (const std::shared_ptr<MemTable>& memtable : cf->state_.imm_memtables) {
+            if (search(memtable)) {
+                break;
             }
-            return result.value();
         }
     }
-    
-    return std::nullopt;
+    return finish_get(cf, &state, value);
+}
+
+bool LsmStorageInner::add_get_result(const MemTable& memtable, const std::string& key, bool hit, EntryType type,
+                                     const PinnableValue& value, GetState* state) {
+    if (hit) {
+        if (type != EntryType::kMerge) {
+            state->found = type;
+            return true;
+        }
+        state->operands.push_back(value.ToString());
+    }
+    // A range tombstone hides the key in every older memtable
+    return memtable.is_range_deleted(key);
+}
+
+bool LsmStorageInner::finish_get(ColumnFamilyHandle* cf, GetState* state, PinnableValue* value) {
+    if (state->failed) {
+        value->Reset();
+        return false;
+    }
+    // An expired value reads like a tombstone
+    bool has_base = state->found == EntryType::kValue && !IsExpired(state->expire_at, clock_->NowMicros());
+    if (state->operands.empty()) {
+        // Empty value means deleted
+        if (!has_base || value->empty()) {
+            value->Reset();
+            return false;  // Deleted or never written
+        }
+        return true;
+    }
+
+    std::optional<std::string> base;
+    if (has_base) {
+        base = value->ToString();
+    }
+    std::string merged = cf->memtable_options_.merge_operator->FullMerge(base ? &*base : nullptr, state->operands);
+    if (merged.empty()) {
+        value->Reset();
+        return false;
+    }
+    *value->GetSelf() = std::move(merged);
+    value->PinSelf();
+    return true;
 }
 
-void LsmStorageInner::put(const std::string& key, const std::string& value) {
+namespace {
+
+// Take state_lock shared, yielding to executor while a writer holds it
+Task<void> AsyncLockShared(AsyncExecutor& executor, std::shared_mutex& state_lock) {
+    while (!state_lock.try_lock_shared()) {
+        co_await executor.yield();
+    }
+}
+
+}  // namespace
+
+Task<std::optional<std::string>> LsmStorageInner::async_get(AsyncExecutor& executor, std::string key) {
+    PinnableValue value;
+    if (!co_await async_get(executor, default_cf_, std::move(key), &value)) {
+        co_return std::nullopt;
+    }
+    co_return value.ToString();
+}
+
+Task<bool> LsmStorageInner::async_get(AsyncExecutor& executor, std::string key, PinnableValue* value) {
+    co_return co_await async_get(executor, default_cf_, std::move(key), value);
+}
+
+Task<bool> LsmStorageInner::async_get(AsyncExecutor& executor, ColumnFamilyHandle* cf, std::string key,
+                                      PinnableValue* value) {
+    // Pin the memtables to search, newest first; the lock is not held across yields
+    std::vector<std::shared_ptr<MemTable>> memtables;
+    co_await async_wait_for_batches(executor);
+    co_await AsyncLockShared(executor, state_lock_);
+    {
+        std::shared_lock<std::shared_mutex> lock(state_lock_, std::adopt_lock);
+        memtables.reserve(cf->state_.imm_memtables.size() + 1);
+        memtables.push_back(cf->state_.memtable);
+        memtables.insert(memtables.end(), cf->state_.imm_memtables.begin(), cf->state_.imm_memtables.end());
+    }
+
+    GetState state;
+    for (const std::shared_ptr<MemTable>& memtable : memtables) {
+        if (!co_await memtable->async_load_for(executor, key)) {
+            state.failed = true;
+            break;
+        }
+        EntryType type;
+        bool hit = co_await memtable->async_get_entry(executor, key, value, &type, &state.expire_at);
+        if (add_get_result(*memtable, key, hit, type, *value, &state)) {
+            break;
+        }
+    }
+    co_return finish_get(cf, &state, value);
+}
+
+bool LsmStorageInner::put(const std::string& key, const std::string& value) {
+    return put(default_cf_, key, value);
+}
+
+bool LsmStorageInner::put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value) {
     // Put a key-value pair into the storage by writing into the current memtable
-    state_.memtable->put(key, value);
-    
-    // Check if memtable should be frozen after put
-    int estimated_size = state_.memtable->Size();
-    try_freeze(estimated_size);
+    return write_to_memtable(cf, key, value, EntryType::kValue);
 }
 
-void LsmStorageInner::delete_key(const std::string& key) {
+bool LsmStorageInner::put(const std::string& key, const std::string& value, std::chrono::microseconds ttl) {
+    return put(default_cf_, key, value, ttl);
+}
+
+bool LsmStorageInner::put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value,
+                          std::chrono::microseconds ttl) {
+    if (ttl.count() <= 0) {
+        return false;
+    }
+    uint64_t expire_at = ExpireAtMicros(clock_->NowMicros(), static_cast<uint64_t>(ttl.count()));
+    return write_to_memtable(cf, key, value, EntryType::kValue, expire_at);
+}
+
+bool LsmStorageInner::delete_key(const std::string& key) {
+    return delete_key(default_cf_, key);
+}
+
+bool LsmStorageInner::delete_key(ColumnFamilyHandle* cf, const std::string& key) {
     // Remove a key from the storage by writing an empty value (tombstone)
-    state_.memtable->put(key, "");
+    return write_to_memtable(cf, key, "", EntryType::kDeletion);
+}
+
+bool LsmStorageInner::merge(const std::string& key, const std::string& operand) {
+    return merge(default_cf_, key, operand);
+}
+
+bool LsmStorageInner::merge(ColumnFamilyHandle* cf, const std::string& key, const std::string& operand) {
+    if (!cf->memtable_options_.merge_operator) {
+        return false;
+    }
+    return write_to_memtable(cf, key, operand, EntryType::kMerge);
+}
+
+void LsmStorageInner::delete_range(const std::string& begin, const std::string& end) {
+    delete_range(default_cf_, begin, end);
+}
+
+// Live keys of the active memtable delete_range overwrites in place before freezing it instead
+static constexpr size_t kMaxInPlaceRangeDeleteKeys = 64;
+
+void LsmStorageInner::delete_range(ColumnFamilyHandle* cf, const std::string& begin, const std::string& end) {
+    if (!cf->memtable_options_.comparator->Less(begin, end)) {
+        return;
+    }
+
+    std::shared_ptr<MemTable> frozen;
+    int estimated_size;
+    {
+        // Exclusive, so the check for live keys and the tombstone see the same active memtable
+        std::unique_lock<std::shared_mutex> lock(state_lock_);
+        frozen = delete_range_locked(cf, begin, end);
+        estimated_size = cf->state_.memtable->Size();
+    }
+    if (frozen) {
+        after_freeze(cf, frozen);
+    }
+
+    try_freeze(cf, estimated_size);
+    enforce_write_buffer_limit();
+}
+
+std::shared_ptr<MemTable> LsmStorageInner::delete_range_locked(ColumnFamilyHandle* cf, const std::string& begin,
+                                                               const std::string& end) {
+    const Comparator* comparator = cf->memtable_options_.comparator;
+    std::shared_ptr<MemTable> frozen;
+    std::vector<std::string> live;
+    for (auto iter = cf->state_.memtable->scan_ptr(begin, ""); iter->is_valid() && comparator->Less(iter->key(), end);
+         iter->next()) {
+        if (iter->entry_type() == EntryType::kDeletion) {
+            continue;
+        }
+        if (live.size() == kMaxInPlaceRangeDeleteKeys) {
+            frozen = freeze_memtable_locked(cf);
+            live.clear();
+            break;
+        }
+        live.push_back(iter->key());
+    }
+    // A few keys are cheaper to shadow with point tombstones than a flush
+    for (std::string& key : live) {
+        cf->state_.memtable->put(std::move(key), "");
+    }
+    cf->state_.memtable->delete_range(begin, end);
+    return frozen;
+}
+
+bool LsmStorageInner::write(const WriteBatch& batch) {
+    // Resolve families and validate up front so a rejected batch leaves no trace
+    std::vector<ColumnFamilyHandle*> families;
+    families.reserve(batch.count());
+    bool has_range_deletion = false;
+    for (const WriteBatch::Operation& op : batch.operations()) {
+        ColumnFamilyHandle* cf = op.column_family ? op.column_family : default_cf_;
+        if (op.type == EntryType::kMerge && !cf->memtable_options_.merge_operator) {
+            return false;
+        }
+        if (op.ttl && op.ttl->count() <= 0) {
+            return false;
+        }
+        has_range_deletion = has_range_deletion || op.range_end.has_value();
+        families.push_back(cf);
+    }
+    {
+        // Every memtable of a family comes from the same factory, so the active one answers for all
+        std::shared_lock<std::shared_mutex> lock(state_lock_);
+        const std::vector<WriteBatch::Operation>& ops = batch.operations();
+        for (size_t i = 0; i < ops.size(); i++) {
+            if (!ops[i].range_end && !families[i]->state_.memtable->accepts_key(ops[i].key)) {
+                return false;
+            }
+        }
+    }
+    uint64_t now = clock_->NowMicros();
+    const std::vector<WriteBatch::Operation>& ops = batch.operations();
+    auto apply = [&](MemTable* memtable, const WriteBatch::Operation& op) {
+        if (op.type == EntryType::kMerge) {
+            memtable->merge(op.key, op.value);
+        } else if (op.type == EntryType::kDeletion) {
+            memtable->put(op.key, "");
+        } else {
+            uint64_t expire_at = op.ttl ? ExpireAtMicros(now, static_cast<uint64_t>(op.ttl->count())) : 0;
+            memtable->put(op.key, op.value, expire_at);
+        }
+    };
+
+    std::vector<std::pair<ColumnFamilyHandle*, int>> touched;
+    std::vector<std::pair<ColumnFamilyHandle*, std::shared_ptr<MemTable>>> frozen;
+    {
+        std::lock_guard<std::mutex> batch_lock(batch_write_lock_);
+        // Reads from here on wait for the whole batch (see wait_for_batches)
+        batches_started_.fetch_add(1);
+        if (has_range_deletion) {
+            std::unique_lock<std::shared_mutex> lock(state_lock_);
+            for (size_t i = 0; i < ops.size(); i++) {
+                ColumnFamilyHandle* cf = families[i];
+                if (!ops[i].range_end) {
+                    apply(cf->state_.memtable.get(), ops[i]);
+                } else if (cf->memtable_options_.comparator->Less(ops[i].key, *ops[i].range_end)) {
+                    if (std::shared_ptr<MemTable> memtable = delete_range_locked(cf, ops[i].key, *ops[i].range_end)) {
+                        frozen.emplace_back(cf, std::move(memtable));
+                    }
+                }
+            }
+            for (ColumnFamilyHandle* cf : families) {
+                bool seen = std::any_of(touched.begin(), touched.end(),
+                                        [cf](const std::pair<ColumnFamilyHandle*, int>& t) { return t.first == cf; });
+                if (!seen) {
+                    touched.emplace_back(cf, cf->state_.memtable->Size());
+                }
+            }
+        } else {
+            // A freeze waits for pinned writers, so each family's share of the
+            // batch lands in one memtable without holding state_lock_ throughout
+            std::vector<std::pair<ColumnFamilyHandle*, std::shared_ptr<MemTable>>> pinned;
+            {
+                std::shared_lock<std::shared_mutex> lock(state_lock_);
+                for (ColumnFamilyHandle* cf : families) {
+                    bool seen = std::any_of(pinned.begin(), pinned.end(), [cf](const auto& p) { return p.first == cf; });
+                    if (!seen) {
+                        pinned.emplace_back(cf, cf->state_.memtable);
+                        pinned.back().second->ref_writer();
+                    }
+                }
+            }
+            for (size_t i = 0; i < ops.size(); i++) {
+                auto target = std::find_if(pinned.begin(), pinned.end(),
+                                           [cf = families[i]](const auto& p) { return p.first == cf; });
+                apply(target->second.get(), ops[i]);
+            }
+            for (const auto& [cf, memtable] : pinned) {
+                touched.emplace_back(cf, memtable->Size());
+                memtable->unref_writer();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(batch_done_lock_);
+            batches_done_.fetch_add(1);
+        }
+        batch_done_cv_.notify_all();
+    }
+
+    for (const auto& [cf, memtable] : frozen) {
+        after_freeze(cf, memtable);
+    }
+    for (const auto& [cf, estimated_size] : touched) {
+        try_freeze(cf, estimated_size);
+    }
+    enforce_write_buffer_limit();
+    return true;
+}
+
+void LsmStorageInner::wait_for_batches() {
+    // Waiting only until no batch runs could starve behind back-to-back batches
+    uint64_t started = batches_started_.load();
+    if (batches_done_.load() >= started) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(batch_done_lock_);
+    batch_done_cv_.wait(lock, [&]() { return batches_done_.load() >= started; });
+}
+
+Task<void> LsmStorageInner::async_wait_for_batches(AsyncExecutor& executor) {
+    uint64_t started = batches_started_.load();
+    while (batches_done_.load() < started) {
+        co_await executor.yield();
+    }
+}
+
+bool LsmStorageInner::write_to_memtable(ColumnFamilyHandle* cf, const std::string& key, const std::string& value,
+                                        EntryType type, uint64_t expire_at_micros) {
+    // Pin the current memtable; the lock covers only the pin, so writers insert concurrently
+    std::shared_ptr<MemTable> memtable;
+    {
+        std::shared_lock<std::shared_mutex> lock(state_lock_);
+        memtable = cf->state_.memtable;
+        memtable->ref_writer();
+    }
+    bool written;
+    if (type == EntryType::kMerge) {
+        written = memtable->merge(key, value);
+    } else {
+        written = memtable->put(key, value, expire_at_micros);
+    }
+    int estimated_size = memtable->Size();
+    memtable->unref_writer();
+    if (!written) {
+        return false;
+    }
     
-    // Check if memtable should be frozen after delete (tombstone still takes space)
-    int estimated_size = state_.memtable->Size();
-    try_freeze(estimated_size);
+    // Check if memtable should be frozen after the write (tombstones still take space)
+    try_freeze(cf, estimated_size);
+    enforce_write_buffer_limit();
+    return true;
 }
 
 void LsmStorageInner::force_freeze_memtable() {
-    std::lock_guard<std::mutex> lock(state_lock_);
-    
-    // Force freeze regardless of size (as the name suggests)
-    // Move current memtable to immutable list and create new one
-    MemTable* old_memtable = state_.memtable;
+    force_freeze_memtable(default_cf_);
+}
+
+void LsmStorageInner::force_freeze_memtable(ColumnFamilyHandle* cf) {
+    std::shared_ptr<MemTable> frozen;
+    {
+        std::unique_lock<std::shared_mutex> lock(state_lock_);
+        
+        // Force freeze regardless of size (as the name suggests)
+        frozen = freeze_memtable_locked(cf);
+    }
+    after_freeze(cf, frozen);
+}
+
+int LsmStorageInner::largest_memtable_size() {
+    std::shared_lock<std::shared_mutex> lock(state_lock_);
+    int largest = 0;
+    for (const auto& cf : column_families_) {
+        largest = std::max(largest, cf->state_.memtable->Size());
+    }
+    return largest;
+}
+
+void LsmStorageInner::freeze_largest_memtable() {
+    ColumnFamilyHandle* largest = nullptr;
+    {
+        std::shared_lock<std::shared_mutex> lock(state_lock_);
+        int largest_size = -1;
+        for (const auto& cf : column_families_) {
+            if (cf->state_.memtable->Size() > largest_size) {
+                largest = cf.get();
+                largest_size = cf->state_.memtable->Size();
+            }
+        }
+    }
+    force_freeze_memtable(largest);
+}
+
+std::shared_ptr<MemTable> LsmStorageInner::freeze_memtable_locked(ColumnFamilyHandle* cf) {
+    // Move current memtable to immutable list and create new one. Writers that
+    // pinned it may still be inserting; after_freeze waits for them.
+    std::shared_ptr<MemTable> old_memtable = cf->state_.memtable;
     
     // Add to immutable memtables (latest first)
-    state_.imm_memtables.insert(state_.imm_memtables.begin(), old_memtable);
+    cf->state_.imm_memtables.insert(cf->state_.imm_memtables.begin(), old_memtable);
     
-    // Create new current memtable
-    state_.memtable = new MemTable();
+    // Create new current memtable; the frozen one is now a table
+    cf->state_.memtable = std::make_shared<MemTable>(cf->memtable_options_);
+    old_memtable->set_id(next_sst_id());
+    old_memtable->set_sequence(old_memtable->Id());
+    return old_memtable;
+}
+
+void LsmStorageInner::after_freeze(ColumnFamilyHandle* cf, const std::shared_ptr<MemTable>& frozen) {
+    // No new writer can pin the memtable after the swap, so this terminates
+    frozen->wait_for_writers();
+    frozen->mark_immutable();
+    {
+        std::unique_lock<std::shared_mutex> lock(state_lock_);
+        cf->imm_sketch_.Merge(frozen->distinct_keys_sketch());
+    }
+
+    if (cf->imm_compaction_trigger_ > 0) {
+        size_t count;
+        {
+            std::shared_lock<std::shared_mutex> lock(state_lock_);
+            count = cf->state_.imm_memtables.size();
+        }
+        // The compacted memtable is flat already, so skip flattening (and writing) the frozen one first
+        if (count >= cf->imm_compaction_trigger_ && compact_imm_memtables(cf)) {
+            return;
+        }
+    }
+    flatten_imm_memtable(cf, frozen);
+    persist_imm_memtable(cf, frozen->Id());
+}
+
+void LsmStorageInner::write_table(ColumnFamilyHandle* cf, MemTable* memtable, IOPriority priority,
+                                  TableMeta* meta) {
+    meta->id = static_cast<uint64_t>(memtable->Id());
+    meta->sequence = static_cast<uint64_t>(memtable->sequence());
+    meta->distinct_keys_sketch = memtable->distinct_keys_sketch().Encode();
+    meta->column_family = cf->id();
+    std::string path = TableFileName(path_, meta->id);
+    if (!WriteTable(env_, path, file_options_for(priority), memtable, meta)) {
+        std::fprintf(stderr, "LsmStorageInner: cannot write table %s\n", path.c_str());
+        std::abort();
+    }
+}
+
+void LsmStorageInner::persist_imm_memtable(ColumnFamilyHandle* cf, int id) {
+    if (!manifest_) {
+        return;
+    }
+    // A compaction that took the memtable logs its deletion; holding its lock keeps
+    // that from happening between writing the table and logging it
+    std::lock_guard<std::mutex> compaction_lock(cf->compaction_lock_);
+    std::shared_ptr<MemTable> memtable;
+    {
+        std::shared_lock<std::shared_mutex> lock(state_lock_);
+        for (const std::shared_ptr<MemTable>& imm : cf->state_.imm_memtables) {
+            if (imm->Id() == id) {
+                memtable = imm;
+                break;
+            }
+        }
+    }
+    if (!memtable) {
+        return;
+    }
+    ManifestEdit edit;
+    edit.new_tables.emplace_back();
+    write_table(cf, memtable.get(), IOPriority::kFlush, &edit.new_tables.back());
+    log_manifest_edit(edit);
+}
+
+void LsmStorageInner::log_manifest_edit(const ManifestEdit& edit) {
+    if (!manifest_->LogAndApply(edit)) {
+        std::fprintf(stderr, "LsmStorageInner: cannot append to the manifest in %s\n", path_.c_str());
+        std::abort();
+    }
+}
+
+bool LsmStorageInner::compact_imm_memtables() {
+    return compact_imm_memtables(default_cf_);
+}
+
+bool LsmStorageInner::compact_imm_memtables(ColumnFamilyHandle* cf) {
+    std::lock_guard<std::mutex> compaction_lock(cf->compaction_lock_);
+
+    std::vector<std::shared_ptr<MemTable>> inputs;
+    {
+        std::shared_lock<std::shared_mutex> lock(state_lock_);
+        inputs = cf->state_.imm_memtables;
+    }
+    // Memtables still draining writers sit at the front; leave them for a later pass
+    auto draining = std::find_if(inputs.rbegin(), inputs.rend(),
+                                 [](const std::shared_ptr<MemTable>& memtable) {
+                                     return !memtable->is_immutable();
+                                 });
+    inputs.erase(inputs.begin(), draining.base());
+    if (inputs.size() < 2) {
+        return false;
+    }
+
+    // Merge newest first so the MergeIterator keeps the latest version of each key;
+    // LsmIterator then drops tombstones since there is no older data for them to hide
+    std::vector<std::unique_ptr<StorageIterator>> iters;
+    std::vector<std::pair<RangeTombstone, size_t>> range_tombstones;
+    for (const std::shared_ptr<MemTable>& memtable : inputs) {
+        iters.push_back(memtable->begin_ptr());
+        add_range_tombstones(*memtable, iters.size(), range_tombstones);
+    }
+    LsmIteratorOptions iter_options;
+    iter_options.range_tombstones = fragment_range_tombstones(range_tombstones, cf->memtable_options_.comparator);
+    // Operands are folded all the way down, leaving plain values
+    iter_options.merge_operator = cf->memtable_options_.merge_operator;
+    iter_options.now_micros = clock_->NowMicros();
+    auto merged = LsmIterator::create(MergeIterator::create(std::move(iters), cf->memtable_options_.comparator),
+                                      std::move(iter_options));
+    std::shared_ptr<MemTable> compacted = MemTable::create_flat(merged.get(), cf->memtable_options_);
+
+    std::unique_lock<std::shared_mutex> lock(state_lock_);
+    // Freezes only prepend, so the inputs must still be the tail of the list
+    std::vector<std::shared_ptr<MemTable>>& imms = cf->state_.imm_memtables;
+    if (imms.size() < inputs.size() ||
+        !std::equal(inputs.begin(), inputs.end(), imms.end() - inputs.size())) {
+        return false;
+    }
+    imms.erase(imms.end() - inputs.size(), imms.end());
+    if (!compacted->isEmpty()) {
+        imms.push_back(compacted);
+    }
+    compacted->set_id(next_sst_id());
+    // Tables frozen during the merge have smaller ids but are newer; the
+    // result takes its newest input's place, below all of them
+    compacted->set_sequence(inputs.front()->sequence());
+
+    cf->imm_sketch_.Clear();
+    for (const std::shared_ptr<MemTable>& memtable : imms) {
+        cf->imm_sketch_.Merge(memtable->distinct_keys_sketch());
+    }
+    cf->imm_sketch_stale_ = false;
+    lock.unlock();
+
+    if (manifest_) {
+        // One edit swaps the tables, so a crash leaves either the inputs or the result
+        ManifestEdit edit;
+        if (!compacted->isEmpty()) {
+            edit.new_tables.emplace_back();
+            write_table(cf, compacted.get(), IOPriority::kCompaction, &edit.new_tables.back());
+        }
+        for (const std::shared_ptr<MemTable>& input : inputs) {
+            edit.deleted_tables.push_back(static_cast<uint64_t>(input->Id()));
+        }
+        log_manifest_edit(edit);
+        // The inputs were read in full by the merge, so nothing needs their files any more
+        for (const std::shared_ptr<MemTable>& input : inputs) {
+            env_->DeleteFile(TableFileName(path_, static_cast<uint64_t>(input->Id())));
+        }
+    }
+    return true;
+}
+
+void LsmStorageInner::flatten_imm_memtable(ColumnFamilyHandle* cf, const std::shared_ptr<MemTable>& frozen) {
+    if (!cf->flatten_immutable_memtables_) {
+        return;
+    }
+
+    // Build the copy without blocking readers; the frozen table no longer changes
+    std::shared_ptr<MemTable> flat = frozen->flatten();
+
+    std::unique_lock<std::shared_mutex> lock(state_lock_);
+    for (std::shared_ptr<MemTable>& memtable : cf->state_.imm_memtables) {
+        if (memtable == frozen) {
+            memtable = flat;
+            return;
+        }
+    }
+}
+
+void LsmStorageInner::enforce_write_buffer_limit() {
+    if (write_buffer_manager_ && write_buffer_manager_->should_freeze()) {
+        write_buffer_manager_->freeze_largest();
+    }
+}
+
+FileOptions LsmStorageInner::file_options_for(IOPriority priority) const {
+    FileOptions options;
+    options.use_direct_io = use_direct_io_for_background_work_ && priority != IOPriority::kForeground;
+    options.rate_limiter = rate_limiter_;
+    options.io_priority = priority;
+    return options;
+}
+
+size_t LsmStorageInner::approximate_distinct_keys() {
+    ColumnFamilyHandle* cf = default_cf_;
+    std::shared_lock<std::shared_mutex> lock(state_lock_);
+    if (cf->imm_sketch_stale_) {
+        // Tables recovered from a manifest that predates sketches build theirs from
+        // their keys, outside the lock; then the union is taken once and kept
+        std::vector<std::shared_ptr<MemTable>> imms = cf->state_.imm_memtables;
+        lock.unlock();
+        for (const std::shared_ptr<MemTable>& memtable : imms) {
+            memtable->distinct_keys_sketch();
+        }
+        {
+            std::unique_lock<std::shared_mutex> exclusive(state_lock_);
+            if (cf->imm_sketch_stale_) {
+                cf->imm_sketch_.Clear();
+                for (const std::shared_ptr<MemTable>& memtable : cf->state_.imm_memtables) {
+                    cf->imm_sketch_.Merge(memtable->distinct_keys_sketch());
+                }
+                cf->imm_sketch_stale_ = false;
+            }
+        }
+        lock.lock();
+    }
+    HyperLogLog sketch = cf->imm_sketch_;
+    sketch.Merge(cf->state_.memtable->distinct_keys_sketch());
+    return static_cast<size_t>(sketch.Estimate() + 0.5);
+}
+
+size_t LsmStorageInner::num_entries() {
+    return num_entries(default_cf_);
+}
+
+size_t LsmStorageInner::num_entries(ColumnFamilyHandle* cf) {
+    std::shared_lock<std::shared_mutex> lock(state_lock_);
+    size_t entries = cf->state_.memtable->num_entries();
+    for (const std::shared_ptr<MemTable>& memtable : cf->state_.imm_memtables) {
+        entries += memtable->num_entries();
+    }
+    return entries;
 }
 
 int LsmStorageInner::next_sst_id() {
@@ -98,17 +885,102 @@ int LsmStorageInner::next_sst_id() {
 }
 
 std::unique_ptr<FusedIterator> LsmStorageInner::scan() {
-    std::lock_guard<std::mutex> lock(state_lock_);
+    return scan(default_cf_);
+}
+
+std::unique_ptr<FusedIterator> LsmStorageInner::scan(ColumnFamilyHandle* cf) {
+    wait_for_batches();
+    std::shared_lock<std::shared_mutex> lock(state_lock_);
+    return scan_locked(cf);
+}
+
+Task<std::unique_ptr<AsyncIterator>> LsmStorageInner::async_scan(AsyncExecutor& executor) {
+    co_return co_await async_scan(executor, default_cf_);
+}
+
+Task<std::unique_ptr<AsyncIterator>> LsmStorageInner::async_scan(AsyncExecutor& executor, ColumnFamilyHandle* cf) {
+    co_await async_wait_for_batches(executor);
+    co_await AsyncLockShared(executor, state_lock_);
+    std::shared_lock<std::shared_mutex> lock(state_lock_, std::adopt_lock);
+    co_return std::make_unique<AsyncIterator>(&executor, scan_locked(cf));
+}
+
+std::unique_ptr<FusedIterator> LsmStorageInner::scan_locked(ColumnFamilyHandle* cf) {
+    const LsmStorageState& state = cf->state_;
     
     std::vector<std::unique_ptr<StorageIterator>> iters;
-    iters.push_back(state_.memtable->begin_ptr());
+    std::vector<std::pair<RangeTombstone, size_t>> range_tombstones;
+    iters.push_back(state.memtable->begin_ptr());
+    add_range_tombstones(*state.memtable, iters.size(), range_tombstones);
     
-    for (size_t i = 0; i < state_.imm_memtables.size(); i++) {
-        iters.push_back(state_.imm_memtables[i]->begin_ptr());
+    for (size_t i = 0; i < state.imm_memtables.size(); i++) {
+        iters.push_back(state.imm_memtables[i]->begin_ptr());
+        add_range_tombstones(*state.imm_memtables[i], iters.size(), range_tombstones);
     }
     
-    auto merge_iter = MergeIterator::create(std::move(iters));
-    auto lsm_iter = LsmIterator::create(std::move(merge_iter));
+    auto merge_iter = MergeIterator::create(std::move(iters), cf->memtable_options_.comparator);
+    LsmIteratorOptions iter_options;
+    iter_options.range_tombstones = fragment_range_tombstones(range_tombstones, cf->memtable_options_.comparator);
+    iter_options.merge_operator = cf->memtable_options_.merge_operator;
+    iter_options.now_micros = clock_->NowMicros();
+    auto lsm_iter = LsmIterator::create(std::move(merge_iter), std::move(iter_options));
+    return FusedIterator::create(std::move(lsm_iter));
+}
+
+std::unique_ptr<FusedIterator> LsmStorageInner::reverse_scan() {
+    std::unique_ptr<FusedIterator> iter = scan();
+    iter->seek_to_last();
+    return iter;
+}
+
+std::unique_ptr<FusedIterator> LsmStorageInner::reverse_scan(const std::string& upper_bound) {
+    std::unique_ptr<FusedIterator> iter = scan();
+    iter->seek_for_prev(upper_bound);
+    return iter;
+}
+
+std::unique_ptr<FusedIterator> LsmStorageInner::scan_prefix(const std::string& prefix) {
+    return scan_prefix(default_cf_, prefix);
+}
+
+std::unique_ptr<FusedIterator> LsmStorageInner::scan_prefix(ColumnFamilyHandle* cf, const std::string& prefix) {
+    const Comparator* comparator = cf->memtable_options_.comparator;
+
+    // The filters hold extracted prefixes, so they can only answer for one of those
+    const PrefixExtractor* extractor = cf->memtable_options_.prefix_extractor.get();
+    bool use_filter = extractor && extractor->InDomain(prefix) && extractor->Transform(prefix) == prefix;
+
+    wait_for_batches();
+    std::shared_lock<std::shared_mutex> lock(state_lock_);
+
+    std::vector<std::unique_ptr<StorageIterator>> iters;
+    std::vector<std::pair<RangeTombstone, size_t>> range_tombstones;
+    auto add = [&](const std::shared_ptr<MemTable>& memtable) {
+        if (!use_filter || memtable->may_contain_prefix(prefix)) {
+            iters.push_back(memtable->scan_ptr(prefix, ""));
+        }
+        // A skipped memtable's range tombstones still hide the older children
+        add_range_tombstones(*memtable, iters.size(), range_tombstones);
+    };
+    add(cf->state_.memtable);
+    for (size_t i = 0; i < cf->state_.imm_memtables.size(); i++) {
+        add(cf->state_.imm_memtables[i]);
+    }
+
+    // Skipped memtables only drop out; the rest keep their newest-first order
+    auto merge_iter = MergeIterator::create(std::move(iters), comparator);
+    LsmIteratorOptions iter_options;
+    iter_options.prefix = prefix;
+    iter_options.comparator = comparator;
+    iter_options.range_tombstones = fragment_range_tombstones(range_tombstones, comparator);
+    iter_options.merge_operator = cf->memtable_options_.merge_operator;
+    iter_options.now_micros = clock_->NowMicros();
+    auto lsm_iter = LsmIterator::create(std::move(merge_iter), std::move(iter_options));
+    if (comparator != BytewiseComparator()) {
+        // In reverse order the children start on the last key of the prefix, not the first,
+        // and under other orders the prefix may have keys anywhere
+        lsm_iter->seek_to_first();
+    }
     return FusedIterator::create(std::move(lsm_iter));
 }
 
@@ -117,20 +989,32 @@ std::unique_ptr<FusedIterator> Lsm::scan() {
     return inner_->scan();
 }
 
-bool LsmStorageInner::try_freeze(int estimated_size) {
-    if (estimated_size >= target_sst_size_) {
-        std::lock_guard<std::mutex> lock(state_lock_);
-        
-        // Double-check after acquiring lock (race condition prevention)
-        if (state_.memtable->Size() >= target_sst_size_) {
-            // Inline the freeze logic to avoid deadlock
-            MemTable* old_memtable = state_.memtable;
-            
-            // Add to immutable memtables (latest first)
-            state_.imm_memtables.insert(state_.imm_memtables.begin(), old_memtable);
+std::unique_ptr<FusedIterator> Lsm::reverse_scan() {
+    return inner_->reverse_scan();
+}
+
+std::unique_ptr<FusedIterator> Lsm::reverse_scan(const std::string& upper_bound) {
+    return inner_->reverse_scan(upper_bound);
+}
+
+std::unique_ptr<FusedIterator> Lsm::scan_prefix(const std::string& prefix) {
+    return inner_->scan_prefix(prefix);
+}
+
+bool LsmStorageInner::try_freeze(ColumnFamilyHandle* cf, int estimated_size) {
+    if (estimated_size >= cf->target_sst_size_) {
+        std::shared_ptr<MemTable> frozen;
+        {
+            std::unique_lock<std::shared_mutex> lock(state_lock_);
             
-            // Create new current memtable
-            state_.memtable = new MemTable();
+            // Double-check after acquiring lock (race condition prevention)
+            if (cf->state_.memtable->Size() >= cf->target_sst_size_) {
+                // Call the locked variant to avoid deadlock
+                frozen = freeze_memtable_locked(cf);
+            }
+        }
+        if (frozen) {
+            after_freeze(cf, frozen);
             return true;
         }
     }
@@ -139,22 +1023,23 @@ bool LsmStorageInner::try_freeze(int estimated_size) {
 
 // Test accessors
 int LsmStorageInner::get_imm_memtables_count() const {
-    return state_.imm_memtables.size();
+    return default_cf_->state_.imm_memtables.size();
 }
 
 int LsmStorageInner::get_imm_memtable_size(int index) const {
-    if (index >= 0 && index < static_cast<int>(state_.imm_memtables.size())) {
-        return state_.imm_memtables[index]->Size();
+    const std::vector<std::shared_ptr<MemTable>>& imms = default_cf_->state_.imm_memtables;
+    if (index >= 0 && index < static_cast<int>(imms.size())) {
+        return imms[index]->Size();
     }
     return 0;
 }
 
 void LsmStorageInner::set_target_sst_size(int size) {
-    target_sst_size_ = size;
+    default_cf_->target_sst_size_ = size;
 }
 
 int LsmStorageInner::get_current_memtable_size() const {
-    return state_.memtable->Size();
+    return default_cf_->state_.memtable->Size();
 }
 
 
@@ -162,6 +1047,21 @@ Lsm::Lsm() {
     inner_ = new LsmStorageInner();
 }
 
+Lsm::Lsm(const LsmStorageOptions& options) {
+    inner_ = new LsmStorageInner(options);
+}
+
+Lsm::Lsm(LsmStorageInner* inner) : inner_(inner) {}
+
+std::unique_ptr<Lsm> Lsm::open(const std::string& path, const LsmStorageOptions& options,
+                               const std::vector<ColumnFamilyDescriptor>& column_families) {
+    std::unique_ptr<LsmStorageInner> inner = LsmStorageInner::open(path, options, column_families);
+    if (!inner) {
+        return nullptr;
+    }
+    return std::unique_ptr<Lsm>(new Lsm(inner.release()));
+}
+
 Lsm::~Lsm() {
     delete inner_;
 }
@@ -170,10 +1070,99 @@ std::optional<std::string> Lsm::get(const std::string& key) {
     return inner_->get(key);
 }
 
-void Lsm::put(const std::string& key, const std::string& value) {
-    inner_->put(key, value);
+bool Lsm::get(const std::string& key, PinnableValue* value) {
+    return inner_->get(key, value);
+}
+
+Task<std::optional<std::string>> Lsm::async_get(AsyncExecutor& executor, std::string key) {
+    return inner_->async_get(executor, std::move(key));
+}
+
+Task<bool> Lsm::async_get(AsyncExecutor& executor, std::string key, PinnableValue* value) {
+    return inner_->async_get(executor, std::move(key), value);
+}
+
+Task<std::unique_ptr<AsyncIterator>> Lsm::async_scan(AsyncExecutor& executor) {
+    return inner_->async_scan(executor);
+}
+
+bool Lsm::put(const std::string& key, const std::string& value) {
+    return inner_->put(key, value);
+}
+
+bool Lsm::put(const std::string& key, const std::string& value, std::chrono::microseconds ttl) {
+    return inner_->put(key, value, ttl);
+}
+
+bool Lsm::delete_key(const std::string& key) {
+    return inner_->delete_key(key);
+}
+
+bool Lsm::merge(const std::string& key, const std::string& operand) {
+    return inner_->merge(key, operand);
+}
+
+void Lsm::delete_range(const std::string& begin, const std::string& end) {
+    inner_->delete_range(begin, end);
+}
+
+size_t Lsm::approximate_distinct_keys() {
+    return inner_->approximate_distinct_keys();
+}
+
+bool Lsm::compact_imm_memtables() {
+    return inner_->compact_imm_memtables();
+}
+
+size_t Lsm::num_entries() {
+    return inner_->num_entries();
+}
+
+ColumnFamilyHandle* Lsm::create_column_family(const std::string& name, const ColumnFamilyOptions& options) {
+    return inner_->create_column_family(name, options);
+}
+
+ColumnFamilyHandle* Lsm::get_column_family(const std::string& name) {
+    return inner_->get_column_family(name);
+}
+
+std::optional<std::string> Lsm::get(ColumnFamilyHandle* cf, const std::string& key) {
+    return inner_->get(cf, key);
+}
+
+bool Lsm::get(ColumnFamilyHandle* cf, const std::string& key, PinnableValue* value) {
+    return inner_->get(cf, key, value);
+}
+
+bool Lsm::put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value) {
+    return inner_->put(cf, key, value);
+}
+
+bool Lsm::put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value,
+              std::chrono::microseconds ttl) {
+    return inner_->put(cf, key, value, ttl);
+}
+
+bool Lsm::delete_key(ColumnFamilyHandle* cf, const std::string& key) {
+    return inner_->delete_key(cf, key);
+}
+
+bool Lsm::merge(ColumnFamilyHandle* cf, const std::string& key, const std::string& operand) {
+    return inner_->merge(cf, key, operand);
+}
+
+void Lsm::delete_range(ColumnFamilyHandle* cf, const std::string& begin, const std::string& end) {
+    inner_->delete_range(cf, begin, end);
+}
+
+std::unique_ptr<FusedIterator> Lsm::scan(ColumnFamilyHandle* cf) {
+    return inner_->scan(cf);
+}
+
+std::unique_ptr<FusedIterator> Lsm::scan_prefix(ColumnFamilyHandle* cf, const std::string& prefix) {
+    return inner_->scan_prefix(cf, prefix);
 }
 
-void Lsm::delete_key(const std::string& key) {
-    inner_->delete_key(key);
+bool Lsm::write(const WriteBatch& batch) {
+    return inner_->write(batch);
 }
@@ -0,0 +1,296 @@
+#include "include/manifest.hpp"
+#include "include/coding.hpp"
+#include "include/record_file.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+// Field tags inside an edit record
+static const char kColumnFamilyField = 'c';
+static const char kNewTableField = 't';
+// Sequence of the new table before it, when it differs from its id
+static const char kTableSequenceField = 's';
+// Distinct-key sketch of the new table before it
+static const char kTableSketchField = 'h';
+static const char kDeletedTableField = 'd';
+static const char kNextTableIdField = 'n';
+
+static const char* const kManifestPrefix = "MANIFEST-";
+
+static std::string EncodeEdit(const ManifestEdit& edit) {
+    std::string out;
+    for (const ManifestEdit::ColumnFamily& cf : edit.column_families) {
+        out.push_back(kColumnFamilyField);
+        PutFixed32(&out, cf.id);
+        PutLengthPrefixed(&out, cf.name);
+        PutLengthPrefixed(&out, cf.comparator);
+    }
+    for (const TableMeta& table : edit.new_tables) {
+        out.push_back(kNewTableField);
+        PutFixed64(&out, table.id);
+        PutFixed32(&out, table.column_family);
+        PutFixed64(&out, static_cast<uint64_t>(table.size));
+        PutFixed64(&out, table.num_entries);
+        PutLengthPrefixed(&out, table.smallest);
+        PutLengthPrefixed(&out, table.largest);
+        PutFixed32(&out, static_cast<uint32_t>(table.range_tombstones.size()));
+        for (const RangeTombstone& tombstone : table.range_tombstones) {
+            PutLengthPrefixed(&out, tombstone.begin);
+            PutLengthPrefixed(&out, tombstone.end);
+        }
+        if (table.sequence != table.id) {
+            out.push_back(kTableSequenceField);
+            PutFixed64(&out, table.sequence);
+        }
+        if (!table.distinct_keys_sketch.empty()) {
+            out.push_back(kTableSketchField);
+            PutLengthPrefixed(&out, table.distinct_keys_sketch);
+        }
+    }
+    for (uint64_t id : edit.deleted_tables) {
+        out.push_back(kDeletedTableField);
+        PutFixed64(&out, id);
+    }
+    if (edit.next_table_id != 0) {
+        out.push_back(kNextTableIdField);
+        PutFixed64(&out, edit.next_table_id);
+    }
+    return out;
+}
+
+static bool DecodeTable(std::string_view* input, TableMeta* table) {
+    uint64_t size;
+    uint32_t num_tombstones;
+    std::string_view smallest;
+    std::string_view largest;
+    if (!GetFixed64(input, &table->id) || !GetFixed32(input, &table->column_family) || !GetFixed64(input, &size) ||
+        !GetFixed64(input, &table->num_entries) || !GetLengthPrefixed(input, &smallest) ||
+        !GetLengthPrefixed(input, &largest) || !GetFixed32(input, &num_tombstones)) {
+        return false;
+    }
+    table->size = static_cast<int64_t>(size);
+    // Overridden by a kTableSequenceField that follows
+    table->sequence = table->id;
+    table->smallest = smallest;
+    table->largest = largest;
+    for (uint32_t i = 0; i < num_tombstones; i++) {
+        std::string_view begin;
+        std::string_view end;
+        if (!GetLengthPrefixed(input, &begin) || !GetLengthPrefixed(input, &end)) {
+            return false;
+        }
+        table->range_tombstones.push_back({std::string(begin), std::string(end)});
+    }
+    return true;
+}
+
+static bool DecodeEdit(std::string_view input, ManifestEdit* edit) {
+    while (!input.empty()) {
+        char field = input.front();
+        input.remove_prefix(1);
+        if (field == kColumnFamilyField) {
+            ManifestEdit::ColumnFamily cf;
+            std::string_view name;
+            std::string_view comparator;
+            if (!GetFixed32(&input, &cf.id) || !GetLengthPrefixed(&input, &name) ||
+                !GetLengthPrefixed(&input, &comparator)) {
+                return false;
+            }
+            cf.name = name;
+            cf.comparator = comparator;
+            edit->column_families.push_back(std::move(cf));
+        } else if (field == kNewTableField) {
+            TableMeta table;
+            if (!DecodeTable(&input, &table)) {
+                return false;
+            }
+            edit->new_tables.push_back(std::move(table));
+        } else if (field == kTableSequenceField) {
+            if (edit->new_tables.empty() || !GetFixed64(&input, &edit->new_tables.back().sequence)) {
+                return false;
+            }
+        } else if (field == kTableSketchField) {
+            std::string_view sketch;
+            if (edit->new_tables.empty() || !GetLengthPrefixed(&input, &sketch)) {
+                return false;
+            }
+            edit->new_tables.back().distinct_keys_sketch = sketch;
+        } else if (field == kDeletedTableField) {
+            uint64_t id;
+            if (!GetFixed64(&input, &id)) {
+                return false;
+            }
+            edit->deleted_tables.push_back(id);
+        } else if (field == kNextTableIdField) {
+            if (!GetFixed64(&input, &edit->next_table_id)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+Manifest::Manifest(Env* env, const std::string& dir, uint64_t max_file_size, const FileOptions& options)
+    : env_(env), dir_(dir), max_file_size_(max_file_size), options_(options), next_table_id_(1), number_(0) {}
+
+std::string Manifest::ManifestFileName_(uint64_t number) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%s%06" PRIu64, kManifestPrefix, number);
+    return dir_ + "/" + name;
+}
+
+std::unique_ptr<Manifest> Manifest::Open(Env* env, const std::string& dir, uint64_t max_file_size,
+                                         const FileOptions& options) {
+    std::unique_ptr<Manifest> manifest(new Manifest(env, dir, max_file_size, options));
+    std::string current;
+    if (env->FileExists(dir + "/CURRENT")) {
+        if (!ReadFileToString(env, dir + "/CURRENT", &current) || current.empty() || current.back() != '\n') {
+            return nullptr;
+        }
+        current.pop_back();
+        if (current.compare(0, std::char_traits<char>::length(kManifestPrefix), kManifestPrefix) != 0) {
+            return nullptr;
+        }
+        manifest->number_ = std::strtoull(current.c_str() + std::char_traits<char>::length(kManifestPrefix),
+                                          nullptr, 10);
+
+        // A crash in the middle of an append leaves a torn last record; the edit it held never took effect
+        std::string contents;
+        std::vector<std::string_view> records;
+        bool truncated;
+        if (!ReadFileToString(env, dir + "/" + current, &contents, options) ||
+            !DecodeRecords(contents, true, &records, &truncated)) {
+            return nullptr;
+        }
+        for (std::string_view record : records) {
+            ManifestEdit edit;
+            if (!DecodeEdit(record, &edit)) {
+                return nullptr;
+            }
+            manifest->Apply_(edit);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(manifest->mu_);
+        if (!manifest->WriteSnapshot_()) {
+            return nullptr;
+        }
+    }
+
+    std::vector<std::string> children;
+    env->GetChildren(dir, &children);
+    std::string live_manifest = manifest->ManifestFileName_(manifest->number_);
+    for (const std::string& name : children) {
+        uint64_t id;
+        bool orphan_table = ParseTableFileName(name, &id) && manifest->tables_.count(id) == 0;
+        bool old_manifest = name.compare(0, std::char_traits<char>::length(kManifestPrefix), kManifestPrefix) == 0 &&
+                            dir + "/" + name != live_manifest;
+        if (orphan_table || old_manifest) {
+            env->DeleteFile(dir + "/" + name);
+        }
+    }
+    return manifest;
+}
+
+void Manifest::Apply_(const ManifestEdit& edit) {
+    for (const ManifestEdit::ColumnFamily& cf : edit.column_families) {
+        column_families_[cf.id] = cf;
+    }
+    for (const TableMeta& table : edit.new_tables) {
+        tables_[table.id] = table;
+        next_table_id_ = std::max(next_table_id_, table.id + 1);
+    }
+    for (uint64_t id : edit.deleted_tables) {
+        tables_.erase(id);
+    }
+    next_table_id_ = std::max(next_table_id_, edit.next_table_id);
+}
+
+bool Manifest::WriteSnapshot_() {
+    ManifestEdit snapshot;
+    for (const auto& [id, cf] : column_families_) {
+        snapshot.column_families.push_back(cf);
+    }
+    for (const auto& [id, table] : tables_) {
+        snapshot.new_tables.push_back(table);
+    }
+    snapshot.next_table_id = next_table_id_;
+    std::string record;
+    EncodeRecord(&record, EncodeEdit(snapshot));
+
+    uint64_t number = number_ + 1;
+    std::string path = ManifestFileName_(number);
+    std::unique_ptr<WritableFile> file = env_->NewWritableFile(path, options_);
+    if (!file || !file->AppendAndSync(record)) {
+        env_->DeleteFile(path);
+        return false;
+    }
+
+    // The new manifest takes over once CURRENT is atomically renamed to point at it
+    std::string current = path.substr(dir_.size() + 1) + "\n";
+    std::unique_ptr<WritableFile> current_file = env_->NewWritableFile(dir_ + "/CURRENT.tmp");
+    if (!current_file || !current_file->AppendAndSync(current) || !current_file->Close() ||
+        !env_->RenameFile(dir_ + "/CURRENT.tmp", dir_ + "/CURRENT")) {
+        env_->DeleteFile(dir_ + "/CURRENT.tmp");
+        env_->DeleteFile(path);
+        return false;
+    }
+    // Until the rename is durable a crash may leave CURRENT naming the old manifest, so keep it until then
+    bool synced = env_->SyncDir(dir_);
+    if (file_) {
+        file_->Close();
+        if (synced) {
+            env_->DeleteFile(ManifestFileName_(number_));
+        }
+    }
+    file_ = std::move(file);
+    number_ = number;
+    return true;
+}
+
+bool Manifest::LogAndApply(const ManifestEdit& edit) {
+    std::string record;
+    EncodeRecord(&record, EncodeEdit(edit));
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!file_->AppendAndSync(record)) {
+        return false;
+    }
+    Apply_(edit);
+    if (file_->Size() > max_file_size_) {
+        // On failure the edits keep going to the current manifest, which is still complete
+        WriteSnapshot_();
+    }
+    return true;
+}
+
+std::vector<ManifestEdit::ColumnFamily> Manifest::column_families() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    std::vector<ManifestEdit::ColumnFamily> column_families;
+    for (const auto& [id, cf] : column_families_) {
+        column_families.push_back(cf);
+    }
+    return column_families;
+}
+
+std::vector<TableMeta> Manifest::tables() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    std::vector<TableMeta> tables;
+    for (const auto& [id, table] : tables_) {
+        tables.push_back(table);
+    }
+    return tables;
+}
+
+uint64_t Manifest::next_table_id() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return next_table_id_;
+}
+
+uint64_t Manifest::file_size() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return file_->Size();
+}
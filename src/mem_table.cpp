@@ -1,24 +1,415 @@
 #include "include/mem_table.hpp"
+#include "include/write_buffer_manager.hpp"
+#include "include/crc32c.hpp"
+#include "include/table.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <string_view>
+#include <thread>
 
+// Stored values end in a tag byte naming their entry type; tombstones are stored empty
+static const char kValueTag = 'v';
+// Value followed by its 8-byte expiry time
+static const char kExpiringValueTag = 'e';
+static const char kMergeTag = 'm';
+// Protected entries carry a 4-byte CRC32C of key, value and tag before an uppercase tag
+static const char kProtectedValueTag = 'V';
+static const char kProtectedExpiringValueTag = 'E';
+static const char kProtectedMergeTag = 'M';
+static const size_t kChecksumSize = sizeof(uint32_t);
 
-MemTable::MemTable() {
+static bool is_protected_tag(char tag) {
+    return tag == kProtectedValueTag || tag == kProtectedExpiringValueTag || tag == kProtectedMergeTag;
+}
+
+static char unprotected_tag(char tag) {
+    return is_protected_tag(tag) ? static_cast<char>(tag - 'A' + 'a') : tag;
+}
+
+// CRC of an entry: key, then the value (and expiry) before the checksum, then the unprotected tag
+static uint32_t entry_checksum(const std::string& key, std::string_view body, char tag) {
+    uint32_t crc = Crc32cValue(key.data(), key.size());
+    crc = Crc32cExtend(crc, body.data(), body.size());
+    return Crc32cExtend(crc, &tag, 1);
+}
+
+// Turn an encoded entry into a protected one (tombstones stay empty)
+static void protect_entry(const std::string& key, std::string* stored) {
+    if (stored->empty()) {
+        return;
+    }
+    char tag = stored->back();
+    stored->pop_back();
+    uint32_t crc = entry_checksum(key, *stored, tag);
+    char buf[kChecksumSize];
+    std::memcpy(buf, &crc, sizeof(crc));
+    stored->append(buf, sizeof(buf));
+    stored->push_back(static_cast<char>(tag - 'a' + 'A'));
+}
+
+// Abort on an entry of a protected memtable whose checksum does not match; there is no way to
+// recover the value. Every entry there but a tombstone is protected, so an unprotected tag is
+// corruption too ('V' and 'v' are one bit apart).
+static void verify_entry(const std::string& key, std::string_view stored) {
+    if (stored.empty()) {
+        return;
+    }
+    size_t min_size = 1 + kChecksumSize + (stored.back() == kProtectedExpiringValueTag ? sizeof(uint64_t) : 0);
+    if (!is_protected_tag(stored.back()) || stored.size() < min_size) {
+        std::fprintf(stderr, "MemTable: unprotected entry for key '%s' in a protected memtable\n", key.c_str());
+        std::abort();
+    }
+    size_t body_size = stored.size() - 1 - kChecksumSize;
+    uint32_t expected;
+    std::memcpy(&expected, stored.data() + body_size, sizeof(expected));
+    if (entry_checksum(key, stored.substr(0, body_size), unprotected_tag(stored.back())) != expected) {
+        std::fprintf(stderr, "MemTable: checksum mismatch in the entry for key '%s'\n", key.c_str());
+        std::abort();
+    }
+}
+
+static std::string encode_entry(EntryType type, std::string value, uint64_t expire_at = 0) {
+    if (type == EntryType::kDeletion || (type == EntryType::kValue && value.empty())) {
+        return "";
+    }
+    if (type == EntryType::kMerge) {
+        value.push_back(kMergeTag);
+    } else if (expire_at != 0) {
+        char buf[sizeof(expire_at)];
+        std::memcpy(buf, &expire_at, sizeof(expire_at));
+        value.append(buf, sizeof(buf));
+        value.push_back(kExpiringValueTag);
+    } else {
+        value.push_back(kValueTag);
+    }
+    return value;
+}
+
+// Strip the tag (and expiry) from a stored value and return its type
+static EntryType decode_entry(std::string* stored, uint64_t* expire_at = nullptr) {
+    if (stored->empty()) {
+        return EntryType::kDeletion;
+    }
+    char tag = stored->back();
+    stored->pop_back();
+    if (is_protected_tag(tag)) {
+        tag = unprotected_tag(tag);
+        stored->resize(stored->size() - kChecksumSize);
+    }
+    if (tag == kMergeTag) {
+        return EntryType::kMerge;
+    }
+    uint64_t expiry = 0;
+    if (tag == kExpiringValueTag) {
+        std::memcpy(&expiry, stored->data() + stored->size() - sizeof(expiry), sizeof(expiry));
+        stored->resize(stored->size() - sizeof(expiry));
+    }
+    if (expire_at) {
+        *expire_at = expiry;
+    }
+    return EntryType::kValue;
+}
+
+// decode_entry for stored bytes that cannot be modified; *suffix is how many trailing bytes to drop
+static EntryType decode_entry(std::string_view stored, size_t* suffix, uint64_t* expire_at) {
+    *suffix = 0;
+    *expire_at = 0;
+    if (stored.empty()) {
+        return EntryType::kDeletion;
+    }
+    *suffix = 1;
+    char tag = stored.back();
+    if (is_protected_tag(tag)) {
+        tag = unprotected_tag(tag);
+        *suffix += kChecksumSize;
+    }
+    if (tag == kMergeTag) {
+        return EntryType::kMerge;
+    }
+    if (tag == kExpiringValueTag) {
+        *suffix += sizeof(*expire_at);
+        std::memcpy(expire_at, stored.data() + stored.size() - *suffix, sizeof(*expire_at));
+    }
+    return EntryType::kValue;
+}
+
+// Sizes are accounted without the tag (an expiry or checksum does count)
+static size_t value_size(size_t stored_size) {
+    return stored_size > 0 ? stored_size - 1 : 0;
+}
+
+/**
+ * Feeds BuildFlatMemTableRep the stored encoding of another iterator's entries.
+ * Expired values and values the compaction filter removes turn into
+ * tombstones, or are skipped altogether with drop_deleted (when nothing older
+ * is left for them to hide). With protect, entries get a checksum again.
+ */
+class RewritingIterator : public StorageIterator {
+public:
+    RewritingIterator(StorageIterator* inner, const CompactionFilter* filter, uint64_t now_micros, bool drop_deleted,
+                      bool protect)
+        : inner_(inner), filter_(filter), now_micros_(now_micros), drop_deleted_(drop_deleted), protect_(protect),
+          size_change_(0) {
+        settle(true);
+    }
+
+    std::string key() override { return inner_->key(); }
+    std::string value() override { return stored_; }
+    bool is_valid() override { return inner_->is_valid(); }
+    void next() override {
+        inner_->next();
+        settle(true);
+    }
+    void prev() override {
+        inner_->prev();
+        settle(false);
+    }
+    void seek(const std::string& target) override {
+        inner_->seek(target);
+        settle(true);
+    }
+    void seek_for_prev(const std::string& target) override {
+        inner_->seek_for_prev(target);
+        settle(false);
+    }
+    void seek_to_first() override {
+        inner_->seek_to_first();
+        settle(true);
+    }
+    void seek_to_last() override {
+        inner_->seek_to_last();
+        settle(false);
+    }
+
+    // Bytes (as counted by MemTable::Size) gained or lost by the values rewritten
+    // so far; meaningful after a single forward pass
+    int64_t size_change() const { return size_change_; }
+
+private:
+    StorageIterator* inner_;
+    const CompactionFilter* filter_;
+    uint64_t now_micros_;
+    bool drop_deleted_;
+    bool protect_;
+    int64_t size_change_;
+    std::string stored_;
+
+    // Rewrite the current entry, stepping past dropped ones in the direction of travel
+    void settle(bool forward) {
+        while (inner_->is_valid()) {
+            stored_ = rewrite();
+            if (!stored_.empty() || !drop_deleted_) {
+                if (protect_) {
+                    protect_entry(inner_->key(), &stored_);
+                }
+                return;
+            }
+            if (forward) {
+                inner_->next();
+            } else {
+                inner_->prev();
+            }
+        }
+    }
+
+    std::string rewrite() {
+        EntryType type = inner_->entry_type();
+        if (type != EntryType::kValue) {
+            return encode_entry(type, inner_->value());
+        }
+        uint64_t expire_at = inner_->expire_at_micros();
+        std::string value = inner_->value();
+        size_t original_size = value_size(encode_entry(type, value, expire_at).size());
+
+        std::string stored;
+        if (!IsExpired(expire_at, now_micros_)) {
+            std::string new_value;
+            CompactionFilter::Decision decision =
+                filter_ ? filter_->Filter(inner_->key(), value, &new_value) : CompactionFilter::Decision::kKeep;
+            if (decision == CompactionFilter::Decision::kChangeValue) {
+                stored = encode_entry(type, std::move(new_value), expire_at);
+            } else if (decision == CompactionFilter::Decision::kKeep) {
+                stored = encode_entry(type, std::move(value), expire_at);
+            }
+        }
+        size_change_ += static_cast<int64_t>(value_size(stored.size())) - static_cast<int64_t>(original_size);
+        return stored;
+    }
+};
+
+/**
+ * Rep of a memtable recovered from a table: the entries are loaded into a
+ * flat rep on first use. Keys outside the table's range need no load.
+ * Read-only like the flat rep, so Insert aborts.
+ */
+class LazyTableRep : public MemTableRep {
+public:
+    LazyTableRep(const TableMeta& meta, std::function<std::unique_ptr<StorageIterator>()> load,
+                 const Comparator* comparator, bool protect)
+        : id_(meta.id), num_entries_(static_cast<int>(meta.num_entries)), smallest_(meta.smallest),
+          largest_(meta.largest), load_(std::move(load)), comparator_(comparator), protect_(protect),
+          loaded_(false) {}
+
+    std::optional<size_t> Insert(const std::string&, const std::string&) override {
+        std::fprintf(stderr, "LazyTableRep: Insert into a read-only representation\n");
+        std::abort();
+    }
+
+    std::optional<std::string> Get(const std::string& key) const override {
+        const MemTableRep* rep = InRange(key) ? Loaded() : nullptr;
+        if (!rep) {
+            return std::nullopt;
+        }
+        return rep->Get(key);
+    }
+
+    bool GetInto(const std::string& key, std::string* buffer, std::string_view* value) const override {
+        const MemTableRep* rep = InRange(key) ? Loaded() : nullptr;
+        return rep && rep->GetInto(key, buffer, value);
+    }
+
+    std::unique_ptr<Lookup> NewLookup(const std::string& key) const override {
+        const MemTableRep* rep = InRange(key) ? Loaded() : nullptr;
+        if (!rep) {
+            return MemTableRep::NewLookup(key);
+        }
+        return rep->NewLookup(key);
+    }
+
+    bool NeedsLoad(const std::string& key) const override {
+        return InRange(key) && !loaded_.load(std::memory_order_acquire);
+    }
+
+    bool Load() const override {
+        std::lock_guard<std::mutex> lock(load_lock_);
+        if (loaded_.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        std::unique_ptr<StorageIterator> entries = load_();
+        if (!entries) {
+            return false;
+        }
+        // Nothing is dropped: the entries were rewritten when the table was written
+        RewritingIterator stored(entries.get(), nullptr, 0, false, protect_);
+        rep_ = BuildFlatMemTableRep(&stored, comparator_);
+        loaded_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    int NumEntries() const override { return num_entries_; }
+
+    size_t ApproximateMemoryUsage() const override {
+        return loaded_.load(std::memory_order_acquire) ? rep_->ApproximateMemoryUsage() : 0;
+    }
+
+    std::unique_ptr<Iterator> NewIterator() const override {
+        const MemTableRep* rep = Loaded();
+        if (!rep) {
+            // Iterators have no way to report the failure
+            std::fprintf(stderr, "MemTable: cannot read table %llu\n", static_cast<unsigned long long>(id_));
+            std::abort();
+        }
+        return rep->NewIterator();
+    }
+
+private:
+    uint64_t id_;
+    int num_entries_;
+    std::string smallest_;
+    std::string largest_;
+    std::function<std::unique_ptr<StorageIterator>()> load_;
+    const Comparator* comparator_;
+    bool protect_;
+    // Serializes loads; rep_ is set once, before loaded_
+    mutable std::mutex load_lock_;
+    mutable std::atomic<bool> loaded_;
+    mutable std::unique_ptr<MemTableRep> rep_;
+
+    bool InRange(const std::string& key) const {
+        return num_entries_ > 0 && comparator_->Compare(key, smallest_) >= 0 &&
+               comparator_->Compare(key, largest_) <= 0;
+    }
+
+    // The loaded entries, or nullptr if the table cannot be read
+    const MemTableRep* Loaded() const {
+        if (!loaded_.load(std::memory_order_acquire) && !Load()) {
+            return nullptr;
+        }
+        return rep_.get();
+    }
+};
+
+
+MemTable::MemTable() : MemTable(MemTableOptions()) {}
+
+MemTable::MemTable(const MemTableOptions& options)
+    : MemTable(options, options.rep_factory ? options.rep_factory->CreateMemTableRep(options.comparator)
+                                            : SkipListRepFactory().CreateMemTableRep(options.comparator)) {}
+
+MemTable::MemTable(const MemTableOptions& options, std::unique_ptr<MemTableRep> rep, bool sketch_pending)
+    : rep_(std::move(rep)), write_buffer_manager_(options.write_buffer_manager),
+      charged_bytes_(0), immutable_(false), active_writers_(0),
+      sketch_(sketch_pending ? 0 : HyperLogLog::kDefaultPrecision), sketch_pending_(sketch_pending),
+      range_tombstones_(ComparatorLess{options.comparator}), has_range_tombstones_(false) {
     id_ = 0;
+    sequence_ = 0;
     approximatesize_ = 0;
+    if (options.enable_hash_index) {
+        hash_index_ = std::make_unique<HashTable>();
+    }
+    if (options.prefix_extractor && options.prefix_bloom_bits > 0) {
+        prefix_extractor_ = options.prefix_extractor;
+        prefix_bloom_ = std::make_shared<BloomFilter>(options.prefix_bloom_bits);
+    }
+    comparator_ = options.comparator;
+    merge_operator_ = options.merge_operator;
+    compaction_filter_ = options.compaction_filter;
+    clock_ = options.clock;
+    protect_entries_ = options.protect_entries;
+    verify_checksums_ = options.protect_entries && options.verify_checksums;
 }
 
 MemTable::~MemTable(){
-
+    if (write_buffer_manager_) {
+        if (!immutable_) {
+            write_buffer_manager_->schedule_free_mem(charged_bytes_);
+        }
+        write_buffer_manager_->free_mem(charged_bytes_);
+    }
 }
 
 int MemTable::Id() {
     return id_;
 }
 
+void MemTable::set_id(int id) {
+    id_ = id;
+}
+
+int MemTable::sequence() {
+    return sequence_;
+}
+
+void MemTable::set_sequence(int sequence) {
+    sequence_ = sequence;
+}
+
 int MemTable::Size() {
     return approximatesize_;
 }
+int MemTable::num_entries() {
+    return rep_->NumEntries();
+}
+
+size_t MemTable::memory_usage() {
+    return rep_->ApproximateMemoryUsage() + (hash_index_ ? hash_index_->ApproximateMemoryUsage() : 0);
+}
+
 bool MemTable::isEmpty(){
-    return map_.isEmpty();
+    return rep_->NumEntries() == 0;
 }
 
 void MemTable::Clear() {
@@ -26,65 +417,537 @@ void MemTable::Clear() {
 }
 
 std::optional<std::string> MemTable::get(std::string key){
-    std::optional<std::string> found = map_.Contains(key);
-    return found;
+    std::optional<Entry> entry = get_entry(key);
+    if (!entry.has_value()) {
+        return std::nullopt;
+    }
+    return std::move(entry->value);
+}
+
+std::optional<MemTable::Entry> MemTable::get_entry(const std::string& key) {
+    std::optional<std::string> stored = hash_index_ ? hash_index_->Contains(key) : rep_->Get(key);
+    if (!stored.has_value()) {
+        return std::nullopt;
+    }
+    if (verify_checksums_) {
+        verify_entry(key, *stored);
+    }
+    uint64_t expire_at = 0;
+    EntryType type = decode_entry(&*stored, &expire_at);
+    return Entry{type, std::move(*stored), expire_at};
+}
+
+bool MemTable::get_entry(const std::string& key, PinnableValue* value, EntryType* type, uint64_t* expire_at) {
+    std::string* buffer = value->GetSelf();
+    std::string_view stored;
+    if (hash_index_) {
+        std::optional<std::string> found = hash_index_->Contains(key);
+        if (!found.has_value()) {
+            value->Reset();
+            return false;
+        }
+        *buffer = std::move(*found);
+        stored = *buffer;
+    } else if (!rep_->GetInto(key, buffer, &stored)) {
+        value->Reset();
+        return false;
+    }
+    settle_entry(key, stored, value, type, expire_at);
+    return true;
 }
 
-bool MemTable::put(std::string key, std::string value){
-    auto old = map_.Contains(key);
-    if (old.has_value()) {
-        int delta = value.size() - old->size();
-        approximatesize_.fetch_add(delta);
+bool MemTable::load_for(const std::string& key) {
+    return !rep_->NeedsLoad(key) || rep_->Load();
+}
+
+Task<bool> MemTable::async_load_for(AsyncExecutor& executor, std::string key) {
+    if (!rep_->NeedsLoad(key)) {
+        co_return true;
+    }
+    // Reading the table takes as long as the whole file; run it off the executor thread
+    std::future<bool> loaded =
+        std::async(std::launch::async, [self = shared_from_this()]() { return self->rep_->Load(); });
+    while (loaded.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        co_await executor.yield();
+    }
+    co_return loaded.get();
+}
+
+Task<bool> MemTable::async_get_entry(AsyncExecutor& executor, std::string key, PinnableValue* value, EntryType* type,
+                                     uint64_t* expire_at) {
+    if (hash_index_) {
+        // Already a single probe
+        co_return get_entry(key, value, type, expire_at);
+    }
+    if (!co_await async_load_for(executor, key)) {
+        value->Reset();
+        co_return false;
+    }
+    std::unique_ptr<MemTableRep::Lookup> lookup = rep_->NewLookup(key);
+    while (lookup->Advance()) {
+        co_await executor.yield();
+    }
+    std::string_view stored;
+    if (!lookup->GetInto(value->GetSelf(), &stored)) {
+        value->Reset();
+        co_return false;
+    }
+    settle_entry(key, stored, value, type, expire_at);
+    co_return true;
+}
+
+void MemTable::settle_entry(const std::string& key, std::string_view stored, PinnableValue* value, EntryType* type,
+                            uint64_t* expire_at) {
+    if (verify_checksums_) {
+        verify_entry(key, stored);
+    }
+    std::string* buffer = value->GetSelf();
+    if (stored.data() == buffer->data()) {
+        // Copied into the buffer
+        value->PinSelf();
+    } else if (std::shared_ptr<const MemTable> self = weak_from_this().lock()) {
+        // The rep lent out its own bytes; they live as long as this memtable
+        value->PinSlice(stored, std::move(self));
     } else {
-        approximatesize_.fetch_add(key.size() + value.size());
+        value->PinSelf(stored);
     }
 
-    map_.Insert(key, value);
+    size_t suffix;
+    uint64_t expiry;
+    *type = decode_entry(value->view(), &suffix, &expiry);
+    value->RemoveSuffix(suffix);
+    if (expire_at) {
+        *expire_at = expiry;
+    }
+}
+
+uint64_t MemTable::now_micros() const {
+    return clock_ ? clock_->NowMicros() : 0;
+}
+
+bool MemTable::put(std::string key, std::string value, uint64_t expire_at_micros){
+    if (!rep_->AcceptsKey(key)) {
+        return false;
+    }
+    std::string stored = encode_entry(EntryType::kValue, std::move(value), expire_at_micros);
+    if (merge_operator_) {
+        std::lock_guard<std::mutex> lock(merge_lock_for(key));
+        insert_stored(key, std::move(stored));
+    } else {
+        insert_stored(key, std::move(stored));
+    }
+    return true;
+}
+
+bool MemTable::accepts_key(const std::string& key) const {
+    return rep_->AcceptsKey(key);
+}
+
+bool MemTable::merge(std::string key, std::string operand) {
+    if (!merge_operator_ || !rep_->AcceptsKey(key)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(merge_lock_for(key));
+    std::optional<Entry> existing = get_entry(key);
+    std::string stored;
+    if (!existing.has_value()) {
+        // The value it applies to, if any, is in an older memtable
+        stored = encode_entry(EntryType::kMerge, std::move(operand));
+    } else if (existing->type == EntryType::kMerge) {
+        stored = encode_entry(EntryType::kMerge, merge_operator_->Merge(&existing->value, operand));
+    } else if (existing->type == EntryType::kValue && !IsExpired(existing->expire_at, now_micros())) {
+        // The merged value expires with the value it was folded onto
+        stored = encode_entry(EntryType::kValue, merge_operator_->Merge(&existing->value, operand),
+                              existing->expire_at);
+    } else {
+        stored = encode_entry(EntryType::kValue, merge_operator_->Merge(nullptr, operand));
+    }
+    insert_stored(key, std::move(stored));
     return true;
 }
 
+std::mutex& MemTable::merge_lock_for(const std::string& key) {
+    return merge_locks_[std::hash<std::string>{}(key) % kMergeLockStripes];
+}
+
+void MemTable::insert_stored(const std::string& key, std::string stored) {
+    if (protect_entries_) {
+        protect_entry(key, &stored);
+    }
+    // Filter first: a scan that finds the key in the rep must also pass the filter
+    if (prefix_bloom_ && prefix_extractor_->InDomain(key)) {
+        prefix_bloom_->Add(prefix_extractor_->Transform(key));
+    }
+
+    std::optional<size_t> old_size;
+    size_t index_growth = 0;
+    if (hash_index_) {
+        std::lock_guard<std::mutex> lock(index_write_lock_);
+        old_size = rep_->Insert(key, stored);
+        size_t index_before = hash_index_->ApproximateMemoryUsage();
+        hash_index_->Insert(key, stored);
+        size_t index_after = hash_index_->ApproximateMemoryUsage();
+        index_growth = index_after > index_before ? index_after - index_before : 0;
+    } else {
+        old_size = rep_->Insert(key, stored);
+    }
+
+    int delta;
+    if (old_size.has_value()) {
+        delta = static_cast<int>(value_size(stored.size())) - static_cast<int>(value_size(*old_size));
+    } else {
+        delta = key.size() + value_size(stored.size());
+    }
+    approximatesize_.fetch_add(delta);
+
+    // Only growth is charged; shrinking overwrites keep their reservation until destruction.
+    // The hash index holds its own copy of each entry, so its growth is charged too.
+    size_t charge = (delta > 0 ? static_cast<size_t>(delta) : 0) + index_growth;
+    if (write_buffer_manager_ && charge > 0) {
+        write_buffer_manager_->reserve_mem(charge);
+        charged_bytes_.fetch_add(charge);
+    }
+
+    sketch_.AddHashConcurrent(HyperLogLog::Hash(key));
+}
+
+void MemTable::delete_range(const std::string& begin, const std::string& end) {
+    {
+        std::lock_guard<std::mutex> lock(range_tombstone_lock_);
+        add_range_tombstone_locked(begin, end);
+    }
+
+    int delta = begin.size() + end.size();
+    approximatesize_.fetch_add(delta);
+    if (write_buffer_manager_) {
+        write_buffer_manager_->reserve_mem(delta);
+        charged_bytes_.fetch_add(delta);
+    }
+}
+
+void MemTable::add_range_tombstone_locked(std::string begin, std::string end) {
+    // Start from the last range beginning at or before begin, in case it reaches it
+    auto it = range_tombstones_.upper_bound(begin);
+    if (it != range_tombstones_.begin() && !comparator_->Less(std::prev(it)->second, begin)) {
+        --it;
+    }
+    // Absorb every range that overlaps or touches [begin, end)
+    while (it != range_tombstones_.end() && !comparator_->Less(end, it->first)) {
+        if (comparator_->Less(it->first, begin)) {
+            begin = it->first;
+        }
+        if (comparator_->Less(end, it->second)) {
+            end = it->second;
+        }
+        it = range_tombstones_.erase(it);
+    }
+    range_tombstones_.emplace(std::move(begin), std::move(end));
+    range_tombstone_snapshot_.reset();
+    has_range_tombstones_.store(true, std::memory_order_release);
+}
+
+bool MemTable::is_range_deleted(const std::string& key) const {
+    if (!has_range_tombstones_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(range_tombstone_lock_);
+    auto it = range_tombstones_.upper_bound(key);
+    if (it == range_tombstones_.begin()) {
+        return false;
+    }
+    --it;
+    return comparator_->Less(key, it->second);
+}
+
+std::shared_ptr<const std::vector<RangeTombstone>> MemTable::range_tombstones() const {
+    if (!has_range_tombstones_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(range_tombstone_lock_);
+    if (!range_tombstone_snapshot_) {
+        auto snapshot = std::make_shared<std::vector<RangeTombstone>>();
+        snapshot->reserve(range_tombstones_.size());
+        for (const auto& [begin, end] : range_tombstones_) {
+            snapshot->push_back({begin, end});
+        }
+        range_tombstone_snapshot_ = std::move(snapshot);
+    }
+    return range_tombstone_snapshot_;
+}
+
+void MemTable::mark_immutable() {
+    if (immutable_.exchange(true)) {
+        return;
+    }
+    int appended = rep_->NumEntries();
+    rep_->MarkReadOnly();
+    if (rep_->NumEntries() < appended) {
+        // The rep (e.g. the vector rep) only dropped overwritten entries now, so the
+        // overwrites were counted as new keys; count what survived instead
+        size_t size = 0;
+        for (auto entries = rep_->NewIterator(); entries->is_valid(); entries->next()) {
+            size += entries->key().size() + value_size(entries->value().size());
+        }
+        approximatesize_ = static_cast<int>(size);
+    }
+    if (write_buffer_manager_) {
+        write_buffer_manager_->schedule_free_mem(charged_bytes_);
+    }
+}
+
+bool MemTable::may_contain_prefix(const std::string& prefix) const {
+    return !prefix_bloom_ || prefix_bloom_->MayContain(prefix);
+}
+
+bool MemTable::is_immutable() const {
+    return immutable_;
+}
+
+void MemTable::ref_writer() {
+    active_writers_.fetch_add(1);
+}
+
+void MemTable::unref_writer() {
+    active_writers_.fetch_sub(1, std::memory_order_release);
+}
+
+void MemTable::wait_for_writers() const {
+    // Writers only hold a pin for the length of one insert, so spinning is cheap
+    while (active_writers_.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+
+HyperLogLog MemTable::distinct_keys_sketch() const {
+    std::lock_guard<std::mutex> lock(sketch_lock_);
+    if (sketch_pending_) {
+        sketch_ = HyperLogLog();
+        for (auto entries = rep_->NewIterator(); entries->is_valid(); entries->next()) {
+            sketch_.Add(entries->key());
+        }
+        sketch_pending_ = false;
+    }
+    return sketch_.Snapshot();
+}
+
+std::shared_ptr<MemTable> MemTable::flatten() {
+    MemTableIterator source(rep_->NewIterator(), nullptr, verify_checksums_);
+    // Older memtables may hold the key, so removed values must stay as tombstones
+    RewritingIterator rewritten(&source, compaction_filter_.get(), now_micros(), false, protect_entries_);
+    MemTableOptions options;
+    options.write_buffer_manager = write_buffer_manager_;
+    options.comparator = comparator_;
+    options.protect_entries = protect_entries_;
+    options.verify_checksums = verify_checksums_;
+    // The flat rep binary searches as fast as a hash probe, so no index is rebuilt
+    std::shared_ptr<MemTable> flat(new MemTable(options, BuildFlatMemTableRep(&rewritten, comparator_)));
+
+    flat->id_ = id_;
+    flat->sequence_ = sequence_;
+    flat->approximatesize_ = static_cast<int>(approximatesize_.load() + rewritten.size_change());
+    flat->sketch_ = distinct_keys_sketch();
+    flat->prefix_extractor_ = prefix_extractor_;
+    flat->prefix_bloom_ = prefix_bloom_;
+    {
+        std::lock_guard<std::mutex> lock(range_tombstone_lock_);
+        flat->range_tombstones_ = range_tombstones_;
+        flat->range_tombstone_snapshot_ = range_tombstone_snapshot_;
+        flat->has_range_tombstones_ = has_range_tombstones_.load();
+    }
+    flat->immutable_ = true;
+
+    // Charge the copy as frozen memory; this memtable releases its own charge when dropped
+    if (write_buffer_manager_) {
+        size_t charged = charged_bytes_.load();
+        write_buffer_manager_->reserve_mem(charged);
+        write_buffer_manager_->schedule_free_mem(charged);
+        flat->charged_bytes_ = charged;
+    }
+    return flat;
+}
+
+std::shared_ptr<MemTable> MemTable::create_flat(StorageIterator* iter, const MemTableOptions& options) {
+    MemTableOptions flat_options;
+    flat_options.write_buffer_manager = options.write_buffer_manager;
+    flat_options.prefix_extractor = options.prefix_extractor;
+    flat_options.prefix_bloom_bits = options.prefix_bloom_bits;
+    flat_options.comparator = options.comparator;
+    flat_options.protect_entries = options.protect_entries;
+    flat_options.verify_checksums = options.verify_checksums;
+    uint64_t now_micros = options.clock ? options.clock->NowMicros() : 0;
+    RewritingIterator rewritten(iter, options.compaction_filter.get(), now_micros, true, options.protect_entries);
+    std::shared_ptr<MemTable> flat(new MemTable(flat_options, BuildFlatMemTableRep(&rewritten, options.comparator)));
+
+    size_t size = 0;
+    auto entries = flat->rep_->NewIterator();
+    while (entries->is_valid()) {
+        std::string key = entries->key();
+        size += key.size() + value_size(entries->value().size());
+        flat->sketch_.Add(key);
+        if (flat->prefix_bloom_ && flat->prefix_extractor_->InDomain(key)) {
+            flat->prefix_bloom_->Add(flat->prefix_extractor_->Transform(key));
+        }
+        entries->next();
+    }
+    flat->approximatesize_ = static_cast<int>(size);
+    flat->immutable_ = true;
+
+    if (flat->write_buffer_manager_) {
+        flat->write_buffer_manager_->reserve_mem(size);
+        flat->write_buffer_manager_->schedule_free_mem(size);
+        flat->charged_bytes_ = size;
+    }
+    return flat;
+}
+
+std::shared_ptr<MemTable> MemTable::create_lazy(const TableMeta& meta,
+                                                std::function<std::unique_ptr<StorageIterator>()> load,
+                                                const MemTableOptions& options) {
+    MemTableOptions lazy_options;
+    lazy_options.write_buffer_manager = options.write_buffer_manager;
+    lazy_options.comparator = options.comparator;
+    lazy_options.protect_entries = options.protect_entries;
+    lazy_options.verify_checksums = options.verify_checksums;
+    std::shared_ptr<MemTable> lazy(new MemTable(
+        lazy_options,
+        std::make_unique<LazyTableRep>(meta, std::move(load), options.comparator, options.protect_entries), true));
+
+    lazy->id_ = static_cast<int>(meta.id);
+    lazy->sequence_ = static_cast<int>(meta.sequence);
+    lazy->approximatesize_ = static_cast<int>(meta.size);
+    // Otherwise distinct_keys_sketch() builds it from the entries
+    lazy->sketch_pending_ = !lazy->sketch_.Decode(meta.distinct_keys_sketch);
+    {
+        std::lock_guard<std::mutex> lock(lazy->range_tombstone_lock_);
+        for (const RangeTombstone& tombstone : meta.range_tombstones) {
+            lazy->add_range_tombstone_locked(tombstone.begin, tombstone.end);
+        }
+    }
+    lazy->immutable_ = true;
+
+    // Charged as frozen memory up front, like create_flat, though it is only read on first use
+    if (lazy->write_buffer_manager_) {
+        size_t size = static_cast<size_t>(meta.size);
+        lazy->write_buffer_manager_->reserve_mem(size);
+        lazy->write_buffer_manager_->schedule_free_mem(size);
+        lazy->charged_bytes_ = size;
+    }
+    return lazy;
+}
+
 // MemTableIterator constructors
-MemTable::MemTableIterator::MemTableIterator() 
-    : current_node_(nullptr) {}
+MemTable::MemTableIterator::MemTableIterator() {}
 
-MemTable::MemTableIterator::MemTableIterator(SkipList::Node* current)
-    : current_node_(current) {}
+MemTable::MemTableIterator::MemTableIterator(std::unique_ptr<MemTableRep::Iterator> rep_iter,
+                                             std::shared_ptr<const MemTable> owner, bool verify_checksums)
+    : owner_(std::move(owner)), rep_iter_(std::move(rep_iter)), verify_checksums_(verify_checksums) {}
+
+void MemTable::MemTableIterator::decode() {
+    if (decoded_) {
+        return;
+    }
+    value_ = rep_iter_->value();
+    if (verify_checksums_) {
+        verify_entry(rep_iter_->key(), value_);
+    }
+    expire_at_ = 0;
+    type_ = decode_entry(&value_, &expire_at_);
+    decoded_ = true;
+}
 
 // MemTableIterator methods
 std::string MemTable::MemTableIterator::key() {
-    return current_node_ ? current_node_->key : "";
+    return is_valid() ? rep_iter_->key() : "";
 }
 
 std::string MemTable::MemTableIterator::value() {
-    return current_node_ ? current_node_->value : "";
+    if (!is_valid()) {
+        return "";
+    }
+    decode();
+    return value_;
+}
+
+EntryType MemTable::MemTableIterator::entry_type() {
+    if (!is_valid()) {
+        return EntryType::kDeletion;
+    }
+    decode();
+    return type_;
+}
+
+uint64_t MemTable::MemTableIterator::expire_at_micros() {
+    if (!is_valid()) {
+        return 0;
+    }
+    decode();
+    return expire_at_;
 }
 
 bool MemTable::MemTableIterator::is_valid() {
-    return current_node_ != nullptr;
+    return rep_iter_ && rep_iter_->is_valid();
 }
 
 void MemTable::MemTableIterator::next() {
-    if (current_node_) {
-        current_node_ = current_node_->next[0];
+    if (is_valid()) {
+        rep_iter_->next();
+        decoded_ = false;
+    }
+}
+
+void MemTable::MemTableIterator::prev() {
+    if (is_valid()) {
+        rep_iter_->prev();
+        decoded_ = false;
+    }
+}
+
+void MemTable::MemTableIterator::seek(const std::string& target) {
+    if (rep_iter_) {
+        rep_iter_->seek(target);
+        decoded_ = false;
+    }
+}
+
+void MemTable::MemTableIterator::seek_for_prev(const std::string& target) {
+    if (rep_iter_) {
+        rep_iter_->seek_for_prev(target);
+        decoded_ = false;
+    }
+}
+
+void MemTable::MemTableIterator::seek_to_first() {
+    if (rep_iter_) {
+        rep_iter_->seek_to_first();
+        decoded_ = false;
+    }
+}
+
+void MemTable::MemTableIterator::seek_to_last() {
+    if (rep_iter_) {
+        rep_iter_->seek_to_last();
+        decoded_ = false;
     }
 }
 
 // MemTable iterator factory methods
 MemTable::MemTableIterator MemTable::begin() const {
-    return MemTableIterator(map_.head_->next[0]);
+    return MemTableIterator(rep_->NewIterator(), weak_from_this().lock(), verify_checksums_);
 }
 
 MemTable::MemTableIterator MemTable::scan(const std::string& lower_bound, const std::string& upper_bound) const {
-    auto skip_iter = map_.scan(lower_bound);
-    // Since MemTable is a friend of SkipList, we can access the private current_ member
-    return MemTableIterator(skip_iter.current_);
+    auto rep_iter = rep_->NewIterator();
+    rep_iter->seek(lower_bound);
+    return MemTableIterator(std::move(rep_iter), weak_from_this().lock(), verify_checksums_);
 }
 
 std::unique_ptr<MemTable::MemTableIterator> MemTable::begin_ptr() const {
-    return std::make_unique<MemTableIterator>(map_.head_->next[0]);
+    return std::make_unique<MemTableIterator>(rep_->NewIterator(), weak_from_this().lock(), verify_checksums_);
 }
 
 std::unique_ptr<MemTable::MemTableIterator> MemTable::scan_ptr(const std::string& lower_bound, const std::string& upper_bound) const {
-    auto skip_iter = map_.scan(lower_bound);
-    return std::make_unique<MemTableIterator>(skip_iter.current_);
-}
\ No newline at end of file
+    auto rep_iter = rep_->NewIterator();
+    rep_iter->seek(lower_bound);
+    return std::make_unique<MemTableIterator>(std::move(rep_iter), weak_from_this().lock(), verify_checksums_);
+}
@@ -0,0 +1,581 @@
+#include "include/memtable_rep.hpp"
+#include "include/data_structures/skiplist.hpp"
+#include "include/data_structures/btree.hpp"
+#include "include/data_structures/key_prefix.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+bool MemTableRep::GetInto(const std::string& key, std::string* buffer, std::string_view* value) const {
+    std::optional<std::string> found = Get(key);
+    if (!found.has_value()) {
+        return false;
+    }
+    *buffer = std::move(*found);
+    *value = *buffer;
+    return true;
+}
+
+namespace {
+
+// Single-step lookup for representations without a resumable search
+class WholeLookup : public MemTableRep::Lookup {
+public:
+    WholeLookup(const MemTableRep* rep, std::string key) : rep_(rep), key_(std::move(key)) {}
+
+    bool Advance() override { return false; }
+
+    bool GetInto(std::string* buffer, std::string_view* value) override {
+        return rep_->GetInto(key_, buffer, value);
+    }
+
+private:
+    const MemTableRep* rep_;
+    std::string key_;
+};
+
+}  // namespace
+
+std::unique_ptr<MemTableRep::Lookup> MemTableRep::NewLookup(const std::string& key) const {
+    return std::make_unique<WholeLookup>(this, key);
+}
+
+namespace {
+
+// ---- Skip list ----
+
+// Fixed-width keys are decoded into the node; strings are stored as they are
+template <typename Key, typename Compare = std::less<Key>>
+class SkipListRep : public MemTableRep {
+public:
+    using List = BasicSkipList<Key, Compare>;
+    static constexpr size_t kKeyWidth = KeyCodec<Key>::kWidth;
+
+    explicit SkipListRep(Compare compare = Compare()) : list_(std::move(compare)) {}
+
+    bool AcceptsKey(const std::string& key) const override {
+        return kKeyWidth == 0 || key.size() == kKeyWidth;
+    }
+
+    std::optional<size_t> Insert(const std::string& key, const std::string& value) override {
+        bool truncated;
+        Key list_key = KeyCodec<Key>::Decode(key, &truncated);
+        if (truncated || !AcceptsKey(key)) {
+            // Storing it would alias it with another key
+            std::fprintf(stderr, "SkipListRep: %zu-byte key in a %zu-byte key representation\n", key.size(), kKeyWidth);
+            std::abort();
+        }
+        // One hint per writer thread, so an ascending run of keys splices in
+        // where the previous one landed; it is ignored for other lists
+        thread_local typename List::InsertHint hint;
+        std::optional<size_t> old_size = list_.Upsert(list_key, value, &hint);
+        if (old_size.has_value()) {
+            memory_usage_.fetch_add(static_cast<int64_t>(value.size()) - static_cast<int64_t>(*old_size));
+            return old_size;
+        }
+        // Expected tower height is 2 with p = 0.5; fixed-width keys live inside the node
+        size_t key_bytes = kKeyWidth == 0 ? key.size() : 0;
+        memory_usage_.fetch_add(key_bytes + value.size() + sizeof(typename List::Node) + 2 * sizeof(void*));
+        return std::nullopt;
+    }
+
+    std::optional<std::string> Get(const std::string& key) const override {
+        if (kKeyWidth != 0 && key.size() != kKeyWidth) {
+            return std::nullopt;
+        }
+        bool truncated;
+        return list_.Contains(KeyCodec<Key>::Decode(key, &truncated));
+    }
+
+    bool GetInto(const std::string& key, std::string* buffer, std::string_view* value) const override {
+        if (kKeyWidth != 0 && key.size() != kKeyWidth) {
+            return false;
+        }
+        bool truncated;
+        bool read_only = read_only_.load(std::memory_order_acquire);
+        return list_.Find(KeyCodec<Key>::Decode(key, &truncated), [&](const std::string& stored) {
+            Deliver_(stored, read_only, buffer, value);
+        });
+    }
+
+    int NumEntries() const override {
+        return list_.Size();
+    }
+
+    size_t ApproximateMemoryUsage() const override {
+        return static_cast<size_t>(memory_usage_.load());
+    }
+
+    void MarkReadOnly() override {
+        read_only_.store(true, std::memory_order_release);
+    }
+
+    class Lookup : public MemTableRep::Lookup {
+    public:
+        Lookup(const SkipListRep* rep, Key key) : rep_(rep), cursor_(&rep->list_, std::move(key)) {}
+
+        bool Advance() override { return cursor_.Step(); }
+
+        bool GetInto(std::string* buffer, std::string_view* value) override {
+            bool read_only = rep_->read_only_.load(std::memory_order_acquire);
+            return cursor_.Finish([&](const std::string& stored) { Deliver_(stored, read_only, buffer, value); });
+        }
+
+    private:
+        const SkipListRep* rep_;
+        typename List::LookupCursor cursor_;
+    };
+
+    std::unique_ptr<MemTableRep::Lookup> NewLookup(const std::string& key) const override {
+        if (kKeyWidth != 0 && key.size() != kKeyWidth) {
+            return MemTableRep::NewLookup(key);
+        }
+        bool truncated;
+        return std::make_unique<Lookup>(this, KeyCodec<Key>::Decode(key, &truncated));
+    }
+
+    class Iterator : public MemTableRep::Iterator {
+    public:
+        explicit Iterator(const List* list) : iter_(list->begin()) {}
+        std::string key() override { return iter_.key(); }
+        std::string value() override { return iter_.value(); }
+        bool is_valid() override { return iter_.is_valid(); }
+        void next() override { iter_.next(); }
+        void prev() override { iter_.prev(); }
+        void seek(const std::string& target) override { iter_.seek(target); }
+        void seek_for_prev(const std::string& target) override { iter_.seek_for_prev(target); }
+        void seek_to_first() override { iter_.seek_to_first(); }
+        void seek_to_last() override { iter_.seek_to_last(); }
+
+    private:
+        typename List::SkipListIterator iter_;
+    };
+
+    std::unique_ptr<MemTableRep::Iterator> NewIterator() const override {
+        return std::make_unique<Iterator>(&list_);
+    }
+
+private:
+    // Once read-only no insert can overwrite a node's value, so it can be lent out
+    static void Deliver_(const std::string& stored, bool read_only, std::string* buffer, std::string_view* value) {
+        if (read_only) {
+            *value = stored;
+        } else {
+            buffer->assign(stored);
+            *value = *buffer;
+        }
+    }
+
+    List list_;
+    std::atomic<int64_t> memory_usage_{0};
+    std::atomic<bool> read_only_{false};
+};
+
+// ---- B+tree ----
+
+class BTreeRep : public MemTableRep {
+public:
+    std::optional<size_t> Insert(const std::string& key, const std::string& value) override {
+        // One descent finds the leaf and reports what it replaced there
+        std::optional<size_t> old_size = tree_.Insert(key, value);
+        // Overwrites publish a new entry and keep the old one alive until the tree is destroyed
+        memory_usage_.fetch_add(key.size() + value.size() + sizeof(BTree::Entry) + kLeafSlotOverhead);
+        return old_size;
+    }
+
+    std::optional<std::string> Get(const std::string& key) const override {
+        return tree_.Contains(key);
+    }
+
+    int NumEntries() const override {
+        return tree_.Size();
+    }
+
+    size_t ApproximateMemoryUsage() const override {
+        return memory_usage_.load();
+    }
+
+    class Iterator : public MemTableRep::Iterator {
+    public:
+        explicit Iterator(const BTree* tree) : iter_(tree->begin()) {}
+        std::string key() override { return iter_.key(); }
+        std::string value() override { return iter_.value(); }
+        bool is_valid() override { return iter_.is_valid(); }
+        void next() override { iter_.next(); }
+        void prev() override { iter_.prev(); }
+        void seek(const std::string& target) override { iter_.seek(target); }
+        void seek_for_prev(const std::string& target) override { iter_.seek_for_prev(target); }
+        void seek_to_first() override { iter_.seek_to_first(); }
+        void seek_to_last() override { iter_.seek_to_last(); }
+
+    private:
+        BTree::BTreeIterator iter_;
+    };
+
+    std::unique_ptr<MemTableRep::Iterator> NewIterator() const override {
+        return std::make_unique<Iterator>(&tree_);
+    }
+
+private:
+    // Prefix + pointer per slot, with leaves about 70% full on random inserts
+    static constexpr size_t kLeafSlotOverhead = (sizeof(uint64_t) + sizeof(void*)) * 10 / 7;
+
+    BTree tree_;
+    std::atomic<size_t> memory_usage_{0};
+};
+
+// ---- Vector ----
+
+using VectorEntries = std::vector<std::pair<std::string, std::string>>;
+
+// Stable sort by key and keep only the last write of each key
+void SortAndDedup(VectorEntries& entries, const Comparator* comparator) {
+    std::stable_sort(entries.begin(), entries.end(),
+                     [comparator](const auto& a, const auto& b) { return comparator->Less(a.first, b.first); });
+    size_t out = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (out > 0 && entries[out - 1].first == entries[i].first) {
+            entries[out - 1] = std::move(entries[i]);
+        } else {
+            if (out != i) entries[out] = std::move(entries[i]);
+            ++out;
+        }
+    }
+    entries.resize(out);
+}
+
+class VectorRep : public MemTableRep {
+public:
+    VectorRep(size_t reserve_entries, const Comparator* comparator)
+        : comparator_(comparator), entries_(std::make_shared<VectorEntries>()), read_only_(false), bytes_(0) {
+        entries_->reserve(reserve_entries);
+    }
+
+    std::optional<size_t> Insert(const std::string& key, const std::string& value) override {
+        std::unique_lock<std::shared_mutex> lk(mu_);
+        entries_->emplace_back(key, value);
+        bytes_ += key.size() + value.size();
+        return std::nullopt;
+    }
+
+    std::optional<std::string> Get(const std::string& key) const override {
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        if (read_only_) {
+            auto it = std::lower_bound(entries_->begin(), entries_->end(), key,
+                                       [this](const auto& e, const std::string& k) {
+                                           return comparator_->Less(e.first, k);
+                                       });
+            if (it != entries_->end() && it->first == key) return it->second;
+            return std::nullopt;
+        }
+        // Unsorted: newest write of a key is the last one appended
+        for (auto it = entries_->rbegin(); it != entries_->rend(); ++it) {
+            if (it->first == key) return it->second;
+        }
+        return std::nullopt;
+    }
+
+    int NumEntries() const override {
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        return static_cast<int>(entries_->size());
+    }
+
+    size_t ApproximateMemoryUsage() const override {
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        return bytes_ + entries_->capacity() * sizeof(VectorEntries::value_type);
+    }
+
+    void MarkReadOnly() override {
+        std::unique_lock<std::shared_mutex> lk(mu_);
+        if (read_only_) return;
+        SortAndDedup(*entries_, comparator_);
+        entries_->shrink_to_fit();
+        read_only_ = true;
+    }
+
+    class Iterator : public MemTableRep::Iterator {
+    public:
+        Iterator(std::shared_ptr<const VectorEntries> entries, const Comparator* comparator)
+            : entries_(std::move(entries)), comparator_(comparator), pos_(0) {}
+        std::string key() override { return (*entries_)[pos_].first; }
+        std::string value() override { return (*entries_)[pos_].second; }
+        bool is_valid() override { return pos_ < entries_->size(); }
+        void next() override { ++pos_; }
+        // Stepping back from the first entry parks at size(), which is invalid
+        void prev() override { pos_ = pos_ == 0 ? entries_->size() : pos_ - 1; }
+        void seek(const std::string& target) override {
+            auto it = std::lower_bound(entries_->begin(), entries_->end(), target,
+                                       [this](const auto& e, const std::string& k) {
+                                           return comparator_->Less(e.first, k);
+                                       });
+            pos_ = static_cast<size_t>(it - entries_->begin());
+        }
+        void seek_for_prev(const std::string& target) override {
+            auto it = std::upper_bound(entries_->begin(), entries_->end(), target,
+                                       [this](const std::string& k, const auto& e) {
+                                           return comparator_->Less(k, e.first);
+                                       });
+            pos_ = it == entries_->begin() ? entries_->size()
+                                           : static_cast<size_t>(it - entries_->begin()) - 1;
+        }
+        void seek_to_first() override { pos_ = 0; }
+        void seek_to_last() override { pos_ = entries_->empty() ? 0 : entries_->size() - 1; }
+
+    private:
+        std::shared_ptr<const VectorEntries> entries_;
+        const Comparator* comparator_;
+        size_t pos_;
+    };
+
+    std::unique_ptr<MemTableRep::Iterator> NewIterator() const override {
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        if (read_only_) {
+            return std::make_unique<Iterator>(entries_, comparator_);
+        }
+        // Still accepting writes: iterate a sorted snapshot
+        auto snapshot = std::make_shared<VectorEntries>(*entries_);
+        SortAndDedup(*snapshot, comparator_);
+        return std::make_unique<Iterator>(std::move(snapshot), comparator_);
+    }
+
+private:
+    const Comparator* comparator_;
+    mutable std::shared_mutex mu_;
+    std::shared_ptr<VectorEntries> entries_;
+    bool read_only_;
+    size_t bytes_;
+};
+
+// ---- Flat (read-only) ----
+
+class FlatRep : public MemTableRep {
+public:
+    FlatRep(StorageIterator* iter, const Comparator* comparator)
+        : bytewise_(comparator == BytewiseComparator()), comparator_(comparator) {
+        while (iter->is_valid()) {
+            std::string key = iter->key();
+            std::string value = iter->value();
+            Slot slot;
+            slot.key_offset = data_.size();
+            slot.key_size = static_cast<uint32_t>(key.size());
+            data_.append(key);
+            slot.value_offset = data_.size();
+            slot.value_size = static_cast<uint32_t>(value.size());
+            data_.append(value);
+            slots_.push_back(slot);
+            if (bytewise_) {
+                prefixes_.push_back(KeyPrefix(key));
+            }
+            iter->next();
+        }
+        data_.shrink_to_fit();
+        slots_.shrink_to_fit();
+        prefixes_.shrink_to_fit();
+        if (!bytewise_) {
+            return;
+        }
+
+        // Eytzinger layout: node k has children 2k and 2k+1, so the first levels of
+        // every search share cache lines and the next levels can be prefetched
+        eytzinger_prefixes_.resize(slots_.size() + 1);
+        eytzinger_to_sorted_.resize(slots_.size() + 1);
+        size_t next = 0;
+        BuildEytzinger_(1, next);
+    }
+
+    // Built complete and never written again; an insert would be lost, so it is fatal in every build
+    std::optional<size_t> Insert(const std::string&, const std::string&) override {
+        std::fprintf(stderr, "FlatRep: Insert into a read-only representation\n");
+        std::abort();
+    }
+
+    std::optional<std::string> Get(const std::string& key) const override {
+        size_t i = LowerBound(key);
+        if (i < slots_.size() && Key(i) == key) {
+            return std::string(Value(i));
+        }
+        return std::nullopt;
+    }
+
+    // Nothing can replace a value here, so it is always handed out in place and no buffer is needed
+    bool GetInto(const std::string& key, std::string*, std::string_view* value) const override {
+        size_t i = LowerBound(key);
+        if (i < slots_.size() && Key(i) == key) {
+            *value = Value(i);
+            return true;
+        }
+        return false;
+    }
+
+    int NumEntries() const override {
+        return static_cast<int>(slots_.size());
+    }
+
+    size_t ApproximateMemoryUsage() const override {
+        return data_.capacity() + slots_.capacity() * sizeof(Slot) +
+               prefixes_.capacity() * sizeof(uint64_t) +
+               eytzinger_prefixes_.capacity() * sizeof(uint64_t) +
+               eytzinger_to_sorted_.capacity() * sizeof(uint32_t);
+    }
+
+    // Index of the first entry whose key is >= key
+    size_t LowerBound(const std::string& key) const {
+        const size_t n = slots_.size();
+        if (!bytewise_) {
+            size_t lo = 0;
+            size_t hi = n;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (comparator_->Less(std::string(Key(mid)), key)) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo;
+        }
+        const uint64_t prefix = KeyPrefix(key);
+
+        // Branch-free descent; afterwards k encodes the last left turn
+        size_t k = 1;
+        while (k <= n) {
+            __builtin_prefetch(eytzinger_prefixes_.data() + std::min(16 * k, n));
+            k = 2 * k + (eytzinger_prefixes_[k] < prefix);
+        }
+        k >>= __builtin_ffsll(~static_cast<long long>(k));
+        size_t i = (k == 0) ? n : eytzinger_to_sorted_[k];
+
+        // Prefix ties: fall back to full key comparison. Keys sharing their first
+        // 8 bytes (e.g. "counter1234") can tie across most of the table, so
+        // binary search the run: ties with a smaller key all come first.
+        if (i >= n || prefixes_[i] != prefix || Key(i) >= key) {
+            return i;
+        }
+        size_t lo = i + 1;
+        size_t hi = n;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (prefixes_[mid] == prefix && Key(mid) < key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    std::string_view Key(size_t i) const {
+        return std::string_view(data_.data() + slots_[i].key_offset, slots_[i].key_size);
+    }
+
+    std::string_view Value(size_t i) const {
+        return std::string_view(data_.data() + slots_[i].value_offset, slots_[i].value_size);
+    }
+
+    size_t Count() const {
+        return slots_.size();
+    }
+
+    class Iterator : public MemTableRep::Iterator {
+    public:
+        explicit Iterator(const FlatRep* rep) : rep_(rep), pos_(0) {}
+        std::string key() override { return std::string(rep_->Key(pos_)); }
+        std::string value() override { return std::string(rep_->Value(pos_)); }
+        bool is_valid() override { return pos_ < rep_->Count(); }
+        void next() override { ++pos_; }
+        void prev() override { pos_ = pos_ == 0 ? rep_->Count() : pos_ - 1; }
+        void seek(const std::string& target) override { pos_ = rep_->LowerBound(target); }
+        void seek_for_prev(const std::string& target) override {
+            size_t i = rep_->LowerBound(target);
+            if (i < rep_->Count() && rep_->Key(i) == target) {
+                pos_ = i;
+            } else {
+                pos_ = i == 0 ? rep_->Count() : i - 1;
+            }
+        }
+        void seek_to_first() override { pos_ = 0; }
+        void seek_to_last() override { pos_ = rep_->Count() == 0 ? 0 : rep_->Count() - 1; }
+
+    private:
+        const FlatRep* rep_;
+        size_t pos_;
+    };
+
+    std::unique_ptr<MemTableRep::Iterator> NewIterator() const override {
+        return std::make_unique<Iterator>(this);
+    }
+
+private:
+    struct Slot {
+        size_t key_offset;
+        size_t value_offset;
+        uint32_t key_size;
+        uint32_t value_size;
+    };
+
+    // Prefix search only agrees with the bytewise order
+    bool bytewise_;
+    const Comparator* comparator_;
+
+    // Every key and value back to back
+    std::string data_;
+    std::vector<Slot> slots_;
+    std::vector<uint64_t> prefixes_;
+
+    // 1-based Eytzinger order of prefixes_, and the sorted index of each node
+    std::vector<uint64_t> eytzinger_prefixes_;
+    std::vector<uint32_t> eytzinger_to_sorted_;
+
+    void BuildEytzinger_(size_t k, size_t& next) {
+        if (k > slots_.size()) return;
+        BuildEytzinger_(2 * k, next);
+        eytzinger_prefixes_[k] = prefixes_[next];
+        eytzinger_to_sorted_[k] = static_cast<uint32_t>(next);
+        ++next;
+        BuildEytzinger_(2 * k + 1, next);
+    }
+};
+
+} // namespace
+
+std::unique_ptr<MemTableRep> BuildFlatMemTableRep(StorageIterator* iter, const Comparator* comparator) {
+    return std::make_unique<FlatRep>(iter, comparator);
+}
+
+std::unique_ptr<MemTableRep> SkipListRepFactory::CreateMemTableRep(const Comparator* comparator) const {
+    // std::less avoids a virtual call per comparison in the common case
+    if (comparator == BytewiseComparator()) {
+        return std::make_unique<SkipListRep<std::string>>();
+    }
+    return std::make_unique<SkipListRep<std::string, ComparatorLess>>(ComparatorLess{comparator});
+}
+
+std::unique_ptr<MemTableRep> FixedKeySkipListRepFactory::CreateMemTableRep(const Comparator* comparator) const {
+    if (comparator == BytewiseComparator()) {
+        if (key_size_ == KeyCodec<uint64_t>::kWidth) {
+            return std::make_unique<SkipListRep<uint64_t>>();
+        }
+        if (key_size_ == KeyCodec<Uuid>::kWidth) {
+            return std::make_unique<SkipListRep<Uuid>>();
+        }
+    }
+    return SkipListRepFactory().CreateMemTableRep(comparator);
+}
+
+std::unique_ptr<MemTableRep> BTreeRepFactory::CreateMemTableRep(const Comparator* comparator) const {
+    if (comparator != BytewiseComparator()) {
+        return SkipListRepFactory().CreateMemTableRep(comparator);
+    }
+    return std::make_unique<BTreeRep>();
+}
+
+std::unique_ptr<MemTableRep> VectorRepFactory::CreateMemTableRep(const Comparator* comparator) const {
+    return std::make_unique<VectorRep>(reserve_entries_, comparator);
+}
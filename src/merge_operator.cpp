@@ -0,0 +1,35 @@
+#include "include/merge_operator.hpp"
+#include <cstdint>
+#include <cstdlib>
+
+std::string MergeOperator::FullMerge(const std::string* existing, const std::vector<std::string>& operands) const {
+    std::string result = existing ? *existing : std::string();
+    bool has_value = existing != nullptr;
+    for (auto it = operands.rbegin(); it != operands.rend(); ++it) {
+        result = Merge(has_value ? &result : nullptr, *it);
+        has_value = true;
+    }
+    return result;
+}
+
+static int64_t parse_int(const std::string& value) {
+    return std::strtoll(value.c_str(), nullptr, 10);
+}
+
+std::string AddOperator::Merge(const std::string* existing, const std::string& operand) const {
+    int64_t base = existing ? parse_int(*existing) : 0;
+    // Wrap like unsigned addition instead of overflowing
+    return std::to_string(static_cast<int64_t>(static_cast<uint64_t>(base) + static_cast<uint64_t>(parse_int(operand))));
+}
+
+std::string StringAppendOperator::Merge(const std::string* existing, const std::string& operand) const {
+    if (!existing) {
+        return operand;
+    }
+    std::string result;
+    result.reserve(existing->size() + 1 + operand.size());
+    result.append(*existing);
+    result.push_back(delimiter_);
+    result.append(operand);
+    return result;
+}
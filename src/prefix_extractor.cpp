@@ -0,0 +1,29 @@
+#include "include/prefix_extractor.hpp"
+
+std::string FixedPrefixExtractor::Transform(const std::string& key) const {
+    return key.substr(0, prefix_len_);
+}
+
+bool FixedPrefixExtractor::InDomain(const std::string& key) const {
+    return key.size() >= prefix_len_;
+}
+
+size_t DelimiterPrefixExtractor::PrefixLength_(const std::string& key) const {
+    size_t pos = 0;
+    for (int i = 0; i < count_; ++i) {
+        size_t found = key.find(delimiter_, pos);
+        if (found == std::string::npos) {
+            return std::string::npos;
+        }
+        pos = found + 1;
+    }
+    return pos;
+}
+
+std::string DelimiterPrefixExtractor::Transform(const std::string& key) const {
+    return key.substr(0, PrefixLength_(key));
+}
+
+bool DelimiterPrefixExtractor::InDomain(const std::string& key) const {
+    return PrefixLength_(key) != std::string::npos;
+}
@@ -0,0 +1,78 @@
+#include "include/range_tombstone.hpp"
+#include <algorithm>
+#include <map>
+#include <set>
+
+FragmentedRangeTombstones::FragmentedRangeTombstones(
+    const std::vector<std::pair<RangeTombstone, size_t>>& tombstones, const Comparator* comparator)
+    : comparator_(comparator) {
+    ComparatorLess less{comparator};
+    std::vector<const std::pair<RangeTombstone, size_t>*> by_begin;
+    std::vector<std::string> boundaries;
+    for (const auto& tombstone : tombstones) {
+        if (!less(tombstone.first.begin, tombstone.first.end)) {
+            continue;
+        }
+        by_begin.push_back(&tombstone);
+        boundaries.push_back(tombstone.first.begin);
+        boundaries.push_back(tombstone.first.end);
+    }
+    std::sort(by_begin.begin(), by_begin.end(), [&less](const auto* a, const auto* b) {
+        return less(a->first.begin, b->first.begin);
+    });
+    std::sort(boundaries.begin(), boundaries.end(), less);
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    // Sweep the boundaries keeping the tombstones that overlap the current gap
+    std::multimap<std::string, size_t, ComparatorLess> active_by_end(less);
+    std::multiset<size_t> active;
+    size_t next = 0;
+    for (size_t i = 0; i + 1 < boundaries.size(); i++) {
+        const std::string& begin = boundaries[i];
+        while (!active_by_end.empty() && !less(begin, active_by_end.begin()->first)) {
+            active.erase(active.find(active_by_end.begin()->second));
+            active_by_end.erase(active_by_end.begin());
+        }
+        while (next < by_begin.size() && by_begin[next]->first.begin == begin) {
+            active_by_end.emplace(by_begin[next]->first.end, by_begin[next]->second);
+            active.insert(by_begin[next]->second);
+            next++;
+        }
+        if (active.empty()) {
+            continue;
+        }
+
+        size_t first_covered = *active.begin();
+        if (!fragments_.empty() && fragments_.back().end == begin &&
+            fragments_.back().first_covered == first_covered) {
+            fragments_.back().end = boundaries[i + 1];
+        } else {
+            fragments_.push_back({begin, boundaries[i + 1], first_covered});
+        }
+    }
+}
+
+bool FragmentedRangeTombstones::empty() const {
+    return fragments_.empty();
+}
+
+const std::vector<FragmentedRangeTombstones::Fragment>& FragmentedRangeTombstones::fragments() const {
+    return fragments_;
+}
+
+const FragmentedRangeTombstones::Fragment* FragmentedRangeTombstones::find(const std::string& key) const {
+    // First fragment ending after key; it holds key if it also starts at or before it
+    auto it = std::upper_bound(fragments_.begin(), fragments_.end(), key,
+                               [this](const std::string& k, const Fragment& fragment) {
+                                   return comparator_->Less(k, fragment.end);
+                               });
+    if (it == fragments_.end() || comparator_->Less(key, it->begin)) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool FragmentedRangeTombstones::covers(const std::string& key, size_t source) const {
+    const Fragment* fragment = find(key);
+    return fragment && source >= fragment->first_covered;
+}
@@ -0,0 +1,134 @@
+#include "include/rate_limiter.hpp"
+#include <algorithm>
+
+RateLimiter::RateLimiter(int64_t max_bytes_per_second, bool auto_tuned, std::chrono::microseconds refill_period)
+    : max_bytes_per_second_(std::max<int64_t>(max_bytes_per_second, 1)),
+      auto_tuned_(auto_tuned),
+      refill_period_(std::max(refill_period, std::chrono::microseconds(1))),
+      leader_waiting_(false),
+      num_refills_(0),
+      num_drains_(0),
+      total_bytes_{},
+      total_requests_{} {
+    SetBytesPerSecondLocked_(max_bytes_per_second_);
+    available_bytes_ = refill_bytes_;
+    next_refill_ = Clock::now() + refill_period_;
+    tuned_time_ = Clock::now();
+}
+
+int64_t RateLimiter::GetBytesPerSecond() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return bytes_per_second_;
+}
+
+void RateLimiter::SetBytesPerSecond(int64_t bytes_per_second) {
+    std::lock_guard<std::mutex> lock(mu_);
+    SetBytesPerSecondLocked_(bytes_per_second);
+}
+
+void RateLimiter::SetBytesPerSecondLocked_(int64_t bytes_per_second) {
+    bytes_per_second_ = std::max<int64_t>(bytes_per_second, 1);
+    refill_bytes_ = std::max<size_t>(1, bytes_per_second_ * refill_period_.count() / 1000000);
+}
+
+size_t RateLimiter::GetSingleBurstBytes() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return refill_bytes_;
+}
+
+int64_t RateLimiter::GetTotalBytesThrough(IOPriority priority) const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return total_bytes_[static_cast<int>(priority)];
+}
+
+int64_t RateLimiter::GetTotalRequests(IOPriority priority) const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return total_requests_[static_cast<int>(priority)];
+}
+
+void RateLimiter::Request(size_t bytes, IOPriority priority) {
+    std::unique_lock<std::mutex> lock(mu_);
+    int p = static_cast<int>(priority);
+    total_requests_[p]++;
+    while (bytes > 0) {
+        size_t chunk = std::min(bytes, refill_bytes_);
+        RequestLocked_(lock, chunk, p);
+        bytes -= chunk;
+    }
+}
+
+void RateLimiter::RequestLocked_(std::unique_lock<std::mutex>& lock, size_t bytes, int priority) {
+    Clock::time_point now = Clock::now();
+    if (auto_tuned_ && now >= tuned_time_ + refill_period_ * kRefillsPerTune) {
+        Tune_(now);
+    }
+    bool queued = std::any_of(std::begin(queues_), std::end(queues_), [](const std::deque<Req*>& q) {
+        return !q.empty();
+    });
+    if (!queued && now >= next_refill_) {
+        RefillAndGrant_(now);
+    }
+    if (!queued && available_bytes_ >= bytes) {
+        available_bytes_ -= bytes;
+        total_bytes_[priority] += bytes;
+        return;
+    }
+
+    Req req{bytes, false};
+    queues_[priority].push_back(&req);
+    while (!req.granted) {
+        if (!leader_waiting_) {
+            leader_waiting_ = true;
+            // Only the leader grants, so nothing wakes it before the refill
+            cv_.wait_until(lock, next_refill_);
+            if (Clock::now() >= next_refill_) {
+                RefillAndGrant_(Clock::now());
+            }
+            leader_waiting_ = false;
+            // Hand the lead to a waiter that is still queued
+            cv_.notify_all();
+        } else {
+            cv_.wait(lock);
+        }
+    }
+    total_bytes_[priority] += bytes;
+}
+
+void RateLimiter::RefillAndGrant_(Clock::time_point now) {
+    available_bytes_ = refill_bytes_;
+    next_refill_ = now + refill_period_;
+    num_refills_++;
+
+    for (int p = kNumPriorities - 1; p >= 0 && available_bytes_ > 0; p--) {
+        std::deque<Req*>& queue = queues_[p];
+        while (!queue.empty() && available_bytes_ > 0) {
+            Req* req = queue.front();
+            if (req->bytes > available_bytes_) {
+                // Partly granted; it stays at the front for the rest
+                req->bytes -= available_bytes_;
+                available_bytes_ = 0;
+                break;
+            }
+            available_bytes_ -= req->bytes;
+            req->granted = true;
+            queue.pop_front();
+        }
+    }
+    if (available_bytes_ == 0) {
+        num_drains_++;
+    }
+}
+
+void RateLimiter::Tune_(Clock::time_point now) {
+    // Refills rather than elapsed periods: a waiter that oversleeps must not look like idle time
+    int64_t drained_pct = num_drains_ * 100 / std::max<int64_t>(1, num_refills_);
+    int64_t min_bytes_per_second = std::max<int64_t>(1, max_bytes_per_second_ / 20);
+    if (drained_pct > 90) {
+        SetBytesPerSecondLocked_(std::min(max_bytes_per_second_, bytes_per_second_ * 105 / 100 + 1));
+    } else if (drained_pct < 50) {
+        SetBytesPerSecondLocked_(std::max(min_bytes_per_second, bytes_per_second_ * 100 / 105));
+    }
+    tuned_time_ = now;
+    num_refills_ = 0;
+    num_drains_ = 0;
+}
@@ -0,0 +1,52 @@
+#include "include/record_file.hpp"
+#include "include/coding.hpp"
+#include "include/crc32c.hpp"
+
+void EncodeRecord(std::string* dst, std::string_view payload) {
+    PutFixed32(dst, Crc32cMask(Crc32cValue(payload.data(), payload.size())));
+    PutFixed32(dst, static_cast<uint32_t>(payload.size()));
+    dst->append(payload.data(), payload.size());
+}
+
+bool DecodeRecords(std::string_view contents, bool verify_checksums, std::vector<std::string_view>* records,
+                   bool* truncated) {
+    if (truncated) {
+        *truncated = false;
+    }
+    while (!contents.empty()) {
+        uint32_t masked_crc;
+        uint32_t size;
+        bool complete = GetFixed32(&contents, &masked_crc) && GetFixed32(&contents, &size) && contents.size() >= size;
+        if (!complete) {
+            if (truncated) {
+                *truncated = true;
+                return true;
+            }
+            return false;
+        }
+        std::string_view payload = contents.substr(0, size);
+        if (verify_checksums && Crc32cUnmask(masked_crc) != Crc32cValue(payload.data(), payload.size())) {
+            return false;
+        }
+        records->push_back(payload);
+        contents.remove_prefix(size);
+    }
+    return true;
+}
+
+bool ReadFileToString(Env* env, const std::string& path, std::string* contents, const FileOptions& options) {
+    uint64_t size;
+    std::unique_ptr<RandomAccessFile> file = env->NewRandomAccessFile(path, options);
+    if (!file || !env->GetFileSize(path, &size)) {
+        return false;
+    }
+    contents->resize(size);
+    std::string_view result;
+    if (!file->Read(0, size, contents->data(), &result) || result.size() != size) {
+        return false;
+    }
+    if (result.data() != contents->data()) {
+        contents->assign(result.data(), result.size());
+    }
+    return true;
+}
@@ -0,0 +1,165 @@
+#include "include/sharded_lsm.hpp"
+#include "include/iterators/merge_iterator.hpp"
+#include <algorithm>
+#include <functional>
+
+ShardedLsm::ShardedLsm() : ShardedLsm(ShardedLsmOptions()) {}
+
+ShardedLsm::ShardedLsm(const ShardedLsmOptions& options)
+    : policy_(options.policy),
+      comparator_(options.shard_options.comparator ? options.shard_options.comparator : BytewiseComparator()) {
+    size_t count;
+    if (policy_ == ShardingPolicy::kRange) {
+        split_keys_ = options.split_keys;
+        std::sort(split_keys_.begin(), split_keys_.end(), ComparatorLess{comparator_});
+        split_keys_.erase(std::unique(split_keys_.begin(), split_keys_.end()), split_keys_.end());
+        count = split_keys_.size() + 1;
+    } else {
+        count = std::max<size_t>(options.num_shards, 1);
+    }
+
+    shards_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        shards_.push_back(std::make_unique<LsmStorageInner>(options.shard_options));
+    }
+}
+
+ShardedLsm::~ShardedLsm() {}
+
+size_t ShardedLsm::num_shards() const {
+    return shards_.size();
+}
+
+size_t ShardedLsm::shard_for(const std::string& key) const {
+    if (policy_ == ShardingPolicy::kRange) {
+        // Number of split keys <= key is the index of the range holding it
+        return std::upper_bound(split_keys_.begin(), split_keys_.end(), key, ComparatorLess{comparator_}) -
+               split_keys_.begin();
+    }
+
+    // Mix std::hash so shard selection does not depend on its low-bit quality
+    uint64_t h = std::hash<std::string>{}(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h % shards_.size();
+}
+
+std::optional<std::string> ShardedLsm::get(const std::string& key) {
+    return shards_[shard_for(key)]->get(key);
+}
+
+bool ShardedLsm::get(const std::string& key, PinnableValue* value) {
+    return shards_[shard_for(key)]->get(key, value);
+}
+
+bool ShardedLsm::put(const std::string& key, const std::string& value) {
+    return shards_[shard_for(key)]->put(key, value);
+}
+
+bool ShardedLsm::put(const std::string& key, const std::string& value, std::chrono::microseconds ttl) {
+    return shards_[shard_for(key)]->put(key, value, ttl);
+}
+
+bool ShardedLsm::delete_key(const std::string& key) {
+    return shards_[shard_for(key)]->delete_key(key);
+}
+
+bool ShardedLsm::merge(const std::string& key, const std::string& operand) {
+    return shards_[shard_for(key)]->merge(key, operand);
+}
+
+void ShardedLsm::delete_range(const std::string& begin, const std::string& end) {
+    if (!comparator_->Less(begin, end)) {
+        return;
+    }
+    size_t first = 0;
+    size_t last = shards_.size() - 1;
+    if (policy_ == ShardingPolicy::kRange) {
+        first = shard_for(begin);
+        last = shard_for(end);
+    }
+    for (size_t i = first; i <= last; i++) {
+        shards_[i]->delete_range(begin, end);
+    }
+}
+
+std::unique_ptr<FusedIterator> ShardedLsm::scan() {
+    if (shards_.size() == 1) {
+        return shards_[0]->scan();
+    }
+
+    // Each shard iterator already hides its tombstones and no key lives in two
+    // shards, so a plain merge yields the final sequence. With range shards the
+    // inputs are disjoint ranges in index order and the merge just concatenates.
+    std::vector<std::unique_ptr<StorageIterator>> iters;
+    iters.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        iters.push_back(shard->scan());
+    }
+    return FusedIterator::create(MergeIterator::create(std::move(iters), comparator_));
+}
+
+std::unique_ptr<FusedIterator> ShardedLsm::reverse_scan() {
+    std::unique_ptr<FusedIterator> iter = scan();
+    iter->seek_to_last();
+    return iter;
+}
+
+std::unique_ptr<FusedIterator> ShardedLsm::reverse_scan(const std::string& upper_bound) {
+    std::unique_ptr<FusedIterator> iter = scan();
+    iter->seek_for_prev(upper_bound);
+    return iter;
+}
+
+std::unique_ptr<FusedIterator> ShardedLsm::scan_prefix(const std::string& prefix) {
+    size_t first = 0;
+    size_t last = shards_.size() - 1;
+    auto has_prefix = [&prefix](const std::string& key) { return key.compare(0, prefix.size(), prefix) == 0; };
+    if (policy_ == ShardingPolicy::kRange && comparator_ == BytewiseComparator()) {
+        // Every key with the prefix is >= prefix and < any larger key not starting with it
+        first = shard_for(prefix);
+        last = first;
+        while (last + 1 < shards_.size() && has_prefix(split_keys_[last])) {
+            last++;
+        }
+    } else if (policy_ == ShardingPolicy::kRange && comparator_ == ReverseBytewiseComparator()) {
+        // Mirrored: the keys with the prefix sort before it, down to the first key without it
+        last = shard_for(prefix);
+        first = last;
+        while (first > 0 && has_prefix(split_keys_[first - 1])) {
+            first--;
+        }
+    }
+    if (first == last) {
+        return shards_[first]->scan_prefix(prefix);
+    }
+
+    std::vector<std::unique_ptr<StorageIterator>> iters;
+    for (size_t i = first; i <= last; i++) {
+        iters.push_back(shards_[i]->scan_prefix(prefix));
+    }
+    return FusedIterator::create(MergeIterator::create(std::move(iters), comparator_));
+}
+
+void ShardedLsm::force_freeze_memtable() {
+    for (const auto& shard : shards_) {
+        shard->force_freeze_memtable();
+    }
+}
+
+size_t ShardedLsm::approximate_distinct_keys() {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard->approximate_distinct_keys();
+    }
+    return total;
+}
+
+size_t ShardedLsm::num_entries() {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard->num_entries();
+    }
+    return total;
+}
@@ -0,0 +1,196 @@
+#include "include/table.hpp"
+#include "include/coding.hpp"
+#include "include/mem_table.hpp"
+#include "include/record_file.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+// First byte of each record payload
+static const char kBlockRecord = 'b';
+static const char kFooterRecord = 'f';
+
+// Entry types in a block
+static const char kValueEntry = 'v';
+static const char kDeletionEntry = 'd';
+static const char kMergeEntry = 'm';
+
+std::string TableFileName(const std::string& dir, uint64_t id) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/%06" PRIu64 ".sst", id);
+    return dir + name;
+}
+
+bool ParseTableFileName(const std::string& name, uint64_t* id) {
+    const std::string suffix = ".sst";
+    if (name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        return false;
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < name.size() - suffix.size(); i++) {
+        if (name[i] < '0' || name[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (name[i] - '0');
+    }
+    *id = value;
+    return true;
+}
+
+bool WriteTable(Env* env, const std::string& path, const FileOptions& options, MemTable* memtable, TableMeta* meta) {
+    std::unique_ptr<WritableFile> file = env->NewWritableFile(path, options);
+    if (!file) {
+        return false;
+    }
+    meta->size = memtable->Size();
+    meta->num_entries = 0;
+    meta->smallest.clear();
+    meta->largest.clear();
+    meta->range_tombstones.clear();
+    if (std::shared_ptr<const std::vector<RangeTombstone>> tombstones = memtable->range_tombstones()) {
+        meta->range_tombstones = *tombstones;
+    }
+
+    std::string block(1, kBlockRecord);
+    std::string records;
+    auto flush_block = [&]() {
+        EncodeRecord(&records, block);
+        block.resize(1);
+        bool ok = file->Append(records);
+        records.clear();
+        return ok;
+    };
+    for (auto iter = memtable->begin(); iter.is_valid(); iter.next()) {
+        std::string key = iter.key();
+        EntryType type = iter.entry_type();
+        PutLengthPrefixed(&block, key);
+        if (type == EntryType::kValue) {
+            block.push_back(kValueEntry);
+            PutFixed64(&block, iter.expire_at_micros());
+        } else {
+            block.push_back(type == EntryType::kMerge ? kMergeEntry : kDeletionEntry);
+        }
+        PutLengthPrefixed(&block, type == EntryType::kDeletion ? std::string() : iter.value());
+
+        if (meta->num_entries == 0) {
+            meta->smallest = key;
+        }
+        meta->largest = std::move(key);
+        meta->num_entries++;
+        if (block.size() >= kTableBlockSize && !flush_block()) {
+            return false;
+        }
+    }
+    if (block.size() > 1 && !flush_block()) {
+        return false;
+    }
+
+    std::string footer(1, kFooterRecord);
+    PutFixed64(&footer, meta->num_entries);
+    EncodeRecord(&records, footer);
+    return file->AppendAndSync(records) && file->Close();
+}
+
+namespace {
+
+// Entries decoded from a table, in key order
+class TableIterator : public StorageIterator {
+public:
+    struct Entry {
+        std::string key;
+        EntryType type;
+        std::string value;
+        uint64_t expire_at;
+    };
+
+    TableIterator(std::vector<Entry> entries, const Comparator* comparator)
+        : entries_(std::move(entries)), comparator_(comparator), index_(0) {}
+
+    std::string key() override { return is_valid() ? entries_[index_].key : ""; }
+    std::string value() override { return is_valid() ? entries_[index_].value : ""; }
+    bool is_valid() override { return index_ < entries_.size(); }
+    void next() override { index_++; }
+    // Stepping back from the first entry parks at size(), which is invalid
+    void prev() override { index_ = index_ == 0 ? entries_.size() : index_ - 1; }
+    void seek(const std::string& target) override {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), target,
+                                   [this](const Entry& e, const std::string& k) { return comparator_->Less(e.key, k); });
+        index_ = static_cast<size_t>(it - entries_.begin());
+    }
+    void seek_for_prev(const std::string& target) override {
+        auto it = std::upper_bound(entries_.begin(), entries_.end(), target,
+                                   [this](const std::string& k, const Entry& e) { return comparator_->Less(k, e.key); });
+        index_ = it == entries_.begin() ? entries_.size() : static_cast<size_t>(it - entries_.begin()) - 1;
+    }
+    void seek_to_first() override { index_ = 0; }
+    void seek_to_last() override { index_ = entries_.empty() ? 0 : entries_.size() - 1; }
+    EntryType entry_type() override { return is_valid() ? entries_[index_].type : EntryType::kDeletion; }
+    uint64_t expire_at_micros() override { return is_valid() ? entries_[index_].expire_at : 0; }
+
+private:
+    std::vector<Entry> entries_;
+    const Comparator* comparator_;
+    size_t index_;
+};
+
+bool DecodeBlock(std::string_view block, std::vector<TableIterator::Entry>* entries) {
+    while (!block.empty()) {
+        TableIterator::Entry entry{"", EntryType::kValue, "", 0};
+        std::string_view key;
+        std::string_view value;
+        if (!GetLengthPrefixed(&block, &key) || block.empty()) {
+            return false;
+        }
+        char type = block.front();
+        block.remove_prefix(1);
+        if (type == kValueEntry) {
+            if (!GetFixed64(&block, &entry.expire_at)) {
+                return false;
+            }
+        } else if (type == kMergeEntry) {
+            entry.type = EntryType::kMerge;
+        } else if (type == kDeletionEntry) {
+            entry.type = EntryType::kDeletion;
+        } else {
+            return false;
+        }
+        if (!GetLengthPrefixed(&block, &value)) {
+            return false;
+        }
+        entry.key = key;
+        entry.value = value;
+        entries->push_back(std::move(entry));
+    }
+    return true;
+}
+
+}  // namespace
+
+std::unique_ptr<StorageIterator> ReadTable(Env* env, const std::string& path, const FileOptions& options,
+                                           bool verify_checksums, const Comparator* comparator) {
+    std::string contents;
+    std::vector<std::string_view> records;
+    if (!ReadFileToString(env, path, &contents, options) || !DecodeRecords(contents, verify_checksums, &records) ||
+        records.empty()) {
+        return nullptr;
+    }
+
+    std::vector<TableIterator::Entry> entries;
+    for (size_t i = 0; i + 1 < records.size(); i++) {
+        std::string_view block = records[i];
+        if (block.empty() || block.front() != kBlockRecord || !DecodeBlock(block.substr(1), &entries)) {
+            return nullptr;
+        }
+    }
+    // The footer must come last and agree, so a file cut at a record boundary is caught too
+    std::string_view footer = records.back();
+    uint64_t num_entries;
+    if (footer.empty() || footer.front() != kFooterRecord) {
+        return nullptr;
+    }
+    footer.remove_prefix(1);
+    if (!GetFixed64(&footer, &num_entries) || num_entries != entries.size()) {
+        return nullptr;
+    }
+    return std::make_unique<TableIterator>(std::move(entries), comparator);
+}
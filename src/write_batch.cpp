@@ -0,0 +1,54 @@
+#include "include/write_batch.hpp"
+
+void WriteBatch::put(const std::string& key, const std::string& value) {
+    put(nullptr, key, value);
+}
+
+void WriteBatch::put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value) {
+    operations_.push_back({cf, EntryType::kValue, key, value, std::nullopt, std::nullopt});
+}
+
+void WriteBatch::put(const std::string& key, const std::string& value, std::chrono::microseconds ttl) {
+    put(nullptr, key, value, ttl);
+}
+
+void WriteBatch::put(ColumnFamilyHandle* cf, const std::string& key, const std::string& value,
+                     std::chrono::microseconds ttl) {
+    operations_.push_back({cf, EntryType::kValue, key, value, ttl, std::nullopt});
+}
+
+void WriteBatch::delete_key(const std::string& key) {
+    delete_key(nullptr, key);
+}
+
+void WriteBatch::delete_key(ColumnFamilyHandle* cf, const std::string& key) {
+    operations_.push_back({cf, EntryType::kDeletion, key, "", std::nullopt, std::nullopt});
+}
+
+void WriteBatch::merge(const std::string& key, const std::string& operand) {
+    merge(nullptr, key, operand);
+}
+
+void WriteBatch::merge(ColumnFamilyHandle* cf, const std::string& key, const std::string& operand) {
+    operations_.push_back({cf, EntryType::kMerge, key, operand, std::nullopt, std::nullopt});
+}
+
+void WriteBatch::delete_range(const std::string& begin, const std::string& end) {
+    delete_range(nullptr, begin, end);
+}
+
+void WriteBatch::delete_range(ColumnFamilyHandle* cf, const std::string& begin, const std::string& end) {
+    operations_.push_back({cf, EntryType::kDeletion, begin, "", std::nullopt, end});
+}
+
+void WriteBatch::clear() {
+    operations_.clear();
+}
+
+size_t WriteBatch::count() const {
+    return operations_.size();
+}
+
+const std::vector<WriteBatch::Operation>& WriteBatch::operations() const {
+    return operations_;
+}
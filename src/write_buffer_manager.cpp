@@ -0,0 +1,123 @@
+#include "include/write_buffer_manager.hpp"
+#include "include/lsm_storage.hpp"
+#include <algorithm>
+
+MemoryBudget::MemoryBudget() : usage_(0) {}
+
+void MemoryBudget::charge(size_t bytes) {
+    usage_.fetch_add(bytes);
+}
+
+void MemoryBudget::release(size_t bytes) {
+    usage_.fetch_sub(bytes);
+}
+
+size_t MemoryBudget::usage() const {
+    return usage_.load();
+}
+
+
+WriteBufferManager::WriteBufferManager(size_t buffer_size, std::shared_ptr<MemoryBudget> cache_budget)
+    : buffer_size_(buffer_size),
+      cache_budget_(std::move(cache_budget)),
+      memory_used_(0),
+      memory_active_(0) {}
+
+WriteBufferManager::~WriteBufferManager() {
+    // Give back whatever is still charged so the shared budget stays consistent
+    if (cache_budget_) {
+        cache_budget_->release(memory_used_.load());
+    }
+}
+
+bool WriteBufferManager::enabled() const {
+    return buffer_size_ > 0;
+}
+
+size_t WriteBufferManager::buffer_size() const {
+    return buffer_size_;
+}
+
+size_t WriteBufferManager::memory_usage() const {
+    return memory_used_.load();
+}
+
+size_t WriteBufferManager::mutable_memory_usage() const {
+    return memory_active_.load();
+}
+
+bool WriteBufferManager::should_freeze() const {
+    if (!enabled()) {
+        return false;
+    }
+    return memory_active_.load() > buffer_size_;
+}
+
+void WriteBufferManager::reserve_mem(size_t bytes) {
+    memory_used_.fetch_add(bytes);
+    memory_active_.fetch_add(bytes);
+    if (cache_budget_) {
+        cache_budget_->charge(bytes);
+    }
+}
+
+void WriteBufferManager::schedule_free_mem(size_t bytes) {
+    memory_active_.fetch_sub(bytes);
+}
+
+void WriteBufferManager::free_mem(size_t bytes) {
+    memory_used_.fetch_sub(bytes);
+    if (cache_budget_) {
+        cache_budget_->release(bytes);
+    }
+}
+
+void WriteBufferManager::register_instance(LsmStorageInner* inner) {
+    std::lock_guard<std::mutex> lock(instances_lock_);
+    instances_.push_back(inner);
+}
+
+void WriteBufferManager::unregister_instance(LsmStorageInner* inner) {
+    std::unique_lock<std::mutex> lock(instances_lock_);
+    instances_.erase(std::remove(instances_.begin(), instances_.end(), inner), instances_.end());
+    candidates_cv_.wait(lock, [&] {
+        return std::find(candidates_.begin(), candidates_.end(), inner) == candidates_.end();
+    });
+}
+
+bool WriteBufferManager::freeze_largest() {
+    std::unique_lock<std::mutex> freeze_lock(freeze_lock_, std::try_to_lock);
+    // Whoever holds it is already freeing up room
+    if (!freeze_lock.owns_lock()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(instances_lock_);
+        // Another writer may have already freed up room while we got here
+        if (!should_freeze()) {
+            return false;
+        }
+        candidates_ = instances_;
+    }
+
+    // Instances take their own state locks, so the manager's lock is not held from here on
+    LsmStorageInner* largest = nullptr;
+    int largest_size = 0;
+    for (LsmStorageInner* inner : candidates_) {
+        int size = inner->largest_memtable_size();
+        if (size > largest_size) {
+            largest = inner;
+            largest_size = size;
+        }
+    }
+    if (largest != nullptr) {
+        largest->freeze_largest_memtable();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(instances_lock_);
+        candidates_.clear();
+    }
+    candidates_cv_.notify_all();
+    return largest != nullptr;
+}
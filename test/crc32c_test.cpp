@@ -0,0 +1,57 @@
+#include "src/include/crc32c.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+static uint32_t Value(const std::string& s) {
+    return Crc32cValue(s.data(), s.size());
+}
+
+TEST(Crc32cTest, StandardResults) {
+    // From RFC 3720, section B.4
+    std::string buf(32, '\0');
+    EXPECT_EQ(Value(buf), 0x8a9136aau);
+    buf.assign(32, '\xff');
+    EXPECT_EQ(Value(buf), 0x62a8ab43u);
+    for (int i = 0; i < 32; i++) {
+        buf[i] = static_cast<char>(i);
+    }
+    EXPECT_EQ(Value(buf), 0x46dd794eu);
+    for (int i = 0; i < 32; i++) {
+        buf[i] = static_cast<char>(31 - i);
+    }
+    EXPECT_EQ(Value(buf), 0x113fdb5cu);
+    EXPECT_EQ(Value("123456789"), 0xe3069283u);
+    EXPECT_EQ(Value(""), 0u);
+}
+
+TEST(Crc32cTest, AcceleratedMatchesPortable) {
+    std::mt19937 rng(49);
+    // Long enough for the three-stream paths, at every alignment
+    std::string data(3 * 8192 * 2 + 3 * 256 + 100, '\0');
+    for (char& c : data) {
+        c = static_cast<char>(rng());
+    }
+    for (size_t offset = 0; offset < 9; offset++) {
+        for (size_t n : {size_t(0), size_t(1), size_t(7), size_t(64), size_t(3 * 256), size_t(3 * 256 + 13),
+                         size_t(3 * 8192), data.size() - offset}) {
+            n = std::min(n, data.size() - offset);
+            EXPECT_EQ(Crc32cExtend(0x12345678, data.data() + offset, n),
+                      Crc32cExtendPortable(0x12345678, data.data() + offset, n))
+                << offset << " " << n;
+        }
+    }
+}
+
+TEST(Crc32cTest, Extend) {
+    EXPECT_EQ(Value("hello world"), Crc32cExtend(Value("hello "), "world", 5));
+    EXPECT_NE(Value("a"), Value("foo"));
+}
+
+TEST(Crc32cTest, Mask) {
+    uint32_t crc = Value("foo");
+    EXPECT_NE(crc, Crc32cMask(crc));
+    EXPECT_NE(crc, Crc32cMask(Crc32cMask(crc)));
+    EXPECT_EQ(crc, Crc32cUnmask(Crc32cMask(crc)));
+    EXPECT_EQ(crc, Crc32cUnmask(Crc32cUnmask(Crc32cMask(Crc32cMask(crc)))));
+}
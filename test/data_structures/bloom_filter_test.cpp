@@ -2,10 +2,66 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <thread>
 #include <vector>
 
+static inline std::string K(int x) { return "k" + std::to_string(x); }
+
 TEST(BloomFilterTest, Instantiation) {
-    // TODO: Implement basic instantiation test
-    EXPECT_TRUE(true); // Placeholder
+    BloomFilter filter(1000);
+    // Rounded up to whole 512-bit blocks
+    EXPECT_EQ(filter.NumBits(), 1024u);
+    EXPECT_EQ(filter.NumProbes(), BloomFilter::kDefaultNumProbes);
+    EXPECT_FALSE(filter.MayContain("anything"));
+}
+
+TEST(BloomFilterTest, NoFalseNegatives) {
+    const int n = 10000;
+    BloomFilter filter(n * 10);
+    for (int i = 0; i < n; ++i) {
+        filter.Add(K(i));
+    }
+    for (int i = 0; i < n; ++i) {
+        EXPECT_TRUE(filter.MayContain(K(i))) << K(i);
+    }
 }
 
+TEST(BloomFilterTest, FalsePositiveRateAtTenBitsPerKey) {
+    const int n = 10000;
+    BloomFilter filter(n * 10);
+    for (int i = 0; i < n; ++i) {
+        filter.Add(K(i));
+    }
+
+    int false_positives = 0;
+    const int probes = 100000;
+    for (int i = n; i < n + probes; ++i) {
+        if (filter.MayContain(K(i))) {
+            false_positives++;
+        }
+    }
+    // ~1% for a standard filter; blocking costs a little on top
+    EXPECT_LT(false_positives, probes * 0.03);
+}
+
+TEST(BloomFilterTest, ConcurrentAdd) {
+    const int threads = 4;
+    const int per_thread = 5000;
+    BloomFilter filter(threads * per_thread * 10);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&filter, t]() {
+            for (int i = 0; i < per_thread; ++i) {
+                filter.Add(K(t * per_thread + i));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (int i = 0; i < threads * per_thread; ++i) {
+        EXPECT_TRUE(filter.MayContain(K(i))) << K(i);
+    }
+}
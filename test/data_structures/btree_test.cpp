@@ -1,11 +1,227 @@
 #include "src/include/data_structures/btree.hpp"
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
+static inline std::string K(int x) { return "k" + std::to_string(x); }
+static inline std::string V(int x) { return "v" + std::to_string(x); }
+
 TEST(BTreeTest, Instantiation) {
-    // TODO: Implement basic instantiation test
-    EXPECT_TRUE(true); // Placeholder
+    BTree tree;
+    EXPECT_TRUE(tree.isEmpty());
+    EXPECT_EQ(tree.Size(), 0);
+    EXPECT_FALSE(tree.begin().is_valid());
+}
+
+TEST(BTreeTest, InsertAndGet) {
+    BTree tree;
+
+    tree.Insert("apple",  "red");
+    tree.Insert("banana", "yellow");
+    tree.Insert("cherry", "dark");
+
+    EXPECT_EQ(tree.Size(), 3);
+    EXPECT_FALSE(tree.isEmpty());
+
+    EXPECT_EQ(tree.Contains("apple").value(),  "red");
+    EXPECT_EQ(tree.Contains("banana").value(), "yellow");
+    EXPECT_EQ(tree.Contains("cherry").value(), "dark");
+    EXPECT_FALSE(tree.Contains("durian").has_value());
+}
+
+TEST(BTreeTest, OverwriteDoesNotGrowSize) {
+    BTree tree;
+    EXPECT_FALSE(tree.Insert("a", "1").has_value());
+    EXPECT_EQ(tree.Insert("a", "22"), 1u);
+    EXPECT_FALSE(tree.Insert("b", "3").has_value());
+    EXPECT_EQ(tree.Insert("b", "4"), 1u);
+    EXPECT_EQ(tree.Insert("a", "2"), 2u);
+
+    EXPECT_EQ(tree.Size(), 2);
+    EXPECT_EQ(tree.Contains("a").value(), "2");
+    EXPECT_EQ(tree.Contains("b").value(), "4");
 }
 
+TEST(BTreeTest, KeyPrefixPreservesOrder) {
+    EXPECT_LT(BTree::KeyPrefix("a"), BTree::KeyPrefix("b"));
+    EXPECT_LT(BTree::KeyPrefix(""), BTree::KeyPrefix("a"));
+    EXPECT_LT(BTree::KeyPrefix("abc"), BTree::KeyPrefix("abd"));
+    // Keys that differ only after 8 bytes tie on the prefix
+    EXPECT_EQ(BTree::KeyPrefix("tenant01/x"), BTree::KeyPrefix("tenant01/y"));
+}
+
+TEST(BTreeTest, ManyKeysWithSharedPrefixes) {
+    BTree tree;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 5000; ++i) {
+        keys.push_back("tenant/table/" + std::to_string(i));
+    }
+    std::vector<std::string> shuffled = keys;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+    for (const auto& k : shuffled) {
+        tree.Insert(k, "v" + k);
+    }
+
+    EXPECT_EQ(tree.Size(), 5000);
+    for (const auto& k : keys) {
+        ASSERT_TRUE(tree.Contains(k).has_value()) << k;
+        EXPECT_EQ(tree.Contains(k).value(), "v" + k);
+    }
+    EXPECT_FALSE(tree.Contains("tenant/table/").has_value());
+
+    // Full traversal is sorted and complete
+    std::sort(keys.begin(), keys.end());
+    auto iter = tree.begin();
+    size_t count = 0;
+    while (iter.is_valid()) {
+        ASSERT_LT(count, keys.size());
+        EXPECT_EQ(iter.key(), keys[count]);
+        count++;
+        iter.next();
+    }
+    EXPECT_EQ(count, keys.size());
+}
+
+TEST(BTreeTest, IteratorScanGreaterEqual) {
+    BTree tree;
+    for (int i = 0; i < 100; i += 2) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%03d", i);
+        tree.Insert(buf, V(i));
+    }
+
+    auto iter = tree.scan("051");
+    ASSERT_TRUE(iter.is_valid());
+    EXPECT_EQ(iter.key(), "052");
+    EXPECT_EQ(iter.value(), V(52));
+
+    int count = 0;
+    while (iter.is_valid()) {
+        count++;
+        iter.next();
+    }
+    EXPECT_EQ(count, 24);
+
+    EXPECT_FALSE(tree.scan("999").is_valid());
+    EXPECT_EQ(tree.scan("").key(), "000");
+}
+
+TEST(BTreeTest, ConcurrentInsertTest) {
+    BTree tree;
+    const int num_threads = 8;
+    const int num_insertions_per_thread = 2000;
+
+    auto insert_task = [&](int start) {
+        for (int i = start; i < start + num_insertions_per_thread; ++i) {
+            tree.Insert(K(i), V(i));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back(insert_task, t * num_insertions_per_thread);
+    }
+    for (auto &th : threads) th.join();
+
+    EXPECT_EQ(tree.Size(), num_threads * num_insertions_per_thread);
+    for (int i = 0; i < num_threads * num_insertions_per_thread; ++i) {
+        auto got = tree.Contains(K(i));
+        ASSERT_TRUE(got.has_value());
+        EXPECT_EQ(*got, V(i));
+    }
+}
+
+TEST(BTreeTest, ConcurrentReadWhileInsert) {
+    BTree tree;
+    const int total = 20000;
+    for (int i = 0; i < total; i += 2) {
+        tree.Insert(K(i), V(i));
+    }
+
+    std::thread writer([&]() {
+        for (int i = 1; i < total; i += 2) {
+            tree.Insert(K(i), V(i));
+        }
+    });
+    std::thread reader([&]() {
+        for (int i = 0; i < total; i += 2) {
+            auto got = tree.Contains(K(i));
+            ASSERT_TRUE(got.has_value());
+            EXPECT_EQ(*got, V(i));
+        }
+    });
+    std::thread scanner([&]() {
+        // Keys present before the writer started must always be seen, in order
+        auto iter = tree.begin();
+        std::string prev;
+        int seen_even = 0;
+        while (iter.is_valid()) {
+            std::string k = iter.key();
+            EXPECT_LT(prev, k);
+            if (std::stoi(k.substr(1)) % 2 == 0) seen_even++;
+            prev = k;
+            iter.next();
+        }
+        EXPECT_EQ(seen_even, total / 2);
+    });
+    writer.join();
+    reader.join();
+    scanner.join();
+
+    EXPECT_EQ(tree.Size(), total);
+}
+
+TEST(BTreeTest, IteratorReverseAcrossLeaves) {
+    BTree tree;
+    // Random insertion order so leaves split at varied points
+    std::vector<int> order;
+    for (int i = 0; i < 2000; ++i) order.push_back(i);
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    for (int i : order) {
+        tree.Insert(K(10000 + 2 * i), V(i));
+    }
+
+    auto iter = tree.begin();
+    iter.seek_to_last();
+    int expected = 1999;
+    while (iter.is_valid()) {
+        ASSERT_EQ(iter.key(), K(10000 + 2 * expected));
+        EXPECT_EQ(iter.value(), V(expected));
+        iter.prev();
+        expected--;
+    }
+    EXPECT_EQ(expected, -1);
+
+    // Every gap between keys finds its predecessor, then switches direction
+    for (int i = 1; i < 2000; i += 37) {
+        iter.seek_for_prev(K(10000 + 2 * i + 1));
+        ASSERT_TRUE(iter.is_valid());
+        EXPECT_EQ(iter.key(), K(10000 + 2 * i));
+        iter.prev();
+        EXPECT_EQ(iter.key(), K(10000 + 2 * (i - 1)));
+        iter.next();
+        iter.next();
+        if (i + 1 < 2000) {
+            EXPECT_EQ(iter.key(), K(10000 + 2 * (i + 1)));
+        }
+    }
+
+    iter.seek_for_prev(K(10000));
+    EXPECT_EQ(iter.key(), K(10000));
+    iter.seek_for_prev("a");
+    EXPECT_FALSE(iter.is_valid());
+}
+
+TEST(BTreeTest, IteratorReverseEmptyTree) {
+    BTree tree;
+    auto iter = tree.begin();
+    iter.seek_to_last();
+    EXPECT_FALSE(iter.is_valid());
+    iter.seek_for_prev("k");
+    EXPECT_FALSE(iter.is_valid());
+}
@@ -2,10 +2,148 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <thread>
 #include <vector>
 
+static inline std::string K(int x) { return "k" + std::to_string(x); }
+static inline std::string V(int x) { return "v" + std::to_string(x); }
+
 TEST(HashTableTest, Instantiation) {
-    // TODO: Implement basic instantiation test
-    EXPECT_TRUE(true); // Placeholder
+    HashTable table;
+    EXPECT_TRUE(table.isEmpty());
+    EXPECT_EQ(table.Size(), 0);
+    EXPECT_EQ(table.Capacity(), 16);
+}
+
+TEST(HashTableTest, InsertAndGet) {
+    HashTable table;
+
+    table.Insert("apple",  "red");
+    table.Insert("banana", "yellow");
+    table.Insert("cherry", "dark");
+
+    EXPECT_EQ(table.Size(), 3);
+    EXPECT_FALSE(table.isEmpty());
+
+    EXPECT_EQ(table.Contains("apple").value(),  "red");
+    EXPECT_EQ(table.Contains("banana").value(), "yellow");
+    EXPECT_EQ(table.Contains("cherry").value(), "dark");
+    EXPECT_FALSE(table.Contains("durian").has_value());
+}
+
+TEST(HashTableTest, OverwriteDoesNotGrowSize) {
+    HashTable table;
+    table.Insert("a", "1");
+    table.Insert("a", "2");
+    table.Insert("b", "3");
+
+    EXPECT_EQ(table.Size(), 2);
+    EXPECT_EQ(table.Contains("a").value(), "2");
+    EXPECT_EQ(table.Contains("b").value(), "3");
+}
+
+TEST(HashTableTest, MemoryUsageCountsKeysAndValues) {
+    HashTable table;
+    size_t empty = table.ApproximateMemoryUsage();
+    table.Insert("key", "value");
+    EXPECT_EQ(table.ApproximateMemoryUsage(), empty + 8);
+    table.Insert("key", "longer value");
+    EXPECT_EQ(table.ApproximateMemoryUsage(), empty + 15);
+    table.Erase("key");
+    EXPECT_EQ(table.ApproximateMemoryUsage(), empty);
+
+    for (int i = 0; i < 100; ++i) {
+        table.Insert(K(i), V(i));
+    }
+    EXPECT_GT(table.ApproximateMemoryUsage(), empty * 2);
+    // Clear keeps the grown slot array but none of the keys and values
+    table.Clear();
+    EXPECT_EQ(table.ApproximateMemoryUsage(), empty / 16 * table.Capacity());
+}
+
+TEST(HashTableTest, GrowsAndKeepsAllKeys) {
+    HashTable table(4);
+    for (int i = 0; i < 1000; ++i) {
+        table.Insert(K(i), V(i));
+    }
+
+    EXPECT_EQ(table.Size(), 1000);
+    EXPECT_GE(table.Capacity() * 3, static_cast<size_t>(1000 * 4));
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(table.Contains(K(i)).has_value());
+        EXPECT_EQ(table.Contains(K(i)).value(), V(i));
+    }
+}
+
+TEST(HashTableTest, EraseKeepsProbeChainsIntact) {
+    HashTable table;
+    for (int i = 0; i < 200; ++i) {
+        table.Insert(K(i), V(i));
+    }
+
+    // Erase every other key; the survivors must still be reachable
+    for (int i = 0; i < 200; i += 2) {
+        table.Erase(K(i));
+    }
+    table.Erase("missing");
+
+    EXPECT_EQ(table.Size(), 100);
+    for (int i = 0; i < 200; ++i) {
+        if (i % 2 == 0) {
+            EXPECT_FALSE(table.Contains(K(i)).has_value());
+        } else {
+            ASSERT_TRUE(table.Contains(K(i)).has_value());
+            EXPECT_EQ(table.Contains(K(i)).value(), V(i));
+        }
+    }
+}
+
+TEST(HashTableTest, ClearResetsStructure) {
+    HashTable table;
+    table.Insert("k1", "v1");
+    table.Insert("k2", "v2");
+
+    table.Clear();
+    EXPECT_TRUE(table.isEmpty());
+    EXPECT_FALSE(table.Contains("k1").has_value());
+
+    table.Insert("k3", "v3");
+    EXPECT_EQ(table.Contains("k3").value(), "v3");
+    EXPECT_EQ(table.Size(), 1);
+}
+
+TEST(HashTableTest, AllowsEmptyStringKey) {
+    HashTable table;
+    table.Insert("", "empty");
+    EXPECT_EQ(table.Contains("").value(), "empty");
 }
 
+TEST(HashTableTest, ConcurrentInsertAndReadTest) {
+    HashTable table;
+    const int num_threads = 8;
+    const int num_insertions_per_thread = 500;
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads * 2);
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&table, t]() {
+            for (int i = t * num_insertions_per_thread; i < (t + 1) * num_insertions_per_thread; ++i) {
+                table.Insert(K(i), V(i));
+            }
+        });
+        threads.emplace_back([&table]() {
+            for (int i = 0; i < num_threads * num_insertions_per_thread; ++i) {
+                auto got = table.Contains(K(i));
+                if (got.has_value()) {
+                    EXPECT_EQ(*got, V(i));
+                }
+            }
+        });
+    }
+    for (auto &th : threads) th.join();
+
+    EXPECT_EQ(table.Size(), num_threads * num_insertions_per_thread);
+    for (int i = 0; i < num_threads * num_insertions_per_thread; ++i) {
+        ASSERT_TRUE(table.Contains(K(i)).has_value());
+    }
+}
@@ -1,10 +1,100 @@
 #include "src/include/data_structures/hyperloglog.hpp"
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <string>
+#include <thread>
 #include <vector>
 
+static inline std::string K(int x) { return "k" + std::to_string(x); }
+
 TEST(HyperLogLogTest, Instantiation) {
-    // TODO: Implement basic instantiation test
-    EXPECT_TRUE(true); // Placeholder
+    HyperLogLog hll;
+    EXPECT_EQ(hll.Precision(), HyperLogLog::kDefaultPrecision);
+    EXPECT_EQ(hll.Estimate(), 0.0);
+}
+
+TEST(HyperLogLogTest, SmallCardinalityIsNearlyExact) {
+    HyperLogLog hll;
+    for (int i = 0; i < 100; ++i) {
+        hll.Add(K(i));
+        hll.Add(K(i)); // duplicates don't count
+    }
+    EXPECT_NEAR(hll.Estimate(), 100.0, 2.0);
+}
+
+TEST(HyperLogLogTest, LargeCardinalityWithinErrorBound) {
+    HyperLogLog hll;
+    const int n = 200000;
+    for (int i = 0; i < n; ++i) {
+        hll.Add(K(i));
+    }
+    // Standard error is ~0.8%; allow 4 sigma
+    EXPECT_NEAR(hll.Estimate(), n, n * 0.035);
+}
+
+TEST(HyperLogLogTest, MergeEstimatesUnion) {
+    HyperLogLog a;
+    HyperLogLog b;
+    for (int i = 0; i < 50000; ++i) a.Add(K(i));
+    for (int i = 25000; i < 75000; ++i) b.Add(K(i));
+
+    a.Merge(b);
+    EXPECT_NEAR(a.Estimate(), 75000, 75000 * 0.035);
+
+    // Merging with a different precision is a no-op
+    HyperLogLog other(10);
+    other.Add("extra");
+    double before = a.Estimate();
+    a.Merge(other);
+    EXPECT_EQ(a.Estimate(), before);
+}
+
+TEST(HyperLogLogTest, ClearResets) {
+    HyperLogLog hll(8);
+    for (int i = 0; i < 1000; ++i) hll.Add(K(i));
+    hll.Clear();
+    EXPECT_EQ(hll.Estimate(), 0.0);
+}
+
+TEST(HyperLogLogTest, EncodeRoundTrips) {
+    // A few keys encode sparsely, many densely
+    for (int n : {10, 100000}) {
+        HyperLogLog hll(12);
+        for (int i = 0; i < n; ++i) hll.Add(K(i));
+        std::string encoded = hll.Encode();
+        if (n == 10) {
+            EXPECT_LT(encoded.size(), 64u);
+        }
+        HyperLogLog decoded;
+        ASSERT_TRUE(decoded.Decode(encoded));
+        EXPECT_EQ(decoded.Precision(), 12);
+        EXPECT_EQ(decoded.Estimate(), hll.Estimate());
+    }
+
+    HyperLogLog untouched;
+    untouched.Add("kept");
+    EXPECT_FALSE(untouched.Decode(""));
+    EXPECT_FALSE(untouched.Decode(std::string("\x0c" "d" "short")));
+    EXPECT_NEAR(untouched.Estimate(), 1.0, 0.1);
+}
+
+TEST(HyperLogLogTest, ConcurrentAddsMatchSequential) {
+    HyperLogLog sequential;
+    for (int i = 0; i < 40000; ++i) sequential.Add(K(i));
+
+    HyperLogLog shared;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&shared, t] {
+            for (int i = t; i < 40000; i += 4) shared.AddHashConcurrent(HyperLogLog::Hash(K(i)));
+        });
+    }
+    // Snapshots may be taken while the adds run
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_GE(shared.Snapshot().Estimate(), 0.0);
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    EXPECT_EQ(shared.Snapshot().Estimate(), sequential.Estimate());
 }
@@ -1,5 +1,7 @@
 #include "src/include/data_structures/skiplist.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 
 #include <memory>
 #include <string>
@@ -270,6 +272,63 @@ TEST(SkipListTest, ConcurrentReadTest) {
     EXPECT_TRUE(list->Contains(K(total_num_elements - 1)).has_value());
 }
 
+TEST(SkipListTest, ConcurrentInsertOverlappingKeys) {
+    // Writers race to link the same shared-prefix keys while readers look up
+    // keys that were there from the start; none may go missing mid-splice
+    SkipList list;
+    auto key = [](int i) { return "tenant-0042/orders/" + std::to_string(i); };
+    for (int i = 0; i < 4000; i += 4) {
+        list.Insert(key(i), "base");
+    }
+    const int num_writers = 4;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_writers; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 4000; ++i) {
+                // Every writer covers every key, in a different order
+                int k = (i * 7 + t * 1000) % 4000;
+                if (k % 4 != 0) {
+                    list.Insert(key(k), "w" + std::to_string(t));
+                }
+            }
+        });
+    }
+    std::atomic<int> missing{0};
+    for (int r = 0; r < 2; ++r) {
+        threads.emplace_back([&]() {
+            while (!done.load()) {
+                for (int i = 0; i < 4000; i += 4) {
+                    if (!list.Contains(key(i)).has_value()) {
+                        missing++;
+                    }
+                }
+            }
+        });
+    }
+    for (int t = 0; t < num_writers; ++t) {
+        threads[t].join();
+    }
+    done.store(true);
+    for (size_t t = num_writers; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    EXPECT_EQ(missing.load(), 0);
+    EXPECT_EQ(list.Size(), 4000);
+    std::string previous;
+    int count = 0;
+    for (auto iter = list.begin(); iter.is_valid(); iter.next()) {
+        EXPECT_LT(previous, iter.key());
+        previous = iter.key();
+        count++;
+    }
+    EXPECT_EQ(count, 4000);
+    for (int i = 1; i < 4000; i += 4) {
+        EXPECT_EQ(list.Contains(key(i)).value()[0], 'w');
+    }
+}
+
 // Iterator Tests
 TEST(SkipListTest, IteratorBeginEmpty) {
     SkipList list;
@@ -395,3 +454,259 @@ TEST(SkipListTest, IteratorSingleElement) {
     iter.next();
     EXPECT_FALSE(iter.is_valid());
 }
+
+TEST(SkipListTest, IteratorReverseTraversal) {
+    SkipList list;
+    for (int i = 0; i < 200; i += 2) {
+        list.Insert(K(1000 + i), V(i));
+    }
+
+    auto iter = list.begin();
+    iter.seek_to_last();
+    int expected = 198;
+    while (iter.is_valid()) {
+        EXPECT_EQ(iter.key(), K(1000 + expected));
+        EXPECT_EQ(iter.value(), V(expected));
+        iter.prev();
+        expected -= 2;
+    }
+    EXPECT_EQ(expected, -2);
+}
+
+TEST(SkipListTest, IteratorSeekForPrev) {
+    SkipList list;
+    list.Insert("b", "2");
+    list.Insert("d", "4");
+    list.Insert("f", "6");
+
+    auto iter = list.begin();
+    iter.seek_for_prev("d");
+    ASSERT_TRUE(iter.is_valid());
+    EXPECT_EQ(iter.key(), "d");
+
+    iter.seek_for_prev("e");
+    ASSERT_TRUE(iter.is_valid());
+    EXPECT_EQ(iter.key(), "d");
+    iter.prev();
+    EXPECT_EQ(iter.key(), "b");
+    iter.next();
+    EXPECT_EQ(iter.key(), "d");
+
+    iter.seek_for_prev("z");
+    EXPECT_EQ(iter.key(), "f");
+
+    iter.seek_for_prev("a");
+    EXPECT_FALSE(iter.is_valid());
+
+    SkipList empty;
+    auto empty_iter = empty.begin();
+    empty_iter.seek_to_last();
+    EXPECT_FALSE(empty_iter.is_valid());
+}
+
+TEST(SkipListTest, FixedWidthIntegerKeys) {
+    BasicSkipList<uint64_t> list;
+    list.Insert(300, "c");
+    list.Insert(1, "a");
+    list.Insert(0x0100000000000000ULL, "big");
+    list.Insert(1, "aa");
+    EXPECT_EQ(list.Size(), 3);
+    EXPECT_EQ(list.Contains(1).value(), "aa");
+    EXPECT_FALSE(list.Contains(2).has_value());
+
+    // Keys come out as 8 big-endian bytes, so byte order matches integer order
+    auto iter = list.begin();
+    ASSERT_TRUE(iter.is_valid());
+    EXPECT_EQ(iter.typed_key(), 1u);
+    EXPECT_EQ(iter.key(), std::string("\0\0\0\0\0\0\0\x01", 8));
+    iter.next();
+    EXPECT_EQ(iter.typed_key(), 300u);
+    iter.next();
+    EXPECT_EQ(iter.key(), std::string("\x01\0\0\0\0\0\0\0", 8));
+
+    // Targets of any length seek like byte strings
+    iter.seek(std::string("\0\0\0\0\0\0\x01", 7));  // before 300 (0x012c)
+    EXPECT_EQ(iter.typed_key(), 300u);
+    iter.seek(std::string("\0\0\0\0\0\0\0\x01\0", 9));  // just after 1
+    EXPECT_EQ(iter.typed_key(), 300u);
+    iter.seek_for_prev(std::string("\0\0\0\0\0\0\x01\x2c", 8));
+    EXPECT_EQ(iter.typed_key(), 300u);
+    iter.seek_for_prev(std::string("\0\0\0\0\0\0\x01\x2c", 7));  // shorter: sorts before 300
+    EXPECT_EQ(iter.typed_key(), 1u);
+    iter.seek_for_prev(std::string("\0\0\0\0\0\0\x01\x2c\0", 9));  // longer: sorts after 300
+    EXPECT_EQ(iter.typed_key(), 300u);
+    iter.prev();
+    EXPECT_EQ(iter.typed_key(), 1u);
+    iter.prev();
+    EXPECT_FALSE(iter.is_valid());
+}
+
+TEST(SkipListTest, UuidKeys) {
+    BasicSkipList<Uuid> list;
+    list.Insert(Uuid{1, 2}, "b");
+    list.Insert(Uuid{1, 1}, "a");
+    list.Insert(Uuid{0, 9}, "first");
+    EXPECT_EQ(list.Contains(Uuid{1, 1}).value(), "a");
+    EXPECT_FALSE(list.Contains(Uuid{2, 1}).has_value());
+
+    std::vector<std::string> values;
+    for (auto iter = list.begin(); iter.is_valid(); iter.next()) {
+        EXPECT_EQ(iter.key().size(), 16u);
+        values.push_back(iter.value());
+    }
+    EXPECT_EQ(values, (std::vector<std::string>{"first", "a", "b"}));
+
+    auto iter = list.begin();
+    iter.seek(KeyCodec<Uuid>::Encode(Uuid{1, 0}));
+    EXPECT_EQ(iter.value(), "a");
+}
+
+struct ReverseLess {
+    bool operator()(const std::string& a, const std::string& b) const { return b < a; }
+};
+
+TEST(SkipListTest, CustomComparator) {
+    BasicSkipList<std::string, ReverseLess> list;
+    for (int i = 0; i < 5; i++) {
+        list.Insert(K(i), V(i));
+    }
+    std::vector<std::string> keys;
+    for (auto iter = list.begin(); iter.is_valid(); iter.next()) {
+        keys.push_back(iter.key());
+    }
+    EXPECT_EQ(keys, (std::vector<std::string>{"k4", "k3", "k2", "k1", "k0"}));
+
+    auto iter = list.scan("k2");
+    EXPECT_EQ(iter.key(), "k2");
+    iter.next();
+    EXPECT_EQ(iter.key(), "k1");
+    list.Erase("k1");
+    EXPECT_FALSE(list.Contains("k1").has_value());
+    EXPECT_EQ(list.Contains("k0").value(), "v0");
+}
+
+TEST(SkipListTest, SharedKeyPrefixes) {
+    SkipList list;
+    // Long shared runs first, then keys that cut the common prefix back
+    std::vector<std::string> keys = {"tenant-0042/orders/0000000007", "tenant-0042/orders/0000000003",
+                                     "tenant-0042/orders/000000000",  "tenant-0042/users/1",
+                                     "tenant-0007/orders/5",          "tenant",
+                                     "other/1",                       std::string("tenant\0\0", 8)};
+    for (size_t i = 0; i < keys.size(); i++) {
+        list.Insert(keys[i], "v" + std::to_string(i));
+        for (size_t j = 0; j <= i; j++) {
+            ASSERT_EQ(list.Contains(keys[j]).value(), "v" + std::to_string(j)) << i << " " << j;
+        }
+    }
+
+    std::vector<std::string> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<std::string> scanned;
+    for (auto iter = list.begin(); iter.is_valid(); iter.next()) {
+        scanned.push_back(iter.key());
+    }
+    EXPECT_EQ(scanned, sorted);
+
+    // Targets on either side of the shared bytes
+    EXPECT_FALSE(list.Contains("tenant-0042/orders/00000000070").has_value());
+    EXPECT_FALSE(list.Contains("a").has_value());
+    EXPECT_EQ(list.scan("tenant-0042/p").key(), "tenant-0042/users/1");
+    EXPECT_EQ(list.scan("o").key(), "other/1");
+    EXPECT_FALSE(list.scan("u").is_valid());
+
+    // An emptied list starts over with the next key's bytes
+    for (const auto& key : keys) {
+        list.Erase(key);
+    }
+    list.Insert("zz/2", "a");
+    list.Insert("zz/1", "b");
+    EXPECT_EQ(list.begin().key(), "zz/1");
+    EXPECT_EQ(list.Contains("zz/2").value(), "a");
+    EXPECT_FALSE(list.Contains("zz/").has_value());
+}
+
+TEST(SkipListTest, GrowsPastInitialMaxLevel) {
+    // Enough entries to raise the height cap twice, then start over after Clear
+    BasicSkipList<uint64_t> list;
+    const uint64_t n = (uint64_t{1} << 17) + 5;
+    for (int round = 0; round < 2; round++) {
+        for (uint64_t i = 0; i < n; i++) {
+            list.Insert((i * 0x9e3779b97f4a7c15ULL) ^ round, "");
+        }
+        ASSERT_EQ(list.Size(), static_cast<int>(n));
+        for (uint64_t i = 0; i < n; i += 97) {
+            ASSERT_TRUE(list.Contains((i * 0x9e3779b97f4a7c15ULL) ^ round).has_value());
+        }
+        uint64_t previous = 0;
+        size_t count = 0;
+        for (auto iter = list.begin(); iter.is_valid(); iter.next()) {
+            if (count++ > 0) {
+                ASSERT_LT(previous, iter.typed_key());
+            }
+            previous = iter.typed_key();
+        }
+        EXPECT_EQ(count, n);
+        list.Clear();
+    }
+}
+
+TEST(SkipListTest, UpsertWithHint) {
+    SkipList list;
+    SkipList::InsertHint hint;
+    // Ascending run, then keys behind and between earlier ones
+    for (int i = 0; i < 200; i += 2) {
+        EXPECT_FALSE(list.Upsert(K(1000 + i), V(i), &hint).has_value());
+    }
+    for (int i = 199; i > 0; i -= 2) {
+        EXPECT_FALSE(list.Upsert(K(1000 + i), V(i), &hint).has_value());
+    }
+    EXPECT_EQ(list.Upsert(K(1050), "x", &hint), std::optional<size_t>(V(50).size()));
+    EXPECT_EQ(list.Upsert(K(1051), "yy", &hint), std::optional<size_t>(V(51).size()));
+    EXPECT_EQ(list.Upsert(K(1052), "z"), std::optional<size_t>(V(52).size()));
+
+    // Freed nodes invalidate the hint; a hint from another list is ignored
+    list.Erase(K(1051));
+    EXPECT_FALSE(list.Upsert(K(1051), "w", &hint).has_value());
+    SkipList other;
+    other.Upsert(K(5000), "o", &hint);
+    EXPECT_FALSE(list.Upsert(K(1300), "v", &hint).has_value());
+    EXPECT_FALSE(other.Contains(K(1300)).has_value());
+
+    EXPECT_EQ(list.Size(), 201);
+    std::string previous;
+    for (auto iter = list.begin(); iter.is_valid(); iter.next()) {
+        EXPECT_LT(previous, iter.key());
+        previous = iter.key();
+    }
+    EXPECT_EQ(list.Contains(K(1050)).value(), "x");
+    EXPECT_EQ(list.Contains(K(1051)).value(), "w");
+    EXPECT_EQ(list.Contains(K(1199)).value(), V(199));
+}
+
+TEST(SkipListTest, LookupCursorAcrossWrites) {
+    SkipList list;
+    for (int i = 0; i < 1000; i += 2) {
+        list.Insert(K(i), V(i));
+    }
+    auto lookup = [&](const std::string& key, bool write_between_steps) {
+        SkipList::LookupCursor cursor(&list, key);
+        int steps = 0;
+        while (cursor.Step()) {
+            if (write_between_steps && steps++ == 3) {
+                // Inserts keep the cursor's path valid; the erase forces a restart
+                list.Insert(key, "new");
+                list.Insert(K(1), V(1));
+                list.Erase(K(0));
+            }
+        }
+        std::optional<std::string> found;
+        cursor.Finish([&](const std::string& value) { found = value; });
+        return found;
+    };
+
+    EXPECT_EQ(lookup(K(500), false), std::optional<std::string>(V(500)));
+    EXPECT_FALSE(lookup(K(501), false).has_value());
+    EXPECT_FALSE(lookup("", false).has_value());
+    EXPECT_EQ(lookup(K(701), true), std::optional<std::string>("new"));
+    EXPECT_EQ(lookup(K(702), true), std::optional<std::string>("new"));
+}
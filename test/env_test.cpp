@@ -0,0 +1,195 @@
+#include "src/include/env.hpp"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Backend 0 is Env::Default(); the io_uring ones get a small registered
+// buffer (appends span several chunks) or none
+static std::unique_ptr<Env> NewIoUringTestEnv(size_t backend) {
+    IoUringEnvOptions options;
+    options.queue_depth = 4;
+    options.registered_buffer_size = backend == 1 ? 4096 : 0;
+    return NewIoUringEnv(options);
+}
+
+class EnvTest : public ::testing::TestWithParam<size_t> {
+protected:
+    void SetUp() override {
+        if (GetParam() == 0) {
+            env_ = Env::Default();
+        } else {
+            owned_ = NewIoUringTestEnv(GetParam());
+            if (!owned_) {
+                GTEST_SKIP() << "io_uring not available";
+            }
+            env_ = owned_.get();
+        }
+        char dir[] = "/tmp/env_test_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        dir_ = dir;
+    }
+
+    void TearDown() override {
+        if (dir_.empty()) {
+            return;
+        }
+        std::vector<std::string> names;
+        Env::Default()->GetChildren(dir_, &names);
+        for (const auto& name : names) {
+            Env::Default()->DeleteFile(dir_ + "/" + name);
+        }
+        rmdir(dir_.c_str());
+    }
+
+    std::string Path(const std::string& name) const { return dir_ + "/" + name; }
+
+    Env* env_ = nullptr;
+    std::unique_ptr<Env> owned_;
+    std::string dir_;
+};
+
+TEST_P(EnvTest, AppendSyncAndRead) {
+    std::string big;
+    for (int i = 0; big.size() < 20000; i++) {
+        big += std::to_string(i) + ",";
+    }
+    auto file = env_->NewWritableFile(Path("log"));
+    ASSERT_NE(file, nullptr);
+    ASSERT_TRUE(file->Append("head:"));
+    ASSERT_TRUE(file->AppendAndSync(big));
+    ASSERT_TRUE(file->Append(""));
+    ASSERT_TRUE(file->Sync());
+    EXPECT_EQ(file->Size(), 5 + big.size());
+    ASSERT_TRUE(file->Close());
+
+    // Reopening for append continues at the end
+    auto more = env_->NewAppendableFile(Path("log"));
+    ASSERT_NE(more, nullptr);
+    EXPECT_EQ(more->Size(), 5 + big.size());
+    ASSERT_TRUE(more->AppendAndSync(":tail"));
+    more.reset();
+
+    std::string expected = "head:" + big + ":tail";
+    uint64_t size = 0;
+    ASSERT_TRUE(env_->GetFileSize(Path("log"), &size));
+    EXPECT_EQ(size, expected.size());
+
+    auto reader = env_->NewRandomAccessFile(Path("log"));
+    ASSERT_NE(reader, nullptr);
+    std::string scratch(expected.size() + 10, '\0');
+    std::string_view result;
+    ASSERT_TRUE(reader->Read(0, scratch.size(), scratch.data(), &result));
+    EXPECT_EQ(result, expected);
+}
+
+TEST_P(EnvTest, MultiRead) {
+    std::string data;
+    for (int i = 0; i < 1000; i++) {
+        data += "block" + std::to_string(1000 + i);
+    }
+    auto file = env_->NewWritableFile(Path("table"));
+    ASSERT_TRUE(file->AppendAndSync(data));
+    file.reset();
+
+    auto reader = env_->NewRandomAccessFile(Path("table"));
+    ASSERT_NE(reader, nullptr);
+    // More requests than the ring holds, one past the end and one straddling it
+    std::vector<ReadRequest> requests(10);
+    std::vector<std::string> scratch(requests.size(), std::string(64, '\0'));
+    for (size_t i = 0; i < requests.size(); i++) {
+        requests[i].offset = i * 900;
+        requests[i].len = 9 + i;
+        requests[i].scratch = scratch[i].data();
+    }
+    requests[8].offset = data.size() + 5;
+    requests[9].offset = data.size() - 4;
+    ASSERT_TRUE(reader->MultiRead(requests.data(), requests.size()));
+    for (size_t i = 0; i < 8; i++) {
+        EXPECT_TRUE(requests[i].ok);
+        EXPECT_EQ(requests[i].result, std::string_view(data).substr(i * 900, 9 + i));
+    }
+    EXPECT_TRUE(requests[8].result.empty());
+    EXPECT_EQ(requests[9].result, std::string_view(data).substr(data.size() - 4));
+}
+
+TEST_P(EnvTest, DirectoryOperations) {
+    EXPECT_EQ(env_->NewRandomAccessFile(Path("missing")), nullptr);
+    EXPECT_FALSE(env_->FileExists(Path("a")));
+    ASSERT_TRUE(env_->NewWritableFile(Path("a"))->AppendAndSync("1"));
+    ASSERT_TRUE(env_->CreateDirIfMissing(dir_));
+    ASSERT_TRUE(env_->RenameFile(Path("a"), Path("b")));
+    EXPECT_FALSE(env_->FileExists(Path("a")));
+    EXPECT_TRUE(env_->FileExists(Path("b")));
+    ASSERT_TRUE(env_->SyncDir(dir_));
+
+    std::vector<std::string> names;
+    ASSERT_TRUE(env_->GetChildren(dir_, &names));
+    EXPECT_EQ(names, std::vector<std::string>{"b"});
+    ASSERT_TRUE(env_->DeleteFile(Path("b")));
+    EXPECT_FALSE(env_->DeleteFile(Path("b")));
+}
+
+TEST_P(EnvTest, DirectIo) {
+    FileOptions direct;
+    direct.use_direct_io = true;
+    auto file = env_->NewWritableFile(Path("direct"), direct);
+    if (!file) {
+        GTEST_SKIP() << "O_DIRECT not supported in " << dir_;
+    }
+    // Unaligned appends, syncs in the middle of a block, and a reopen that continues the last block
+    std::string expected;
+    for (int i = 0; i < 300; i++) {
+        std::string record = "record" + std::to_string(i) + std::string(i * 37 % 5000, 'a' + i % 26);
+        expected += record;
+        ASSERT_TRUE(i % 7 == 0 ? file->AppendAndSync(record) : file->Append(record));
+        if (i == 150) {
+            ASSERT_TRUE(file->Close());
+            file = env_->NewAppendableFile(Path("direct"), direct);
+            ASSERT_NE(file, nullptr);
+            EXPECT_EQ(file->Size(), expected.size());
+        }
+    }
+    ASSERT_TRUE(file->Close());
+    uint64_t size = 0;
+    ASSERT_TRUE(env_->GetFileSize(Path("direct"), &size));
+    EXPECT_EQ(size, expected.size());
+
+    auto reader = env_->NewRandomAccessFile(Path("direct"), direct);
+    ASSERT_NE(reader, nullptr);
+    std::string scratch(expected.size(), '\0');
+    std::string_view result;
+    ASSERT_TRUE(reader->Read(0, expected.size(), scratch.data(), &result));
+    EXPECT_EQ(result, expected);
+    ASSERT_TRUE(reader->Read(12345, 100, scratch.data(), &result));
+    EXPECT_EQ(result, std::string_view(expected).substr(12345, 100));
+    ASSERT_TRUE(reader->Read(expected.size() - 10, 100, scratch.data(), &result));
+    EXPECT_EQ(result, std::string_view(expected).substr(expected.size() - 10));
+}
+
+TEST_P(EnvTest, RateLimitedFiles) {
+    FileOptions limited;
+    limited.rate_limiter = std::make_shared<RateLimiter>(64 << 20, false, std::chrono::milliseconds(1));
+    limited.io_priority = IOPriority::kFlush;
+    std::string data(300000, 'd');
+    auto file = env_->NewWritableFile(Path("limited"), limited);
+    ASSERT_NE(file, nullptr);
+    ASSERT_TRUE(file->Append(data.substr(0, 1000)));
+    ASSERT_TRUE(file->AppendAndSync(data.substr(1000)));
+    EXPECT_EQ(file->Size(), data.size());
+    file.reset();
+
+    limited.io_priority = IOPriority::kCompaction;
+    auto reader = env_->NewRandomAccessFile(Path("limited"), limited);
+    ASSERT_NE(reader, nullptr);
+    std::string scratch(data.size(), '\0');
+    std::string_view result;
+    ASSERT_TRUE(reader->Read(0, data.size(), scratch.data(), &result));
+    EXPECT_EQ(result, data);
+    EXPECT_EQ(limited.rate_limiter->GetTotalBytesThrough(IOPriority::kFlush), static_cast<int64_t>(data.size()));
+    EXPECT_EQ(limited.rate_limiter->GetTotalBytesThrough(IOPriority::kCompaction), static_cast<int64_t>(data.size()));
+}
+
+INSTANTIATE_TEST_SUITE_P(AllEnvs, EnvTest, ::testing::Range<size_t>(0, 3));
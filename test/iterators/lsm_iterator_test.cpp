@@ -31,6 +31,29 @@ public:
             current_index_++;
         }
     }
+
+    // Positioning assumes data_ is sorted by key; size() marks the invalid position
+    void prev() override {
+        current_index_ = current_index_ == 0 ? data_.size() : current_index_ - 1;
+    }
+
+    void seek(const std::string& target) override {
+        current_index_ = 0;
+        while (current_index_ < data_.size() && data_[current_index_].first < target) {
+            current_index_++;
+        }
+    }
+
+    void seek_for_prev(const std::string& target) override {
+        size_t i = data_.size();
+        while (i > 0 && data_[i - 1].first > target) {
+            i--;
+        }
+        current_index_ = i == 0 ? data_.size() : i - 1;
+    }
+
+    void seek_to_first() override { current_index_ = 0; }
+    void seek_to_last() override { current_index_ = data_.empty() ? 0 : data_.size() - 1; }
 };
 
 /**
@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 #include <vector>
 #include <string>
+#include <memory>
 
 /**
  * MockIterator for testing - simulates a simple in-memory iterator
@@ -48,6 +49,29 @@ public:
             current_index_++;
         }
     }
+
+    // Positioning assumes data_ is sorted by key; size() marks the invalid position
+    void prev() override {
+        current_index_ = current_index_ == 0 ? data_.size() : current_index_ - 1;
+    }
+
+    void seek(const std::string& target) override {
+        current_index_ = 0;
+        while (current_index_ < data_.size() && data_[current_index_].first < target) {
+            current_index_++;
+        }
+    }
+
+    void seek_for_prev(const std::string& target) override {
+        size_t i = data_.size();
+        while (i > 0 && data_[i - 1].first > target) {
+            i--;
+        }
+        current_index_ = i == 0 ? data_.size() : i - 1;
+    }
+
+    void seek_to_first() override { current_index_ = 0; }
+    void seek_to_last() override { current_index_ = data_.empty() ? 0 : data_.size() - 1; }
 };
 
 /**
@@ -263,4 +287,68 @@ TEST(MergeIteratorTest, BasicIteration) {
     
     merge_iter->next();
     EXPECT_FALSE(merge_iter->is_valid());
-}
\ No newline at end of file
+}
+
+static std::unique_ptr<MergeIterator> MakeOverlappingMerge() {
+    std::vector<std::unique_ptr<StorageIterator>> iters;
+    iters.push_back(std::make_unique<MockIterator>(std::vector<std::pair<std::string, std::string>>{
+        {"a", "1.1"}, {"c", "3.1"}, {"e", ""}}));
+    iters.push_back(std::make_unique<MockIterator>(std::vector<std::pair<std::string, std::string>>{
+        {"a", "1.2"}, {"b", "2.2"}, {"c", "3.2"}, {"d", "4.2"}}));
+    iters.push_back(std::make_unique<MockIterator>(std::vector<std::pair<std::string, std::string>>{
+        {"b", "2.3"}, {"c", "3.3"}, {"d", "4.3"}, {"f", "6.3"}}));
+    return MergeIterator::create(std::move(iters));
+}
+
+/**
+ * Reverse iteration yields each key once, still taking the newest version
+ */
+TEST(MergeIteratorTest, ReverseIteration) {
+    auto iter = MakeOverlappingMerge();
+    iter->seek_to_last();
+
+    std::vector<std::pair<std::string, std::string>> actual;
+    while (iter->is_valid()) {
+        actual.push_back({iter->key(), iter->value()});
+        iter->prev();
+    }
+    std::vector<std::pair<std::string, std::string>> expected = {
+        {"f", "6.3"}, {"e", ""}, {"d", "4.2"}, {"c", "3.1"}, {"b", "2.2"}, {"a", "1.1"}};
+    EXPECT_EQ(actual, expected);
+}
+
+/**
+ * Switching direction mid-scan must not repeat or skip keys
+ */
+TEST(MergeIteratorTest, DirectionSwitch) {
+    auto iter = MakeOverlappingMerge();
+    EXPECT_EQ(iter->key(), "a");
+    iter->next();
+    iter->next();
+    EXPECT_EQ(iter->key(), "c");
+    EXPECT_EQ(iter->value(), "3.1");
+    EXPECT_EQ(iter->current_index(), 0);
+
+    iter->prev();
+    EXPECT_EQ(iter->key(), "b");
+    EXPECT_EQ(iter->value(), "2.2");
+    iter->prev();
+    EXPECT_EQ(iter->key(), "a");
+    iter->next();
+    EXPECT_EQ(iter->key(), "b");
+    iter->next();
+    EXPECT_EQ(iter->key(), "c");
+    iter->next();
+    EXPECT_EQ(iter->key(), "d");
+    EXPECT_EQ(iter->value(), "4.2");
+
+    iter->seek_for_prev("cc");
+    EXPECT_EQ(iter->key(), "c");
+    EXPECT_EQ(iter->value(), "3.1");
+    iter->seek("cc");
+    EXPECT_EQ(iter->key(), "d");
+
+    iter->seek_to_first();
+    iter->prev();
+    EXPECT_FALSE(iter->is_valid());
+}
@@ -1,6 +1,11 @@
 #include "src/include/lsm_storage.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <atomic>
+#include <thread>
+#include <unistd.h>
 
 TEST(LsmStorageTest, StorageIntegration) {
     LsmStorageInner storage;
@@ -217,3 +222,1279 @@ TEST(LsmStorageTest, StorageIntegrationOfficial) {
     EXPECT_EQ(storage.get("3").value(), "233333");   // Latest from current memtable
     EXPECT_EQ(storage.get("4").value(), "23333");    // From middle memtable
 }
+
+TEST(LsmStorageTest, MemtableHashIndex) {
+    LsmStorageOptions options;
+    options.enable_memtable_hash_index = true;
+    LsmStorageInner storage(options);
+
+    storage.put("1", "233");
+    storage.put("2", "2333");
+    storage.force_freeze_memtable();
+    storage.put("1", "23333");
+    storage.delete_key("2");
+
+    EXPECT_EQ(storage.get("1").value(), "23333");
+    EXPECT_FALSE(storage.get("2").has_value());
+    EXPECT_FALSE(storage.get("3").has_value());
+}
+
+TEST(LsmStorageTest, BTreeMemtableRepresentation) {
+    LsmStorageOptions options;
+    options.memtable_factory = std::make_shared<BTreeRepFactory>();
+    LsmStorageInner storage(options);
+
+    storage.put("1", "233");
+    storage.put("2", "2333");
+    storage.force_freeze_memtable();
+    storage.put("1", "23333");
+    storage.delete_key("2");
+    storage.put("3", "233333");
+
+    EXPECT_EQ(storage.get("1").value(), "23333");
+    EXPECT_FALSE(storage.get("2").has_value());
+
+    auto iter = storage.scan();
+    EXPECT_EQ(iter->key(), "1");
+    EXPECT_EQ(iter->value(), "23333");
+    iter->next();
+    EXPECT_EQ(iter->key(), "3");
+    iter->next();
+    EXPECT_FALSE(iter->is_valid());
+}
+
+TEST(LsmStorageTest, ApproximateDistinctKeys) {
+    Lsm lsm;
+    EXPECT_EQ(lsm.approximate_distinct_keys(), 0);
+
+    // Same 1000 keys written three times
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 1000; i++) {
+            lsm.put("key" + std::to_string(i), "v" + std::to_string(round));
+        }
+    }
+    EXPECT_EQ(lsm.num_entries(), 1000);
+    EXPECT_NEAR(static_cast<double>(lsm.approximate_distinct_keys()), 1000.0, 20.0);
+}
+
+TEST(LsmStorageTest, ApproximateDistinctKeysAcrossFrozenMemtables) {
+    LsmStorageInner storage;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 1000; i++) {
+            storage.put("key" + std::to_string(i), "v" + std::to_string(round));
+        }
+        storage.force_freeze_memtable();
+    }
+    storage.put("key_new", "v");
+
+    // Every memtable holds its own copy of each key; the sketch sees the overlap
+    EXPECT_EQ(storage.num_entries(), 3001);
+    EXPECT_NEAR(static_cast<double>(storage.approximate_distinct_keys()), 1001.0, 20.0);
+}
+
+TEST(LsmStorageTest, VectorMemtableRepresentation) {
+    LsmStorageOptions options;
+    options.memtable_factory = std::make_shared<VectorRepFactory>();
+    LsmStorageInner storage(options);
+
+    storage.put("2", "2333");
+    storage.put("1", "233");
+    storage.put("2", "23333");
+    storage.force_freeze_memtable();
+    storage.delete_key("1");
+
+    EXPECT_FALSE(storage.get("1").has_value());
+    EXPECT_EQ(storage.get("2").value(), "23333");
+
+    auto iter = storage.scan();
+    EXPECT_EQ(iter->key(), "2");
+    EXPECT_EQ(iter->value(), "23333");
+    iter->next();
+    EXPECT_FALSE(iter->is_valid());
+}
+
+TEST(LsmStorageTest, ScanSurvivesFlatten) {
+    LsmStorageInner storage;
+    storage.put("a", "1");
+    storage.put("b", "2");
+    storage.force_freeze_memtable();
+
+    auto iter = storage.scan();
+    // The next freeze flattens a memtable the iterator is still reading
+    storage.put("c", "3");
+    storage.force_freeze_memtable();
+    storage.put("a", "11");
+    storage.force_freeze_memtable();
+
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->key(), "a");
+    EXPECT_EQ(iter->value(), "1");
+    iter->next();
+    EXPECT_EQ(iter->key(), "b");
+    iter->next();
+    EXPECT_FALSE(iter->is_valid());
+
+    EXPECT_EQ(storage.get("a").value(), "11");
+    EXPECT_EQ(storage.get("c").value(), "3");
+}
+
+TEST(LsmStorageTest, FlattenDisabled) {
+    LsmStorageOptions options;
+    options.flatten_immutable_memtables = false;
+    LsmStorageInner storage(options);
+
+    storage.put("1", "233");
+    storage.force_freeze_memtable();
+    storage.delete_key("1");
+    storage.put("2", "2333");
+
+    EXPECT_FALSE(storage.get("1").has_value());
+    EXPECT_EQ(storage.get("2").value(), "2333");
+}
+
+TEST(LsmStorageTest, CompactImmMemtables) {
+    LsmStorageInner storage;
+    EXPECT_FALSE(storage.compact_imm_memtables());
+
+    storage.put("a", "1");
+    storage.put("b", "2");
+    storage.put("c", "3");
+    storage.force_freeze_memtable();
+    storage.put("a", "11");
+    storage.delete_key("b");
+    storage.force_freeze_memtable();
+    storage.put("d", "4");
+    storage.force_freeze_memtable();
+    storage.put("c", "33");  // stays in the active memtable
+    EXPECT_EQ(storage.num_entries(), 7);
+
+    auto before = storage.scan();
+    EXPECT_TRUE(storage.compact_imm_memtables());
+    EXPECT_EQ(storage.get_imm_memtables_count(), 1);
+    // Only a, c and d survive the merge; b's tombstone is dropped with it
+    EXPECT_EQ(storage.num_entries(), 4);
+
+    EXPECT_EQ(storage.get("a").value(), "11");
+    EXPECT_FALSE(storage.get("b").has_value());
+    EXPECT_EQ(storage.get("c").value(), "33");
+    EXPECT_EQ(storage.get("d").value(), "4");
+    EXPECT_NEAR(static_cast<double>(storage.approximate_distinct_keys()), 3.0, 0.5);
+
+    // Iterators opened before the compaction still read the old memtables
+    std::vector<std::pair<std::string, std::string>> expected = {
+        {"a", "11"}, {"c", "33"}, {"d", "4"}};
+    auto after = storage.scan();
+    for (auto* iter : {before.get(), after.get()}) {
+        for (const auto& [key, value] : expected) {
+            ASSERT_TRUE(iter->is_valid());
+            EXPECT_EQ(iter->key(), key);
+            EXPECT_EQ(iter->value(), value);
+            iter->next();
+        }
+        EXPECT_FALSE(iter->is_valid());
+    }
+}
+
+TEST(LsmStorageTest, ImmCompactionTrigger) {
+    LsmStorageOptions options;
+    options.imm_compaction_trigger = 3;
+    LsmStorageInner storage(options);
+
+    // An update-heavy workload: the same 10 keys rewritten in every memtable
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 10; i++) {
+            storage.put("key" + std::to_string(i), "round" + std::to_string(round));
+        }
+        storage.force_freeze_memtable();
+        EXPECT_LT(storage.get_imm_memtables_count(), 3);
+    }
+    EXPECT_LE(storage.num_entries(), 20);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(storage.get("key" + std::to_string(i)).value(), "round9");
+    }
+}
+
+TEST(LsmStorageTest, ConcurrentWritersAcrossFreezes) {
+    for (bool btree : {false, true}) {
+        LsmStorageOptions options;
+        // Freeze every few hundred bytes so writers constantly race the swap
+        options.target_sst_size = 512;
+        options.imm_compaction_trigger = 8;
+        if (btree) {
+            options.memtable_factory = std::make_shared<BTreeRepFactory>();
+        }
+        LsmStorageInner storage(options);
+
+        const int num_writers = 4;
+        const int per_writer = 2000;
+        std::atomic<bool> done{false};
+        std::thread reader([&]() {
+            while (!done) {
+                storage.get("w0_0");
+                auto iter = storage.scan();
+                while (iter->is_valid()) {
+                    iter->next();
+                }
+            }
+        });
+
+        std::vector<std::thread> writers;
+        for (int w = 0; w < num_writers; w++) {
+            writers.emplace_back([&storage, w]() {
+                for (int i = 0; i < per_writer; i++) {
+                    std::string key = "w" + std::to_string(w) + "_" + std::to_string(i % 500);
+                    if (i % 7 == 3) {
+                        storage.delete_key(key);
+                    } else {
+                        storage.put(key, std::to_string(i));
+                    }
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        done = true;
+        reader.join();
+
+        // Every key holds the last write its writer made; none was lost in a freeze
+        size_t live = 0;
+        for (int w = 0; w < num_writers; w++) {
+            for (int k = 0; k < 500; k++) {
+                int last = per_writer - 500 + k;
+                std::optional<std::string> value = storage.get("w" + std::to_string(w) + "_" + std::to_string(k));
+                if (last % 7 == 3) {
+                    EXPECT_FALSE(value.has_value());
+                } else {
+                    ASSERT_TRUE(value.has_value());
+                    EXPECT_EQ(value.value(), std::to_string(last));
+                    live++;
+                }
+            }
+        }
+        auto iter = storage.scan();
+        size_t scanned = 0;
+        while (iter->is_valid()) {
+            scanned++;
+            iter->next();
+        }
+        EXPECT_EQ(scanned, live);
+        EXPECT_GT(storage.get_imm_memtables_count(), 0);
+    }
+}
+
+TEST(LsmStorageTest, ReverseScan) {
+    LsmStorageInner storage;
+    for (int i = 0; i < 20; i++) {
+        storage.put("event" + std::to_string(100 + i), std::to_string(i));
+        if (i % 6 == 5) {
+            storage.force_freeze_memtable();
+        }
+    }
+    storage.delete_key("event117");
+    storage.put("event115", "updated");
+    storage.delete_key("event119");
+
+    // Latest three events at or before event116
+    auto iter = storage.reverse_scan("event116");
+    std::vector<std::pair<std::string, std::string>> actual;
+    for (int n = 0; n < 3 && iter->is_valid(); n++) {
+        actual.push_back({iter->key(), iter->value()});
+        iter->prev();
+    }
+    std::vector<std::pair<std::string, std::string>> expected = {
+        {"event116", "16"}, {"event115", "updated"}, {"event114", "14"}};
+    EXPECT_EQ(actual, expected);
+
+    // Full reverse scan skips tombstones in every memtable
+    auto full = storage.reverse_scan();
+    ASSERT_TRUE(full->is_valid());
+    EXPECT_EQ(full->key(), "event118");
+    size_t count = 0;
+    while (full->is_valid()) {
+        count++;
+        full->prev();
+    }
+    EXPECT_EQ(count, 18);
+
+    // Turning around continues from where the scan is
+    auto turn = storage.reverse_scan("event1185");
+    EXPECT_EQ(turn->key(), "event118");
+    turn->prev();
+    EXPECT_EQ(turn->key(), "event116");
+    turn->next();
+    EXPECT_EQ(turn->key(), "event118");
+    turn->next();
+    EXPECT_FALSE(turn->is_valid());
+}
+
+static std::vector<std::string> CollectKeys(StorageIterator* iter) {
+    std::vector<std::string> keys;
+    while (iter->is_valid()) {
+        keys.push_back(iter->key());
+        iter->next();
+    }
+    return keys;
+}
+
+TEST(LsmStorageTest, ScanPrefix) {
+    LsmStorageOptions options;
+    options.prefix_extractor = std::make_shared<DelimiterPrefixExtractor>('/', 1);
+    LsmStorageInner storage(options);
+
+    // One tenant per frozen memtable, then a mix in the active one
+    storage.put("t1/a", "1");
+    storage.put("t1/b", "1");
+    storage.force_freeze_memtable();
+    storage.put("t2/a", "2");
+    storage.put("t2/b", "2");
+    storage.force_freeze_memtable();
+    storage.put("t3/a", "3");
+    storage.delete_key("t1/b");
+    storage.put("t1/c", "1");
+    storage.delete_key("t2/b");
+    storage.put("t", "no tenant");
+
+    auto t1 = storage.scan_prefix("t1/");
+    EXPECT_EQ(CollectKeys(t1.get()), (std::vector<std::string>{"t1/a", "t1/c"}));
+
+    // A trailing tombstone inside the prefix does not leak the next tenant
+    auto t2 = storage.scan_prefix("t2/");
+    EXPECT_EQ(CollectKeys(t2.get()), (std::vector<std::string>{"t2/a"}));
+
+    auto missing = storage.scan_prefix("t9/");
+    EXPECT_FALSE(missing->is_valid());
+
+    // Prefixes the extractor would not produce still scan, just without filtering
+    auto all = storage.scan_prefix("t");
+    EXPECT_EQ(CollectKeys(all.get()), (std::vector<std::string>{"t", "t1/a", "t1/c", "t2/a", "t3/a"}));
+
+    // Backwards within the prefix
+    auto reverse = storage.scan_prefix("t1/");
+    reverse->seek_to_last();
+    ASSERT_TRUE(reverse->is_valid());
+    EXPECT_EQ(reverse->key(), "t1/c");
+    reverse->prev();
+    EXPECT_EQ(reverse->key(), "t1/a");
+    reverse->prev();
+    EXPECT_FALSE(reverse->is_valid());
+}
+
+TEST(LsmStorageTest, ScanPrefixWithoutExtractor) {
+    LsmStorageInner storage;
+    storage.put("apple", "1");
+    storage.put("apricot", "2");
+    storage.force_freeze_memtable();
+    storage.put("banana", "3");
+    storage.put("ap", "4");
+
+    auto iter = storage.scan_prefix("ap");
+    EXPECT_EQ(CollectKeys(iter.get()), (std::vector<std::string>{"ap", "apple", "apricot"}));
+}
+
+TEST(LsmStorageTest, DeleteRange) {
+    LsmStorageInner storage;
+    for (int i = 0; i < 20; i++) {
+        storage.put("key" + std::to_string(100 + i), std::to_string(i));
+        if (i % 7 == 6) {
+            storage.force_freeze_memtable();
+        }
+    }
+
+    // The active memtable holds key114..key119; key114 gets a point tombstone
+    storage.delete_range("key105", "key115");
+    EXPECT_EQ(storage.get("key104").value(), "4");
+    EXPECT_FALSE(storage.get("key105").has_value());
+    EXPECT_FALSE(storage.get("key114").has_value());
+    EXPECT_EQ(storage.get("key115").value(), "15");
+
+    // Writes after the range delete win, even in the memtable holding the tombstone
+    storage.put("key110", "again");
+    EXPECT_EQ(storage.get("key110").value(), "again");
+
+    auto iter = storage.scan();
+    std::vector<std::string> keys = CollectKeys(iter.get());
+    std::vector<std::string> expected = {"key100", "key101", "key102", "key103", "key104", "key110",
+                                         "key115", "key116", "key117", "key118", "key119"};
+    EXPECT_EQ(keys, expected);
+
+    auto reverse = storage.reverse_scan("key114");
+    ASSERT_TRUE(reverse->is_valid());
+    EXPECT_EQ(reverse->key(), "key110");
+    reverse->prev();
+    EXPECT_EQ(reverse->key(), "key104");
+
+    // A second range delete over key110 hides it again
+    storage.delete_range("key108", "key112");
+    EXPECT_FALSE(storage.get("key110").has_value());
+    auto after = storage.scan();
+    keys = CollectKeys(after.get());
+    expected.erase(std::find(expected.begin(), expected.end(), "key110"));
+    EXPECT_EQ(keys, expected);
+
+    auto prefixed = storage.scan_prefix("key10");
+    EXPECT_EQ(CollectKeys(prefixed.get()),
+              (std::vector<std::string>{"key100", "key101", "key102", "key103", "key104"}));
+}
+
+TEST(LsmStorageTest, DeleteRangeFreezesOnlyPastManyLiveKeys) {
+    LsmStorageInner storage;
+    for (int i = 0; i < 10; i++) {
+        storage.put("a" + std::to_string(i), "v");
+    }
+    storage.delete_range("a", "b");
+    EXPECT_EQ(storage.get_imm_memtables_count(), 0);
+    EXPECT_FALSE(storage.get("a3").has_value());
+
+    for (int i = 0; i < 100; i++) {
+        storage.put("b" + std::to_string(100 + i), "v");
+    }
+    storage.delete_range("b", "c");
+    EXPECT_EQ(storage.get_imm_memtables_count(), 1);
+    EXPECT_FALSE(storage.get("b150").has_value());
+    auto iter = storage.scan();
+    EXPECT_FALSE(iter->is_valid());
+}
+
+TEST(LsmStorageTest, DeleteRangeSurvivesFlattenAndCompaction) {
+    LsmStorageInner storage;
+    for (int i = 0; i < 10; i++) {
+        storage.put("k" + std::to_string(i), "old");
+    }
+    storage.force_freeze_memtable();
+    storage.delete_range("k2", "k7");
+    storage.put("k3", "new");
+    // Flattening the memtable that holds the tombstone keeps it
+    storage.force_freeze_memtable();
+    storage.put("k9", "newest");
+
+    EXPECT_FALSE(storage.get("k2").has_value());
+    EXPECT_EQ(storage.get("k3").value(), "new");
+
+    ASSERT_TRUE(storage.compact_imm_memtables());
+    EXPECT_EQ(storage.get_imm_memtables_count(), 1);
+    // k0 k1 k3 k7 k8 k9 in the compacted memtable plus the newest k9
+    EXPECT_EQ(storage.num_entries(), 7);
+    EXPECT_FALSE(storage.get("k5").has_value());
+    EXPECT_EQ(storage.get("k9").value(), "newest");
+
+    auto iter = storage.scan();
+    EXPECT_EQ(CollectKeys(iter.get()), (std::vector<std::string>{"k0", "k1", "k3", "k7", "k8", "k9"}));
+}
+
+TEST(LsmStorageTest, MergeOperator) {
+    LsmStorageInner unconfigured;
+    EXPECT_FALSE(unconfigured.merge("key", "1"));
+
+    LsmStorageOptions options;
+    options.merge_operator = std::make_shared<StringAppendOperator>(',');
+    LsmStorageInner storage(options);
+
+    storage.put("list", "a");
+    storage.force_freeze_memtable();
+    storage.merge("list", "b");
+    storage.merge("fresh", "x");
+    storage.force_freeze_memtable();
+    storage.merge("list", "c");
+    storage.merge("fresh", "y");
+
+    EXPECT_EQ(storage.get("list").value(), "a,b,c");
+    EXPECT_EQ(storage.get("fresh").value(), "x,y");
+
+    auto iter = storage.scan();
+    std::vector<std::pair<std::string, std::string>> entries;
+    while (iter->is_valid()) {
+        entries.emplace_back(iter->key(), iter->value());
+        iter->next();
+    }
+    std::vector<std::pair<std::string, std::string>> expected = {{"fresh", "x,y"}, {"list", "a,b,c"}};
+    EXPECT_EQ(entries, expected);
+
+    auto reverse = storage.reverse_scan();
+    ASSERT_TRUE(reverse->is_valid());
+    EXPECT_EQ(reverse->value(), "a,b,c");
+    reverse->prev();
+    EXPECT_EQ(reverse->value(), "x,y");
+
+    // A delete (point or range) below the operands starts the fold over
+    storage.delete_key("list");
+    storage.merge("list", "d");
+    EXPECT_EQ(storage.get("list").value(), "d");
+    storage.force_freeze_memtable();
+    storage.delete_range("f", "g");
+    storage.merge("fresh", "z");
+    EXPECT_EQ(storage.get("fresh").value(), "z");
+
+    // Compaction folds the operands into plain values
+    ASSERT_TRUE(storage.compact_imm_memtables());
+    EXPECT_EQ(storage.get("list").value(), "d");
+    EXPECT_EQ(storage.get("fresh").value(), "z");
+    auto after = storage.scan();
+    EXPECT_EQ(CollectKeys(after.get()), (std::vector<std::string>{"fresh", "list"}));
+}
+
+TEST(LsmStorageTest, ConcurrentMergeCounters) {
+    LsmStorageOptions options;
+    options.merge_operator = std::make_shared<AddOperator>();
+    options.target_sst_size = 1024;
+    LsmStorageInner storage(options);
+
+    const int threads = 4;
+    const int increments = 2000;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++) {
+        writers.emplace_back([&storage, t]() {
+            for (int i = 0; i < increments; i++) {
+                storage.merge("counter" + std::to_string(i % 8), "1");
+                if (i % 100 == 0) {
+                    storage.put("filler" + std::to_string(t) + "_" + std::to_string(i), std::string(64, 'x'));
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_GT(storage.get_imm_memtables_count(), 0);
+    for (int c = 0; c < 8; c++) {
+        EXPECT_EQ(storage.get("counter" + std::to_string(c)).value(), std::to_string(threads * increments / 8));
+    }
+}
+
+class ManualClock : public TtlClock {
+public:
+    uint64_t NowMicros() const override { return now_; }
+    void Advance(uint64_t micros) { now_ += micros; }
+
+private:
+    std::atomic<uint64_t> now_{1000000};
+};
+
+TEST(LsmStorageTest, TtlPut) {
+    auto clock = std::make_shared<ManualClock>();
+    LsmStorageOptions options;
+    options.clock = clock;
+    LsmStorageInner storage(options);
+
+    storage.put("forever", "a");
+    storage.put("short", "b", std::chrono::seconds(1));
+    storage.put("long", "c", std::chrono::seconds(10));
+    EXPECT_EQ(storage.get("short").value(), "b");
+
+    clock->Advance(1000000);
+    EXPECT_FALSE(storage.get("short").has_value());
+    EXPECT_EQ(storage.get("long").value(), "c");
+    auto iter = storage.scan();
+    EXPECT_EQ(CollectKeys(iter.get()), (std::vector<std::string>{"forever", "long"}));
+    auto reverse = storage.reverse_scan();
+    ASSERT_TRUE(reverse->is_valid());
+    EXPECT_EQ(reverse->key(), "long");
+    reverse->prev();
+    EXPECT_EQ(reverse->key(), "forever");
+
+    // An expired value in a newer memtable hides the older version like a tombstone
+    storage.force_freeze_memtable();
+    storage.put("long", "d", std::chrono::seconds(1));
+    storage.force_freeze_memtable();
+    clock->Advance(1000000);
+    EXPECT_FALSE(storage.get("long").has_value());
+
+    // Flattening kept the expired entries as tombstones; compaction drops them
+    EXPECT_EQ(storage.num_entries(), 4);
+    ASSERT_TRUE(storage.compact_imm_memtables());
+    EXPECT_EQ(storage.num_entries(), 1);
+    EXPECT_EQ(storage.get("forever").value(), "a");
+    EXPECT_FALSE(storage.get("long").has_value());
+}
+
+TEST(LsmStorageTest, TtlOutOfRange) {
+    auto clock = std::make_shared<ManualClock>();
+    LsmStorageOptions options;
+    options.clock = clock;
+    LsmStorageInner storage(options);
+
+    EXPECT_FALSE(storage.put("zero", "a", std::chrono::microseconds(0)));
+    EXPECT_FALSE(storage.put("negative", "b", std::chrono::seconds(-1)));
+    EXPECT_FALSE(storage.get("zero").has_value());
+    EXPECT_FALSE(storage.get("negative").has_value());
+
+    // Too far out to represent: saturates instead of wrapping into the past
+    clock->Advance(UINT64_MAX - 3000000);
+    EXPECT_TRUE(storage.put("huge", "c", std::chrono::microseconds::max()));
+    clock->Advance(1000000);
+    EXPECT_EQ(storage.get("huge").value(), "c");
+}
+
+TEST(LsmStorageTest, TtlMerge) {
+    auto clock = std::make_shared<ManualClock>();
+    LsmStorageOptions options;
+    options.clock = clock;
+    options.merge_operator = std::make_shared<AddOperator>();
+    LsmStorageInner storage(options);
+
+    // Operands folded onto an expiring value expire with it
+    storage.put("counter", "10", std::chrono::seconds(1));
+    storage.merge("counter", "1");
+    storage.force_freeze_memtable();
+    storage.merge("counter", "2");
+    EXPECT_EQ(storage.get("counter").value(), "13");
+
+    // Once it expires the later operands apply to nothing
+    clock->Advance(1000000);
+    EXPECT_EQ(storage.get("counter").value(), "2");
+    auto iter = storage.scan();
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->value(), "2");
+}
+
+class TestCompactionFilter : public CompactionFilter {
+public:
+    const char* Name() const override { return "TestCompactionFilter"; }
+
+    // Drops "drop*" keys and upper-cases "upper*" values
+    Decision Filter(const std::string& key, const std::string& value, std::string* new_value) const override {
+        if (key.rfind("drop", 0) == 0) {
+            return Decision::kRemove;
+        }
+        if (key.rfind("upper", 0) == 0) {
+            *new_value = value;
+            std::transform(new_value->begin(), new_value->end(), new_value->begin(), ::toupper);
+            return Decision::kChangeValue;
+        }
+        return Decision::kKeep;
+    }
+};
+
+TEST(LsmStorageTest, CompactionFilter) {
+    LsmStorageOptions options;
+    options.compaction_filter = std::make_shared<TestCompactionFilter>();
+    LsmStorageInner storage(options);
+
+    // Written before the filter can see them: the first flatten filters these
+    storage.put("drop1", "old");
+    storage.put("keep", "k");
+    storage.put("upper", "abc");
+    EXPECT_EQ(storage.get("upper").value(), "abc");
+    storage.force_freeze_memtable();
+    EXPECT_FALSE(storage.get("drop1").has_value());
+    EXPECT_EQ(storage.get("upper").value(), "ABC");
+
+    storage.put("drop2", "x");
+    storage.force_freeze_memtable();
+    EXPECT_FALSE(storage.get("drop2").has_value());
+    auto iter = storage.scan();
+    EXPECT_EQ(CollectKeys(iter.get()), (std::vector<std::string>{"keep", "upper"}));
+
+    ASSERT_TRUE(storage.compact_imm_memtables());
+    EXPECT_EQ(storage.num_entries(), 2);
+    EXPECT_EQ(storage.get("upper").value(), "ABC");
+    EXPECT_EQ(storage.get("keep").value(), "k");
+}
+
+TEST(LsmStorageTest, ColumnFamilies) {
+    LsmStorageInner storage;
+    ColumnFamilyOptions meta_options;
+    meta_options.target_sst_size = 64;
+    meta_options.memtable_factory = std::make_shared<BTreeRepFactory>();
+    ColumnFamilyHandle* meta = storage.create_column_family("meta", meta_options);
+    ASSERT_NE(meta, nullptr);
+    EXPECT_EQ(storage.create_column_family("meta", meta_options), nullptr);
+    EXPECT_EQ(storage.get_column_family("meta"), meta);
+    EXPECT_EQ(storage.get_column_family("missing"), nullptr);
+    EXPECT_EQ(storage.default_column_family()->name(), LsmStorageInner::kDefaultColumnFamilyName);
+
+    // The same key lives independently in each family
+    storage.put("k", "payload");
+    storage.put(meta, "k", "metadata");
+    EXPECT_EQ(storage.get("k").value(), "payload");
+    EXPECT_EQ(storage.get(meta, "k").value(), "metadata");
+    storage.delete_key(meta, "k");
+    EXPECT_FALSE(storage.get(meta, "k").has_value());
+    EXPECT_EQ(storage.get("k").value(), "payload");
+
+    // Each family freezes at its own memtable size
+    for (int i = 0; i < 20; i++) {
+        storage.put(meta, "m" + std::to_string(i), "0123456789");
+    }
+    EXPECT_EQ(storage.get_imm_memtables_count(), 0);
+    EXPECT_EQ(storage.num_entries(meta), 21);
+    auto iter = storage.scan(meta);
+    EXPECT_EQ(CollectKeys(iter.get()).size(), 20);
+
+    storage.force_freeze_memtable(meta);
+    ASSERT_TRUE(storage.compact_imm_memtables(meta));
+    EXPECT_EQ(storage.num_entries(meta), 20);
+    EXPECT_EQ(storage.num_entries(), 1);
+}
+
+TEST(LsmStorageTest, WriteBatchAcrossColumnFamilies) {
+    LsmStorageOptions options;
+    options.target_sst_size = 4096;
+    LsmStorageInner storage(options);
+    ColumnFamilyOptions meta_options;
+    ColumnFamilyHandle* meta = storage.create_column_family("meta", meta_options);
+
+    WriteBatch rejected;
+    rejected.put("a", "1");
+    rejected.merge(meta, "counter", "1");
+    EXPECT_FALSE(storage.write(rejected));
+    EXPECT_FALSE(storage.get("a").has_value());
+
+    // Metadata is written before the payload it describes; a reader that sees
+    // the metadata must also see the payload
+    std::atomic<bool> done{false};
+    std::atomic<int> violations{0};
+    std::thread reader([&]() {
+        while (!done.load()) {
+            std::optional<std::string> version = storage.get(meta, "version");
+            std::optional<std::string> payload = storage.get("payload");
+            if (version.has_value() && (!payload.has_value() || std::stoi(*payload) < std::stoi(*version))) {
+                violations++;
+            }
+        }
+    });
+    for (int i = 0; i < 2000; i++) {
+        WriteBatch batch;
+        batch.put(meta, "version", std::to_string(i));
+        batch.put("payload", std::to_string(i));
+        batch.put("filler" + std::to_string(i), std::string(32, 'x'));
+        ASSERT_TRUE(storage.write(batch));
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(violations.load(), 0);
+    EXPECT_GT(storage.get_imm_memtables_count(), 0);
+    EXPECT_EQ(storage.get(meta, "version").value(), "1999");
+    EXPECT_EQ(storage.get("payload").value(), "1999");
+}
+
+TEST(LsmStorageTest, WriteBatchTtlAndRangeDeletion) {
+    auto clock = std::make_shared<ManualClock>();
+    LsmStorageOptions options;
+    options.clock = clock;
+    LsmStorageInner storage(options);
+    ColumnFamilyOptions meta_options;
+    ColumnFamilyHandle* meta = storage.create_column_family("meta", meta_options);
+
+    WriteBatch rejected;
+    rejected.put("a", "1");
+    rejected.put(meta, "lease", "x", std::chrono::seconds(0));
+    EXPECT_FALSE(storage.write(rejected));
+    EXPECT_FALSE(storage.get("a").has_value());
+
+    for (int i = 0; i < 5; i++) {
+        storage.put("k" + std::to_string(i), "old");
+    }
+    storage.force_freeze_memtable();
+    storage.put("k3", "active");
+
+    // Keys written before the range deletion in the batch are deleted, later ones survive
+    WriteBatch batch;
+    batch.put("k2", "batched");
+    batch.delete_range("k1", "k4");
+    batch.put("k1", "again");
+    batch.put(meta, "lease", "x", std::chrono::seconds(1));
+    ASSERT_TRUE(storage.write(batch));
+    auto iter = storage.scan();
+    EXPECT_EQ(CollectKeys(iter.get()), (std::vector<std::string>{"k0", "k1", "k4"}));
+    EXPECT_EQ(storage.get("k1").value(), "again");
+    EXPECT_EQ(storage.get(meta, "lease").value(), "x");
+
+    clock->Advance(1000000);
+    EXPECT_FALSE(storage.get(meta, "lease").has_value());
+}
+
+TEST(LsmStorageTest, FixedWidthKeysRefuseOtherSizes) {
+    LsmStorageOptions options;
+    options.memtable_factory = std::make_shared<FixedKeySkipListRepFactory>(8);
+    LsmStorageInner storage(options);
+    EXPECT_TRUE(storage.put("key00001", "a"));
+    EXPECT_FALSE(storage.put("key1", "b"));
+    EXPECT_FALSE(storage.delete_key("key000001"));
+    EXPECT_FALSE(storage.get("key1").has_value());
+
+    WriteBatch batch;
+    batch.put("key00002", "c");
+    batch.put("key2", "d");
+    EXPECT_FALSE(storage.write(batch));
+    EXPECT_FALSE(storage.get("key00002").has_value());
+}
+
+TEST(LsmStorageTest, CustomComparator) {
+    LsmStorageOptions options;
+    options.comparator = ReverseBytewiseComparator();
+    LsmStorageInner storage(options);
+    for (int i = 0; i < 6; i++) {
+        storage.put("k" + std::to_string(i), "v" + std::to_string(i));
+    }
+    storage.force_freeze_memtable();
+    storage.put("k2", "new");
+    storage.delete_key("k4");
+
+    auto iter = storage.scan();
+    EXPECT_EQ(CollectKeys(iter.get()), (std::vector<std::string>{"k5", "k3", "k2", "k1", "k0"}));
+    EXPECT_EQ(storage.get("k2").value(), "new");
+
+    // Range bounds follow the comparator too: [k3, k1) holds k3 and k2
+    storage.delete_range("k3", "k1");
+    auto after = storage.scan();
+    EXPECT_EQ(CollectKeys(after.get()), (std::vector<std::string>{"k5", "k1", "k0"}));
+    EXPECT_FALSE(storage.get("k2").has_value());
+
+    auto reverse = storage.reverse_scan("k1");
+    ASSERT_TRUE(reverse->is_valid());
+    EXPECT_EQ(reverse->key(), "k1");
+    reverse->prev();
+    EXPECT_EQ(reverse->key(), "k5");
+
+    storage.force_freeze_memtable();
+    ASSERT_TRUE(storage.compact_imm_memtables());
+    auto compacted = storage.scan();
+    EXPECT_EQ(CollectKeys(compacted.get()), (std::vector<std::string>{"k5", "k1", "k0"}));
+}
+
+TEST(LsmStorageTest, ScanPrefixInReverseOrder) {
+    LsmStorageOptions options;
+    options.comparator = ReverseBytewiseComparator();
+    LsmStorageInner storage(options);
+    for (const char* key : {"a", "b", "b/1", "b/2", "b/3", "c", "\xff", "\xff\x01"}) {
+        storage.put(key, "v");
+    }
+    storage.force_freeze_memtable();
+    storage.put("b/0", "v");
+    storage.delete_key("b/2");
+
+    // The run of keys with the prefix starts at the largest one and ends at the prefix itself
+    auto iter = storage.scan_prefix("b");
+    EXPECT_EQ(CollectKeys(iter.get()), (std::vector<std::string>{"b/3", "b/1", "b/0", "b"}));
+    iter->seek_to_last();
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->key(), "b");
+    iter->prev();
+    EXPECT_EQ(iter->key(), "b/0");
+
+    auto top = storage.scan_prefix("\xff");
+    EXPECT_EQ(CollectKeys(top.get()), (std::vector<std::string>{"\xff\x01", "\xff"}));
+    auto none = storage.scan_prefix("bb");
+    EXPECT_FALSE(none->is_valid());
+}
+
+// Shorter keys first, then bytewise
+class LengthFirstComparator : public Comparator {
+public:
+    const char* Name() const override { return "LengthFirstComparator"; }
+
+    int Compare(const std::string& a, const std::string& b) const override {
+        if (a.size() != b.size()) {
+            return a.size() < b.size() ? -1 : 1;
+        }
+        return a.compare(b);
+    }
+};
+
+TEST(LsmStorageTest, ScanPrefixUnderOtherComparators) {
+    LengthFirstComparator comparator;
+    LsmStorageOptions options;
+    options.comparator = &comparator;
+    LsmStorageInner storage(options);
+    for (const char* key : {"b", "c", "a1", "b1", "b2", "b22", "a333", "b333"}) {
+        storage.put(key, "v");
+    }
+    storage.force_freeze_memtable();
+    storage.delete_key("b2");
+    storage.delete_range("b333", "c333");
+
+    // The prefix's keys are interleaved with others, which are stepped over
+    auto iter = storage.scan_prefix("b");
+    EXPECT_EQ(CollectKeys(iter.get()), (std::vector<std::string>{"b", "b1", "b22"}));
+    iter->seek_to_last();
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->key(), "b22");
+    iter->prev();
+    EXPECT_EQ(iter->key(), "b1");
+    iter->prev();
+    EXPECT_EQ(iter->key(), "b");
+    iter->prev();
+    EXPECT_FALSE(iter->is_valid());
+    auto none = storage.scan_prefix("d");
+    EXPECT_FALSE(none->is_valid());
+}
+
+TEST(LsmStorageTest, GetIntoPinnableValue) {
+    LsmStorageOptions options;
+    options.merge_operator = std::make_shared<AddOperator>();
+    LsmStorageInner storage(options);
+    PinnableValue value;
+
+    // The active memtable can still overwrite its values, so they are copied
+    storage.put("a", "1");
+    ASSERT_TRUE(storage.get("a", &value));
+    EXPECT_EQ(value.view(), "1");
+    EXPECT_FALSE(value.IsPinned());
+    EXPECT_FALSE(storage.get("missing", &value));
+    EXPECT_TRUE(value.empty());
+
+    // Frozen values are referenced in place and outlive their memtable
+    std::string big(4096, 'x');
+    storage.put("big", big);
+    storage.put("gone", "1");
+    storage.force_freeze_memtable();
+    ASSERT_TRUE(storage.get("big", &value));
+    EXPECT_TRUE(value.IsPinned());
+    storage.put("big", "new");
+    storage.force_freeze_memtable();
+    storage.compact_imm_memtables();
+    EXPECT_EQ(value.view(), big);
+    ASSERT_TRUE(storage.get("big", &value));
+    EXPECT_EQ(value.view(), "new");
+
+    // Tombstones, and merges across memtables
+    storage.delete_key("gone");
+    EXPECT_FALSE(storage.get("gone", &value));
+    storage.merge("a", "5");
+    ASSERT_TRUE(storage.get("a", &value));
+    EXPECT_EQ(value.view(), "6");
+    EXPECT_FALSE(value.IsPinned());
+}
+
+TEST(LsmStorageTest, AsyncGetAndScan) {
+    LsmStorageOptions options;
+    options.merge_operator = std::make_shared<AddOperator>();
+    LsmStorageInner storage(options);
+    for (int i = 0; i < 300; i++) {
+        storage.put("key" + std::to_string(i), std::to_string(i));
+        if (i % 100 == 99) {
+            storage.force_freeze_memtable();
+        }
+    }
+    storage.delete_key("key7");
+    storage.merge("key8", "10");
+    storage.delete_range("key2", "key21");
+
+    // Many lookups in flight on one executor return what get() does
+    AsyncExecutor executor;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 320; i++) {
+        keys.push_back("key" + std::to_string(i));
+    }
+    std::vector<std::optional<std::string>> results(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        executor.spawn([](LsmStorageInner* storage, AsyncExecutor* executor, std::string key,
+                          std::optional<std::string>* result) -> Task<void> {
+            *result = co_await storage->async_get(*executor, std::move(key));
+        }(&storage, &executor, keys[i], &results[i]));
+    }
+    EXPECT_GT(executor.run(), keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        EXPECT_EQ(results[i], storage.get(keys[i])) << keys[i];
+    }
+    EXPECT_EQ(results[8], std::optional<std::string>("18"));
+    EXPECT_FALSE(results[7].has_value());
+    EXPECT_FALSE(results[20].has_value());
+
+    // Scans yield every AsyncIterator::kYieldInterval entries
+    std::vector<std::string> scanned;
+    executor.spawn([](LsmStorageInner* storage, AsyncExecutor* executor,
+                      std::vector<std::string>* scanned) -> Task<void> {
+        std::unique_ptr<AsyncIterator> iter = co_await storage->async_scan(*executor);
+        while (iter->is_valid()) {
+            scanned->push_back(iter->key());
+            co_await iter->next();
+        }
+    }(&storage, &executor, &scanned));
+    EXPECT_GT(executor.run(), 1u);
+    std::vector<std::string> expected;
+    auto iter = storage.scan();
+    for (; iter->is_valid(); iter->next()) {
+        expected.push_back(iter->key());
+    }
+    EXPECT_EQ(scanned, expected);
+    EXPECT_GT(scanned.size(), AsyncIterator::kYieldInterval);
+}
+
+TEST(LsmStorageTest, MemTableChecksums) {
+    LsmStorageOptions options;
+    options.memtable_checksums = true;
+    options.imm_compaction_trigger = 3;
+    options.merge_operator = std::make_shared<AddOperator>();
+    LsmStorageInner storage(options);
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 10; i++) {
+            storage.put("key" + std::to_string(i), "round" + std::to_string(round));
+        }
+        storage.merge("counter", "1");
+        storage.force_freeze_memtable();
+    }
+    storage.delete_key("key3");
+
+    // Entries keep their checksums through flattening and compaction of the frozen memtables
+    EXPECT_EQ(storage.get("key0").value(), "round4");
+    EXPECT_FALSE(storage.get("key3").has_value());
+    EXPECT_EQ(storage.get("counter").value(), "5");
+    PinnableValue value;
+    ASSERT_TRUE(storage.get("key9", &value));
+    EXPECT_EQ(value.view(), "round4");
+    auto iter = storage.scan();
+    int count = 0;
+    for (; iter->is_valid(); iter->next()) {
+        EXPECT_EQ(iter->value(), iter->key() == "counter" ? "5" : "round4");
+        count++;
+    }
+    EXPECT_EQ(count, 10);
+}
+
+// Temporary database directory, removed with its files
+class TempDir {
+public:
+    TempDir() {
+        char dir[] = "/tmp/lsm_storage_test_XXXXXX";
+        path_ = mkdtemp(dir) ? dir : "";
+    }
+    ~TempDir() {
+        std::vector<std::string> names;
+        Env::Default()->GetChildren(path_, &names);
+        for (const auto& name : names) {
+            Env::Default()->DeleteFile(path_ + "/" + name);
+        }
+        rmdir(path_.c_str());
+    }
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+TEST(LsmStorageTest, OpenRecoversTables) {
+    TempDir dir;
+    ASSERT_FALSE(dir.path().empty());
+    LsmStorageOptions options;
+    options.merge_operator = std::make_shared<AddOperator>();
+    options.imm_compaction_trigger = 4;
+    {
+        auto storage = LsmStorageInner::open(dir.path(), options);
+        ASSERT_NE(storage, nullptr);
+        for (int round = 0; round < 6; round++) {
+            for (int i = 0; i < 50; i++) {
+                storage->put("key" + std::to_string(i), "round" + std::to_string(round));
+            }
+            storage->merge("counter", "1");
+            storage->force_freeze_memtable();
+        }
+        storage->delete_key("key3");
+        storage->delete_range("key4", "key5");
+        storage->put("ttl", "gone", std::chrono::microseconds(1));
+        ColumnFamilyHandle* cf = storage->create_column_family("other", ColumnFamilyOptions());
+        storage->put(cf, "key0", "other");
+        // Closing writes out the active memtables
+    }
+
+    auto storage = LsmStorageInner::open(dir.path(), options);
+    ASSERT_NE(storage, nullptr);
+    EXPECT_EQ(storage->get("key0").value(), "round5");
+    EXPECT_FALSE(storage->get("key3").has_value());
+    EXPECT_FALSE(storage->get("key45").has_value());
+    EXPECT_EQ(storage->get("key5").value(), "round5");
+    EXPECT_FALSE(storage->get("ttl").has_value());
+    EXPECT_EQ(storage->get("counter").value(), "6");
+    ColumnFamilyHandle* cf = storage->get_column_family("other");
+    ASSERT_NE(cf, nullptr);
+    EXPECT_EQ(storage->get(cf, "key0").value(), "other");
+    EXPECT_FALSE(storage->get(cf, "key1").has_value());
+
+    int count = 0;
+    for (auto iter = storage->scan(); iter->is_valid(); iter->next()) {
+        count++;
+    }
+    // 50 keys less key3, key4 and key40..key49, plus counter
+    EXPECT_EQ(count, 50 - 12 + 1);
+    EXPECT_NEAR(static_cast<double>(storage->approximate_distinct_keys()), count, 2);
+
+    // New tables continue after the recovered ones and survive another reopen
+    storage->put("key1", "after");
+    storage->force_freeze_memtable();
+    EXPECT_TRUE(storage->compact_imm_memtables());
+    storage.reset();
+    storage = LsmStorageInner::open(dir.path(), options);
+    ASSERT_NE(storage, nullptr);
+    EXPECT_EQ(storage->get("key1").value(), "after");
+    EXPECT_EQ(storage->get("key2").value(), "round5");
+    EXPECT_EQ(storage->get_imm_memtables_count(), 1);
+}
+
+// Once armed, holds up the merge at key "gate" until released
+class GateCompactionFilter : public CompactionFilter {
+public:
+    const char* Name() const override { return "GateCompactionFilter"; }
+
+    Decision Filter(const std::string& key, const std::string&, std::string*) const override {
+        if (key == "gate" && armed.load()) {
+            entered = true;
+            while (!released.load()) {
+                std::this_thread::yield();
+            }
+        }
+        return Decision::kKeep;
+    }
+
+    mutable std::atomic<bool> armed{false};
+    mutable std::atomic<bool> entered{false};
+    std::atomic<bool> released{false};
+};
+
+TEST(LsmStorageTest, OpenKeepsTablesFrozenDuringCompactionNewer) {
+    TempDir dir;
+    LsmStorageOptions options;
+    auto gate = std::make_shared<GateCompactionFilter>();
+    options.compaction_filter = gate;
+    {
+        auto storage = LsmStorageInner::open(dir.path(), options);
+        ASSERT_NE(storage, nullptr);
+        storage->put("gate", "g");
+        storage->put("key", "old");
+        storage->force_freeze_memtable();
+        storage->put("key", "old");
+        storage->force_freeze_memtable();
+
+        gate->armed = true;
+        std::thread compaction([&storage] { EXPECT_TRUE(storage->compact_imm_memtables()); });
+        while (!gate->entered.load()) {
+            std::this_thread::yield();
+        }
+        // Frozen after the compaction picked its inputs, so it gets the smaller id
+        storage->put("key", "new");
+        std::thread freeze([&storage] { storage->force_freeze_memtable(); });
+        while (storage->get_imm_memtables_count() < 3) {
+            std::this_thread::yield();
+        }
+        gate->released = true;
+        compaction.join();
+        freeze.join();
+        EXPECT_EQ(storage->get("key").value(), "new");
+    }
+
+    auto storage = LsmStorageInner::open(dir.path(), options);
+    ASSERT_NE(storage, nullptr);
+    EXPECT_EQ(storage->get_imm_memtables_count(), 2);
+    EXPECT_EQ(storage->get("key").value(), "new");
+    EXPECT_EQ(storage->get("gate").value(), "g");
+}
+
+TEST(LsmStorageTest, CompactionWritesAtCompactionPriority) {
+    TempDir dir;
+    LsmStorageOptions options;
+    options.rate_limiter = std::make_shared<RateLimiter>(1 << 30);
+    auto storage = LsmStorageInner::open(dir.path(), options);
+    ASSERT_NE(storage, nullptr);
+    for (int round = 0; round < 2; round++) {
+        storage->put("key" + std::to_string(round), "value");
+        storage->force_freeze_memtable();
+    }
+    int64_t flushed = options.rate_limiter->GetTotalBytesThrough(IOPriority::kFlush);
+    EXPECT_GT(flushed, 0);
+    EXPECT_EQ(options.rate_limiter->GetTotalBytesThrough(IOPriority::kCompaction), 0);
+
+    ASSERT_TRUE(storage->compact_imm_memtables());
+    EXPECT_GT(options.rate_limiter->GetTotalBytesThrough(IOPriority::kCompaction), 0);
+    EXPECT_EQ(options.rate_limiter->GetTotalBytesThrough(IOPriority::kFlush), flushed);
+}
+
+TEST(LsmStorageTest, OpenIsLazy) {
+    TempDir dir;
+    {
+        auto lsm = Lsm::open(dir.path());
+        ASSERT_NE(lsm, nullptr);
+        lsm->put("a", "1");
+        lsm->put("m", "2");
+    }
+    // No table is read until a lookup falls in its key range
+    std::vector<std::string> names;
+    Env::Default()->GetChildren(dir.path(), &names);
+    for (const auto& name : names) {
+        uint64_t id;
+        if (ParseTableFileName(name, &id)) {
+            Env::Default()->DeleteFile(dir.path() + "/" + name);
+        }
+    }
+    auto lsm = Lsm::open(dir.path());
+    ASSERT_NE(lsm, nullptr);
+    // The manifest carries each table's sketch
+    EXPECT_EQ(lsm->approximate_distinct_keys(), 2u);
+    EXPECT_FALSE(lsm->get("z").has_value());
+    // A get reports the missing table as a failed lookup; an iterator cannot
+    EXPECT_FALSE(lsm->get("b").has_value());
+    EXPECT_DEATH(lsm->scan(), "cannot read table");
+}
+
+TEST(LsmStorageTest, UnreadableTableFailsGets) {
+    TempDir dir;
+    {
+        auto storage = LsmStorageInner::open(dir.path(), LsmStorageOptions());
+        ASSERT_NE(storage, nullptr);
+        storage->put("b", "old");
+        storage->force_freeze_memtable();
+        storage->put("b", "new");
+        storage->put("c", "1");
+        storage->force_freeze_memtable();
+    }
+    // Lose the newer table
+    uint64_t newest = 0;
+    std::vector<std::string> names;
+    Env::Default()->GetChildren(dir.path(), &names);
+    for (const auto& name : names) {
+        uint64_t id;
+        if (ParseTableFileName(name, &id)) {
+            newest = std::max(newest, id);
+        }
+    }
+    ASSERT_TRUE(Env::Default()->DeleteFile(TableFileName(dir.path(), newest)));
+
+    auto storage = LsmStorageInner::open(dir.path(), LsmStorageOptions());
+    ASSERT_NE(storage, nullptr);
+    AsyncExecutor executor;
+    std::optional<std::string> result = "unset";
+    bool done = false;
+    executor.spawn([](LsmStorageInner* storage, AsyncExecutor* executor, std::optional<std::string>* result,
+                      bool* done) -> Task<void> {
+        *result = co_await storage->async_get(*executor, "b");
+        *done = true;
+    }(storage.get(), &executor, &result, &done));
+    // Runs alongside the get while the table is read off the executor thread
+    int resumed = 0;
+    executor.spawn([](AsyncExecutor* executor, bool* done, int* resumed) -> Task<void> {
+        while (!*done) {
+            ++*resumed;
+            co_await executor->yield();
+        }
+    }(&executor, &done, &resumed));
+    executor.run();
+    EXPECT_GE(resumed, 1);
+    // The older table's value must not show through
+    EXPECT_FALSE(result.has_value());
+    EXPECT_FALSE(storage->get("b").has_value());
+    EXPECT_FALSE(storage->get("c").has_value());
+}
+
+TEST(LsmStorageTest, OpenChecksComparator) {
+    TempDir dir;
+    {
+        auto lsm = Lsm::open(dir.path());
+        ASSERT_NE(lsm, nullptr);
+        ColumnFamilyOptions reversed;
+        reversed.comparator = ReverseBytewiseComparator();
+        ASSERT_NE(lsm->create_column_family("reversed", reversed), nullptr);
+    }
+    EXPECT_EQ(Lsm::open(dir.path()), nullptr);
+
+    ColumnFamilyDescriptor descriptor{"reversed", ColumnFamilyOptions()};
+    descriptor.options.comparator = ReverseBytewiseComparator();
+    auto lsm = Lsm::open(dir.path(), LsmStorageOptions(), {descriptor});
+    ASSERT_NE(lsm, nullptr);
+    EXPECT_NE(lsm->get_column_family("reversed"), nullptr);
+
+    LsmStorageOptions reversed_default;
+    reversed_default.comparator = ReverseBytewiseComparator();
+    lsm.reset();
+    EXPECT_EQ(Lsm::open(dir.path(), reversed_default, {descriptor}), nullptr);
+}
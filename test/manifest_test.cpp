@@ -0,0 +1,275 @@
+#include "src/include/manifest.hpp"
+#include "src/include/mem_table.hpp"
+#include "src/include/record_file.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+class ManifestTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char dir[] = "/tmp/manifest_test_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        dir_ = dir;
+    }
+
+    void TearDown() override {
+        std::vector<std::string> names;
+        env_->GetChildren(dir_, &names);
+        for (const auto& name : names) {
+            env_->DeleteFile(dir_ + "/" + name);
+        }
+        rmdir(dir_.c_str());
+    }
+
+    // Overwrite path with contents
+    void WriteFile(const std::string& path, const std::string& contents) {
+        auto file = env_->NewWritableFile(path);
+        ASSERT_NE(file, nullptr);
+        ASSERT_TRUE(file->AppendAndSync(contents));
+        file->Close();
+    }
+
+    std::string ReadFile(const std::string& path) {
+        std::string contents;
+        EXPECT_TRUE(ReadFileToString(env_, path, &contents));
+        return contents;
+    }
+
+    static TableMeta Table(uint64_t id, uint32_t column_family = 0) {
+        TableMeta table;
+        table.id = id;
+        table.column_family = column_family;
+        table.sequence = id;
+        table.size = 100 * id;
+        table.num_entries = id;
+        table.smallest = "a" + std::to_string(id);
+        table.largest = "z" + std::to_string(id);
+        return table;
+    }
+
+    Env* env_ = Env::Default();
+    std::string dir_;
+};
+
+TEST_F(ManifestTest, RecordFraming) {
+    std::string contents;
+    EncodeRecord(&contents, "first");
+    EncodeRecord(&contents, "");
+    EncodeRecord(&contents, std::string(1000, 'x'));
+
+    std::vector<std::string_view> records;
+    ASSERT_TRUE(DecodeRecords(contents, true, &records));
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0], "first");
+    EXPECT_EQ(records[1], "");
+    EXPECT_EQ(records[2].size(), 1000u);
+
+    // A torn last record is only acceptable to readers that expect one
+    std::string torn = contents.substr(0, contents.size() - 10);
+    records.clear();
+    EXPECT_FALSE(DecodeRecords(torn, true, &records));
+    bool truncated;
+    records.clear();
+    ASSERT_TRUE(DecodeRecords(torn, true, &records, &truncated));
+    EXPECT_TRUE(truncated);
+    EXPECT_EQ(records.size(), 2u);
+
+    std::string corrupt = contents;
+    corrupt[kRecordHeaderSize + 1] ^= 1;
+    records.clear();
+    EXPECT_FALSE(DecodeRecords(corrupt, true, &records, &truncated));
+    EXPECT_TRUE(records.empty());
+    records.clear();
+    EXPECT_TRUE(DecodeRecords(corrupt, false, &records));
+    EXPECT_EQ(records[0], "fhrst");
+}
+
+TEST_F(ManifestTest, TableRoundTrip) {
+    MemTableOptions options;
+    options.merge_operator = std::make_shared<AddOperator>();
+    auto memtable = std::make_shared<MemTable>(options);
+    // Enough entries for several blocks
+    for (int i = 0; i < 5000; i++) {
+        memtable->put("key" + std::to_string(10000 + i), std::string(20, 'v'));
+    }
+    memtable->put("key10001", "");
+    memtable->put("key10002", "ttl", 777);
+    memtable->merge("key20000", "5");
+    memtable->delete_range("key10100", "key10200");
+
+    TableMeta meta;
+    std::string path = TableFileName(dir_, 7);
+    ASSERT_TRUE(WriteTable(env_, path, FileOptions(), memtable.get(), &meta));
+    EXPECT_EQ(path, dir_ + "/000007.sst");
+    uint64_t id;
+    ASSERT_TRUE(ParseTableFileName("000007.sst", &id));
+    EXPECT_EQ(id, 7u);
+    EXPECT_FALSE(ParseTableFileName("MANIFEST-000001", &id));
+    EXPECT_EQ(meta.num_entries, 5001u);
+    EXPECT_EQ(meta.size, memtable->Size());
+    EXPECT_EQ(meta.smallest, "key10000");
+    EXPECT_EQ(meta.largest, "key20000");
+    ASSERT_EQ(meta.range_tombstones.size(), 1u);
+    EXPECT_EQ(meta.range_tombstones[0].begin, "key10100");
+    uint64_t file_size;
+    ASSERT_TRUE(env_->GetFileSize(path, &file_size));
+    EXPECT_GT(file_size, 3 * kTableBlockSize);
+
+    auto expected = memtable->begin();
+    auto actual = ReadTable(env_, path, FileOptions(), true);
+    ASSERT_NE(actual, nullptr);
+    for (; expected.is_valid(); expected.next(), actual->next()) {
+        ASSERT_TRUE(actual->is_valid());
+        EXPECT_EQ(actual->key(), expected.key());
+        EXPECT_EQ(actual->entry_type(), expected.entry_type());
+        EXPECT_EQ(actual->value(), expected.value());
+        EXPECT_EQ(actual->expire_at_micros(), expected.expire_at_micros());
+    }
+    EXPECT_FALSE(actual->is_valid());
+    actual->seek("key10002a");
+    EXPECT_EQ(actual->key(), "key10003");
+    actual->seek_for_prev("key10002a");
+    EXPECT_EQ(actual->key(), "key10002");
+    actual->prev();
+    EXPECT_EQ(actual->key(), "key10001");
+    actual->seek_to_last();
+    EXPECT_EQ(actual->key(), "key20000");
+
+    // Served lazily through a memtable, the file is read on the first lookup in range
+    auto lazy = MemTable::create_lazy(meta, [&]() { return ReadTable(env_, path, FileOptions(), true); }, options);
+    EXPECT_EQ(lazy->Size(), memtable->Size());
+    EXPECT_EQ(lazy->num_entries(), 5001);
+    EXPECT_FALSE(lazy->get("a").has_value());
+    EXPECT_EQ(lazy->memory_usage(), 0u);
+    EXPECT_TRUE(lazy->is_range_deleted("key10150"));
+    EXPECT_EQ(lazy->get_entry("key10002")->expire_at, 777u);
+    EXPECT_GT(lazy->memory_usage(), 0u);
+    EXPECT_EQ(lazy->get_entry("key20000")->type, EntryType::kMerge);
+    EXPECT_EQ(lazy->get("key10001").value(), "");
+    EXPECT_NEAR(lazy->distinct_keys_sketch().Estimate(), 5001, 250);
+    EXPECT_DEATH(lazy->put("key10000", "v"), "read-only");
+
+    // A file cut short at a record boundary, or corrupted, is refused
+    std::string contents = ReadFile(path);
+    std::vector<std::string_view> records;
+    ASSERT_TRUE(DecodeRecords(contents, true, &records));
+    WriteFile(path, contents.substr(0, records.back().data() - contents.data() - kRecordHeaderSize));
+    EXPECT_EQ(ReadTable(env_, path, FileOptions(), true), nullptr);
+    contents[contents.size() / 2] ^= 1;
+    WriteFile(path, contents);
+    EXPECT_EQ(ReadTable(env_, path, FileOptions(), true), nullptr);
+    EXPECT_EQ(ReadTable(env_, dir_ + "/missing.sst", FileOptions(), true), nullptr);
+}
+
+TEST_F(ManifestTest, ReplaysEdits) {
+    {
+        auto manifest = Manifest::Open(env_, dir_, 1 << 20);
+        ASSERT_NE(manifest, nullptr);
+        EXPECT_TRUE(manifest->tables().empty());
+        EXPECT_EQ(manifest->next_table_id(), 1u);
+
+        ManifestEdit create;
+        create.column_families.push_back({0, "default", "leveldb.BytewiseComparator"});
+        create.column_families.push_back({1, "other", "leveldb.BytewiseComparator"});
+        ASSERT_TRUE(manifest->LogAndApply(create));
+        for (uint64_t id = 1; id <= 4; id++) {
+            ManifestEdit edit;
+            edit.new_tables.push_back(Table(id, id == 4 ? 1 : 0));
+            ASSERT_TRUE(manifest->LogAndApply(edit));
+        }
+        ManifestEdit compaction;
+        TableMeta merged = Table(6);
+        // Takes the place of the newest input, below table 3
+        merged.sequence = 2;
+        merged.distinct_keys_sketch = std::string("\x0e" "s\0\0\0", 5);
+        merged.range_tombstones.push_back({"b", "c"});
+        compaction.new_tables.push_back(merged);
+        compaction.deleted_tables = {1, 2, 5};
+        ASSERT_TRUE(manifest->LogAndApply(compaction));
+    }
+    // Left by a crash between writing a table and logging it
+    WriteFile(dir_ + "/000009.sst", "orphan");
+
+    auto manifest = Manifest::Open(env_, dir_, 1 << 20);
+    ASSERT_NE(manifest, nullptr);
+    auto families = manifest->column_families();
+    ASSERT_EQ(families.size(), 2u);
+    EXPECT_EQ(families[1].name, "other");
+    auto tables = manifest->tables();
+    ASSERT_EQ(tables.size(), 3u);
+    EXPECT_EQ(tables[0].id, 3u);
+    EXPECT_EQ(tables[0].sequence, 3u);
+    EXPECT_EQ(tables[1].id, 4u);
+    EXPECT_EQ(tables[1].column_family, 1u);
+    EXPECT_EQ(tables[2].id, 6u);
+    EXPECT_EQ(tables[2].sequence, 2u);
+    EXPECT_EQ(tables[2].distinct_keys_sketch, std::string("\x0e" "s\0\0\0", 5));
+    EXPECT_TRUE(tables[0].distinct_keys_sketch.empty());
+    EXPECT_EQ(tables[2].size, 600);
+    EXPECT_EQ(tables[2].largest, "z6");
+    ASSERT_EQ(tables[2].range_tombstones.size(), 1u);
+    EXPECT_EQ(tables[2].range_tombstones[0].end, "c");
+    EXPECT_EQ(manifest->next_table_id(), 7u);
+    EXPECT_FALSE(env_->FileExists(dir_ + "/000009.sst"));
+
+    // Only the new manifest and CURRENT remain
+    std::vector<std::string> names;
+    env_->GetChildren(dir_, &names);
+    EXPECT_EQ(names.size(), 2u);
+}
+
+TEST_F(ManifestTest, TornLastRecord) {
+    {
+        auto manifest = Manifest::Open(env_, dir_, 1 << 20);
+        ASSERT_NE(manifest, nullptr);
+        for (uint64_t id = 1; id <= 3; id++) {
+            ManifestEdit edit;
+            edit.new_tables.push_back(Table(id));
+            ASSERT_TRUE(manifest->LogAndApply(edit));
+        }
+    }
+    std::string current = ReadFile(dir_ + "/CURRENT");
+    std::string manifest_path = dir_ + "/" + current.substr(0, current.size() - 1);
+    std::string contents = ReadFile(manifest_path);
+    WriteFile(manifest_path, contents.substr(0, contents.size() - 5));
+
+    auto manifest = Manifest::Open(env_, dir_, 1 << 20);
+    ASSERT_NE(manifest, nullptr);
+    EXPECT_EQ(manifest->tables().size(), 2u);
+
+    // A bad checksum before the end is corruption, not a torn append
+    current = ReadFile(dir_ + "/CURRENT");
+    manifest_path = dir_ + "/" + current.substr(0, current.size() - 1);
+    contents = ReadFile(manifest_path);
+    contents[kRecordHeaderSize] ^= 1;
+    WriteFile(manifest_path, contents);
+    manifest.reset();
+    EXPECT_EQ(Manifest::Open(env_, dir_, 1 << 20), nullptr);
+}
+
+TEST_F(ManifestTest, SnapshotsBoundSize) {
+    const uint64_t max_file_size = 4096;
+    {
+        auto manifest = Manifest::Open(env_, dir_, max_file_size);
+        ASSERT_NE(manifest, nullptr);
+        // A long-running database: tables come and go, few are live at a time
+        for (uint64_t id = 1; id <= 2000; id++) {
+            ManifestEdit edit;
+            edit.new_tables.push_back(Table(id));
+            if (id > 5) {
+                edit.deleted_tables.push_back(id - 5);
+            }
+            ASSERT_TRUE(manifest->LogAndApply(edit));
+            ASSERT_LE(manifest->file_size(), max_file_size + 256);
+        }
+    }
+    auto manifest = Manifest::Open(env_, dir_, max_file_size);
+    ASSERT_NE(manifest, nullptr);
+    auto tables = manifest->tables();
+    ASSERT_EQ(tables.size(), 5u);
+    EXPECT_EQ(tables.front().id, 1996u);
+    EXPECT_EQ(manifest->next_table_id(), 2001u);
+}
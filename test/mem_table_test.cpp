@@ -1,4 +1,5 @@
 #include "src/include/mem_table.hpp"
+#include "src/include/write_buffer_manager.hpp"
 #include <gtest/gtest.h>
 #include <vector>
 
@@ -185,4 +186,378 @@ TEST(MemTableTest, IteratorWithOverwrites) {
     
     iter.next();
     EXPECT_FALSE(iter.is_valid());
-}
\ No newline at end of file
+}
+TEST(MemTableTest, HashIndexPointLookups) {
+    MemTableOptions options;
+    options.enable_hash_index = true;
+    MemTable memtable(options);
+
+    memtable.put("key1", "value1");
+    memtable.put("key2", "value2");
+    memtable.put("key1", "updated1");
+
+    EXPECT_EQ(memtable.get("key1").value(), "updated1");
+    EXPECT_EQ(memtable.get("key2").value(), "value2");
+    EXPECT_FALSE(memtable.get("key3").has_value());
+
+    // Ordered iteration still comes from the skip list
+    auto iter = memtable.begin();
+    EXPECT_EQ(iter.key(), "key1");
+    EXPECT_EQ(iter.value(), "updated1");
+    iter.next();
+    EXPECT_EQ(iter.key(), "key2");
+    iter.next();
+    EXPECT_FALSE(iter.is_valid());
+}
+
+TEST(MemTableTest, HashIndexIsCharged) {
+    WriteBufferManager indexed_wbm(1 << 20);
+    WriteBufferManager plain_wbm(1 << 20);
+    MemTableOptions options;
+    options.enable_hash_index = true;
+    options.write_buffer_manager = &indexed_wbm;
+    MemTable indexed(options);
+    options.enable_hash_index = false;
+    options.write_buffer_manager = &plain_wbm;
+    MemTable plain(options);
+    for (int i = 0; i < 1000; i++) {
+        for (MemTable* memtable : {&indexed, &plain}) {
+            memtable->put("key" + std::to_string(i), std::string(100, 'v'));
+        }
+    }
+
+    // The index's copy of the entries shows in the memory figures but not in the data size
+    EXPECT_EQ(indexed.Size(), plain.Size());
+    EXPECT_GT(indexed.memory_usage(), plain.memory_usage() + static_cast<size_t>(plain.Size()));
+    EXPECT_GT(indexed_wbm.memory_usage(), plain_wbm.memory_usage() + static_cast<size_t>(plain.Size()));
+}
+
+TEST(MemTableTest, BTreeRepresentation) {
+    MemTableOptions options;
+    options.rep_factory = std::make_shared<BTreeRepFactory>();
+    MemTable memtable(options);
+    EXPECT_TRUE(memtable.isEmpty());
+
+    memtable.put("cherry", "fruit3");
+    memtable.put("apple", "fruit1");
+    memtable.put("banana", "fruit2");
+    memtable.put("apple", "updated1");
+
+    EXPECT_EQ(memtable.get("apple").value(), "updated1");
+    EXPECT_FALSE(memtable.get("date").has_value());
+
+    auto iter = memtable.begin();
+    EXPECT_EQ(iter.key(), "apple");
+    EXPECT_EQ(iter.value(), "updated1");
+    iter.next();
+    EXPECT_EQ(iter.key(), "banana");
+    iter.next();
+    EXPECT_EQ(iter.key(), "cherry");
+    iter.next();
+    EXPECT_FALSE(iter.is_valid());
+
+    auto scan_iter = memtable.scan("b", "c");
+    EXPECT_EQ(scan_iter.key(), "banana");
+}
+
+TEST(MemTableTest, VectorRepCountsOverwritesOnceFrozen) {
+    MemTableOptions options;
+    options.rep_factory = std::make_shared<VectorRepFactory>();
+    MemTable vector_memtable(options);
+    MemTable skiplist_memtable;
+    for (MemTable* memtable : {&vector_memtable, &skiplist_memtable}) {
+        memtable->put("a", "1");
+        memtable->put("b", "22");
+        memtable->put("a", "333");
+        memtable->mark_immutable();
+    }
+
+    // The appends of "a" collapse to one entry when the vector is sorted
+    EXPECT_EQ(vector_memtable.num_entries(), 2);
+    EXPECT_EQ(vector_memtable.Size(), skiplist_memtable.Size());
+    EXPECT_EQ(vector_memtable.get("a").value(), "333");
+}
+
+TEST(MemTableTest, FlattenPreservesContents) {
+    auto memtable = std::make_shared<MemTable>();
+    // Long shared prefixes force the full-key comparison on prefix ties
+    for (int i = 0; i < 200; i += 2) {
+        memtable->put("common_prefix_" + std::to_string(1000 + i), "v" + std::to_string(i));
+    }
+    memtable->put("a", "short");
+    memtable->put("common_prefix_1000", "updated");
+    memtable->mark_immutable();
+
+    std::shared_ptr<MemTable> flat = memtable->flatten();
+    EXPECT_EQ(flat->num_entries(), memtable->num_entries());
+    EXPECT_EQ(flat->Size(), memtable->Size());
+    EXPECT_EQ(flat->get("a").value(), "short");
+    EXPECT_EQ(flat->get("common_prefix_1000").value(), "updated");
+    EXPECT_EQ(flat->get("common_prefix_1198").value(), "v198");
+    EXPECT_FALSE(flat->get("common_prefix_1001").has_value());
+    EXPECT_FALSE(flat->get("common_prefix_").has_value());
+    EXPECT_FALSE(flat->get("zzz").has_value());
+
+    auto expected = memtable->begin();
+    auto actual = flat->begin();
+    while (expected.is_valid()) {
+        ASSERT_TRUE(actual.is_valid());
+        EXPECT_EQ(actual.key(), expected.key());
+        EXPECT_EQ(actual.value(), expected.value());
+        expected.next();
+        actual.next();
+    }
+    EXPECT_FALSE(actual.is_valid());
+
+    auto scan_iter = flat->scan("common_prefix_1051", "");
+    ASSERT_TRUE(scan_iter.is_valid());
+    EXPECT_EQ(scan_iter.key(), "common_prefix_1052");
+}
+
+TEST(MemTableTest, IteratorKeepsMemTableAlive) {
+    auto memtable = std::make_shared<MemTable>();
+    memtable->put("key1", "value1");
+    memtable->put("key2", "value2");
+
+    auto iter = memtable->begin_ptr();
+    memtable.reset();
+
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->key(), "key1");
+    iter->next();
+    EXPECT_EQ(iter->value(), "value2");
+}
+
+TEST(MemTableTest, RangeTombstonesCoalesce) {
+    MemTable mem;
+    EXPECT_EQ(mem.range_tombstones(), nullptr);
+    mem.delete_range("c", "e");
+    mem.delete_range("m", "p");
+    mem.delete_range("a", "b");
+    // Touches [c, e) and overlaps [m, p), so all three become one range
+    mem.delete_range("e", "n");
+    mem.delete_range("d", "f");
+
+    auto tombstones = mem.range_tombstones();
+    ASSERT_NE(tombstones, nullptr);
+    ASSERT_EQ(tombstones->size(), 2);
+    EXPECT_EQ((*tombstones)[0].begin, "a");
+    EXPECT_EQ((*tombstones)[0].end, "b");
+    EXPECT_EQ((*tombstones)[1].begin, "c");
+    EXPECT_EQ((*tombstones)[1].end, "p");
+
+    EXPECT_TRUE(mem.is_range_deleted("a"));
+    EXPECT_FALSE(mem.is_range_deleted("b"));
+    EXPECT_TRUE(mem.is_range_deleted("c"));
+    EXPECT_TRUE(mem.is_range_deleted("ozzz"));
+    EXPECT_FALSE(mem.is_range_deleted("p"));
+    EXPECT_EQ(mem.range_tombstones(), tombstones);
+}
+
+TEST(MemTableTest, PrefixBloomFilter) {
+    MemTableOptions options;
+    options.prefix_extractor = std::make_shared<DelimiterPrefixExtractor>('/', 1);
+    options.prefix_bloom_bits = 8192;
+    auto memtable = std::make_shared<MemTable>(options);
+    memtable->put("a/1", "x");
+    memtable->put("b/2", "y");
+    memtable->put("no_delimiter", "z");
+
+    EXPECT_TRUE(memtable->may_contain_prefix("a/"));
+    EXPECT_TRUE(memtable->may_contain_prefix("b/"));
+    int ruled_out = 0;
+    for (char c = 'c'; c <= 'z'; c++) {
+        if (!memtable->may_contain_prefix(std::string(1, c) + "/")) {
+            ruled_out++;
+        }
+    }
+    EXPECT_GE(ruled_out, 20);
+
+    // Flattened copies keep answering for the keys they hold
+    memtable->mark_immutable();
+    std::shared_ptr<MemTable> flat = memtable->flatten();
+    EXPECT_TRUE(flat->may_contain_prefix("a/"));
+    EXPECT_TRUE(flat->may_contain_prefix("b/"));
+
+    // Without a filter every prefix may be present
+    MemTable unfiltered;
+    EXPECT_TRUE(unfiltered.may_contain_prefix("c/"));
+}
+
+TEST(MemTableTest, MergeOperands) {
+    MemTable plain;
+    EXPECT_FALSE(plain.merge("counter", "1"));
+
+    MemTableOptions options;
+    options.merge_operator = std::make_shared<AddOperator>();
+    auto memtable = std::make_shared<MemTable>(options);
+
+    // With nothing below in this memtable the operands are combined but stay operands
+    memtable->merge("counter", "1");
+    memtable->merge("counter", "2");
+    std::optional<MemTable::Entry> entry = memtable->get_entry("counter");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->type, EntryType::kMerge);
+    EXPECT_EQ(entry->value, "3");
+
+    // Onto a value or a tombstone in the same memtable they fold to a value
+    memtable->put("base", "10");
+    memtable->merge("base", "5");
+    entry = memtable->get_entry("base");
+    EXPECT_EQ(entry->type, EntryType::kValue);
+    EXPECT_EQ(entry->value, "15");
+    memtable->put("gone", "");
+    memtable->merge("gone", "7");
+    EXPECT_EQ(memtable->get_entry("gone")->type, EntryType::kValue);
+    EXPECT_EQ(memtable->get("gone").value(), "7");
+
+    // Sizes count the value as the user sees it
+    EXPECT_EQ(memtable->Size(), static_cast<int>(std::string("base15counter3gone7").size()));
+
+    auto iter = memtable->begin();
+    EXPECT_EQ(iter.key(), "base");
+    EXPECT_EQ(iter.entry_type(), EntryType::kValue);
+    iter.next();
+    EXPECT_EQ(iter.key(), "counter");
+    EXPECT_EQ(iter.entry_type(), EntryType::kMerge);
+    EXPECT_EQ(iter.value(), "3");
+}
+
+TEST(MemTableTest, ExpiringValues) {
+    MemTable memtable;
+    memtable.put("plain", "a");
+    memtable.put("ttl", "b", 500);
+
+    std::optional<MemTable::Entry> entry = memtable.get_entry("ttl");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->type, EntryType::kValue);
+    EXPECT_EQ(entry->value, "b");
+    EXPECT_EQ(entry->expire_at, 500u);
+    EXPECT_EQ(memtable.get_entry("plain")->expire_at, 0u);
+
+    // The expiry time is counted with the value
+    EXPECT_EQ(memtable.Size(), static_cast<int>(std::string("plainattlb").size() + sizeof(uint64_t)));
+
+    auto iter = memtable.begin();
+    ASSERT_TRUE(iter.is_valid());
+    EXPECT_EQ(iter.key(), "plain");
+    EXPECT_EQ(iter.expire_at_micros(), 0u);
+    iter.next();
+    EXPECT_EQ(iter.value(), "b");
+    EXPECT_EQ(iter.expire_at_micros(), 500u);
+}
+
+TEST(MemTableTest, RefusesKeysTheRepCannotHold) {
+    MemTableOptions options;
+    options.rep_factory = std::make_shared<FixedKeySkipListRepFactory>(8);
+    MemTable mem(options);
+    EXPECT_TRUE(mem.put("12345678", "v"));
+    EXPECT_FALSE(mem.put("1234", "v"));
+    EXPECT_FALSE(mem.put("123456789", ""));
+    EXPECT_FALSE(mem.get("1234").has_value());
+    EXPECT_EQ(mem.num_entries(), 1);
+}
+
+TEST(MemTableTest, EntryChecksums) {
+    MemTableOptions options;
+    options.protect_entries = true;
+    options.merge_operator = std::make_shared<AddOperator>();
+    auto memtable = std::make_shared<MemTable>(options);
+    memtable->put("plain", "a");
+    memtable->put("ttl", "b", 500);
+    memtable->put("gone", "");
+    memtable->merge("counter", "1");
+    memtable->merge("counter", "2");
+
+    EXPECT_EQ(memtable->get("plain").value(), "a");
+    EXPECT_EQ(memtable->get_entry("ttl")->expire_at, 500u);
+    EXPECT_EQ(memtable->get("gone").value(), "");
+    EXPECT_EQ(memtable->get_entry("counter")->type, EntryType::kMerge);
+    EXPECT_EQ(memtable->get("counter").value(), "3");
+    PinnableValue value;
+    EntryType type;
+    ASSERT_TRUE(memtable->get_entry("plain", &value, &type));
+    EXPECT_EQ(value.view(), "a");
+
+    // Checksums are counted with the value; tombstones have none
+    EXPECT_EQ(memtable->Size(), static_cast<int>(std::string("plainattlbgonecounter3").size() + sizeof(uint64_t) +
+                                                 3 * sizeof(uint32_t)));
+
+    memtable->mark_immutable();
+    std::shared_ptr<MemTable> flat = memtable->flatten();
+    EXPECT_EQ(flat->Size(), memtable->Size());
+    auto iter = flat->begin();
+    ASSERT_TRUE(iter.is_valid());
+    EXPECT_EQ(iter.key(), "counter");
+    EXPECT_EQ(iter.entry_type(), EntryType::kMerge);
+    EXPECT_EQ(iter.value(), "3");
+    iter.next();
+    iter.next();
+    EXPECT_EQ(iter.value(), "a");
+    iter.next();
+    EXPECT_EQ(iter.value(), "b");
+    EXPECT_EQ(iter.expire_at_micros(), 500u);
+}
+
+// A skip list that flips the first value byte of keys starting with "bad", as a stray write would
+class CorruptingRep : public MemTableRep {
+public:
+    explicit CorruptingRep(std::unique_ptr<MemTableRep> rep) : rep_(std::move(rep)) {}
+    std::optional<size_t> Insert(const std::string& key, const std::string& value) override {
+        std::string stored = value;
+        if (key.rfind("badtag", 0) == 0 && !stored.empty()) {
+            stored.back() ^= 0x20;  // 'V' -> 'v'
+        } else if (key.rfind("bad", 0) == 0 && !stored.empty()) {
+            stored[0] ^= 1;
+        }
+        return rep_->Insert(key, stored);
+    }
+    std::optional<std::string> Get(const std::string& key) const override { return rep_->Get(key); }
+    int NumEntries() const override { return rep_->NumEntries(); }
+    size_t ApproximateMemoryUsage() const override { return rep_->ApproximateMemoryUsage(); }
+    std::unique_ptr<Iterator> NewIterator() const override { return rep_->NewIterator(); }
+
+private:
+    std::unique_ptr<MemTableRep> rep_;
+};
+
+class CorruptingRepFactory : public MemTableRepFactory {
+public:
+    std::unique_ptr<MemTableRep> CreateMemTableRep(const Comparator* comparator) const override {
+        return std::make_unique<CorruptingRep>(SkipListRepFactory().CreateMemTableRep(comparator));
+    }
+    const char* Name() const override { return "CorruptingRepFactory"; }
+};
+
+TEST(MemTableTest, ChecksumMismatchAborts) {
+    MemTableOptions options;
+    options.rep_factory = std::make_shared<CorruptingRepFactory>();
+    options.protect_entries = true;
+    auto memtable = std::make_shared<MemTable>(options);
+    memtable->put("good", "value");
+    memtable->put("bad", "value");
+    EXPECT_EQ(memtable->get("good").value(), "value");
+    EXPECT_DEATH(memtable->get("bad"), "checksum mismatch");
+    EXPECT_DEATH(
+        {
+            auto iter = memtable->scan("bad", "");
+            iter.value();
+        },
+        "checksum mismatch");
+
+    // A flipped tag bit must not turn verification off for the entry
+    memtable->put("badtag", "value");
+    EXPECT_DEATH(memtable->get("badtag"), "unprotected entry");
+    EXPECT_DEATH(
+        {
+            auto iter = memtable->scan("badtag", "");
+            iter.value();
+        },
+        "unprotected entry");
+
+    // Without verification the corrupted value is returned as stored
+    options.verify_checksums = false;
+    auto unverified = std::make_shared<MemTable>(options);
+    unverified->put("bad", "value");
+    EXPECT_EQ(unverified->get("bad").value(), "walue");
+}
@@ -0,0 +1,305 @@
+#include "src/include/memtable_rep.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Every representation must pass the same behavioural checks
+class MemTableRepTest : public ::testing::TestWithParam<std::shared_ptr<MemTableRepFactory>> {
+protected:
+    std::unique_ptr<MemTableRep> NewRep() { return GetParam()->CreateMemTableRep(); }
+
+    static std::vector<std::pair<std::string, std::string>> Collect(MemTableRep::Iterator* iter) {
+        std::vector<std::pair<std::string, std::string>> out;
+        while (iter->is_valid()) {
+            out.emplace_back(iter->key(), iter->value());
+            iter->next();
+        }
+        return out;
+    }
+};
+
+TEST_P(MemTableRepTest, InsertGetOverwrite) {
+    auto rep = NewRep();
+    rep->Insert("b", "2");
+    rep->Insert("a", "1");
+    rep->Insert("b", "22");
+
+    EXPECT_EQ(rep->Get("a").value(), "1");
+    EXPECT_EQ(rep->Get("b").value(), "22");
+    EXPECT_FALSE(rep->Get("c").has_value());
+    EXPECT_GT(rep->ApproximateMemoryUsage(), 0);
+}
+
+TEST_P(MemTableRepTest, GetIntoBuffer) {
+    auto rep = NewRep();
+    rep->Insert("a", "1");
+    rep->Insert("b", std::string(100, 'b'));
+    std::string buffer;
+    std::string_view value;
+    EXPECT_FALSE(rep->GetInto("c", &buffer, &value));
+    ASSERT_TRUE(rep->GetInto("b", &buffer, &value));
+    EXPECT_EQ(value, std::string(100, 'b'));
+    ASSERT_TRUE(rep->GetInto("a", &buffer, &value));
+    EXPECT_EQ(value, "1");
+
+    // Frozen reps may lend out their own bytes
+    rep->MarkReadOnly();
+    ASSERT_TRUE(rep->GetInto("b", &buffer, &value));
+    EXPECT_EQ(value, std::string(100, 'b'));
+}
+
+TEST_P(MemTableRepTest, OrderedIterationKeepsLatestValue) {
+    auto rep = NewRep();
+    rep->Insert("c", "3");
+    rep->Insert("a", "1");
+    rep->Insert("b", "2");
+    rep->Insert("a", "11");
+
+    std::vector<std::pair<std::string, std::string>> expected = {{"a", "11"}, {"b", "2"}, {"c", "3"}};
+    auto iter = rep->NewIterator();
+    EXPECT_EQ(Collect(iter.get()), expected);
+
+    // Same result once frozen
+    rep->MarkReadOnly();
+    EXPECT_EQ(rep->NumEntries(), 3);
+    EXPECT_EQ(rep->Get("a").value(), "11");
+    iter = rep->NewIterator();
+    EXPECT_EQ(Collect(iter.get()), expected);
+}
+
+TEST_P(MemTableRepTest, Seek) {
+    auto rep = NewRep();
+    for (int i = 0; i < 100; i += 10) {
+        rep->Insert("key" + std::to_string(100 + i), std::to_string(i));
+    }
+    rep->MarkReadOnly();
+
+    auto iter = rep->NewIterator();
+    iter->seek("key125");
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->key(), "key130");
+
+    iter->seek("key999");
+    EXPECT_FALSE(iter->is_valid());
+
+    iter->seek_to_first();
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->key(), "key100");
+}
+
+TEST_P(MemTableRepTest, ReverseIteration) {
+    auto rep = NewRep();
+    for (int i = 0; i < 100; i += 10) {
+        rep->Insert("key" + std::to_string(100 + i), std::to_string(i));
+    }
+    rep->Insert("key150", "overwritten");
+    rep->MarkReadOnly();
+
+    auto iter = rep->NewIterator();
+    iter->seek_to_last();
+    std::vector<std::string> keys;
+    while (iter->is_valid()) {
+        keys.push_back(iter->key());
+        iter->prev();
+    }
+    std::vector<std::string> expected;
+    for (int i = 90; i >= 0; i -= 10) {
+        expected.push_back("key" + std::to_string(100 + i));
+    }
+    EXPECT_EQ(keys, expected);
+
+    iter->seek_for_prev("key155");
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->key(), "key150");
+    EXPECT_EQ(iter->value(), "overwritten");
+    iter->seek_for_prev("key160");
+    EXPECT_EQ(iter->key(), "key160");
+    iter->seek_for_prev("key0");
+    EXPECT_FALSE(iter->is_valid());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllReps, MemTableRepTest,
+    ::testing::Values(std::make_shared<SkipListRepFactory>(),
+                      std::make_shared<BTreeRepFactory>(),
+                      std::make_shared<VectorRepFactory>()),
+    [](const ::testing::TestParamInfo<std::shared_ptr<MemTableRepFactory>>& info) {
+        std::string name = info.param->Name();
+        return name.substr(0, name.find("RepFactory"));
+    });
+
+TEST(VectorRepTest, MutableIteratorIsASnapshot) {
+    auto rep = VectorRepFactory().CreateMemTableRep();
+    rep->Insert("b", "2");
+    auto iter = rep->NewIterator();
+    rep->Insert("a", "1");
+
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->key(), "b");
+    iter->next();
+    EXPECT_FALSE(iter->is_valid());
+}
+
+TEST(FlatRepTest, MatchesSourceAtEverySize) {
+    // Sizes around powers of two exercise incomplete Eytzinger levels
+    for (int n : {0, 1, 2, 3, 7, 8, 9, 31, 64, 100}) {
+        auto source = SkipListRepFactory().CreateMemTableRep();
+        for (int i = 0; i < n; ++i) {
+            source->Insert("k" + std::to_string(100 + 2 * i), std::to_string(i));
+        }
+        auto iter = source->NewIterator();
+        auto flat = BuildFlatMemTableRep(iter.get());
+        EXPECT_EQ(flat->NumEntries(), n);
+
+        for (int i = 0; i < n; ++i) {
+            EXPECT_EQ(flat->Get("k" + std::to_string(100 + 2 * i)).value(), std::to_string(i));
+            EXPECT_FALSE(flat->Get("k" + std::to_string(101 + 2 * i)).has_value());
+        }
+
+        auto flat_iter = flat->NewIterator();
+        for (int i = 0; i < n; ++i) {
+            // Seek between the previous key and this one ("k" sorts before everything)
+            flat_iter->seek(i == 0 ? "k" : "k" + std::to_string(99 + 2 * i));
+            ASSERT_TRUE(flat_iter->is_valid());
+            EXPECT_EQ(flat_iter->key(), "k" + std::to_string(100 + 2 * i));
+        }
+        flat_iter->seek("l");
+        EXPECT_FALSE(flat_iter->is_valid());
+
+        flat_iter->seek_to_first();
+        auto source_iter = source->NewIterator();
+        while (source_iter->is_valid()) {
+            ASSERT_TRUE(flat_iter->is_valid());
+            EXPECT_EQ(flat_iter->key(), source_iter->key());
+            EXPECT_EQ(flat_iter->value(), source_iter->value());
+            source_iter->next();
+            flat_iter->next();
+        }
+        EXPECT_FALSE(flat_iter->is_valid());
+
+        // Backwards from every gap
+        for (int i = 0; i < n; ++i) {
+            flat_iter->seek_for_prev("k" + std::to_string(101 + 2 * i));
+            ASSERT_TRUE(flat_iter->is_valid());
+            EXPECT_EQ(flat_iter->key(), "k" + std::to_string(100 + 2 * i));
+        }
+        flat_iter->seek_to_last();
+        for (int i = n - 1; i >= 0; --i) {
+            ASSERT_TRUE(flat_iter->is_valid());
+            EXPECT_EQ(flat_iter->key(), "k" + std::to_string(100 + 2 * i));
+            flat_iter->prev();
+        }
+        EXPECT_FALSE(flat_iter->is_valid());
+    }
+}
+
+TEST(FlatRepTest, KeysSharingTheirPrefixWord) {
+    // Every key starts with the same 8 bytes, so lookups hinge on the tie search
+    auto source = SkipListRepFactory().CreateMemTableRep();
+    for (int i = 0; i < 500; ++i) {
+        source->Insert("counter_" + std::to_string(1000 + 2 * i), std::to_string(i));
+    }
+    source->Insert("counter", "short");
+    source->Insert("counter_~", "last");
+    auto iter = source->NewIterator();
+    auto flat = BuildFlatMemTableRep(iter.get());
+
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_EQ(flat->Get("counter_" + std::to_string(1000 + 2 * i)).value(), std::to_string(i));
+        EXPECT_FALSE(flat->Get("counter_" + std::to_string(1001 + 2 * i)).has_value());
+    }
+    EXPECT_EQ(flat->Get("counter").value(), "short");
+    EXPECT_EQ(flat->Get("counter_~").value(), "last");
+
+    auto flat_iter = flat->NewIterator();
+    flat_iter->seek("counter_1501");
+    ASSERT_TRUE(flat_iter->is_valid());
+    EXPECT_EQ(flat_iter->key(), "counter_1502");
+    flat_iter->seek("counter_2");
+    EXPECT_EQ(flat_iter->key(), "counter_~");
+}
+
+TEST(FlatRepTest, InsertAborts) {
+    auto source = SkipListRepFactory().CreateMemTableRep();
+    source->Insert("a", "1");
+    auto iter = source->NewIterator();
+    auto flat = BuildFlatMemTableRep(iter.get());
+    EXPECT_DEATH(flat->Insert("b", "2"), "read-only");
+}
+
+TEST(FixedKeySkipListRepTest, EightAndSixteenByteKeys) {
+    for (size_t width : {8, 16}) {
+        auto rep = FixedKeySkipListRepFactory(width).CreateMemTableRep();
+        std::vector<std::string> keys;
+        for (int i = 0; i < 50; i++) {
+            std::string key(width, '\0');
+            key[width - 1] = static_cast<char>(200 - i);  // high bytes sort after low ones
+            key[0] = static_cast<char>(i % 3);
+            keys.push_back(key);
+            rep->Insert(key, "v" + std::to_string(i));
+        }
+        EXPECT_TRUE(rep->Insert(keys[7], "again").has_value());
+        EXPECT_EQ(rep->NumEntries(), 50);
+        EXPECT_EQ(rep->Get(keys[7]).value(), "again");
+        EXPECT_FALSE(rep->Get("short").has_value());
+
+        std::sort(keys.begin(), keys.end());
+        auto iter = rep->NewIterator();
+        std::vector<std::string> seen;
+        for (; iter->is_valid(); iter->next()) {
+            seen.push_back(iter->key());
+        }
+        EXPECT_EQ(seen, keys);
+
+        iter->seek_to_last();
+        EXPECT_EQ(iter->key(), keys.back());
+        iter->seek(keys[10]);
+        EXPECT_EQ(iter->key(), keys[10]);
+    }
+}
+
+TEST(FixedKeySkipListRepTest, RejectsOtherWidths) {
+    auto rep = FixedKeySkipListRepFactory(8).CreateMemTableRep();
+    EXPECT_TRUE(rep->AcceptsKey("12345678"));
+    // Padded or cut to 8 bytes these would alias other keys
+    EXPECT_FALSE(rep->AcceptsKey("1234"));
+    EXPECT_FALSE(rep->AcceptsKey("123456789"));
+    EXPECT_DEATH(rep->Insert("123456789", "v"), "9-byte key");
+}
+
+TEST(ComparatorRepTest, EveryRepFollowsTheComparator) {
+    std::vector<std::shared_ptr<MemTableRepFactory>> factories = {
+        std::make_shared<SkipListRepFactory>(), std::make_shared<BTreeRepFactory>(),
+        std::make_shared<VectorRepFactory>(), std::make_shared<FixedKeySkipListRepFactory>(8)};
+    for (const auto& factory : factories) {
+        auto rep = factory->CreateMemTableRep(ReverseBytewiseComparator());
+        rep->Insert("a", "1");
+        rep->Insert("c", "3");
+        rep->Insert("b", "2");
+        rep->MarkReadOnly();
+        EXPECT_EQ(rep->Get("b").value(), "2") << factory->Name();
+
+        auto iter = rep->NewIterator();
+        std::string keys;
+        for (; iter->is_valid(); iter->next()) {
+            keys += iter->key();
+        }
+        EXPECT_EQ(keys, "cba") << factory->Name();
+
+        // seek finds the first key at or after the target in comparator order
+        iter->seek("bb");
+        ASSERT_TRUE(iter->is_valid());
+        EXPECT_EQ(iter->key(), "b") << factory->Name();
+        iter->seek_for_prev("bb");
+        EXPECT_EQ(iter->key(), "c") << factory->Name();
+
+        auto source = rep->NewIterator();
+        auto flat = BuildFlatMemTableRep(source.get(), ReverseBytewiseComparator());
+        EXPECT_EQ(flat->Get("a").value(), "1");
+        auto flat_iter = flat->NewIterator();
+        flat_iter->seek("bb");
+        EXPECT_EQ(flat_iter->key(), "b");
+    }
+}
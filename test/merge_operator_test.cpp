@@ -0,0 +1,39 @@
+#include "src/include/merge_operator.hpp"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+TEST(MergeOperatorTest, Add) {
+    AddOperator add;
+    std::string base = "40";
+    EXPECT_EQ(add.Merge(&base, "2"), "42");
+    EXPECT_EQ(add.Merge(nullptr, "-5"), "-5");
+    EXPECT_EQ(add.Merge(&base, "not a number"), "40");
+}
+
+TEST(MergeOperatorTest, StringAppend) {
+    StringAppendOperator append(',');
+    std::string base = "a";
+    EXPECT_EQ(append.Merge(&base, "b"), "a,b");
+    EXPECT_EQ(append.Merge(nullptr, "b"), "b");
+}
+
+TEST(MergeOperatorTest, FullMergeAppliesOldestOperandFirst) {
+    StringAppendOperator append(',');
+    std::string base = "a";
+    // Newest first, as reads collect them
+    std::vector<std::string> operands = {"d", "c", "b"};
+    EXPECT_EQ(append.FullMerge(&base, operands), "a,b,c,d");
+    EXPECT_EQ(append.FullMerge(nullptr, operands), "b,c,d");
+    EXPECT_EQ(append.FullMerge(&base, {}), "a");
+}
+
+TEST(MergeOperatorTest, CombiningOperandsFirstGivesTheSameValue) {
+    AddOperator add;
+    std::string base = "10";
+    std::string older = "3";
+    std::string combined = add.Merge(&older, "4");
+    std::string step = add.Merge(&base, "3");
+    EXPECT_EQ(add.Merge(&step, "4"), add.Merge(&base, combined));
+}
@@ -0,0 +1,24 @@
+#include "src/include/prefix_extractor.hpp"
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(PrefixExtractorTest, FixedPrefix) {
+    FixedPrefixExtractor extractor(4);
+    EXPECT_TRUE(extractor.InDomain("user42"));
+    EXPECT_EQ(extractor.Transform("user42"), "user");
+    EXPECT_TRUE(extractor.InDomain("user"));
+    EXPECT_EQ(extractor.Transform("user"), "user");
+    EXPECT_FALSE(extractor.InDomain("usr"));
+}
+
+TEST(PrefixExtractorTest, DelimiterPrefix) {
+    DelimiterPrefixExtractor extractor('/', 2);
+    EXPECT_TRUE(extractor.InDomain("acme/orders/17"));
+    EXPECT_EQ(extractor.Transform("acme/orders/17"), "acme/orders/");
+    // The prefix itself maps to itself, so it can be used as a scan prefix
+    EXPECT_TRUE(extractor.InDomain("acme/orders/"));
+    EXPECT_EQ(extractor.Transform("acme/orders/"), "acme/orders/");
+    EXPECT_FALSE(extractor.InDomain("acme/orders"));
+    EXPECT_FALSE(extractor.InDomain(""));
+}
@@ -0,0 +1,54 @@
+#include "src/include/range_tombstone.hpp"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST(RangeTombstoneTest, EmptySet) {
+    FragmentedRangeTombstones fragments;
+    EXPECT_TRUE(fragments.empty());
+    EXPECT_EQ(fragments.find("a"), nullptr);
+
+    // Empty ranges are ignored
+    FragmentedRangeTombstones degenerate({{{"b", "b"}, 0}, {{"c", "a"}, 0}});
+    EXPECT_TRUE(degenerate.empty());
+}
+
+TEST(RangeTombstoneTest, OverlapsAreSplitAndKeepNewestSource) {
+    // Source 1 hides [b, f) from source 1 on; source 3 hides [a, d) and [e, h) from source 3 on
+    FragmentedRangeTombstones fragments({
+        {{"a", "d"}, 3},
+        {{"b", "f"}, 1},
+        {{"e", "h"}, 3},
+    });
+
+    std::vector<std::pair<std::string, std::string>> ranges;
+    std::vector<size_t> first_covered;
+    for (const auto& fragment : fragments.fragments()) {
+        ranges.emplace_back(fragment.begin, fragment.end);
+        first_covered.push_back(fragment.first_covered);
+    }
+    std::vector<std::pair<std::string, std::string>> expected_ranges = {
+        {"a", "b"}, {"b", "f"}, {"f", "h"}};
+    EXPECT_EQ(ranges, expected_ranges);
+    EXPECT_EQ(first_covered, (std::vector<size_t>{3, 1, 3}));
+
+    EXPECT_FALSE(fragments.covers("a", 2));
+    EXPECT_TRUE(fragments.covers("a", 3));
+    EXPECT_TRUE(fragments.covers("c", 1));
+    EXPECT_FALSE(fragments.covers("c", 0));
+    EXPECT_TRUE(fragments.covers("eee", 2));
+    EXPECT_FALSE(fragments.covers("g", 2));
+    // End keys are exclusive
+    EXPECT_EQ(fragments.find("h"), nullptr);
+    EXPECT_EQ(fragments.find("0"), nullptr);
+}
+
+TEST(RangeTombstoneTest, DisjointRangesStayApart) {
+    FragmentedRangeTombstones fragments({{{"m", "p"}, 0}, {{"a", "c"}, 0}});
+    ASSERT_EQ(fragments.fragments().size(), 2);
+    EXPECT_EQ(fragments.find("b")->begin, "a");
+    EXPECT_EQ(fragments.find("d"), nullptr);
+    EXPECT_EQ(fragments.find("o")->end, "p");
+}
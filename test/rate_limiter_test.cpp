@@ -0,0 +1,78 @@
+#include "src/include/rate_limiter.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+static double MillisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+TEST(RateLimiterTest, LimitsThroughput) {
+    // 10 KB per 10 ms refill
+    RateLimiter limiter(1 << 20, false, std::chrono::milliseconds(10));
+    EXPECT_EQ(limiter.GetSingleBurstBytes(), 10485u);
+
+    auto start = Clock::now();
+    for (int i = 0; i < 10; i++) {
+        limiter.Request(10000, IOPriority::kFlush);
+    }
+    // The first burst is available at once, each later one needs a refill
+    EXPECT_GE(MillisSince(start), 80);
+    // A request larger than a burst is granted over several refills
+    limiter.Request(50000, IOPriority::kCompaction);
+    EXPECT_GE(MillisSince(start), 120);
+
+    EXPECT_EQ(limiter.GetTotalBytesThrough(IOPriority::kFlush), 100000);
+    EXPECT_EQ(limiter.GetTotalBytesThrough(IOPriority::kCompaction), 50000);
+    EXPECT_EQ(limiter.GetTotalRequests(IOPriority::kFlush), 10);
+    EXPECT_EQ(limiter.GetTotalRequests(IOPriority::kCompaction), 1);
+}
+
+TEST(RateLimiterTest, ForegroundGoesFirst) {
+    RateLimiter limiter(1 << 20, false, std::chrono::milliseconds(10));
+    // A compaction backlog of about 400 ms
+    std::atomic<bool> compaction_done{false};
+    std::thread compaction([&] {
+        for (int i = 0; i < 40; i++) {
+            limiter.Request(10000, IOPriority::kCompaction);
+        }
+        compaction_done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+    // Each foreground request jumps the queue and waits about one refill
+    auto start = Clock::now();
+    for (int i = 0; i < 5; i++) {
+        limiter.Request(10000, IOPriority::kForeground);
+    }
+    EXPECT_LT(MillisSince(start), 250);
+    EXPECT_FALSE(compaction_done);
+    compaction.join();
+    EXPECT_EQ(limiter.GetTotalBytesThrough(IOPriority::kCompaction), 400000);
+}
+
+TEST(RateLimiterTest, AutoTunes) {
+    const int64_t max_rate = 10 << 20;
+    RateLimiter limiter(max_rate, true, std::chrono::milliseconds(1));
+
+    // Little pending work: the rate is lowered after each tuning window
+    auto start = Clock::now();
+    while (MillisSince(start) < 350) {
+        limiter.Request(100, IOPriority::kFlush);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    int64_t lowered = limiter.GetBytesPerSecond();
+    EXPECT_LT(lowered, max_rate);
+    EXPECT_GE(lowered, max_rate / 20);
+
+    // A backlog drains the bucket every refill and the rate climbs back
+    start = Clock::now();
+    while (MillisSince(start) < 350) {
+        limiter.Request(limiter.GetSingleBurstBytes() * 4, IOPriority::kCompaction);
+    }
+    EXPECT_GT(limiter.GetBytesPerSecond(), lowered);
+    EXPECT_LE(limiter.GetBytesPerSecond(), max_rate);
+}
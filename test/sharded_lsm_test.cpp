@@ -0,0 +1,218 @@
+#include "src/include/sharded_lsm.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::vector<std::pair<std::string, std::string>> Collect(StorageIterator* iter) {
+    std::vector<std::pair<std::string, std::string>> out;
+    while (iter->is_valid()) {
+        out.emplace_back(iter->key(), iter->value());
+        iter->next();
+    }
+    return out;
+}
+
+TEST(ShardedLsmTest, HashShardingPointOperations) {
+    ShardedLsmOptions options;
+    options.num_shards = 4;
+    ShardedLsm lsm(options);
+    EXPECT_EQ(lsm.num_shards(), 4);
+
+    for (int i = 0; i < 100; i++) {
+        lsm.put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    lsm.delete_key("key7");
+    lsm.put("key8", "updated");
+
+    EXPECT_EQ(lsm.get("key0").value(), "value0");
+    EXPECT_EQ(lsm.get("key99").value(), "value99");
+    EXPECT_EQ(lsm.get("key8").value(), "updated");
+    EXPECT_FALSE(lsm.get("key7").has_value());
+    EXPECT_FALSE(lsm.get("missing").has_value());
+
+    // Keys are spread over more than one shard
+    std::vector<int> per_shard(lsm.num_shards());
+    for (int i = 0; i < 100; i++) {
+        per_shard[lsm.shard_for("key" + std::to_string(i))]++;
+    }
+    EXPECT_EQ(std::count(per_shard.begin(), per_shard.end(), 0), 0);
+}
+
+TEST(ShardedLsmTest, HashShardingScanIsOrdered) {
+    ShardedLsm lsm;
+    std::vector<std::pair<std::string, std::string>> expected;
+    for (int i = 0; i < 50; i++) {
+        std::string key = "key" + std::to_string(100 + i);
+        lsm.put(key, std::to_string(i));
+        if (i % 5 == 0) {
+            lsm.delete_key(key);
+        } else {
+            expected.emplace_back(key, std::to_string(i));
+        }
+        if (i == 25) {
+            lsm.force_freeze_memtable();
+        }
+    }
+
+    auto iter = lsm.scan();
+    EXPECT_EQ(Collect(iter.get()), expected);
+}
+
+TEST(ShardedLsmTest, RangeSharding) {
+    ShardedLsmOptions options;
+    options.policy = ShardingPolicy::kRange;
+    options.split_keys = {"m", "d", "m"};  // sorted and deduplicated on open
+    ShardedLsm lsm(options);
+    EXPECT_EQ(lsm.num_shards(), 3);
+
+    EXPECT_EQ(lsm.shard_for(""), 0);
+    EXPECT_EQ(lsm.shard_for("cz"), 0);
+    EXPECT_EQ(lsm.shard_for("d"), 1);
+    EXPECT_EQ(lsm.shard_for("lzz"), 1);
+    EXPECT_EQ(lsm.shard_for("m"), 2);
+    EXPECT_EQ(lsm.shard_for("zebra"), 2);
+
+    lsm.put("zebra", "3");
+    lsm.put("apple", "1");
+    lsm.put("kiwi", "2");
+    lsm.put("mango", "x");
+    lsm.delete_key("mango");
+
+    EXPECT_EQ(lsm.get("kiwi").value(), "2");
+    EXPECT_FALSE(lsm.get("mango").has_value());
+
+    auto iter = lsm.scan();
+    std::vector<std::pair<std::string, std::string>> expected = {
+        {"apple", "1"}, {"kiwi", "2"}, {"zebra", "3"}};
+    EXPECT_EQ(Collect(iter.get()), expected);
+}
+
+TEST(ShardedLsmTest, ConcurrentWriters) {
+    ShardedLsmOptions options;
+    options.num_shards = 4;
+    options.shard_options.target_sst_size = 1024;
+    ShardedLsm lsm(options);
+
+    const int num_threads = 4;
+    const int per_thread = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&lsm, t]() {
+            for (int i = 0; i < per_thread; i++) {
+                lsm.put("t" + std::to_string(t) + "_" + std::to_string(i), std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < num_threads; t++) {
+        EXPECT_EQ(lsm.get("t" + std::to_string(t) + "_" + std::to_string(per_thread - 1)).value(),
+                  std::to_string(per_thread - 1));
+    }
+    auto iter = lsm.scan();
+    EXPECT_EQ(Collect(iter.get()).size(), num_threads * per_thread);
+    EXPECT_EQ(lsm.num_entries(), num_threads * per_thread);
+}
+
+TEST(ShardedLsmTest, ReverseScan) {
+    for (ShardingPolicy policy : {ShardingPolicy::kHash, ShardingPolicy::kRange}) {
+        ShardedLsmOptions options;
+        options.policy = policy;
+        options.num_shards = 3;
+        options.split_keys = {"key110", "key120"};
+        ShardedLsm lsm(options);
+
+        std::vector<std::pair<std::string, std::string>> expected;
+        for (int i = 0; i < 30; i++) {
+            std::string key = "key" + std::to_string(100 + i);
+            lsm.put(key, std::to_string(i));
+            if (key <= "key125") {
+                expected.emplace_back(key, std::to_string(i));
+            }
+        }
+        std::reverse(expected.begin(), expected.end());
+
+        auto iter = lsm.reverse_scan("key125");
+        std::vector<std::pair<std::string, std::string>> actual;
+        while (iter->is_valid()) {
+            actual.emplace_back(iter->key(), iter->value());
+            iter->prev();
+        }
+        EXPECT_EQ(actual, expected);
+    }
+}
+
+TEST(ShardedLsmTest, ScanPrefix) {
+    ShardedLsmOptions options;
+    options.policy = ShardingPolicy::kRange;
+    // "b/" straddles the first split
+    options.split_keys = {"b/5", "c/"};
+    options.shard_options.prefix_extractor = std::make_shared<DelimiterPrefixExtractor>('/', 1);
+    ShardedLsm lsm(options);
+
+    for (int i = 0; i < 10; i++) {
+        lsm.put("a/" + std::to_string(i), "a");
+        lsm.put("b/" + std::to_string(i), "b");
+        lsm.put("c/" + std::to_string(i), "c");
+    }
+    lsm.delete_key("b/9");
+
+    auto iter = lsm.scan_prefix("b/");
+    auto entries = Collect(iter.get());
+    ASSERT_EQ(entries.size(), 9);
+    EXPECT_EQ(entries.front().first, "b/0");
+    EXPECT_EQ(entries.back().first, "b/8");
+
+    ShardedLsmOptions hash_options;
+    hash_options.num_shards = 4;
+    ShardedLsm hashed(hash_options);
+    hashed.put("x/1", "1");
+    hashed.put("x/2", "2");
+    hashed.put("y/1", "3");
+    auto hashed_iter = hashed.scan_prefix("x/");
+    EXPECT_EQ(Collect(hashed_iter.get()).size(), 2);
+}
+
+TEST(ShardedLsmTest, ScanPrefixInReverseOrder) {
+    ShardedLsmOptions options;
+    options.policy = ShardingPolicy::kRange;
+    options.shard_options.comparator = ReverseBytewiseComparator();
+    // Keys with the prefix "ab" sort before it, so "abz" lands in the first shard
+    options.split_keys = {"abm", "a"};
+    ShardedLsm lsm(options);
+    for (const char* key : {"abz", "ab", "abc", "b", "aa", "a"}) {
+        lsm.put(key, "v");
+    }
+
+    auto iter = lsm.scan_prefix("ab");
+    std::vector<std::string> keys;
+    for (const auto& entry : Collect(iter.get())) {
+        keys.push_back(entry.first);
+    }
+    EXPECT_EQ(keys, (std::vector<std::string>{"abz", "abc", "ab"}));
+    iter->seek_to_last();
+    ASSERT_TRUE(iter->is_valid());
+    EXPECT_EQ(iter->key(), "ab");
+}
+
+TEST(ShardedLsmTest, DeleteRange) {
+    ShardedLsmOptions options;
+    options.policy = ShardingPolicy::kRange;
+    options.split_keys = {"d", "m"};
+    ShardedLsm lsm(options);
+    for (char c = 'a'; c <= 'z'; c++) {
+        lsm.put(std::string(1, c), "v");
+    }
+    // Spans all three shards
+    lsm.delete_range("c", "n");
+    auto iter = lsm.scan();
+    EXPECT_EQ(Collect(iter.get()).size(), 26 - 11);
+    EXPECT_TRUE(lsm.get("b").has_value());
+    EXPECT_FALSE(lsm.get("c").has_value());
+    EXPECT_FALSE(lsm.get("m").has_value());
+    EXPECT_TRUE(lsm.get("n").has_value());
+}
@@ -0,0 +1,145 @@
+#include "src/include/write_buffer_manager.hpp"
+#include "src/include/lsm_storage.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+TEST(WriteBufferManagerTest, TracksMemtableMemory) {
+    auto wbm = std::make_shared<WriteBufferManager>(1024 * 1024);
+
+    LsmStorageOptions options;
+    options.write_buffer_manager = wbm;
+    LsmStorageInner storage(options);
+
+    storage.put("key1", "value1");
+    storage.put("key2", "value2");
+    EXPECT_EQ(wbm->memory_usage(), storage.get_current_memtable_size());
+    EXPECT_EQ(wbm->mutable_memory_usage(), wbm->memory_usage());
+
+    // Frozen memtables are still alive but no longer count as active memory
+    storage.force_freeze_memtable();
+    EXPECT_EQ(wbm->mutable_memory_usage(), 0);
+    EXPECT_EQ(wbm->memory_usage(), storage.get_imm_memtable_size(0));
+}
+
+TEST(WriteBufferManagerTest, ReleasesMemoryOnDestruction) {
+    auto wbm = std::make_shared<WriteBufferManager>(1024 * 1024);
+    {
+        LsmStorageOptions options;
+        options.write_buffer_manager = wbm;
+        LsmStorageInner storage(options);
+        storage.put("key1", "value1");
+        storage.force_freeze_memtable();
+        storage.put("key2", "value2");
+        EXPECT_GT(wbm->memory_usage(), 0);
+    }
+    EXPECT_EQ(wbm->memory_usage(), 0);
+    EXPECT_EQ(wbm->mutable_memory_usage(), 0);
+}
+
+TEST(WriteBufferManagerTest, FreezesLargestMemtableAcrossInstances) {
+    auto wbm = std::make_shared<WriteBufferManager>(200);
+
+    LsmStorageOptions options;
+    options.write_buffer_manager = wbm;
+    LsmStorageInner small(options);
+    LsmStorageInner large(options);
+
+    small.put("s", "1");
+    for (int i = 0; i < 10; i++) {
+        large.put("key" + std::to_string(i), std::string(10, 'x'));
+    }
+    EXPECT_EQ(large.get_imm_memtables_count(), 0);
+
+    // Pushing the small instance over the shared budget freezes the large one
+    small.put("t", std::string(100, 'y'));
+    EXPECT_EQ(large.get_imm_memtables_count(), 1);
+    EXPECT_EQ(small.get_imm_memtables_count(), 0);
+    EXPECT_LE(wbm->mutable_memory_usage(), wbm->buffer_size());
+
+    // Data is still readable after the freeze
+    EXPECT_EQ(large.get("key3").value(), std::string(10, 'x'));
+}
+
+TEST(WriteBufferManagerTest, ChargesSharedCacheBudget) {
+    auto budget = std::make_shared<MemoryBudget>();
+    {
+        auto wbm = std::make_shared<WriteBufferManager>(0, budget);
+        EXPECT_FALSE(wbm->enabled());
+
+        LsmStorageOptions options;
+        options.write_buffer_manager = wbm;
+        Lsm lsm(options);
+        lsm.put("key", std::string(100, 'v'));
+
+        EXPECT_EQ(budget->usage(), wbm->memory_usage());
+        EXPECT_GT(budget->usage(), 100);
+    }
+    EXPECT_EQ(budget->usage(), 0);
+}
+
+TEST(WriteBufferManagerTest, ImmCompactionReleasesOverwrittenVersions) {
+    auto wbm = std::make_shared<WriteBufferManager>(1024 * 1024);
+
+    LsmStorageOptions options;
+    options.write_buffer_manager = wbm;
+    LsmStorageInner storage(options);
+
+    for (int round = 0; round < 4; round++) {
+        storage.put("key1", "value1");
+        storage.put("key2", "value2");
+        storage.force_freeze_memtable();
+    }
+    size_t before = wbm->memory_usage();
+
+    ASSERT_TRUE(storage.compact_imm_memtables());
+    EXPECT_EQ(wbm->memory_usage(), before / 4);
+    EXPECT_EQ(wbm->memory_usage(), storage.get_imm_memtable_size(0));
+    EXPECT_EQ(wbm->mutable_memory_usage(), 0);
+}
+
+TEST(WriteBufferManagerTest, FreezesLargestColumnFamily) {
+    auto wbm = std::make_shared<WriteBufferManager>(1024);
+
+    LsmStorageOptions options;
+    options.write_buffer_manager = wbm;
+    LsmStorageInner storage(options);
+    ColumnFamilyHandle* payload = storage.create_column_family("payload", ColumnFamilyOptions());
+
+    storage.put("meta", "small");
+    for (int i = 0; i < 20; i++) {
+        storage.put(payload, "key" + std::to_string(i), std::string(60, 'x'));
+    }
+
+    // Column families share the budget; the payload family holds most of it
+    EXPECT_LE(wbm->mutable_memory_usage(), 1024);
+    EXPECT_EQ(storage.get_imm_memtables_count(), 0);
+    EXPECT_EQ(storage.get("meta").value(), "small");
+    EXPECT_EQ(storage.get(payload, "key0").value(), std::string(60, 'x'));
+}
+
+TEST(WriteBufferManagerTest, InstancesComeAndGoWhileOthersFreeze) {
+    auto wbm = std::make_shared<WriteBufferManager>(512);
+    LsmStorageOptions options;
+    options.write_buffer_manager = wbm;
+    LsmStorageInner steady(options);
+    steady.put("key1", std::string(20, 'x'));
+
+    // The writer's freezes call into whichever instance is largest, including short-lived ones
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 0; !done; i++) {
+            steady.put("key" + std::to_string(i % 100), std::string(20, 'x'));
+        }
+    });
+    for (int round = 0; round < 200; round++) {
+        LsmStorageInner transient(options);
+        transient.put("big", std::string(400, 'y'));
+    }
+    done = true;
+    writer.join();
+
+    EXPECT_EQ(steady.get("key1").value(), std::string(20, 'x'));
+}